@@ -21,13 +21,23 @@
 #define LED_AZUL_PIN 12     ///< Pino GPIO para o componente Azul do LED RGB.
 
 // --- CONFIGURAÇÕES DE ENTRADA ---
-#define BTN_DEBOUNCE_TIME_MS 200      ///< Tempo (ms) para debounce dos botões A e B.
+#define BTN_DEBOUNCE_TIME_MS 20       ///< Tempo (ms) do alarme de debounce: o nível lido ao fim dele é o estável.
+#define BTN_LONG_PRESS_MS 800         ///< Tempo (ms) pressionado até o evento de toque longo.
+#define BTN_DOUBLE_PRESS_MS 350       ///< Janela (ms) entre dois presses para o evento de toque duplo.
 #define ADC_JOYSTICK_Y_CHANNEL 0      ///< Canal ADC para o eixo Y do joystick.
-// Limiares para detecção de movimento do joystick no eixo Y (valores ADC de 12 bits: 0-4095)
-#define JOYSTICK_Y_MOVE_UP_THRESHOLD 3000     ///< Limiar ADC para movimento "para cima" do joystick.
-#define JOYSTICK_Y_MOVE_DOWN_THRESHOLD 1000   ///< Limiar ADC para movimento "para baixo" do joystick.
-#define JOYSTICK_Y_NEUTRAL_DEADZONE_HIGH 2500 ///< Limiar superior da zona morta central do joystick.
-#define JOYSTICK_Y_NEUTRAL_DEADZONE_LOW 1500  ///< Limiar inferior da zona morta central do joystick.
+#define ADC_JOYSTICK_X_CHANNEL 1      ///< Canal ADC para o eixo X do joystick.
+#define ADC_TEMP_SENSOR_CHANNEL 4     ///< Canal ADC do sensor de temperatura interno do RP2040.
+#define ADC_SCAN_RATE_HZ 500          ///< Rodadas/s do ADC em round-robin (cada rodada converte Y, X e temperatura).
+// Limiares para detecção de movimento do joystick nos eixos X e Y (valores ADC de 12 bits: 0-4095)
+#define JOYSTICK_MOVE_HIGH_THRESHOLD 3000   ///< Limiar ADC para movimento "para cima" (Y) ou "para a direita" (X).
+#define JOYSTICK_MOVE_LOW_THRESHOLD 1000    ///< Limiar ADC para movimento "para baixo" (Y) ou "para a esquerda" (X).
+#define JOYSTICK_NEUTRAL_DEADZONE_HIGH 2500 ///< Limiar superior da zona morta central (histerese da volta ao centro).
+#define JOYSTICK_NEUTRAL_DEADZONE_LOW 1500  ///< Limiar inferior da zona morta central (histerese da volta ao centro).
+#define JOYSTICK_FILTER_SHIFT 2             ///< Média móvel exponencial das leituras: peso 1/2^N para a nova amostra.
+#define JOYSTICK_REPEAT_DELAY_MS 500        ///< Tempo (ms) segurando o joystick até o primeiro evento repetido.
+#define JOYSTICK_REPEAT_INTERVAL_MS 200     ///< Intervalo (ms) entre os eventos repetidos seguintes.
+#define INPUT_QUEUE_LEN 32                  ///< Eventos na fila de entrada (potência de 2).
+#define INPUT_EVENT_MAX_AGE_MS 1000         ///< Navegação mais velha que isso é ignorada pelo menu; outros eventos expiram na cauda da fila.
 
 // --- CONFIGURAÇÕES DO DISPLAY OLED ---
 #define OLED_I2C_PORT i2c1               ///< Instância I2C utilizada para o OLED.
@@ -36,5 +46,51 @@
 #define OLED_WIDTH 128                   ///< Largura do display OLED em pixels.
 #define OLED_HEIGHT 64                   ///< Altura do display OLED em pixels.
 #define OLED_LINE_HEIGHT 10              ///< Altura aproximada de uma linha de texto no OLED.
+#define OLED_MENU_VISIBLE_ITEMS 4        ///< Itens de menu visíveis de uma vez; o restante rola com a seleção.
+
+// --- CONFIGURAÇÕES DE TELEMETRIA ---
+#define NET_STATS_PUBLISH_INTERVAL_MS 60000 ///< Intervalo (ms) entre publicações das estatísticas do lwIP.
+#define MQTT_RECONNECT_MIN_MS 1000          ///< Espera (ms) antes da primeira nova tentativa de conexão ao broker.
+#define MQTT_RECONNECT_MAX_MS 30000         ///< Espera máxima (ms) entre tentativas; dobra a cada falha até este valor.
+
+// --- CONFIGURAÇÕES DE NONCE ---
+#define NONCE_FLASH_OFFSET (PICO_FLASH_SIZE_BYTES - 2 * 4096) ///< Dois últimos setores da flash: contador de boots.
+#define NONCE_MAX_SENDERS 4                                   ///< Publishers acompanhados na detecção de replay.
+// #define FRAME_ALLOWED_SENDERS 0x0404040c, 0x0a0b0c0d       ///< IDs de publisher aceitos nos frames AEAD (sem a definição, todos).
+
+// --- CONFIGURAÇÕES DO JOURNAL (STORE-AND-FORWARD) ---
+#define JOURNAL_FLASH_SECTORS 16                                                     ///< Setores do anel (64 KB); cada um é apagado uma vez por volta.
+#define JOURNAL_FLASH_OFFSET (NONCE_FLASH_OFFSET - JOURNAL_FLASH_SECTORS * 4096)     ///< Logo abaixo dos setores do contador de boots.
+#define JOURNAL_DRAIN_RATE_PER_S 50                                                  ///< Mensagens/s reenviadas depois que a conexão volta.
+#define JOURNAL_DRAIN_BATCH 8                                                        ///< Máximo de mensagens reenviadas por chamada de journal_poll.
+#define JOURNAL_FLUSH_MS 2000                                                        ///< Tempo máximo (ms) de um registro no buffer de página em RAM.
+
+// --- CONFIGURAÇÕES DO MODO INTERCALADO (PUBLISHER) ---
+#define PUBLISH_MIXED_INTERVAL_MS 100 ///< Intervalo (ms) entre mensagens; cada uma usa o próximo modo de segurança.
+
+// --- CONFIGURAÇÕES DA LATÊNCIA DE PONTA A PONTA (SUBSCRIBER) ---
+#define CLOCK_SYNC_INTERVAL_MS 2000       ///< Intervalo entre pings de sincronização do relógio com o publisher.
+#define CLOCK_SYNC_WINDOW 8               ///< Amostras guardadas; vale o offset da de menor atraso.
+#define LATENCY_SUB_BITS 4                ///< Precisão dos histogramas: erro relativo de até 2^-(LATENCY_SUB_BITS - 1).
+#define LATENCY_MAX_BITS 24               ///< Maior latência registrada: 2^LATENCY_MAX_BITS - 1 µs (~16,8 s).
+#define LATENCY_PUBLISH_INTERVAL_MS 10000 ///< Intervalo entre publicações dos percentis no tópico de status.
+
+// --- CONFIGURAÇÕES DO FIRMWARE DE LOOPBACK (src/loopback.c) ---
+#define LOOPBACK_MESSAGES 100           ///< Mensagens por rodada de um modo (percentis sobre elas).
+#define LOOPBACK_TIMEOUT_MS 2000        ///< Espera máxima pela volta de uma mensagem pelo broker.
+#define LOOPBACK_MAX_TIMEOUTS 3         ///< Perdas seguidas que encerram a rodada (broker fora).
+#define LOOPBACK_STEP_INTERVAL_MS 1000  ///< Pausa entre rodadas, com o resultado no display.
+
+// --- CONFIGURAÇÕES DO PRÉ-FILTRO (SUBSCRIBER) ---
+#define PREFILTER_RATE_PER_S 10               ///< Mensagens/s por remetente que seguem para o MAC/decifragem.
+#define PREFILTER_BURST 5                     ///< Rajada máxima do balde de tokens de cada remetente.
+#define PREFILTER_DISPLAY_INTERVAL_MS 1000    ///< Intervalo mínimo (ms) entre atualizações do contador de recusas no OLED.
+
+// --- CONFIGURAÇÕES DA COMPRESSÃO (src/compress.c) ---
+#define COMPRESS_KEYFRAME_INTERVAL 10 ///< Mensagens entre quadros-chave no modo delta (limita a perda após uma lacuna).
+#define COMPRESS_MAX_TOPICS 8         ///< Tópicos com estado de descompressão no subscriber.
+
+// --- CONFIGURAÇÕES DE CHAVES ---
+#define KEY_ROTATION_INTERVAL_MS 3600000 ///< Intervalo (ms) entre rotações de sessão feitas pelo publisher (0 desabilita).
 
 #endif // CONFIG_H
@@ -9,25 +9,44 @@
 // Credenciais do Broker MQTT
 #define MQTT_CLIENT_ID_PUBLISHER "bitdog_publisher"
 #define MQTT_CLIENT_ID_SUBSCRIBER "bitdog_subscriber"
+#define MQTT_CLIENT_ID_LOOPBACK "bitdog_loopback"
 
 #define MQTT_BROKER_IP "164.152.59.111" // Mudar para o IP broker (Mosquitto)
 
+#if MQTT_USE_TLS
+#define MQTT_BROKER_PORT 8883
+#define MQTT_TLS_SERVER_NAME "mosquitto.local" // Deve corresponder ao CN/SAN do certificado do broker
+// Certificado da CA que assinou o certificado do broker (PEM)
+#define MQTT_TLS_CA_CERT \
+    "-----BEGIN CERTIFICATE-----\n" \
+    "COLE_AQUI_O_CERTIFICADO_DA_CA\n" \
+    "-----END CERTIFICATE-----\n"
+#else
 #define MQTT_BROKER_PORT 1883
+#endif
 #define MQTT_USER "aluno"
 #define MQTT_PASS "senha123"
 
 #define MQTT_TOPIC_SUBSCRIBE "escola/sala1/temperatura"
+#define MQTT_TOPIC_STATUS "escola/sala1/status" // Estatísticas publicadas em <topico>/<client_id>
+#define MQTT_TOPIC_KEYS "escola/sala1/chaves"   // Anúncio de nova sessão de chaves (mensagem retida)
+#define MQTT_TOPIC_SENSORS "escola/sala1/sensores" // Streams adicionais do modo multi-stream: <topico>/<sensor>
+#define MQTT_TOPIC_CLOCK "escola/sala1/relogio" // Sincronização do relógio: <topico>/ping e <topico>/pong
+#define MQTT_TOPIC_LOOPBACK "escola/sala1/loopback" // Firmware de loopback: publica e recebe as próprias mensagens
 
-// Chave XOR para criptografia/descriptografia
-#define XOR_KEY 42
+// Segredo mestre: as chaves XOR, HMAC, AES e ChaCha de cada sessão são derivadas dele
+// com HKDF-SHA256 (ver include/key_manager.h)
+#define KEY_MASTER_SECRET "DontPanicAndCarryATowelHitchhike" // 32 bytes
+#define KEY_HKDF_SALT "iot-security-lab"
 
-// Chave secreta para HMAC
-#define HMAC_SECRET_KEY "DontPanicAndCarryATowelHitchhike"
 #define HMAC_DIGEST_SIZE 32 // SHA256 tamnho de output 32 bytes
 
-// Chave e IV para AES-GCM
-#define AES_KEY "MostlyHarmless42LifeUniverseEv" // 32 bytes para AES-256
+// Tamanhos para AES-GCM
 #define AES_IV_LEN 12
 #define AES_TAG_LEN 16
 
+// Tamanhos para ChaCha20-Poly1305 (RFC 8439)
+#define CHACHA_NONCE_LEN 12
+#define CHACHA_TAG_LEN 16
+
 #endif // CREDENTIALS_H
\ No newline at end of file
@@ -0,0 +1,47 @@
+#ifndef ADC_SCAN_H
+#define ADC_SCAN_H
+
+#include <stdint.h>
+
+/**
+ * ADC em modo livre: o hardware converte em round-robin os eixos Y e X do joystick e o
+ * sensor de temperatura, a ADC_SCAN_RATE_HZ rodadas por segundo, e grava na FIFO. A IRQ
+ * da FIFO dispara a cada rodada completa, guarda a última leitura de cada canal e chama
+ * o handler registrado (o joystick filtra e gera eventos ali). Ninguém mais chama
+ * adc_read(): quem precisa de uma leitura usa adc_scan_latest(), sem esperar conversão.
+ * Se a FIFO transborda, a ordem dos canais se perde: a IRQ para o ADC, esvazia a FIFO e
+ * recomeça a rodada pelo primeiro canal.
+ */
+
+#define ADC_SCAN_CHANNEL_COUNT 5 // Canais do ADC do RP2040 (0-3 nos GPIOs 26-29, 4 = temperatura)
+
+/**
+ * Chamado na IRQ a cada rodada.
+ * @param samples  Leituras de 12 bits indexadas pelo canal do ADC
+ * @param now_ms   Instante da rodada, desde o boot
+ */
+typedef void (*adc_scan_handler_t)(const uint16_t *samples, uint32_t now_ms);
+
+/**
+ * Configura os GPIOs, a FIFO, o divisor de clock e a IRQ e liga a conversão contínua.
+ * Pode ser chamada mais de uma vez.
+ */
+void adc_scan_init(void);
+
+/**
+ * Registra o handler da rodada (um só; NULL desliga).
+ */
+void adc_scan_set_handler(adc_scan_handler_t handler);
+
+/**
+ * Última leitura de 12 bits do canal (0 antes da primeira rodada ou para canal fora da varredura).
+ */
+uint16_t adc_scan_latest(uint8_t channel);
+
+/**
+ * Imprime rodadas por segundo, ressincronizações por transbordo, erros de conversão e a
+ * fração de CPU gasta na IRQ desde a última chamada.
+ */
+void adc_scan_print_stats(void);
+
+#endif // ADC_SCAN_H
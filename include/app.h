@@ -0,0 +1,58 @@
+#ifndef APP_H
+#define APP_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "include/mqtt_comm.h"
+
+/**
+ * Núcleo comum do publisher e do subscriber: boot (periféricos, chaves, Wi-Fi, MQTT),
+ * laço principal (console, estatísticas, log, reconexão) e a máquina de estados do menu.
+ * Cada firmware só descreve o seu papel (app_role_t) e a tabela de modos; cada modo de
+ * segurança é um plugin (app_mode_t) com os mesmos quatro ganchos nos dois lados:
+ *   init      ao entrar no modo (ex.: tabela de streams)
+ *   encode    um passo de publicação; retorna quanto dormir até o próximo
+ *   decode    handler MQTT das mensagens recebidas enquanto o modo está ativo
+ *   teardown  ao voltar ao menu
+ * O publisher usa init/encode e o subscriber decode; um firmware com os dois lados
+ * pode preencher todos. Os ganchos ausentes (NULL) são pulados.
+ */
+
+// Retorno de encode para voltar ao menu (falha que o modo não consegue contornar)
+#define APP_MODE_EXIT (-1)
+
+// Número máximo de modos no menu
+#define APP_MAX_MODES 8
+
+typedef struct {
+    const char *label;  // Item do menu
+    const char *title;  // Linha 0 do display enquanto o modo está ativo
+    void (*init)(void);
+    int32_t (*encode)(void);       // ms até o próximo passo, ou APP_MODE_EXIT
+    mqtt_message_handler_t decode; // Instalado com mqtt_comm_set_message_handler
+    void (*teardown)(void);
+} app_mode_t;
+
+typedef struct {
+    const char *name;      // Título do menu
+    const char *client_id; // Cliente MQTT e sufixo do tópico de status
+    bool is_publisher;     // Coluna das linhas do display (display_text_in_line)
+    bool offline_ok;       // Segue para o menu mesmo sem Wi-Fi ou broker no boot
+    const char *idle_text; // Linha 1 ao entrar em um modo ("Enviando msg...")
+    const app_mode_t *modes;
+    size_t mode_count;
+    void (*boot)(void);         // Depois da espera do terminal, antes do Wi-Fi (gravações na flash)
+    void (*connected)(void);    // Depois da conexão MQTT (assinaturas)
+    void (*poll)(bool in_mode); // A cada volta do laço, antes da reconexão
+} app_role_t;
+
+/**
+ * Inicializa a placa, conecta e roda o menu e os modos do papel. Só retorna se o
+ * Wi-Fi ou o broker falharem no boot e o papel não aceitar rodar sem rede.
+ * @param role  Papel do firmware (a tabela de modos deve viver até o fim do programa)
+ * @return -1 na falha de conexão
+ */
+int app_run(const app_role_t *role);
+
+#endif // APP_H
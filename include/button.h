@@ -1,18 +1,28 @@
 #ifndef BUTTON_H
 #define BUTTON_H
 
-#include "pico/stdlib.h"
 #include <stdbool.h>
 
 /**
- * @brief Initializes the button GPIO and sets up the interrupt.
+ * Botões A, B e do joystick pelos eventos de entrada (include/input.h). Uma borda em
+ * qualquer botão desliga a IRQ daquele pino e arma um alarme de BTN_DEBOUNCE_TIME_MS; no
+ * alarme, o nível lido é o estável. Se mudou, sai um press ou release com o instante da
+ * primeira borda, e a IRQ é religada. Um pulso mais curto que o debounce não gera nada.
+ * Um press arma outro alarme, que gera o toque longo se o botão ainda estiver pressionado
+ * depois de BTN_LONG_PRESS_MS. Um segundo press até BTN_DOUBLE_PRESS_MS depois do
+ * primeiro gera o toque duplo. Os toques feitos enquanto o laço principal dorme ficam
+ * na fila, um evento por toque.
+ */
+
+/**
+ * Configura os GPIOs dos três botões (pull-up, ativos em nível baixo) e as IRQs de borda.
  */
 void button_init(void);
 
 /**
- * @brief Checks if the button was pressed and resets the flag.
- * 
- * @return true if the button was pressed since the last call, false otherwise.
+ * Retira da fila o próximo press do botão A ou do botão do joystick (confirma no menu,
+ * volta ao menu nos modos). Presses anteriores ao último atendido são descartados.
+ * @return true se havia um press na fila
  */
 bool button_get_pressed_and_reset(void);
 
@@ -0,0 +1,50 @@
+#ifndef CLOCK_SYNC_H
+#define CLOCK_SYNC_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/**
+ * Sincronização do relógio do subscriber com o do publisher, no estilo do NTP, por
+ * MQTT_TOPIC_CLOCK. A cada CLOCK_SYNC_INTERVAL_MS o subscriber publica um ping em
+ * <topico>/ping com o instante de envio t1; o publisher responde em <topico>/pong com
+ * t1, a chegada do ping t2 e o envio da resposta t3; o subscriber anota a chegada t4.
+ * As chegadas são as do PUBLISH no lwIP (mqtt_comm_message_age_us), não a do handler.
+ *   atraso = (t4 - t1) - (t3 - t2)
+ *   offset = ((t2 - t1) + (t3 - t4)) / 2     (relógio do publisher - relógio local)
+ * Das últimas CLOCK_SYNC_WINDOW amostras vale a de menor atraso: o erro do offset é no
+ * máximo metade desse atraso, mais a deriva entre os cristais até a próxima amostra.
+ * O ping não é autenticado; o offset só é usado em medições (include/latency.h).
+ */
+
+/**
+ * Lado do publisher: assina <topico>/ping e responde cada ping. Chamar depois da conexão MQTT.
+ */
+void clock_sync_serve(void);
+
+/**
+ * Lado do subscriber: assina <topico>/pong. Chamar depois da conexão MQTT.
+ */
+void clock_sync_start(void);
+
+/**
+ * Lado do subscriber: publica o próximo ping quando vence o intervalo.
+ * @param now_ms  Tempo atual em ms desde o boot
+ */
+void clock_sync_poll(uint32_t now_ms);
+
+/**
+ * Converte um instante do relógio local para o relógio do publisher.
+ * @param local_us   µs desde o boot desta placa
+ * @param remote_us  Recebe o mesmo instante em µs desde o boot do publisher
+ * @return false enquanto não houver amostra
+ */
+bool clock_sync_to_remote(uint64_t local_us, uint64_t *remote_us);
+
+/**
+ * Imprime o offset em uso, o atraso da amostra escolhida e os pings enviados, respondidos
+ * e descartados.
+ */
+void clock_sync_print_stats(void);
+
+#endif // CLOCK_SYNC_H
@@ -0,0 +1,91 @@
+#ifndef COMPRESS_H
+#define COMPRESS_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * Compressão das leituras antes do modo de segurança (o frame_encode recebe o resultado
+ * como texto em claro). As amostras viram inteiros em ponto fixo e cada uma é enviada
+ * como a diferença para a anterior, em varint zigzag; diferenças zero consecutivas
+ * (a mesma leitura repetida) viram um único par [0][repetições - 1]:
+ *   [marcador | chave | casas (1)] [época] [seq] [n] [timestamp] [d1] [d2] ... (varints)
+ * A época é o contador de boots do publisher (nonce_boot()): seq e timestamp recomeçam
+ * a cada boot, então o subscriber só compara os dois dentro da mesma época. Um quadro-chave
+ * de época maior reinicia o estado do tópico; época menor é replay.
+ * Quadro-chave: timestamp e primeira leitura absolutos; não depende de mensagens anteriores.
+ * Quadro delta: timestamp e primeira leitura relativos ao quadro anterior do mesmo stream.
+ * No modo COMPRESS_DELTA, um quadro-chave sai a cada COMPRESS_KEYFRAME_INTERVAL mensagens.
+ * Se uma mensagem se perde, o subscriber percebe o salto na seq e descarta os deltas até
+ * o próximo quadro-chave. COMPRESS_STATELESS só envia quadros-chave: os deltas ficam
+ * dentro do lote, e perder uma mensagem não afeta as seguintes.
+ * O subscriber devolve o mesmo texto "v1;v2;...;vN,timestamp" dos streams sem compressão.
+ */
+
+#define COMPRESS_MARKER 0xC0           // Nibble alto do primeiro byte; texto ASCII nunca começa assim
+#define COMPRESS_MAX_READINGS 32       // Leituras por mensagem
+#define COMPRESS_MAX_DECIMALS 7        // Casas decimais do ponto fixo (3 bits no primeiro byte)
+#define COMPRESS_MAX_LEN(count) (1 + 5 + 5 + 1 + 10 + 5 * (count)) // Pior caso de compress_encode
+
+typedef enum {
+    COMPRESS_NONE = 0,  // Texto "v1;v2;...,timestamp"
+    COMPRESS_DELTA,     // Deltas entre mensagens, com quadro-chave periódico
+    COMPRESS_STATELESS, // Toda mensagem é quadro-chave (deltas só dentro do lote)
+} compress_mode_t;
+
+typedef enum {
+    COMPRESS_OK = 0,
+    COMPRESS_ERR_FORMAT,   // Varint truncado, contagem inválida ou texto não cabe na saída
+    COMPRESS_ERR_GAP,      // Seq pulou: mensagem perdida, deltas descartados até o próximo quadro-chave
+    COMPRESS_ERR_UNSYNCED, // Quadro delta recebido enquanto espera o quadro-chave (ou de época nova)
+    COMPRESS_ERR_REPLAY,   // Época menor, ou seq/timestamp não maior que o último aceito da época
+    COMPRESS_STATUS_COUNT
+} compress_status_t;
+
+// Estado do codificador de um stream (zerado = o próximo quadro é chave)
+typedef struct {
+    bool valid;
+    uint8_t decimals;
+    uint8_t since_key; // Mensagens desde o último quadro-chave
+    uint32_t seq;
+    int32_t last_value;
+    uint64_t last_timestamp;
+} compress_encoder_t;
+
+/**
+ * Casas decimais de uma amostra em texto (ex.: "26.5" -> 1).
+ */
+uint8_t compress_sample_decimals(const char *text);
+
+/**
+ * Comprime um lote de leituras.
+ * @param out_size  Deve comportar COMPRESS_MAX_LEN(count) bytes
+ * @return Bytes escritos, ou 0 se count, decimals ou out_size forem inválidos
+ */
+size_t compress_encode(compress_encoder_t *encoder, compress_mode_t mode, const int32_t *values, size_t count,
+                       uint8_t decimals, uint64_t timestamp_us, uint8_t *out, size_t out_size);
+
+/**
+ * Indica se a mensagem (já sem o modo de segurança) foi gerada por compress_encode.
+ */
+bool compress_is_packed(const uint8_t *data, size_t len);
+
+/**
+ * Descomprime para o texto "v1;v2;...;vN,timestamp" (terminado em '\0'), usando o
+ * estado do tópico. O estado só avança quando o resultado é COMPRESS_OK; uma lacuna
+ * marca o tópico para esperar o próximo quadro-chave.
+ * @param text_size  Tamanho do buffer de texto
+ */
+compress_status_t compress_decode(const char *topic, const uint8_t *data, size_t len,
+                                  char *text, size_t text_size, size_t *text_len);
+
+/**
+ * Imprime o resultado do decodificador por status e mede, em traces sintéticos
+ * (valor fixo, sensor de temperatura, joystick parado e contador), a taxa de
+ * compressão e os ns por leitura de cada modo, com lote de 1 e de 8 leituras, e as
+ * leituras perdidas a mais quando 1 em cada 17 mensagens some.
+ */
+void compress_benchmark(void);
+
+#endif // COMPRESS_H
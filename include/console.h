@@ -0,0 +1,12 @@
+#ifndef CONSOLE_H
+#define CONSOLE_H
+
+/**
+ * Lê um caractere do terminal serial (USB) sem bloquear e executa o comando correspondente.
+ * Os comandos (estatísticas, benchmarks, rotação de chaves, rastreamento...) ficam na
+ * tabela `commands` de src/console.c, a única lista mantida; '?' a imprime na serial.
+ * Deve ser chamada periodicamente pelo loop principal.
+ */
+void console_poll(void);
+
+#endif // CONSOLE_H
@@ -0,0 +1,11 @@
+#ifndef CRYPTO_BENCH_H
+#define CRYPTO_BENCH_H
+
+/**
+ * Compara AES-256-GCM e ChaCha20-Poly1305 (mbedTLS) na placa: imprime o µs do setkey
+ * e, com o contexto já com a chave (como nos slots do key_manager), µs por mensagem e
+ * ciclos/byte para cifrar e decifrar 16 B, 64 B, 256 B e 1 KB.
+ */
+void crypto_bench_aead(void);
+
+#endif // CRYPTO_BENCH_H
@@ -0,0 +1,43 @@
+#ifndef DISPATCH_H
+#define DISPATCH_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "include/frame.h"
+#include "include/mqtt_comm.h"
+
+/**
+ * Despachante do subscriber: escolhe o decodificador de cada mensagem pelo byte de
+ * tipo (FRAME_TYPE em include/frame.h), com uma consulta a uma tabela indexada pelo
+ * modo, independentemente do modo selecionado no menu.
+ * Os decodificadores são os próprios handlers dos modos fixos. Eles ficam "quentes":
+ * as chaves e os contextos GCM/ChaCha20-Poly1305 já estão expandidos nos slots do
+ * key_manager, então alternar o modo a cada mensagem não executa setkey.
+ */
+
+typedef struct {
+    frame_kind_t kind;
+    mqtt_message_handler_t decode; // Recebe a mensagem inteira, com o byte de tipo
+} dispatch_route_t;
+
+/**
+ * Monta a tabela de roteamento. Modos sem rota são recusados como cabeçalho inválido.
+ * @param routes  Rotas (a tabela é copiada)
+ * @param count   Número de rotas
+ */
+void dispatch_set_routes(const dispatch_route_t *routes, size_t count);
+
+/**
+ * Handler MQTT: roteia a mensagem para o decodificador do seu modo.
+ * Tipo desconhecido é contado no pré-filtro (PREFILTER_HEADER), sem log.
+ */
+void dispatch_message(const char *topic, const uint8_t *payload, size_t len);
+
+/**
+ * Imprime mensagens e µs médios por modo, os tipos desconhecidos e o custo do
+ * roteamento (ns/mensagem, medido com decodificadores vazios) comparado ao setkey
+ * que seria pago a cada troca de modo sem os contextos quentes.
+ */
+void dispatch_print_stats(void);
+
+#endif // DISPATCH_H
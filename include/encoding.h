@@ -0,0 +1,48 @@
+#ifndef ENCODING_H
+#define ENCODING_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * Hex (minúsculo, como o "%02x") e base64 (RFC 4648, com '=') por tabela, para as
+ * strings de display e de log. O hex usa uma tabela de pares: cada byte vira uma cópia
+ * de 2 caracteres, sem passar pelo parser de formato do sprintf. Onde o acesso
+ * desalinhado é permitido (RP2350 e PC; o M0+ do RP2040 não tem), o hex processa
+ * 4 bytes por vez e grava 8 caracteres de uma vez.
+ */
+
+#define HEX_ENCODED_LEN(len) (2 * (len) + 1)                // Com o '\0'
+#define BASE64_ENCODED_LEN(len) (4 * (((len) + 2) / 3) + 1) // Com o '\0'
+
+/**
+ * Codifica em hex. `out` deve comportar HEX_ENCODED_LEN(len) bytes.
+ * @return Caracteres escritos, sem o '\0' (2 * len)
+ */
+size_t hex_encode(const uint8_t *data, size_t len, char *out);
+
+/**
+ * Decodifica hex (maiúsculo ou minúsculo).
+ * @return Bytes escritos, ou -1 se o texto tem tamanho ímpar, caractere inválido ou não cabe em out_size
+ */
+int hex_decode(const char *text, size_t text_len, uint8_t *out, size_t out_size);
+
+/**
+ * Codifica em base64. `out` deve comportar BASE64_ENCODED_LEN(len) bytes.
+ * @return Caracteres escritos, sem o '\0'
+ */
+size_t base64_encode(const uint8_t *data, size_t len, char *out);
+
+/**
+ * Decodifica base64 com '=' no fim.
+ * @return Bytes escritos, ou -1 se o tamanho não é múltiplo de 4, há caractere inválido ou não cabe em out_size
+ */
+int base64_decode(const char *text, size_t text_len, uint8_t *out, size_t out_size);
+
+/**
+ * Mede ns por byte do laço de sprintf("%02x") e dos codificadores/decodificadores por
+ * tabela, com entradas de 16, 64, 256 e 1024 bytes.
+ */
+void encoding_benchmark(void);
+
+#endif // ENCODING_H
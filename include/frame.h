@@ -0,0 +1,120 @@
+#ifndef FRAME_H
+#define FRAME_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "include/nonce.h"
+#include "include/mac.h"
+
+/**
+ * Frame dos modos AEAD (AES-GCM e ChaCha20-Poly1305):
+ *   [tipo (1)] [remetente (4)] [boot (4)] [contador (4)] [hash do tópico (4)] [tag (16)] [ciphertext]
+ *   |------------------- cabeçalho em claro, autenticado como AAD ------------------|
+ * Os 12 bytes remetente/boot/contador são o próprio nonce (nonce.c), então o IV não
+ * ocupa espaço extra. O tipo é (FRAME_VERSION << 4) | frame_aead_t.
+ * Como o cabeçalho é legível sem a chave, o subscriber recusa frames de outro tipo,
+ * de outro tópico, de remetentes fora da lista ou com sequência repetida antes de
+ * gastar CPU com a decifragem; a tag garante depois que o cabeçalho não foi alterado.
+ */
+
+#define FRAME_VERSION 1
+#define FRAME_HEADER_LEN (1 + NONCE_LEN + 4)
+#define FRAME_TAG_LEN 16
+#define FRAME_OVERHEAD (FRAME_HEADER_LEN + FRAME_TAG_LEN)
+
+typedef enum {
+    FRAME_AEAD_AES_GCM = 1,
+    FRAME_AEAD_CHACHAPOLY = 2,
+} frame_aead_t;
+
+/**
+ * Toda mensagem publicada começa pelo byte de tipo FRAME_TYPE(frame_kind_t). Nos modos
+ * sem AEAD ele apenas antecede o payload do modo:
+ *   Normal: [tipo] [texto]   XOR: [tipo] [texto ^ chave]   MAC: [tipo] [frame do mac.c]
+ * Assim o subscriber escolhe o decodificador de cada mensagem pelo primeiro byte
+ * (dispatch.c), e os modos podem ser intercalados no mesmo tópico.
+ */
+typedef enum {
+    FRAME_KIND_AES_GCM = FRAME_AEAD_AES_GCM,
+    FRAME_KIND_CHACHAPOLY = FRAME_AEAD_CHACHAPOLY,
+    FRAME_KIND_PLAIN = 3,
+    FRAME_KIND_XOR = 4,
+    FRAME_KIND_MAC = 5,
+    FRAME_KIND_COUNT
+} frame_kind_t;
+
+#define FRAME_TYPE(kind) ((uint8_t)((FRAME_VERSION << 4) | (kind)))
+#define FRAME_TYPE_LEN 1
+#define FRAME_MAX_OVERHEAD (FRAME_TYPE_LEN + MAC_MAX_OVERHEAD) // Maior overhead entre os modos (MAC com nonce)
+
+typedef enum {
+    FRAME_OK = 0,
+    FRAME_ERR_SHORT,   // Menor que o cabeçalho + tag, ou maior que o buffer de saída
+    FRAME_ERR_TYPE,    // Versão ou AEAD diferente do esperado
+    FRAME_ERR_TOPIC,   // Hash do tópico não confere com o tópico em que chegou
+    FRAME_ERR_SENDER,  // Remetente fora de FRAME_ALLOWED_SENDERS (quando definida)
+    FRAME_ERR_REPLAY,  // Sequência não é maior que a última aceita do remetente
+    FRAME_ERR_AUTH,    // Tag inválida (decifragem executada)
+    FRAME_ERR_CRYPTO,  // Outro erro do mbedTLS ou nonce indisponível
+    FRAME_STATUS_COUNT
+} frame_status_t;
+
+/**
+ * Hash FNV-1a de 32 bits do nome do tópico.
+ */
+uint32_t frame_topic_hash(const char *topic);
+
+/**
+ * Monta a mensagem de qualquer modo, com o byte de tipo na frente, usando a sessão atual.
+ * @param out_size  Deve comportar FRAME_MAX_OVERHEAD + plain_len bytes
+ * @return 0 em sucesso, -1 sem espaço ou sem nonce, ou o erro do mbedTLS
+ */
+int frame_encode(frame_kind_t kind, const char *topic, const uint8_t *plain, size_t plain_len,
+                 uint8_t *out, size_t out_size, size_t *out_len);
+
+/**
+ * Nome curto do modo (ex.: "xor").
+ */
+const char *frame_kind_name(frame_kind_t kind);
+
+/**
+ * Cifra `plain` com a sessão de chaves atual e monta o frame.
+ * @param out_size  Deve comportar FRAME_OVERHEAD + plain_len bytes
+ * @param seq       Opcional: sequência usada no nonce
+ * @return 0 em sucesso, -1 sem espaço ou sem nonce, ou o erro do mbedTLS
+ */
+int frame_seal(frame_aead_t aead, const char *topic, const uint8_t *plain, size_t plain_len,
+               uint8_t *out, size_t out_size, size_t *out_len, nonce_seq_t *seq);
+
+/**
+ * Só a validação do cabeçalho em claro (tamanho, tipo, tópico, remetente e replay), sem chave.
+ * Usada pelo pré-filtro do subscriber (prefilter.c) para recusar frames antes de frame_open.
+ * @param plain_size  Tamanho do buffer de saída que será passado a frame_open
+ * @param seq         Sequência lida do cabeçalho (preenchida a partir de FRAME_ERR_SENDER)
+ * @return FRAME_OK ou o primeiro motivo de recusa
+ */
+frame_status_t frame_check_header(frame_aead_t aead, const char *topic, const uint8_t *frame, size_t len,
+                                  size_t plain_size, nonce_seq_t *seq);
+
+/**
+ * Valida o cabeçalho (tipo, tópico, remetente e replay) e só então decifra.
+ * A sequência só é registrada como vista depois que a tag confere.
+ * @param plain_size  Tamanho do buffer de saída (o texto tem len - FRAME_OVERHEAD bytes)
+ * @param seq         Sequência lida do cabeçalho (preenchida a partir de FRAME_ERR_SENDER)
+ */
+frame_status_t frame_open(frame_aead_t aead, const char *topic, const uint8_t *frame, size_t len,
+                          uint8_t *plain, size_t plain_size, size_t *plain_len, nonce_seq_t *seq);
+
+/**
+ * Texto curto do status (ex.: "replay").
+ */
+const char *frame_status_name(frame_status_t status);
+
+/**
+ * Imprime contagem e µs médios de frame_open por resultado, e a CPU poupada por
+ * frame recusado no cabeçalho em relação a uma decifragem com tag inválida.
+ */
+void frame_print_stats(void);
+
+#endif // FRAME_H
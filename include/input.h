@@ -0,0 +1,70 @@
+#ifndef INPUT_H
+#define INPUT_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/**
+ * Fila de eventos de entrada entre as interrupções e o laço principal. Os produtores
+ * (IRQ do ADC do joystick, alarmes de debounce dos botões) gravam o evento e só depois
+ * avançam a cabeça; o laço principal lê e avança a cauda. Cada índice tem um único
+ * escritor, então não há trava nem interrupções desabilitadas. Os produtores devem ter
+ * a mesma prioridade de IRQ (a padrão do SDK), para que um não interrompa o outro no
+ * meio de um push. Com a fila cheia, o evento novo é descartado e contado.
+ * Cada consumidor retira só os eventos que lhe interessam (input_pop com máscaras); os
+ * outros ficam na fila na ordem de chegada. Um evento que chega à cauda sem ninguém
+ * pedir por INPUT_EVENT_MAX_AGE_MS expira, para não ocupar a fila.
+ */
+
+typedef enum {
+    INPUT_NAV_UP = 0,
+    INPUT_NAV_DOWN,
+    INPUT_NAV_LEFT,
+    INPUT_NAV_RIGHT,
+    INPUT_BTN_PRESS,   // Nível pressionado estável depois do debounce
+    INPUT_BTN_RELEASE,
+    INPUT_BTN_LONG,    // Ainda pressionado BTN_LONG_PRESS_MS depois do press
+    INPUT_BTN_DOUBLE,  // Segundo press até BTN_DOUBLE_PRESS_MS depois do primeiro (vem logo após o press)
+    INPUT_EVENT_TYPE_COUNT
+} input_event_type_t;
+
+typedef enum {
+    INPUT_SOURCE_JOYSTICK = 0, // Eixos X e Y
+    INPUT_SOURCE_BTN_A,
+    INPUT_SOURCE_BTN_B,
+    INPUT_SOURCE_BTN_JOYSTICK,
+    INPUT_SOURCE_COUNT
+} input_source_t;
+
+#define INPUT_MASK(value) (1u << (value)) // Bit de um tipo ou de uma origem nas máscaras de input_pop
+#define INPUT_MASK_ALL 0xFFFFFFFFu
+#define INPUT_MASK_NAV (INPUT_MASK(INPUT_NAV_UP) | INPUT_MASK(INPUT_NAV_DOWN) | \
+                        INPUT_MASK(INPUT_NAV_LEFT) | INPUT_MASK(INPUT_NAV_RIGHT))
+
+typedef struct {
+    uint8_t type;     // input_event_type_t
+    uint8_t source;   // input_source_t
+    bool repeat;      // Repetição por segurar o joystick (false no primeiro evento e nos botões)
+    uint32_t time_ms; // Instante do evento, desde o boot (nos botões, a primeira borda)
+} input_event_t;
+
+/**
+ * Enfileira um evento. Chamada pelas IRQs dos produtores.
+ * @return false se a fila está cheia (evento descartado)
+ */
+bool input_push(input_event_type_t type, input_source_t source, bool repeat, uint32_t time_ms);
+
+/**
+ * Retira o evento mais antigo cujo tipo está em `type_mask` e cuja origem está em
+ * `source_mask` (INPUT_MASK). Chamada só pelo laço principal.
+ * @return false se nenhum evento da fila combina
+ */
+bool input_pop(uint32_t type_mask, uint32_t source_mask, input_event_t *event);
+
+/**
+ * Imprime os eventos enfileirados por tipo, os descartados, os expirados e o pico de
+ * ocupação da fila.
+ */
+void input_print_stats(void);
+
+#endif // INPUT_H
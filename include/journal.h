@@ -0,0 +1,86 @@
+#ifndef JOURNAL_H
+#define JOURNAL_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * Journal de store-and-forward na flash: as mensagens que não puderam ser publicadas
+ * (Wi-Fi ou broker fora) são gravadas prontas, já com o modo de segurança aplicado, e
+ * reenviadas na ordem quando a conexão volta, a no máximo JOURNAL_DRAIN_RATE_PER_S.
+ * Layout: JOURNAL_FLASH_SECTORS setores usados como anel (logo abaixo dos setores do
+ * nonce), cada um com [cabeçalho: magic, sequência] seguido de registros
+ *   [tamanho (2)] [tamanho do tópico (1)] [QoS (1)] [CRC-32 (4)] [enviado (4)] [tópico] [payload]
+ * alinhados em 4 bytes. Os registros só são acrescentados; o setor só é apagado quando
+ * o anel dá a volta, o que distribui o desgaste entre todos os setores. Se o anel encher,
+ * o setor mais antigo é descartado.
+ * As gravações passam por um buffer de uma página em RAM: a página só é programada
+ * quando enche, antes de um reenvio ou JOURNAL_FLUSH_MS depois do primeiro registro
+ * pendente (uma queda de energia nesse intervalo perde só o que está no buffer).
+ * Um registro reenviado tem a palavra "enviado" zerada, sem apagar o setor; no boot,
+ * journal_init() encontra o setor mais novo pela sequência e o primeiro registro não
+ * enviado. Registros com CRC inválido (gravação interrompida) são ignorados.
+ * Cada programação ou apagamento desabilita as interrupções (~1 ms por página, ~45 ms
+ * por setor), como o contador de boots do nonce.
+ */
+
+#if !PICO_ON_DEVICE
+/**
+ * Host: usa o arquivo `path` como a região do journal na flash (criado apagado se não
+ * existir), mapeado em memória. Sem esta chamada a região fica só em RAM.
+ * @return 0 em sucesso, -1 se o arquivo não pôde ser aberto ou mapeado
+ */
+int journal_flash_open(const char *path);
+#endif
+
+/**
+ * Reconstrói as posições de escrita e de reenvio a partir da flash.
+ * Deve ser chamada uma vez no boot, antes de journal_publish().
+ */
+void journal_init(void);
+
+/**
+ * Publica pelo mqtt_comm ou, se não houver conexão, a fila de saída estiver cheia ou
+ * ainda houver registros pendentes (para manter a ordem), grava no journal.
+ * @return 0 se a mensagem foi publicada ou gravada, -1 se não cabe em um registro
+ */
+int journal_publish(const char *topic, const uint8_t *data, size_t len, uint8_t qos);
+
+/**
+ * Grava uma mensagem no journal (no buffer de página; ver journal_flush).
+ * @return 0 em sucesso, -1 se tópico ou payload não cabem em um registro
+ */
+int journal_append(const char *topic, const uint8_t *data, size_t len, uint8_t qos);
+
+/**
+ * Programa na flash a página parcial que está no buffer de RAM.
+ */
+void journal_flush(void);
+
+/**
+ * Chamada no loop principal: programa o buffer vencido e, com o broker conectado,
+ * reenvia os registros pendentes na ordem, limitado a JOURNAL_DRAIN_RATE_PER_S.
+ * @param now_ms  Tempo atual (to_ms_since_boot)
+ */
+void journal_poll(uint32_t now_ms);
+
+/**
+ * Registros gravados e ainda não reenviados.
+ */
+uint32_t journal_pending(void);
+
+/**
+ * Imprime pendentes, descartes, páginas programadas, setores apagados e a vazão
+ * medida da gravação e do reenvio desde o boot.
+ */
+void journal_print_stats(void);
+
+/**
+ * Mede a vazão da gravação (com o buffer de página) e do reenvio (para um destino
+ * que só conta) com 256 registros do tamanho de um frame AES-GCM.
+ * Usa a própria região do journal: só roda com o journal vazio.
+ */
+void journal_benchmark(void);
+
+#endif // JOURNAL_H
@@ -1,19 +1,32 @@
 #ifndef JOYSTICK_H
 #define JOYSTICK_H
 
-#include "pico/stdlib.h"
-#include "hardware/adc.h"
+/**
+ * Joystick pelos eventos de entrada (include/input.h). A cada rodada do ADC
+ * (include/adc_scan.h), ainda na IRQ, cada eixo passa por uma média móvel exponencial e
+ * por uma histerese: o eixo entra em "alto" acima de JOYSTICK_MOVE_HIGH_THRESHOLD e só
+ * volta ao neutro dentro da zona morta, então o ruído perto de um limiar não gera
+ * eventos repetidos. Ao entrar em uma direção sai um evento; segurando, sai um repetido
+ * depois de JOYSTICK_REPEAT_DELAY_MS e outro a cada JOYSTICK_REPEAT_INTERVAL_MS.
+ */
 
 /**
- * @brief Initializes the ADC for joystick input.
+ * Liga a varredura do ADC (adc_scan_init) e registra o processamento dos eixos.
  */
 void joystick_init(void);
 
 /**
- * @brief Processes joystick input for menu navigation.
- * @param item_count Total number of items in the current menu.
- * @param selected_idx_ptr Pointer to the currently selected item index (will be modified).
+ * Consome os eventos da fila e move a seleção do menu (cima/baixo, com volta nas pontas).
+ * Eventos mais velhos que INPUT_EVENT_MAX_AGE_MS são descartados. Não bloqueia.
+ * @param item_count Total de itens do menu.
+ * @param selected_idx_ptr Índice do item selecionado (modificado).
  */
 void joystick_handle_menu_navigation(int item_count, int *selected_idx_ptr);
 
+/**
+ * Imprime as estatísticas do ADC, a leitura filtrada e o estado de cada eixo e os
+ * contadores da fila de eventos.
+ */
+void joystick_print_stats(void);
+
 #endif // JOYSTICK_H
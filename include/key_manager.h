@@ -0,0 +1,97 @@
+#ifndef KEY_MANAGER_H
+#define KEY_MANAGER_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "mbedtls/gcm.h"
+#include "mbedtls/chachapoly.h"
+
+/**
+ * Hierarquia de chaves dos modos de segurança.
+ *   PRK          = HKDF-Extract(KEY_HKDF_SALT, KEY_MASTER_SECRET)   (calculado uma vez)
+ *   chave(label) = HKDF-Expand(PRK, label || session_id, 32)
+ * com labels "xor", "hmac", "siphash", "aes", "chacha" e "control" (esta fixa, não depende da sessão).
+ *
+ * Dois slots em buffer duplo: a sessão atual e a anterior, esta mantida para as
+ * mensagens ainda em trânsito durante a troca. Os contextos GCM e ChaCha20-Poly1305
+ * de cada slot ficam com a chave já expandida, então o caminho de publicação não
+ * executa setkey.
+ *
+ * A rotação é anunciada no tópico MQTT_TOPIC_KEYS (mensagem retida), sem desconectar:
+ *   [session_id (4, big-endian)] [HMAC-SHA256(chave de controle, "rot" || session_id) (32)]
+ * Só é aceita uma sessão maior que a atual. O handler do tópico roda no contexto do
+ * lwIP e apenas agenda a rotação; a derivação é feita por key_manager_poll() no loop principal.
+ */
+
+#define KEY_LEN 32
+#define KEY_CONTROL_MSG_LEN (4 + 32)
+
+typedef struct {
+    volatile bool valid; // Falso enquanto o slot está sendo rederivado
+    uint32_t session_id;
+    uint8_t xor_key;
+    uint8_t hmac_key[KEY_LEN];
+    uint8_t siphash_key[16];
+    mbedtls_gcm_context gcm;               // AES-256-GCM com a chave da sessão
+    mbedtls_chachapoly_context chachapoly; // ChaCha20-Poly1305 com a chave da sessão
+} key_slot_t;
+
+/**
+ * HKDF-SHA256 (RFC 5869) sobre o backend de SHA-256.
+ * @param salt     Salt do Extract (pode ser NULL)
+ * @param ikm      Material de entrada
+ * @param info     Contexto do Expand
+ * @param okm      Saída de okm_len bytes (no máximo 255 * 32)
+ * @return 0 em sucesso, código de erro caso contrário
+ */
+int hkdf_sha256(const uint8_t *salt, size_t salt_len, const uint8_t *ikm, size_t ikm_len,
+                const uint8_t *info, size_t info_len, uint8_t *okm, size_t okm_len);
+
+/**
+ * Deriva a sessão inicial (0). Chamar na inicialização, antes de usar os modos.
+ * @return true em sucesso
+ */
+bool key_manager_init(void);
+
+/**
+ * Slot da sessão atual.
+ */
+key_slot_t *key_manager_current(void);
+
+/**
+ * Slot da sessão anterior, ou NULL se não houver (ou se estiver sendo rederivado).
+ */
+key_slot_t *key_manager_previous(void);
+
+/**
+ * Deriva a sessão no slot livre e a torna atual. A anterior passa a ser a "previous".
+ * @param session_id  Nova sessão; deve ser maior que a atual
+ * @return 0 em sucesso, -1 se a sessão não for maior que a atual, ou o erro da derivação
+ */
+int key_manager_rotate(uint32_t session_id);
+
+/**
+ * Publica o anúncio da próxima sessão em MQTT_TOPIC_KEYS (retido, QoS 1) e, só se o
+ * lwIP o aceitou, aplica a sessão localmente. Se a publicação falhar, nada muda.
+ * Qualquer placa com o segredo mestre pode iniciar a rotação.
+ */
+void key_manager_announce_next(void);
+
+/**
+ * Aplica rotações recebidas pelo tópico de controle e, se `schedule` for verdadeiro,
+ * anuncia uma nova sessão a cada KEY_ROTATION_INTERVAL_MS. Chamar no loop principal.
+ */
+void key_manager_poll(bool schedule);
+
+/**
+ * Handler do tópico MQTT_TOPIC_KEYS (registrar com mqtt_comm_subscribe_with_handler).
+ */
+void key_manager_control_handler(const char *topic, const uint8_t *payload, size_t len);
+
+/**
+ * Imprime a sessão atual, número de rotações, anúncios recusados e o tempo da última rotação.
+ */
+void key_manager_print_stats(void);
+
+#endif // KEY_MANAGER_H
@@ -0,0 +1,53 @@
+#ifndef LATENCY_H
+#define LATENCY_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "include/frame.h"
+
+/**
+ * Latência de ponta a ponta das mensagens aceitas pelo subscriber: do timestamp que o
+ * publisher grava na mensagem até a decodificação, com o relógio local convertido para
+ * o do publisher (include/clock_sync.h). Antes da primeira sincronização nada é medido.
+ * Cada modo tem um histograma log-linear no estilo HDR: valores abaixo de
+ * 2^LATENCY_SUB_BITS µs têm balde próprio, e cada potência de 2 acima disso é dividida
+ * em 2^(LATENCY_SUB_BITS - 1) baldes, o que limita o erro relativo dos percentis a
+ * 2^-(LATENCY_SUB_BITS - 1). Registrar custa um CLZ e um incremento, sem ordenação.
+ * Latências negativas (erro do offset maior que a latência) são contadas à parte e
+ * entram no primeiro balde.
+ */
+
+/**
+ * Registra uma mensagem aceita. Chamada pelos decodificadores (contexto do lwIP).
+ * @param kind     Modo da mensagem
+ * @param sent_us  Timestamp da mensagem (µs desde o boot do publisher)
+ */
+void latency_record(frame_kind_t kind, uint64_t sent_us);
+
+/**
+ * Percentil de todos os modos somados.
+ * @param permille  Percentil em milésimos (500 = p50, 990 = p99)
+ * @return Limite superior do balde, em µs (0 sem amostras)
+ */
+uint32_t latency_percentile_all(uint32_t permille);
+
+/**
+ * Resumo curto para o rodapé do OLED ("p50 1.2 p99 9.8ms").
+ * @return Tamanho do texto (0 sem amostras)
+ */
+size_t latency_format_summary(char *out, size_t size);
+
+/**
+ * Publica os percentis de cada modo em MQTT_TOPIC_STATUS/<client_id>/latencia a cada
+ * LATENCY_PUBLISH_INTERVAL_MS, se houver amostras novas.
+ * @param client_id  Sufixo do tópico de status
+ */
+void latency_poll(const char *client_id);
+
+/**
+ * Imprime o estado da sincronização e, por modo, mensagens, negativas, p50, p90, p99,
+ * p99.9 e máximo.
+ */
+void latency_print_stats(void);
+
+#endif // LATENCY_H
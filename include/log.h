@@ -0,0 +1,94 @@
+#ifndef LOG_H
+#define LOG_H
+
+#include <stdint.h>
+#include <stdio.h>
+
+/**
+ * Log diferido para os caminhos de publicação/recepção.
+ * LOG_ERROR/LOG_WARN/LOG_INFO/LOG_DEBUG gravam apenas o ponteiro da string de
+ * formato (que serve de ID) e os argumentos brutos em um buffer circular; a
+ * formatação e a escrita no USB acontecem depois, em log_flush(), chamada
+ * quando o loop principal está ocioso.
+ *
+ * LOG_LEVEL (compilação) remove por completo as chamadas abaixo do nível.
+ * LOG_DEFERRED=0 faz as macros chamarem printf diretamente (para comparação).
+ *
+ * Conversões suportadas: d i u x X c p s f, com modificadores hh h l ll z.
+ * Strings (%s) são copiadas para a entrada e truncadas: todas as de uma entrada dividem
+ * LOG_STR_LEN bytes, e as que não couberem são impressas vazias.
+ */
+
+#define LOG_LEVEL_NONE 0
+#define LOG_LEVEL_ERROR 1
+#define LOG_LEVEL_WARN 2
+#define LOG_LEVEL_INFO 3
+#define LOG_LEVEL_DEBUG 4
+
+#ifndef LOG_LEVEL
+#define LOG_LEVEL LOG_LEVEL_INFO
+#endif
+
+#ifndef LOG_DEFERRED
+#define LOG_DEFERRED 1
+#endif
+
+#if LOG_DEFERRED
+#define LOG_WRITE(level, ...) log_record((level), __VA_ARGS__)
+#else
+#define LOG_WRITE(level, ...) printf(__VA_ARGS__)
+#endif
+
+// Chamadas abaixo do nível: nenhum código é gerado, mas os argumentos continuam "usados"
+#define LOG_DISCARD(level, ...)            \
+    do                                     \
+    {                                      \
+        if (0)                             \
+            LOG_WRITE(level, __VA_ARGS__); \
+    } while (0)
+
+#if LOG_LEVEL >= LOG_LEVEL_ERROR
+#define LOG_ERROR(...) LOG_WRITE(LOG_LEVEL_ERROR, __VA_ARGS__)
+#else
+#define LOG_ERROR(...) LOG_DISCARD(LOG_LEVEL_ERROR, __VA_ARGS__)
+#endif
+
+#if LOG_LEVEL >= LOG_LEVEL_WARN
+#define LOG_WARN(...) LOG_WRITE(LOG_LEVEL_WARN, __VA_ARGS__)
+#else
+#define LOG_WARN(...) LOG_DISCARD(LOG_LEVEL_WARN, __VA_ARGS__)
+#endif
+
+#if LOG_LEVEL >= LOG_LEVEL_INFO
+#define LOG_INFO(...) LOG_WRITE(LOG_LEVEL_INFO, __VA_ARGS__)
+#else
+#define LOG_INFO(...) LOG_DISCARD(LOG_LEVEL_INFO, __VA_ARGS__)
+#endif
+
+#if LOG_LEVEL >= LOG_LEVEL_DEBUG
+#define LOG_DEBUG(...) LOG_WRITE(LOG_LEVEL_DEBUG, __VA_ARGS__)
+#else
+#define LOG_DEBUG(...) LOG_DISCARD(LOG_LEVEL_DEBUG, __VA_ARGS__)
+#endif
+
+/**
+ * Grava uma entrada no buffer circular sem formatar.
+ * Pode ser chamada do loop principal e dos callbacks do lwIP.
+ * Se o buffer estiver cheio, a entrada é descartada e contabilizada.
+ * @param level  Nível da mensagem (LOG_LEVEL_*)
+ * @param fmt    String de formato estilo printf; deve ser literal (persistente)
+ */
+void log_record(uint8_t level, const char *fmt, ...) __attribute__((format(printf, 2, 3)));
+
+/**
+ * Formata e imprime as entradas pendentes. Chamar quando o loop principal estiver ocioso.
+ */
+void log_flush(void);
+
+/**
+ * Imprime quantas entradas foram gravadas/descartadas e o tempo médio gasto
+ * gravando (caminho crítico) e formatando (caminho ocioso) cada uma.
+ */
+void log_print_stats(void);
+
+#endif // LOG_H
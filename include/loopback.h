@@ -0,0 +1,73 @@
+#ifndef LOOPBACK_H
+#define LOOPBACK_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "include/app.h"
+#include "include/frame.h"
+
+/**
+ * Publisher e subscriber na mesma placa, para medir o caminho completo de um modo de
+ * segurança sem uma segunda placa. Cada rodada manda LOOPBACK_MESSAGES mensagens de um
+ * modo, uma por vez: monta "valor,timestamp", aplica o modo (frame_encode), entrega e
+ * decodifica (decifra ou confere a tag e lê o timestamp). O tempo de ida e volta vai do
+ * timestamp da mensagem até a decodificação. Entrega:
+ *   LOOPBACK_INTERNAL  chamada direta ao decodificador, sem rede (custo só do modo)
+ *   LOOPBACK_BROKER    publica em MQTT_TOPIC_LOOPBACK e espera a própria mensagem
+ *                      voltar do broker (Wi-Fi + lwIP + broker + modo)
+ * O decodificador é o do modo, sem o pré-filtro do subscriber: o balde de tokens
+ * (PREFILTER_RATE_PER_S) limitaria a taxa medida.
+ */
+
+typedef enum {
+    LOOPBACK_INTERNAL,
+    LOOPBACK_BROKER,
+} loopback_transport_t;
+
+typedef struct {
+    uint32_t sent;
+    uint32_t received;   // Voltaram e decodificaram com o timestamp esperado
+    uint32_t failed;     // Falha ao montar ou ao decodificar
+    uint32_t timeouts;   // Não voltaram em LOOPBACK_TIMEOUT_MS
+    uint32_t p50_us;
+    uint32_t p90_us;
+    uint32_t p99_us;
+    uint32_t max_us;
+    uint32_t msgs_per_s; // Recebidas / duração da rodada (uma mensagem em voo por vez)
+} loopback_result_t;
+
+/**
+ * Roda uma rodada de um modo. No modo broker, para depois de LOOPBACK_MAX_TIMEOUTS
+ * perdas seguidas (broker fora), para não bloquear o laço por muito tempo.
+ * @param kind       Modo de segurança
+ * @param transport  Entrega interna ou pelo broker
+ * @param result     Recebe as contagens e os percentis
+ */
+void loopback_run(frame_kind_t kind, loopback_transport_t transport, loopback_result_t *result);
+
+/**
+ * Imprime a última rodada de cada modo e entrega (chamada ao fim de cada volta pelos modos).
+ */
+void loopback_print_results(void);
+
+// Plugins do firmware de loopback (include/app.h): entrega interna e pelo broker
+extern const app_mode_t loopback_modes[];
+extern const size_t loopback_mode_count;
+
+/**
+ * Reserva um boot para os nonces AEAD (gancho boot do app_role_t).
+ */
+void loopback_boot(void);
+
+/**
+ * Assina MQTT_TOPIC_LOOPBACK e os anúncios de rotação (gancho connected do app_role_t).
+ */
+void loopback_connected(void);
+
+/**
+ * Deriva as chaves anunciadas no tópico de controle (gancho poll do app_role_t).
+ */
+void loopback_poll(bool in_mode);
+
+#endif // LOOPBACK_H
@@ -19,25 +19,54 @@
 #define MEM_LIBC_MALLOC             0
 #endif
 #define MEM_ALIGNMENT               4
-#define MEM_SIZE                    4000
-#define MEMP_NUM_TCP_SEG            32
 #define MEMP_NUM_ARP_QUEUE          10
-#define PBUF_POOL_SIZE              24
 #define LWIP_ARP                    1
 #define LWIP_ETHERNET               1
 #define LWIP_ICMP                   1
 #define LWIP_RAW                    1
-#define TCP_WND                     (8 * TCP_MSS)
 #define TCP_MSS                     1460
+#if LWIPOPTS_PROFILE_TELEMETRY
+// Perfil de telemetria: uma única conexão TCP (MQTT) com publicações pequenas e
+// frequentes. Os valores vêm do replay de tests/lwip_replay.c (tráfego real dos plugins
+// sobre as regras de alocação do lwIP 2.1; ctest -R lwip_), cujos picos foram:
+//   heap: 1480 B fixos (cliente MQTT com o anel de 1 KB e o DHCP); 4436 B com perdas de
+//     3%; 5976 B no pior cenário, o journal reenviando depois de 20 s sem broker com um
+//     RTO no meio. Com TCP_SND_BUF de 2 MSS a fila do TCP tem no máximo três pbufs de um
+//     MSS (~1540 B cada, pelo TCP_OVERSIZE): ~6.2 KB no limite, e MEM_SIZE 8000 deixa ~20%
+//     para fragmentação, ACKs, ARP e DHCP. Com 4 MSS e 6000 B o reenvio esgotava o heap.
+//   tcp_seg: 2 com perdas, 6 no reenvio; o limite é TCP_SND_QUEUELEN (8) no envio mais
+//     TCP_OOSEQ_MAX_PBUFS (8) fora de ordem, o que cabe em 16.
+//   PBUF_POOL: 1 quadro por vez sem perdas, 3 com 3% e 7 no reenvio; TCP_OOSEQ_MAX_PBUFS
+//     deixa 4 livres para o quadro em processamento, ARP e broadcast.
+// Na placa, os high-water marks reais saem com LWIP_POOL_STATS (net_stats).
+#define MEM_SIZE                    8000
+#define MEMP_NUM_TCP_SEG            16
+#define PBUF_POOL_SIZE              12
+#define TCP_WND                     (4 * TCP_MSS)
+#define TCP_SND_BUF                 (2 * TCP_MSS)
+#define TCP_OOSEQ_MAX_PBUFS         8
+#define MQTT_OUTPUT_RINGBUF_SIZE    1024
+#else
+#define MEM_SIZE                    4000
+#define MEMP_NUM_TCP_SEG            32
+#define PBUF_POOL_SIZE              24
+#define TCP_WND                     (8 * TCP_MSS)
 #define TCP_SND_BUF                 (8 * TCP_MSS)
+#endif
 #define TCP_SND_QUEUELEN            ((4 * (TCP_SND_BUF) + (TCP_MSS - 1)) / (TCP_MSS))
 #define LWIP_NETIF_STATUS_CALLBACK  1
 #define LWIP_NETIF_LINK_CALLBACK    1
 #define LWIP_NETIF_HOSTNAME         1
 #define LWIP_NETCONN                0
+#if LWIP_POOL_STATS
+// High-water marks e falhas de alocação do heap e de cada pool (ver net_stats.h)
+#define MEM_STATS                   1
+#define MEMP_STATS                  1
+#else
 #define MEM_STATS                   0
-#define SYS_STATS                   0
 #define MEMP_STATS                  0
+#endif
+#define SYS_STATS                   0
 #define LINK_STATS                  0
 // #define ETH_PAD_SIZE                2
 #define LWIP_CHKSUM_ALGORITHM       3
@@ -51,6 +80,14 @@
 #define DHCP_DOES_ARP_CHECK         0
 #define LWIP_DHCP_DOES_ACD_CHECK    0
 
+// MQTT sobre TLS: o cliente MQTT do lwIP usa altcp_tls quando tls_config é informado
+#if MQTT_USE_TLS
+#define LWIP_ALTCP                  1
+#define LWIP_ALTCP_TLS              1
+#define LWIP_ALTCP_TLS_MBEDTLS      1
+#define ALTCP_MBEDTLS_AUTHMODE      MBEDTLS_SSL_VERIFY_REQUIRED
+#endif
+
 #ifndef NDEBUG
 #define LWIP_DEBUG                  1
 #define LWIP_STATS                  1
@@ -0,0 +1,82 @@
+#ifndef MAC_H
+#define MAC_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * Autenticadores de mensagem do modo de autenticação, escolhidos por tópico.
+ * Formato do frame:
+ *   HMAC-SHA256, SipHash: [tag (tag_len)] [mensagem]
+ *   Poly1305:             [nonce (12)] [tag (tag_len)] [mensagem]
+ * O Poly1305 exige chave única por mensagem: a chave de uso único vem do ChaCha20
+ * com o nonce do nonce.c (ChaCha20-Poly1305 com a mensagem como AAD e texto vazio),
+ * por isso o nonce vai junto no frame.
+ * As tags podem ser truncadas (mínimo MAC_MIN_TAG_LEN bytes). As chaves são as da
+ * sessão atual do key_manager; na verificação a sessão anterior também é tentada.
+ */
+
+#define MAC_MIN_TAG_LEN 8
+#define MAC_MAX_TAG_LEN 32
+#define MAC_NONCE_LEN 12
+#define MAC_MAX_OVERHEAD (MAC_NONCE_LEN + MAC_MAX_TAG_LEN)
+
+typedef enum {
+    MAC_HMAC_SHA256, // Tag nativa de 32 bytes, 4 compressões SHA-256 para mensagens curtas
+    MAC_SIPHASH,     // SipHash-2-4 (tag de 8 bytes) ou SipHash-2-4-128 (tag > 8 bytes)
+    MAC_POLY1305,    // Poly1305 com chave de uso único do ChaCha20, tag nativa de 16 bytes
+} mac_alg_t;
+
+typedef struct {
+    const char *topic; // NULL na entrada padrão
+    mac_alg_t alg;
+    uint8_t tag_len;
+} mac_config_t;
+
+/**
+ * Configuração de MAC do tópico (tabela em src/mac.c); tópicos fora da tabela usam a entrada padrão.
+ */
+const mac_config_t *mac_config_for_topic(const char *topic);
+
+/**
+ * Nome legível do algoritmo (ex.: "HMAC-SHA256").
+ */
+const char *mac_alg_name(mac_alg_t alg);
+
+/**
+ * Bytes acrescentados à mensagem no frame (nonce + tag).
+ */
+size_t mac_overhead(const mac_config_t *config);
+
+/**
+ * Monta o frame autenticado com a sessão de chaves atual.
+ * @param frame       Destino, com pelo menos mac_overhead(config) + msg_len bytes
+ * @param frame_size  Tamanho do destino
+ * @param frame_len   Tamanho do frame gerado
+ * @return 0 em sucesso, -1 se o destino for pequeno ou faltar nonce, ou o erro do mbedTLS
+ */
+int mac_protect(const mac_config_t *config, const uint8_t *msg, size_t msg_len,
+                uint8_t *frame, size_t frame_size, size_t *frame_len);
+
+/**
+ * Verifica o frame (sessão atual e, durante uma rotação, a anterior).
+ * @param msg      Aponta para a mensagem dentro do frame
+ * @param msg_len  Tamanho da mensagem
+ * @return true se a tag confere
+ */
+bool mac_verify(const mac_config_t *config, const uint8_t *frame, size_t frame_len,
+                const uint8_t **msg, size_t *msg_len);
+
+/**
+ * SipHash-2-4 (out_len 8) ou SipHash-2-4-128 (out_len 16).
+ */
+void siphash(const uint8_t key[16], const uint8_t *msg, size_t len, uint8_t *out, size_t out_len);
+
+/**
+ * Tabela de bytes no ar e µs por mensagem (autenticar e verificar) de cada
+ * combinação de algoritmo e tamanho de tag, para uma leitura típica do sensor.
+ */
+void mac_benchmark(void);
+
+#endif // MAC_H
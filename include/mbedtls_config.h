@@ -1,12 +1,68 @@
 /* Workaround for some mbedtls source files using INT_MAX without including limits.h */
 #include <limits.h>
 
+/*
+ * Perfis de configuração (selecionados no CMake com -DMBEDTLS_PROFILE=...):
+ *   default  - configuração original, com a suíte TLS completa
+ *   minimal  - apenas o necessário para os modos do firmware (SHA-256/HMAC, AES-256-GCM e
+ *              ChaCha20-Poly1305)
+ *              e, com MQTT_USE_TLS, somente ECDHE-ECDSA sobre P-256
+ *   fast     - igual ao default, mas com tabelas AES completas, SHA-256 desenrolado
+ *              e tabela GHASH de 8 bits (mais flash/RAM, menos ciclos por mensagem)
+ */
+
 #define MBEDTLS_NO_PLATFORM_ENTROPY
 #define MBEDTLS_ENTROPY_HARDWARE_ALT
 
+#define MBEDTLS_ALLOW_PRIVATE_ACCESS
+
+#if defined(MBEDTLS_PROFILE_MINIMAL)
+
+/* Primitivas usadas pelos modos HMAC, AES-GCM e ChaCha20-Poly1305 */
+#define MBEDTLS_AES_C
+#define MBEDTLS_CIPHER_C
+#define MBEDTLS_GCM_C
+#define MBEDTLS_CHACHA20_C
+#define MBEDTLS_POLY1305_C
+#define MBEDTLS_CHACHAPOLY_C
+#define MBEDTLS_MD_C
+#define MBEDTLS_SHA256_C
+#define MBEDTLS_ERROR_C
+#define MBEDTLS_SHA256_SMALLER
+#define MBEDTLS_AES_FEWER_TABLES
+#define MBEDTLS_AES_ROM_TABLES
+
+#if MQTT_USE_TLS
+/* TLS 1.2 cliente, ECDHE-ECDSA-AES-GCM sobre P-256 */
+#define MBEDTLS_SSL_OUT_CONTENT_LEN    2048
+#define MBEDTLS_HAVE_TIME
+#define MBEDTLS_SSL_PROTO_TLS1_2
+#define MBEDTLS_SSL_CLI_C
+#define MBEDTLS_SSL_TLS_C
+#define MBEDTLS_SSL_SERVER_NAME_INDICATION
+#define MBEDTLS_SSL_SESSION_TICKETS
+#define MBEDTLS_KEY_EXCHANGE_ECDHE_ECDSA_ENABLED
+#define MBEDTLS_ECP_DP_SECP256R1_ENABLED
+#define MBEDTLS_ECP_C
+#define MBEDTLS_ECDH_C
+#define MBEDTLS_ECDSA_C
+#define MBEDTLS_BIGNUM_C
+#define MBEDTLS_ASN1_PARSE_C
+#define MBEDTLS_ASN1_WRITE_C
+#define MBEDTLS_OID_C
+#define MBEDTLS_PK_C
+#define MBEDTLS_PK_PARSE_C
+#define MBEDTLS_X509_USE_C
+#define MBEDTLS_X509_CRT_PARSE_C
+#define MBEDTLS_CTR_DRBG_C
+#define MBEDTLS_ENTROPY_C
+#define MBEDTLS_PLATFORM_C
+#endif
+
+#else /* default e fast */
+
 #define MBEDTLS_SSL_OUT_CONTENT_LEN    2048
 
-#define MBEDTLS_ALLOW_PRIVATE_ACCESS
 #define MBEDTLS_HAVE_TIME
 
 #define MBEDTLS_CIPHER_MODE_CBC
@@ -24,7 +80,6 @@
 #define MBEDTLS_ECP_DP_CURVE25519_ENABLED
 #define MBEDTLS_KEY_EXCHANGE_RSA_ENABLED
 #define MBEDTLS_PKCS1_V15
-#define MBEDTLS_SHA256_SMALLER
 #define MBEDTLS_SSL_SERVER_NAME_INDICATION
 #define MBEDTLS_AES_C
 #define MBEDTLS_ASN1_PARSE_C
@@ -50,7 +105,14 @@
 #define MBEDTLS_SSL_TLS_C
 #define MBEDTLS_X509_CRT_PARSE_C
 #define MBEDTLS_X509_USE_C
+
+#if defined(MBEDTLS_PROFILE_FAST)
+/* Tabelas AES completas em RAM (a leitura da flash via XIP é lenta) e GHASH com tabela de 8 bits */
+#define MBEDTLS_GCM_LARGE_TABLE
+#else
+#define MBEDTLS_SHA256_SMALLER
 #define MBEDTLS_AES_FEWER_TABLES
+#endif
 
 /* TLS 1.2 */
 #define MBEDTLS_SSL_PROTO_TLS1_2
@@ -60,3 +122,13 @@
 #define MBEDTLS_ECP_C
 #define MBEDTLS_ECDSA_C
 #define MBEDTLS_ASN1_WRITE_C
+
+/* Retomada de sessão (session ID e session tickets) para reconexões MQTT sobre TLS */
+#define MBEDTLS_SSL_SESSION_TICKETS
+
+/* AEAD do modo ChaCha20-Poly1305 (sem tabelas, só somas/rotações/XOR de 32 bits) */
+#define MBEDTLS_CHACHA20_C
+#define MBEDTLS_POLY1305_C
+#define MBEDTLS_CHACHAPOLY_C
+
+#endif /* MBEDTLS_PROFILE_MINIMAL */
@@ -4,11 +4,35 @@
 #include <stddef.h>
 #include <stdint.h>
 
+// Máximo de tópicos assinados (cada um com seu handler opcional)
+#define MQTT_COMM_MAX_SUBSCRIPTIONS 4
+
 // Tipo de função callback para tratamento de mensagens recebidas
 typedef void (*mqtt_message_handler_t)(const char *topic, const uint8_t *payload, size_t len);
 
+// Contadores da recepção (mqtt_incoming_data_cb)
+typedef struct {
+    uint32_t messages;  // Mensagens entregues aos handlers
+    uint32_t oversized; // Descartadas por não caberem no buffer de payload (handler não é chamado)
+    uint64_t busy_us;   // Tempo total gasto dentro dos handlers
+} mqtt_rx_stats_t;
+
+#if MQTT_USE_TLS
+// Medições dos handshakes TLS (completo com ECDHE vs. retomada de sessão)
+typedef struct {
+    uint32_t full_count;        // Handshakes completos realizados
+    uint32_t full_last_us;      // Duração do último handshake completo (TCP + TLS + CONNACK)
+    int full_heap_bytes;        // Heap alocado pela conexão após o handshake completo
+    uint32_t resumed_count;     // Handshakes em que o servidor aceitou a sessão oferecida
+    uint32_t resumed_last_us;   // Duração do último handshake retomado
+    int resumed_heap_bytes;     // Heap alocado pela conexão após o handshake retomado
+    uint32_t resume_refused_count; // Sessão oferecida, mas o servidor fez o handshake completo (contado em full_count)
+} mqtt_tls_stats_t;
+#endif
+
 /**
  * Inicializa e conecta o cliente MQTT.
+ * Compilado com MQTT_USE_TLS=1, a conexão usa TLS (altcp_tls + mbedTLS) na porta MQTT_BROKER_PORT.
  * @param client_id  ID do cliente MQTT
  * @param broker_ip  Endereço IP do broker (ex: "192.168.1.1")
  * @param user       Usuário para autenticação (pode ser NULL)
@@ -16,6 +40,37 @@ typedef void (*mqtt_message_handler_t)(const char *topic, const uint8_t *payload
  */
 void mqtt_setup(const char *client_id, const char *broker_ip, const char *user, const char *pass);
 
+/**
+ * Reconecta ao broker com os parâmetros de mqtt_setup.
+ * No modo TLS, a sessão do último handshake é oferecida ao servidor, evitando o ECDHE completo.
+ * Reinscreve automaticamente nos tópicos assinados com mqtt_comm_subscribe.
+ * As tentativas são espaçadas: a espera começa em MQTT_RECONNECT_MIN_MS, dobra a cada
+ * tentativa até MQTT_RECONNECT_MAX_MS e volta ao mínimo quando o broker aceita a conexão.
+ * @return 0 se a conexão foi iniciada, já está em andamento ou aguarda a espera; -1 em caso de erro
+ */
+int mqtt_comm_reconnect(void);
+
+#if MQTT_USE_TLS
+/**
+ * Copia as medições de tempo e RAM dos handshakes TLS.
+ * @param stats  Estrutura de destino
+ */
+void mqtt_comm_get_tls_stats(mqtt_tls_stats_t *stats);
+#endif
+
+/**
+ * Copia os contadores de recepção (mensagens, descartes por tamanho e tempo nos handlers).
+ * @param stats  Estrutura de destino
+ */
+void mqtt_comm_get_rx_stats(mqtt_rx_stats_t *stats);
+
+/**
+ * Tempo desde a chegada do PUBLISH em processamento; chamada de dentro de um handler,
+ * mede a latência local da mensagem (recepção + filtros + decifragem).
+ * @return Microssegundos desde o início da mensagem atual
+ */
+uint32_t mqtt_comm_message_age_us(void);
+
 /**
  * Publica mensagem em um tópico.
  * @param topic  Nome do tópico
@@ -24,6 +79,22 @@ void mqtt_setup(const char *client_id, const char *broker_ip, const char *user,
  */
 void mqtt_comm_publish(const char *topic, const uint8_t *data, size_t len);
 
+/**
+ * Publica mensagem retida com QoS 1: o broker a entrega a quem assinar o tópico depois.
+ * @param topic  Nome do tópico
+ * @param data   Payload (array de bytes)
+ * @param len    Tamanho do payload
+ * @return 0 se o lwIP aceitou a publicação, -1 sem conexão ou com a fila de saída cheia
+ */
+int mqtt_comm_publish_retained(const char *topic, const uint8_t *data, size_t len);
+
+/**
+ * Publica com o QoS escolhido.
+ * @param qos  0 ou 1 (o QoS 1 ocupa uma das requisições em andamento do lwIP até o PUBACK)
+ * @return 0 se a mensagem entrou na fila de saída, -1 caso contrário (ex.: fila cheia)
+ */
+int mqtt_comm_publish_qos(const char *topic, const uint8_t *data, size_t len, uint8_t qos);
+
 /**
  * Verifica se o cliente está conectado ao broker.
  * @return 1 se conectado, 0 caso contrário
@@ -32,10 +103,27 @@ int mqtt_comm_is_connected(void);
 
 /**
  * Inscreve o cliente em um tópico MQTT.
+ * As mensagens vão para o handler de mqtt_comm_set_message_handler.
  * @param topic  Nome do tópico a ser assinado
  */
 void mqtt_comm_subscribe(const char *topic);
 
+/**
+ * Inscreve o cliente em um tópico com um handler próprio, chamado no lugar do
+ * handler geral (ex.: tópico de controle). Se ainda não houver conexão, a
+ * inscrição é feita quando o broker aceitar a conexão.
+ * @param topic    Nome do tópico (comparação exata, sem curingas)
+ * @param handler  Função chamada para as mensagens deste tópico
+ */
+void mqtt_comm_subscribe_with_handler(const char *topic, mqtt_message_handler_t handler);
+
+/**
+ * Cancela a inscrição em um tópico assinado por mqtt_comm_subscribe(_with_handler);
+ * ele deixa de ser reinscrito nas reconexões. Tópico não assinado: nada acontece.
+ * @param topic  Nome do tópico, igual ao usado na inscrição
+ */
+void mqtt_comm_unsubscribe(const char *topic);
+
 /**
  * Registra uma função de callback para tratar mensagens recebidas.
  * @param handler  Ponteiro para a função de tratamento de mensagem
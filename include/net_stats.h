@@ -0,0 +1,34 @@
+#ifndef NET_STATS_H
+#define NET_STATS_H
+
+#include <stddef.h>
+
+/**
+ * Estatísticas de memória do lwIP (heap e pools memp).
+ * Requer compilação com LWIP_POOL_STATS=1; caso contrário as funções apenas
+ * informam que as estatísticas estão desabilitadas.
+ */
+
+/**
+ * Imprime no stdio (USB) uso atual, high-water mark e falhas de alocação
+ * do heap do lwIP e de cada pool.
+ */
+void net_stats_print(void);
+
+/**
+ * Formata as estatísticas em texto compacto para publicação MQTT.
+ * Formato: "MEM:used/max/err;POOL:used/max/avail/err;..." (só pools já utilizados).
+ * @param buf  Buffer de destino
+ * @param len  Tamanho do buffer
+ * @return Número de caracteres escritos (sem o '\0')
+ */
+size_t net_stats_format(char *buf, size_t len);
+
+/**
+ * Publica as estatísticas em MQTT_TOPIC_STATUS/<client_id> a cada
+ * NET_STATS_PUBLISH_INTERVAL_MS. Deve ser chamada periodicamente pelo loop principal.
+ * @param client_id  Identificador do firmware, usado no tópico
+ */
+void net_stats_poll(const char *client_id);
+
+#endif // NET_STATS_H
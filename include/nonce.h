@@ -0,0 +1,69 @@
+#ifndef NONCE_H
+#define NONCE_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/**
+ * Gerador de nonces de 12 bytes para os modos AEAD (AES-GCM e ChaCha20-Poly1305).
+ * Layout (big-endian): [remetente (4)] [boot (4)] [contador (4)]
+ *   remetente - derivado do ID único da flash da placa, separa publishers com a mesma chave
+ *   boot      - contador de inicializações persistido na flash, incrementado em nonce_init()
+ *   contador  - contador de mensagens em RAM, reiniciado a cada boot
+ * A flash só é escrita uma vez por boot (um registro de 16 bytes); o caminho de
+ * publicação apenas incrementa o contador em RAM.
+ * O trio (boot, contador) também serve de número de sequência para a detecção
+ * de replay no subscriber, sem depender do timestamp dentro do texto claro.
+ */
+
+#define NONCE_LEN 12
+
+typedef struct {
+    uint32_t sender;  // ID do publisher
+    uint32_t boot;    // Contador de boots do publisher
+    uint32_t counter; // Contador de mensagens dentro do boot
+} nonce_seq_t;
+
+/**
+ * Lê o contador de boots da flash, incrementa e grava o novo valor.
+ * Desabilita interrupções durante a escrita: deve ser chamada antes de
+ * inicializar o Wi-Fi (connect_to_wifi).
+ * @return true se o contador foi persistido e nonce_next() pode ser usado
+ */
+bool nonce_init(void);
+
+/**
+ * Contador de boots deste publisher (0 se nonce_init() não foi bem-sucedido).
+ * Também é a época dos lotes comprimidos (src/compress.c).
+ */
+uint32_t nonce_boot(void);
+
+/**
+ * Gera o próximo nonce.
+ * @param out  Nonce de NONCE_LEN bytes
+ * @param seq  Opcional: sequência correspondente ao nonce gerado
+ * @return 0 em sucesso, -1 se nonce_init() não foi bem-sucedido ou o contador esgotou
+ */
+int nonce_next(uint8_t out[NONCE_LEN], nonce_seq_t *seq);
+
+/**
+ * Extrai remetente, boot e contador de um nonce recebido.
+ */
+void nonce_parse(const uint8_t nonce[NONCE_LEN], nonce_seq_t *seq);
+
+/**
+ * Consulta sem registrar: a sequência seria aceita por nonce_seq_accept()?
+ * Permite recusar replays pelo cabeçalho em claro, antes de decifrar.
+ */
+bool nonce_seq_is_fresh(const nonce_seq_t *seq);
+
+/**
+ * Detecção de replay no subscriber: aceita a sequência apenas se for maior que a
+ * última aceita do mesmo remetente (boot maior, ou mesmo boot com contador maior).
+ * Só deve ser chamada depois que a tag AEAD foi verificada, para que mensagens
+ * forjadas não avancem a janela.
+ * @return true se a mensagem é nova; nesse caso a janela do remetente é atualizada
+ */
+bool nonce_seq_accept(const nonce_seq_t *seq);
+
+#endif // NONCE_H
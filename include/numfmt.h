@@ -0,0 +1,72 @@
+#ifndef NUMFMT_H
+#define NUMFMT_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * Formatação e parse de números das mensagens de telemetria, sem snprintf/sscanf e sem
+ * alocação. O M0+ não tem divisor de 64 bits: o uint64 é quebrado em blocos de 8 dígitos
+ * por multiplicação pelo recíproco de 10^8, e cada bloco vira pares de dígitos de uma
+ * tabela com aritmética de 32 bits. O parse acumula blocos de até 9 dígitos em 32 bits.
+ * Os parsers são estritos: qualquer caractere fora do formato é erro (o sscanf parava
+ * no primeiro caractere inválido e deixava o timestamp em 0).
+ */
+
+#define NUMFMT_U64_LEN 20   // Dígitos de UINT64_MAX, sem o '\0'
+#define NUMFMT_FIXED_LEN 12 // '-' + 10 dígitos + '.', sem o '\0'
+
+typedef enum {
+    NUMFMT_OK = 0,
+    NUMFMT_ERR_EMPTY,  // Sem dígitos (ou sem valor antes da vírgula)
+    NUMFMT_ERR_SYNTAX, // Caractere fora do formato
+    NUMFMT_ERR_RANGE,  // Não cabe no tipo
+} numfmt_status_t;
+
+/**
+ * Escreve `value` em decimal, terminado em '\0'. `out` deve comportar NUMFMT_U64_LEN + 1 bytes.
+ * @return Caracteres escritos, sem o '\0'
+ */
+size_t numfmt_u64(char *out, uint64_t value);
+
+/**
+ * Escreve um valor em ponto fixo com `decimals` casas, até 9 (ex.: 265, 1 -> "26.5"),
+ * terminado em '\0'. `out` deve comportar NUMFMT_FIXED_LEN + 1 bytes.
+ * @return Caracteres escritos, sem o '\0'
+ */
+size_t numfmt_fixed(char *out, int32_t value, uint8_t decimals);
+
+/**
+ * Monta "valor,timestamp" com o valor em ponto fixo.
+ * @return Caracteres escritos, sem o '\0', ou 0 se não cabe em `size`
+ */
+size_t numfmt_reading(char *out, size_t size, int32_t value, uint8_t decimals, uint64_t timestamp);
+
+/**
+ * Lê um decimal sem sinal de exatamente `len` caracteres.
+ */
+numfmt_status_t numfmt_parse_u64(const char *text, size_t len, uint64_t *value);
+
+/**
+ * Lê um decimal com sinal e ponto opcionais para ponto fixo com `decimals` casas
+ * (casas a mais são truncadas, a menos são completadas com zero; até 9 dígitos
+ * significativos, sem contar os zeros à esquerda).
+ */
+numfmt_status_t numfmt_parse_fixed(const char *text, size_t len, uint8_t decimals, int32_t *value);
+
+/**
+ * Separa "valor,timestamp": o valor é o texto antes da primeira vírgula e o timestamp,
+ * tudo depois dela, em decimal estrito.
+ * @param value       Recebe o valor com '\0' (truncado em value_size - 1), ou NULL para só validar
+ * @param value_size  Tamanho de `value`
+ */
+numfmt_status_t numfmt_parse_reading(const char *text, size_t len, char *value, size_t value_size,
+                                     uint64_t *timestamp);
+
+/**
+ * Mede ciclos por chamada de numfmt_u64 x snprintf("%llu") e do parse de uma mensagem
+ * "valor,timestamp" (com NUMFMT_BENCH_SSCANF=1, também do sscanf que ele substituiu).
+ */
+void numfmt_benchmark(void);
+
+#endif // NUMFMT_H
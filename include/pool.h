@@ -0,0 +1,49 @@
+#ifndef POOL_H
+#define POOL_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * Alocador de blocos fixos para os buffers de mensagem (payloads, textos decifrados,
+ * strings hex) e o framebuffer do display. Cada classe de tamanho tem um vetor estático
+ * de blocos e um bitmap de livres (no máximo 32 blocos por classe): alocar é achar o
+ * primeiro bit livre, liberar é religá-lo, ambos O(1) e com as interrupções desabilitadas
+ * por poucas instruções, o que permite usar o pool nos handlers do lwIP.
+ * Um pedido usa a menor classe que comporta o tamanho; se ela estiver esgotada, a
+ * próxima classe maior (contado como "emprestado"). Toda a memória é reservada na
+ * linkagem (pool_arena_bytes()), então o pior caso aparece no --print-memory-usage e no
+ * relatório da opção RAM_REPORT do CMake (tools/ram_report.cmake).
+ */
+
+/**
+ * Aloca um bloco de pelo menos `size` bytes.
+ * @return Ponteiro alinhado a 8 bytes, ou NULL se nenhuma classe que comporta o tamanho tem bloco livre
+ */
+void *pool_alloc(size_t size);
+
+/**
+ * Devolve um bloco ao pool. NULL é ignorado; um ponteiro que não é início de bloco ou
+ * um bloco já livre param o firmware com panic().
+ */
+void pool_free(void *block);
+
+/**
+ * Bytes reservados para todas as classes.
+ */
+size_t pool_arena_bytes(void);
+
+/**
+ * Imprime, por classe: blocos, em uso, pico de uso (high-water mark), alocações,
+ * empréstimos para a classe maior e falhas.
+ */
+void pool_print_stats(void);
+
+/**
+ * Mede ns por par alocação/liberação do pool e do malloc/free da newlib, com blocos
+ * isolados e com rajadas que esgotam a classe. Rodadas cuja classe não tem blocos livres
+ * para a rajada são puladas, e pedidos sem bloco durante a rodada são sinalizados.
+ */
+void pool_benchmark(void);
+
+#endif // POOL_H
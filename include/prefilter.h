@@ -0,0 +1,95 @@
+#ifndef PREFILTER_H
+#define PREFILTER_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "include/frame.h"
+#include "include/nonce.h"
+
+/**
+ * Pré-filtro do subscriber contra inundação: verificações baratas, sem chave, feitas
+ * antes do MAC ou da decifragem, na ordem do custo:
+ *   1. tamanho (limites do modo)
+ *   2. cabeçalho em claro (tipo, tópico e remetente dos frames AEAD)
+ *   3. replay (sequência do nonce ou timestamp em claro do modo de autenticação)
+ *   4. balde de tokens (PREFILTER_RATE_PER_S, rajada PREFILTER_BURST)
+ * Os caminhos de recusa não alocam, não imprimem e não desenham no OLED: apenas
+ * incrementam o contador do motivo (comando 'p' do console).
+ * O ID do remetente no cabeçalho pode ser copiado, então antes da tag nenhum frame é
+ * cobrado da cota autenticada de um remetente. Os de IDs nunca autenticados, e as
+ * mensagens dos modos sem ID, dividem o balde compartilhado. Os de um ID já autenticado
+ * (prefilter_accept) usam o balde "não verificado" desse ID, e o token volta quando a
+ * tag confere (prefilter_verified). Só então o balde "verificado" do remetente é
+ * debitado. Uma inundação com IDs forjados gasta no máximo a taxa do balde pré-tag em
+ * decifragens, e a cota verificada dos publishers conhecidos continua intacta. Mesmo
+ * assim, quem copia o ID de um publisher pode esvaziar o balde pré-tag desse ID e
+ * atrasar os frames legítimos dele: o filtro protege a CPU, não a entrega.
+ */
+
+#define PREFILTER_SENDER_NONE 0 // Mensagens sem ID de remetente (modos sem nonce)
+
+typedef enum {
+    PREFILTER_PASS = 0,
+    PREFILTER_LENGTH, // Fora dos limites do modo
+    PREFILTER_HEADER, // Tipo, tópico ou remetente do cabeçalho não conferem
+    PREFILTER_REPLAY, // Sequência ou timestamp já vistos
+    PREFILTER_RATE,   // Balde de tokens do remetente vazio
+    PREFILTER_AUTH,   // Passou pelo filtro e falhou na tag (recusa tardia, ver prefilter_reject)
+    PREFILTER_FORMAT, // Texto fora do formato "valor,timestamp"
+    PREFILTER_REASON_COUNT
+} prefilter_reason_t;
+
+/**
+ * Filtra um frame AEAD (include/frame.h) pelo cabeçalho e pelo balde pré-tag.
+ * @param plain_size  Tamanho do buffer que será passado a frame_open
+ * @param seq         Sequência lida do cabeçalho (para prefilter_accept)
+ * @return PREFILTER_PASS ou o motivo da recusa, já contabilizado
+ */
+prefilter_reason_t prefilter_frame(frame_aead_t aead, const char *topic, const uint8_t *frame, size_t len,
+                                   size_t plain_size, nonce_seq_t *seq);
+
+/**
+ * Cobra a cota autenticada de um frame AEAD cuja tag conferiu em frame_open e devolve o
+ * token cobrado antes da tag por prefilter_frame.
+ * @param sender  Remetente autenticado
+ * @return PREFILTER_PASS ou PREFILTER_RATE, já contabilizado
+ */
+prefilter_reason_t prefilter_verified(uint32_t sender);
+
+/**
+ * Filtra uma mensagem sem ID de remetente: byte de tipo, tamanho, replay pelo timestamp
+ * em claro ("valor,timestamp" logo após o tipo e os `overhead` bytes) e balde compartilhado.
+ * Lotes comprimidos (include/compress.h) pulam o replay, conferido depois na descompressão.
+ * @param kind            Modo esperado no byte de tipo (FRAME_KIND_PLAIN, _XOR ou _MAC)
+ * @param overhead        Bytes entre o tipo e a mensagem (tag do MAC, ou 0)
+ * @param max_msg_len     Maior mensagem aceita, sem o overhead
+ * @param last_timestamp  Último timestamp aceito, ou NULL se a mensagem não está em claro
+ * @return PREFILTER_PASS ou o motivo da recusa, já contabilizado
+ */
+prefilter_reason_t prefilter_plain(frame_kind_t kind, const uint8_t *payload, size_t len, size_t overhead,
+                                   size_t max_msg_len, const uint64_t *last_timestamp);
+
+/**
+ * Registra uma mensagem aceita e a latência local dela (chegada do PUBLISH até aqui).
+ * @param sender  Remetente autenticado; recebe balde próprio se ainda não tiver
+ */
+void prefilter_accept(uint32_t sender);
+
+/**
+ * Contabiliza uma recusa decidida depois do filtro (tag inválida, replay após decifrar).
+ */
+void prefilter_reject(prefilter_reason_t reason);
+
+/**
+ * Total de mensagens recusadas (filtro + recusas tardias + descartes por tamanho do mqtt_comm).
+ */
+uint32_t prefilter_rejected_total(void);
+
+/**
+ * Imprime as recusas por motivo e, desde a última chamada, a CPU gasta nos handlers
+ * e a latência local das mensagens aceitas (média e máxima).
+ */
+void prefilter_print_stats(void);
+
+#endif // PREFILTER_H
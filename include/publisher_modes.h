@@ -0,0 +1,35 @@
+#ifndef PUBLISHER_MODES_H
+#define PUBLISHER_MODES_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include "include/app.h"
+
+/**
+ * Plugins de publicação (include/app.h): um por modo de segurança, mais o intercalado
+ * (um modo diferente a cada mensagem) e o multi-stream (tabela de src/stream.c).
+ * Todos publicam pelo journal no tópico MQTT_TOPIC_SUBSCRIBE.
+ */
+
+extern const app_mode_t publisher_modes[];
+extern const size_t publisher_mode_count;
+
+/**
+ * Reserva um boot para os nonces AEAD e reconstrói o journal. Ambos gravam na flash,
+ * por isso antes do Wi-Fi (gancho boot do app_role_t).
+ */
+void publisher_boot(void);
+
+/**
+ * Assina os anúncios de rotação das chaves e os pings de sincronização do relógio
+ * (gancho connected do app_role_t).
+ */
+void publisher_connected(void);
+
+/**
+ * Rotações agendadas e reenvio do journal (gancho poll do app_role_t).
+ * @param in_mode  Não usado: o journal drena também no menu
+ */
+void publisher_poll(bool in_mode);
+
+#endif // PUBLISHER_MODES_H
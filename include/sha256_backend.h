@@ -0,0 +1,82 @@
+#ifndef SHA256_BACKEND_H
+#define SHA256_BACKEND_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "mbedtls/sha256.h"
+#if PICO_RP2350
+#include "pico/sha256.h"
+#endif
+
+#define SHA256_DIGEST_LEN 32
+#define SHA256_BLOCK_LEN 64
+// A partir deste tamanho o acelerador do RP2350 é alimentado por DMA
+#define SHA256_DMA_THRESHOLD 256
+
+/**
+ * Backend de SHA-256 usado pelo HMAC dos dois firmwares.
+ * No RP2350 usa o acelerador de hardware (pico_sha256) sempre que ele estiver
+ * livre; caso contrário (RP2040, ou acelerador ocupado) usa o mbedTLS em software.
+ */
+typedef enum {
+    SHA256_BACKEND_SOFTWARE,
+    SHA256_BACKEND_HARDWARE,
+} sha256_backend_t;
+
+typedef struct {
+    sha256_backend_t backend;
+    union {
+        mbedtls_sha256_context sw;
+#if PICO_RP2350
+        pico_sha256_state_t hw;
+#endif
+    } u;
+} sha256_backend_ctx_t;
+
+/**
+ * Inicia um hash, escolhendo o backend em tempo de execução.
+ * @param ctx           Contexto a inicializar
+ * @param expected_len  Total de bytes que serão processados (decide o uso de DMA)
+ * @return 0 em sucesso, código de erro do mbedTLS caso contrário
+ */
+int sha256_backend_start(sha256_backend_ctx_t *ctx, size_t expected_len);
+
+/**
+ * Força um backend específico (usado pelo autoteste e pelo benchmark).
+ * @return 0 em sucesso, -1 se o backend não estiver disponível
+ */
+int sha256_backend_start_with(sha256_backend_ctx_t *ctx, sha256_backend_t backend, size_t expected_len);
+
+/**
+ * Processa mais dados. Com DMA, os dados devem permanecer válidos até o próximo
+ * update ou o finish.
+ */
+int sha256_backend_update(sha256_backend_ctx_t *ctx, const uint8_t *data, size_t len);
+
+/**
+ * Finaliza o hash e libera o backend.
+ * @param out  Digest de 32 bytes
+ */
+int sha256_backend_finish(sha256_backend_ctx_t *ctx, uint8_t out[SHA256_DIGEST_LEN]);
+
+/**
+ * HMAC-SHA256 (RFC 2104) sobre o backend selecionado.
+ * @return 0 em sucesso, código de erro do mbedTLS caso contrário
+ */
+int hmac_sha256(const uint8_t *key, size_t key_len, const uint8_t *msg, size_t msg_len,
+                uint8_t out[SHA256_DIGEST_LEN]);
+
+/**
+ * Verifica os vetores do RFC 4231 em cada backend disponível e compara as
+ * saídas dos backends entre si (incluindo o caminho com DMA).
+ * @return true se todos os resultados conferem
+ */
+bool sha256_backend_selftest(void);
+
+/**
+ * Imprime ciclos/byte de cada backend para 64 B, 256 B e 1 KB.
+ */
+void sha256_backend_benchmark(void);
+
+#endif // SHA256_BACKEND_H
@@ -0,0 +1,64 @@
+#ifndef SHA256_VECTORS_H
+#define SHA256_VECTORS_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "include/sha256_backend.h"
+
+/**
+ * Vetores de HMAC-SHA256 conferidos pelo autoteste do boot (sha256_backend_selftest) e
+ * pelo teste de host do caminho em software (tests/test_sha256_software.c): casos 1, 2
+ * e 6 do RFC 4231, e 1 KB com a chave do projeto, que no RP2350 passa pelo DMA.
+ * As tabelas são static: cada arquivo que inclui este cabeçalho tem a sua cópia.
+ */
+
+typedef struct {
+    const uint8_t *key;
+    size_t key_len;
+    const char *msg;
+    uint8_t expected[SHA256_DIGEST_LEN];
+} hmac_vector_t;
+
+static const uint8_t sha256_rfc4231_key_tc1[20] = {
+    0x0b, 0x0b, 0x0b, 0x0b, 0x0b, 0x0b, 0x0b, 0x0b, 0x0b, 0x0b, 0x0b, 0x0b, 0x0b, 0x0b, 0x0b, 0x0b,
+    0x0b, 0x0b, 0x0b, 0x0b};
+
+// Caso 6: chave maior que o bloco, que o HMAC substitui pelo seu hash
+static const uint8_t sha256_rfc4231_key_tc6[131] = {
+    0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa,
+    0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa,
+    0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa,
+    0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa,
+    0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa,
+    0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa,
+    0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa,
+    0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa,
+    0xaa, 0xaa, 0xaa};
+
+static const hmac_vector_t sha256_rfc4231_vectors[] = {
+    {sha256_rfc4231_key_tc1, sizeof(sha256_rfc4231_key_tc1), "Hi There",
+     {0xb0, 0x34, 0x4c, 0x61, 0xd8, 0xdb, 0x38, 0x53, 0x5c, 0xa8, 0xaf, 0xce, 0xaf, 0x0b, 0xf1, 0x2b,
+      0x88, 0x1d, 0xc2, 0x00, 0xc9, 0x83, 0x3d, 0xa7, 0x26, 0xe9, 0x37, 0x6c, 0x2e, 0x32, 0xcf, 0xf7}},
+    {(const uint8_t *)"Jefe", 4, "what do ya want for nothing?",
+     {0x5b, 0xdc, 0xc1, 0x46, 0xbf, 0x60, 0x75, 0x4e, 0x6a, 0x04, 0x24, 0x26, 0x08, 0x95, 0x75, 0xc7,
+      0x5a, 0x00, 0x3f, 0x08, 0x9d, 0x27, 0x39, 0x83, 0x9d, 0xec, 0x58, 0xb9, 0x64, 0xec, 0x38, 0x43}},
+    {sha256_rfc4231_key_tc6, sizeof(sha256_rfc4231_key_tc6), "Test Using Larger Than Block-Size Key - Hash Key First",
+     {0x60, 0xe4, 0x31, 0x59, 0x1e, 0xe0, 0xb6, 0x7f, 0x0d, 0x8a, 0x26, 0xaa, 0xcb, 0xf5, 0xb7, 0x7f,
+      0x8e, 0x0b, 0xc6, 0x21, 0x37, 0x28, 0xc5, 0x14, 0x05, 0x46, 0x04, 0x0f, 0x0e, 0xe3, 0x7f, 0x54}},
+};
+#define SHA256_RFC4231_VECTOR_COUNT (sizeof(sha256_rfc4231_vectors) / sizeof(sha256_rfc4231_vectors[0]))
+
+// HMAC com a chave do projeto sobre 1 KB gerado por sha256_vector_fill_1k (byte i = i*7+3)
+#define SHA256_VECTOR_1K_LEN 1024
+static const char sha256_vector_1k_key[] = "DontPanicAndCarryATowelHitchhike";
+static const uint8_t sha256_vector_1k_expected[SHA256_DIGEST_LEN] = {
+    0xd6, 0x43, 0x2d, 0xca, 0xba, 0x61, 0xbb, 0x3a, 0x7b, 0xe2, 0x71, 0x07, 0x11, 0x23, 0x7c, 0xf0,
+    0xac, 0x8a, 0x97, 0x21, 0x40, 0x3d, 0x5e, 0xe0, 0x8d, 0x21, 0xa8, 0x32, 0x52, 0x36, 0x42, 0x87};
+
+static inline void sha256_vector_fill_1k(uint8_t out[SHA256_VECTOR_1K_LEN]) {
+    for (size_t i = 0; i < SHA256_VECTOR_1K_LEN; i++) {
+        out[i] = (uint8_t)(i * 7 + 3);
+    }
+}
+
+#endif // SHA256_VECTORS_H
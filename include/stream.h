@@ -0,0 +1,87 @@
+#ifndef STREAM_H
+#define STREAM_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "include/frame.h"
+#include "include/compress.h"
+
+/**
+ * Motor de publicação por tabela: cada stream declara tópico, fonte de amostras,
+ * período, modo de segurança, QoS e tamanho do lote. stream_poll() só percorre a
+ * tabela quando o próximo vencimento chega; no resto das chamadas custa uma comparação.
+ * Mensagem publicada (antes do modo de segurança, via frame_encode):
+ *   "a1;a2;...;aN,timestamp"   (N = batch, timestamp em µs desde o boot)
+ * O subscriber lê o lote como o campo "valor" do formato "valor,timestamp".
+ * Com compression != COMPRESS_NONE, as amostras viram ponto fixo e o lote vai
+ * comprimido (include/compress.h); o subscriber devolve o mesmo texto.
+ */
+
+#define STREAM_MAX_STREAMS 50
+#define STREAM_MAX_BATCH 8
+#define STREAM_SAMPLE_LEN 8 // Maior amostra em texto, sem o terminador (ex.: "-12.34")
+
+/**
+ * Fonte de amostras: escreve o valor em texto.
+ * @return Número de caracteres escritos, ou -1 se não houver amostra
+ */
+typedef int (*stream_source_t)(char *out, size_t size);
+
+/**
+ * Destino das mensagens prontas (o padrão é journal_publish: MQTT ou, sem conexão, a flash).
+ * @return 0 se a mensagem foi aceita
+ */
+typedef int (*stream_sink_t)(const char *topic, const uint8_t *data, size_t len, uint8_t qos);
+
+typedef struct {
+    const char *topic;
+    stream_source_t source;
+    uint32_t period_ms;    // Intervalo entre amostras
+    frame_kind_t security; // Modo de segurança da mensagem (include/frame.h)
+    uint8_t qos;           // 0 ou 1
+    uint8_t batch;         // Amostras por mensagem (1 a STREAM_MAX_BATCH)
+    compress_mode_t compression; // Texto (COMPRESS_NONE), delta ou delta sem estado
+} stream_config_t;
+
+/* Fontes prontas */
+int stream_source_fixed(char *out, size_t size);         // "26.5", o valor fixo dos modos do menu
+int stream_source_chip_temp(char *out, size_t size);     // Sensor de temperatura interno do RP2040 (ADC 4), em °C
+int stream_source_joystick_y(char *out, size_t size);    // Leitura bruta do eixo Y do joystick
+int stream_source_counter(char *out, size_t size);       // Contador crescente (testes de carga)
+
+/**
+ * Carrega a tabela de streams e agenda a primeira amostra de cada um para agora.
+ * @param streams  Tabela (não é copiada; deve permanecer válida)
+ * @param count    Número de streams (até STREAM_MAX_STREAMS; o excedente é ignorado)
+ * @param sink     Destino das mensagens, ou NULL para publicar pelo mqtt_comm
+ */
+void stream_init(const stream_config_t *streams, size_t count, stream_sink_t sink);
+
+/**
+ * Amostra e publica os streams vencidos.
+ * @param now_ms  Tempo atual (to_ms_since_boot)
+ * @return ms até o próximo vencimento (0 se algum stream já está atrasado)
+ */
+uint32_t stream_poll(uint32_t now_ms);
+
+/**
+ * Total de mensagens publicadas desde stream_init.
+ */
+uint32_t stream_published_total(void);
+
+/**
+ * Imprime, por stream: tópico, modo, período, lote, QoS, mensagens publicadas,
+ * falhas (codificação ou fila de saída cheia), atrasos do agendamento e, nos
+ * streams comprimidos, os bytes enviados contra os do mesmo lote em texto.
+ */
+void stream_print_stats(void);
+
+/**
+ * Mede a vazão agregada do motor (amostra + texto + modo de segurança) com 1, 10 e
+ * 50 streams de período 0, publicando num destino que só conta as mensagens, para
+ * isolar o custo do motor do custo da rede. Restaura a tabela ativa ao terminar
+ * (com os contadores zerados).
+ */
+void stream_benchmark(void);
+
+#endif // STREAM_H
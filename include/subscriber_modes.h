@@ -0,0 +1,36 @@
+#ifndef SUBSCRIBER_MODES_H
+#define SUBSCRIBER_MODES_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include "include/app.h"
+
+/**
+ * Plugins de recepção (include/app.h): um decodificador por modo de segurança, mais o
+ * automático, que escolhe o decodificador pelo byte de tipo de cada mensagem
+ * (src/dispatch.c). As recusas só incrementam os contadores do pré-filtro.
+ */
+
+extern const app_mode_t subscriber_modes[];
+extern const size_t subscriber_mode_count;
+
+/**
+ * Monta as rotas do modo automático (gancho boot do app_role_t).
+ */
+void subscriber_boot(void);
+
+/**
+ * Assina o tópico dos modos, os streams adicionais, os anúncios de rotação das chaves e
+ * as respostas de sincronização do relógio (gancho connected do app_role_t).
+ */
+void subscriber_connected(void);
+
+/**
+ * Deriva as chaves anunciadas, sincroniza o relógio, publica os percentis da latência e,
+ * dentro de um modo, mostra as recusas e a latência no rodapé do OLED, no máximo uma vez
+ * a cada PREFILTER_DISPLAY_INTERVAL_MS (gancho poll).
+ * @param in_mode  true fora do menu principal
+ */
+void subscriber_poll(bool in_mode);
+
+#endif // SUBSCRIBER_MODES_H
@@ -0,0 +1,50 @@
+#ifndef TRACE_H
+#define TRACE_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/**
+ * Rastreamento leve dos estágios de publicação e recepção.
+ * Cada TRACE_BEGIN/TRACE_END grava um evento com timestamp em µs (time_us_32)
+ * em um buffer circular em RAM. Compilado com TRACE_ENABLED=0 (padrão) as
+ * macros não geram código. O conteúdo é despejado pelo comando 't' do console
+ * e convertido em histogramas por tools/trace_histogram.py.
+ */
+
+// Estágios instrumentados (a ordem define os nomes impressos no dump)
+typedef enum {
+    TRACE_SAMPLE,             // Leitura do sensor e timestamp
+    TRACE_FRAME_BUILD,        // Montagem do texto/payload
+    TRACE_CRYPTO,             // Cifragem/MAC no publisher
+    TRACE_MQTT_PUBLISH,       // Chamada a mqtt_publish
+    TRACE_MQTT_INCOMING_DATA, // Callback de dados recebidos (inclui o handler do modo)
+    TRACE_DECRYPT_VERIFY,     // Decifragem/verificação no subscriber
+    TRACE_PARSE,              // Extração de valor e timestamp
+    TRACE_DISPLAY_FLUSH,      // Envio do framebuffer ao OLED
+    TRACE_STAGE_COUNT
+} trace_stage_t;
+
+#if TRACE_ENABLED
+#define TRACE_BEGIN(stage) trace_record((stage), true)
+#define TRACE_END(stage) trace_record((stage), false)
+#else
+#define TRACE_BEGIN(stage) ((void)0)
+#define TRACE_END(stage) ((void)0)
+#endif
+
+/**
+ * Grava um evento no buffer circular. Pode ser chamada do loop principal e
+ * dos callbacks do lwIP (contexto de interrupção).
+ * @param stage     Estágio instrumentado
+ * @param is_begin  true no início do estágio, false no fim
+ */
+void trace_record(trace_stage_t stage, bool is_begin);
+
+/**
+ * Imprime os eventos gravados no formato "TRACE,<estagio>,<B|E>,<us>"
+ * (entre as linhas "TRACE-BEGIN" e "TRACE-END") e esvazia o buffer.
+ */
+void trace_dump(void);
+
+#endif // TRACE_H
@@ -0,0 +1,22 @@
+// Firmware de loopback: publisher e subscriber na mesma placa, para medir a ida e volta
+// de cada modo de segurança sem uma segunda placa (src/loopback.c)
+#include "app.h"
+#include "loopback.h"
+#include "config/credentials.h" // Credenciais da rede WiFi e do broker MQTT
+
+int main()
+{
+    const app_role_t role = {
+        .name = "LOOPBACK",
+        .client_id = MQTT_CLIENT_ID_LOOPBACK,
+        .is_publisher = true,
+        .offline_ok = true, // O loopback interno não usa a rede
+        .idle_text = "Medindo...",
+        .modes = loopback_modes,
+        .mode_count = loopback_mode_count,
+        .boot = loopback_boot,
+        .connected = loopback_connected,
+        .poll = loopback_poll,
+    };
+    return app_run(&role);
+}
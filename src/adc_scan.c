@@ -0,0 +1,116 @@
+#include "include/adc_scan.h"
+#include "config/config.h"
+#include "pico/stdlib.h"
+#include "hardware/adc.h"
+#include "hardware/clocks.h"
+#include "hardware/irq.h"
+#include <stdbool.h>
+#include <stdio.h>
+
+// O round-robin converte os canais da máscara em ordem crescente, a partir do selecionado
+#if !(ADC_JOYSTICK_Y_CHANNEL < ADC_JOYSTICK_X_CHANNEL && ADC_JOYSTICK_X_CHANNEL < ADC_TEMP_SENSOR_CHANNEL)
+#error "scan_channels[] deve estar na ordem crescente dos canais do ADC"
+#endif
+
+static const uint8_t scan_channels[] = {ADC_JOYSTICK_Y_CHANNEL, ADC_JOYSTICK_X_CHANNEL, ADC_TEMP_SENSOR_CHANNEL};
+#define SCAN_COUNT (sizeof(scan_channels) / sizeof(scan_channels[0]))
+
+static volatile uint16_t latest[ADC_SCAN_CHANNEL_COUNT];
+static adc_scan_handler_t round_handler = NULL;
+static bool running = false;
+
+static uint32_t rounds = 0;
+static uint32_t resyncs = 0;
+static uint32_t conversion_errors = 0;
+static uint64_t irq_busy_us = 0;
+
+// Recomeça a varredura pelo primeiro canal depois de um transbordo da FIFO
+static void resync(void) {
+    adc_run(false);
+    adc_fifo_drain();
+    hw_set_bits(&adc_hw->fcs, ADC_FCS_OVER_BITS | ADC_FCS_UNDER_BITS); // Bits limpos ao escrever 1
+    adc_select_input(scan_channels[0]);
+    adc_run(true);
+    resyncs++;
+}
+
+static void adc_scan_irq(void) {
+    uint32_t start_us = time_us_32();
+    if (adc_hw->fcs & ADC_FCS_OVER_BITS) {
+        resync();
+    } else {
+        uint32_t now_ms = to_ms_since_boot(get_absolute_time());
+        while (adc_fifo_get_level() >= SCAN_COUNT) {
+            uint16_t samples[ADC_SCAN_CHANNEL_COUNT] = {0};
+            for (size_t i = 0; i < SCAN_COUNT; i++) {
+                uint16_t sample = adc_fifo_get();
+                if (sample & ADC_FIFO_ERR_BITS) {
+                    conversion_errors++;
+                }
+                samples[scan_channels[i]] = sample & 0x0FFF;
+                latest[scan_channels[i]] = sample & 0x0FFF;
+            }
+            rounds++;
+            if (round_handler != NULL) {
+                round_handler(samples, now_ms);
+            }
+        }
+    }
+    irq_busy_us += time_us_32() - start_us;
+}
+
+void adc_scan_init(void) {
+    if (running) {
+        return;
+    }
+    adc_init();
+    adc_gpio_init(JOYSTICK_VRY_PIN);
+    adc_gpio_init(JOYSTICK_VRX_PIN);
+    adc_set_temp_sensor_enabled(true);
+
+    uint32_t mask = 0;
+    for (size_t i = 0; i < SCAN_COUNT; i++) {
+        mask |= 1u << scan_channels[i];
+    }
+    adc_select_input(scan_channels[0]);
+    adc_set_round_robin(mask);
+    // IRQ com uma rodada inteira na FIFO; o bit 15 de cada amostra marca erro de conversão
+    adc_fifo_setup(true, false, SCAN_COUNT, true, false);
+    adc_set_clkdiv((float)(clock_get_hz(clk_adc) / (ADC_SCAN_RATE_HZ * SCAN_COUNT) - 1));
+
+    irq_set_exclusive_handler(ADC_IRQ_FIFO, adc_scan_irq);
+    adc_irq_set_enabled(true);
+    irq_set_enabled(ADC_IRQ_FIFO, true);
+    running = true;
+    adc_run(true);
+}
+
+void adc_scan_set_handler(adc_scan_handler_t handler) {
+    round_handler = handler;
+}
+
+uint16_t adc_scan_latest(uint8_t channel) {
+    return channel < ADC_SCAN_CHANNEL_COUNT ? latest[channel] : 0;
+}
+
+void adc_scan_print_stats(void) {
+    static uint32_t last_rounds = 0;
+    static uint64_t last_busy_us = 0;
+    static uint64_t last_print_us = 0;
+
+    uint64_t now_us = time_us_64();
+    uint64_t window_us = now_us - last_print_us;
+    uint32_t irq_state = save_and_disable_interrupts();
+    uint32_t round_count = rounds;
+    uint64_t busy_us = irq_busy_us;
+    restore_interrupts(irq_state);
+
+    printf("ADC: %lu rodadas (%lu/s), %lu ressincronizacoes, %lu erros de conversao\n", (unsigned long)round_count,
+           (unsigned long)((uint64_t)(round_count - last_rounds) * 1000000 / window_us), (unsigned long)resyncs,
+           (unsigned long)conversion_errors);
+    printf("CPU na IRQ do ADC: %lu.%lu%% em %lu ms\n", (unsigned long)((busy_us - last_busy_us) * 100 / window_us),
+           (unsigned long)((busy_us - last_busy_us) * 1000 / window_us % 10), (unsigned long)(window_us / 1000));
+    last_rounds = round_count;
+    last_busy_us = busy_us;
+    last_print_us = now_us;
+}
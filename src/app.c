@@ -0,0 +1,170 @@
+#include "include/app.h"
+#include "config/credentials.h" // Credenciais da rede WiFi e do broker MQTT
+#include "config/config.h"
+#include "wifi_conn.h"
+#include "mqtt_comm.h"
+#include "display.h"
+#include "button.h"
+#include "joystick.h"
+#include "console.h"
+#include "net_stats.h"
+#include "log.h"
+#include "sha256_backend.h"
+#include "key_manager.h"
+#include "pico/stdlib.h"
+#include <stdio.h>
+
+// Intervalo do laço nos modos sem encode (só o botão e o console a atender)
+#define APP_IDLE_SLEEP_MS 100
+
+// Espera pelo terminal serial antes do boot do papel
+#define APP_TERMINAL_WAIT_MS 5000
+
+static int app_connect(const app_role_t *role) {
+    bool col = role->is_publisher;
+
+    display_text_in_line("Conectando Wi-Fi...", 1, col);
+    connect_to_wifi(WIFI_SSID, WIFI_PASSWORD);
+    if (!wifi_comm_is_connected()) {
+        printf("Falha ao obter link da rede Wi-Fi. Abortando.\n");
+        return -1;
+    }
+    printf("Link da rede Wi-Fi estabelecido.\n");
+    display_text_in_line("Link estabecido!", 2, col);
+
+    // Parâmetros em credentials.h
+    mqtt_setup(role->client_id, MQTT_BROKER_IP, MQTT_USER, MQTT_PASS);
+    sleep_ms(1000);
+    display_text_in_line("Conectando MQTT...", 1, col);
+
+    printf("Aguardando conexao MQTT (3s)...\n"); // Tempo para o cliente MQTT conectar
+    sleep_ms(3000);
+    if (!mqtt_comm_is_connected()) {
+        printf("Falha ao conectar ao broker MQTT. Abortando.\n");
+        return -1;
+    }
+    printf("Conexão MQTT estabelecida.\n");
+    display_text_in_line("MQTT Conectado!", 2, col);
+    display_text_in_line(role->client_id, 3, col);
+    sleep_ms(2000);
+    return 0;
+}
+
+static void app_draw_mode(const app_role_t *role, const app_mode_t *mode) {
+    display_clear();
+    display_text_in_line(mode->title, 0, role->is_publisher);
+    display_text_in_line(role->idle_text, 1, role->is_publisher);
+    for (int line = 2; line <= 4; line++) {
+        display_text_in_line("", line, role->is_publisher);
+    }
+}
+
+static void app_enter_mode(const app_role_t *role, const app_mode_t *mode) {
+    if (mode->init != NULL) {
+        mode->init();
+    }
+    if (mode->decode != NULL) {
+        mqtt_comm_set_message_handler(mode->decode);
+    }
+    printf("Modo %s selecionado.\n", mode->label);
+    app_draw_mode(role, mode);
+}
+
+static void app_leave_mode(const app_mode_t *mode) {
+    if (mode->teardown != NULL) {
+        mode->teardown();
+    }
+    if (mode->decode != NULL) {
+        mqtt_comm_set_message_handler(NULL); // Nada decodifica (nem desenha) sobre o menu
+    }
+}
+
+int app_run(const app_role_t *role) {
+    stdio_init_all();
+    display_init();
+    button_init();
+    joystick_init();
+
+    // Confere o backend de SHA-256 com os vetores do RFC 4231 antes de usá-lo no HMAC
+    if (!sha256_backend_selftest()) {
+        printf("Autoteste do SHA-256 falhou!\n");
+    }
+
+    // Deriva as chaves da sessão inicial a partir do segredo mestre
+    key_manager_init();
+
+    sleep_ms(APP_TERMINAL_WAIT_MS);
+    if (role->boot != NULL) {
+        role->boot();
+    }
+
+    if (app_connect(role) == 0) {
+        if (role->connected != NULL) {
+            role->connected();
+        }
+    } else if (!role->offline_ok) {
+        return -1;
+    } else {
+        printf("Sem rede: seguindo so com os modos locais.\n");
+    }
+
+    const char *labels[APP_MAX_MODES];
+    int mode_count = role->mode_count < APP_MAX_MODES ? (int)role->mode_count : APP_MAX_MODES;
+    for (int i = 0; i < mode_count; i++) {
+        labels[i] = role->modes[i].label;
+    }
+
+    const app_mode_t *mode = NULL; // NULL: menu principal
+    int selected_idx = 0;
+    bool redraw_menu = true;
+
+    while (true) {
+        console_poll();                  // Comandos do terminal serial (ex.: 's' = estatísticas do lwIP)
+        net_stats_poll(role->client_id); // Publica periodicamente o uso dos pools do lwIP
+        log_flush();                     // Esvazia o log diferido enquanto está ocioso
+        if (role->poll != NULL) {
+            role->poll(mode != NULL);
+        }
+
+        // Reconecta se o broker caiu; no modo TLS a sessão anterior é retomada
+        if (!mqtt_comm_is_connected()) {
+            mqtt_comm_reconnect();
+        }
+
+        if (mode == NULL) {
+            if (redraw_menu) {
+                draw_menu(role->name, labels, mode_count, selected_idx);
+                redraw_menu = false;
+            }
+            int previous_idx = selected_idx;
+            joystick_handle_menu_navigation(mode_count, &selected_idx);
+            if (previous_idx != selected_idx) {
+                redraw_menu = true;
+            }
+            if (button_get_pressed_and_reset()) {
+                mode = &role->modes[selected_idx];
+                app_enter_mode(role, mode);
+            }
+        } else if (button_get_pressed_and_reset()) {
+            // O menu volta com o item do modo selecionado
+            app_leave_mode(mode);
+            mode = NULL;
+            redraw_menu = true;
+        } else if (mode->encode != NULL) {
+            int32_t wait_ms = mode->encode();
+            if (wait_ms == APP_MODE_EXIT) {
+                app_leave_mode(mode);
+                mode = NULL;
+                redraw_menu = true;
+            } else {
+                log_flush(); // Imprime o log enquanto aguarda o próximo passo
+                sleep_ms((uint32_t)wait_ms);
+            }
+        } else {
+            sleep_ms(APP_IDLE_SLEEP_MS);
+        }
+        tight_loop_contents();
+    }
+
+    return 0;
+}
@@ -1,36 +1,117 @@
 #include "button.h"
-#include "config/config.h" // Required for BTN_A_PIN, BTN_DEBOUNCE_TIME_MS
-
-static volatile uint32_t last_btn_press_time = 0;
-static volatile bool button_pressed_flag = false;
-
-// IRQ callback function for button A press
-static void button_a_irq_callback(uint gpio, uint32_t events)
-{
-    if (events == GPIO_IRQ_EDGE_FALL && gpio == BTN_A_PIN && !button_pressed_flag)
-    {
-        uint32_t now = time_us_32();
-        if ((int32_t)(now - last_btn_press_time) > BTN_DEBOUNCE_TIME_MS * 1000 || last_btn_press_time == 0)
-        {
-            button_pressed_flag = true;
-            last_btn_press_time = now;
+#include "input.h"
+#include "config/config.h" // Pinos dos botões e tempos de debounce, toque longo e duplo
+#include "pico/stdlib.h"
+
+#define BUTTON_EDGES (GPIO_IRQ_EDGE_FALL | GPIO_IRQ_EDGE_RISE)
+
+typedef struct {
+    uint8_t pin;
+    uint8_t source;          // input_source_t
+    bool pressed;            // Nível estável depois do debounce
+    bool double_armed;       // O próximo press pode fechar um toque duplo
+    uint32_t edge_ms;        // Primeira borda desde o último nível estável
+    uint32_t last_press_ms;
+    alarm_id_t long_alarm;   // Alarme do toque longo pendente (0 = nenhum)
+} button_t;
+
+static button_t buttons[] = {
+    {BTN_A_PIN, INPUT_SOURCE_BTN_A, false, false, 0, 0, 0},
+    {BTN_B_PIN, INPUT_SOURCE_BTN_B, false, false, 0, 0, 0},
+    {JOYSTICK_BTN_PIN, INPUT_SOURCE_BTN_JOYSTICK, false, false, 0, 0, 0},
+};
+#define BUTTON_COUNT (sizeof(buttons) / sizeof(buttons[0]))
+
+static int64_t long_press_alarm(alarm_id_t id, void *user_data) {
+    (void)id;
+    button_t *button = user_data;
+    button->long_alarm = 0;
+    if (button->pressed) {
+        input_push(INPUT_BTN_LONG, (input_source_t)button->source, false, to_ms_since_boot(get_absolute_time()));
+        button->double_armed = false; // Um toque longo não conta como metade de um duplo
+    }
+    return 0; // Não reagenda
+}
+
+// Novo nível estável de um botão
+static void button_settle(button_t *button, bool pressed, uint32_t time_ms) {
+    if (pressed == button->pressed) {
+        return; // Pulso mais curto que o debounce
+    }
+    button->pressed = pressed;
+    input_source_t source = (input_source_t)button->source;
+    if (!pressed) {
+        if (button->long_alarm > 0) {
+            cancel_alarm(button->long_alarm);
+            button->long_alarm = 0;
+        }
+        input_push(INPUT_BTN_RELEASE, source, false, time_ms);
+        return;
+    }
+
+    input_push(INPUT_BTN_PRESS, source, false, time_ms);
+    if (button->double_armed && time_ms - button->last_press_ms <= BTN_DOUBLE_PRESS_MS) {
+        input_push(INPUT_BTN_DOUBLE, source, false, time_ms);
+        button->double_armed = false; // Um terceiro press começa outro par
+    } else {
+        button->double_armed = true;
+    }
+    button->last_press_ms = time_ms;
+    alarm_id_t id = add_alarm_in_ms(BTN_LONG_PRESS_MS, long_press_alarm, button, true);
+    button->long_alarm = id > 0 ? id : 0;
+}
+
+static int64_t debounce_alarm(alarm_id_t id, void *user_data) {
+    (void)id;
+    button_t *button = user_data;
+    // Limpa as bordas do período de debounce antes de ler o nível: uma borda depois da
+    // leitura fica registrada e dispara assim que a IRQ for religada
+    gpio_acknowledge_irq(button->pin, BUTTON_EDGES);
+    button_settle(button, !gpio_get(button->pin), button->edge_ms);
+    gpio_set_irq_enabled(button->pin, BUTTON_EDGES, true);
+    return 0;
+}
+
+static void button_irq_callback(uint gpio, uint32_t events) {
+    (void)events;
+    for (size_t i = 0; i < BUTTON_COUNT; i++) {
+        button_t *button = &buttons[i];
+        if (button->pin != gpio) {
+            continue;
+        }
+        button->edge_ms = to_ms_since_boot(get_absolute_time());
+        gpio_set_irq_enabled(gpio, BUTTON_EDGES, false);
+        if (add_alarm_in_ms(BTN_DEBOUNCE_TIME_MS, debounce_alarm, button, true) <= 0) {
+            gpio_set_irq_enabled(gpio, BUTTON_EDGES, true); // Sem alarme livre: espera a próxima borda
         }
+        return;
     }
 }
 
-void button_init(void)
-{
-    gpio_init(BTN_A_PIN);
-    gpio_set_dir(BTN_A_PIN, GPIO_IN);
-    gpio_pull_up(BTN_A_PIN);
-    gpio_set_irq_enabled_with_callback(BTN_A_PIN, GPIO_IRQ_EDGE_FALL, true, &button_a_irq_callback);
+void button_init(void) {
+    for (size_t i = 0; i < BUTTON_COUNT; i++) {
+        gpio_init(buttons[i].pin);
+        gpio_set_dir(buttons[i].pin, GPIO_IN);
+        gpio_pull_up(buttons[i].pin);
+        buttons[i].pressed = !gpio_get(buttons[i].pin);
+    }
+    // O callback de GPIO é um só para todos os pinos
+    gpio_set_irq_enabled_with_callback(buttons[0].pin, BUTTON_EDGES, true, &button_irq_callback);
+    for (size_t i = 1; i < BUTTON_COUNT; i++) {
+        gpio_set_irq_enabled(buttons[i].pin, BUTTON_EDGES, true);
+    }
 }
 
-bool button_get_pressed_and_reset(void)
-{
-    if (button_pressed_flag)
-    {
-        button_pressed_flag = false; // Reset the flag atomically (assuming single core access or IRQ priorities handle it)
+bool button_get_pressed_and_reset(void) {
+    static uint32_t last_taken_ms = 0;
+    input_event_t event;
+    while (input_pop(INPUT_MASK(INPUT_BTN_PRESS), INPUT_MASK(INPUT_SOURCE_BTN_A) | INPUT_MASK(INPUT_SOURCE_BTN_JOYSTICK),
+                     &event)) {
+        // Vários presses durante o mesmo sleep valem uma ação: o da ação anterior já os atendeu
+        if ((int32_t)(event.time_ms - last_taken_ms) < 0) {
+            continue;
+        }
+        last_taken_ms = to_ms_since_boot(get_absolute_time());
         return true;
     }
     return false;
@@ -0,0 +1,147 @@
+#include "include/clock_sync.h"
+#include "include/mqtt_comm.h"
+#include "config/config.h"
+#include "config/credentials.h"
+#include "pico/stdlib.h"
+#include "hardware/sync.h"
+#include <stdio.h>
+#include <string.h>
+
+#define CLOCK_TOPIC_PING MQTT_TOPIC_CLOCK "/ping"
+#define CLOCK_TOPIC_PONG MQTT_TOPIC_CLOCK "/pong"
+
+// Ping: [seq (4)] [t1 (8)]; pong: [seq (4)] [t1 (8)] [t2 (8)] [t3 (8)], na ordem de bytes da placa
+#define CLOCK_PING_LEN 12
+#define CLOCK_PONG_LEN 28
+
+typedef struct {
+    int64_t offset_us;
+    uint32_t delay_us;
+} clock_sample_t;
+
+static clock_sample_t samples[CLOCK_SYNC_WINDOW];
+static uint32_t sample_count = 0; // Total de amostras (o anel guarda as CLOCK_SYNC_WINDOW últimas)
+static volatile int64_t offset_us = 0;
+static volatile uint32_t offset_delay_us = 0;
+static volatile bool synced = false;
+
+// Ping em andamento (um por vez; a resposta de um ping anterior é descartada)
+static volatile uint32_t ping_seq = 0;
+static volatile uint64_t ping_t1 = 0;
+static uint32_t last_ping_ms = 0;
+
+static uint32_t pings_sent = 0;
+static uint32_t pongs_used = 0;
+static uint32_t pongs_stale = 0;
+static uint32_t pings_served = 0;
+
+// Chegada do PUBLISH em processamento, no relógio local
+static uint64_t arrival_us(void) {
+    return to_us_since_boot(get_absolute_time()) - mqtt_comm_message_age_us();
+}
+
+static void clock_on_ping(const char *topic, const uint8_t *payload, size_t len) {
+    (void)topic;
+    if (len != CLOCK_PING_LEN) {
+        return;
+    }
+    uint8_t pong[CLOCK_PONG_LEN];
+    uint64_t t2 = arrival_us();
+    memcpy(pong, payload, CLOCK_PING_LEN); // seq e t1 voltam como vieram
+    memcpy(pong + 12, &t2, sizeof(t2));
+    uint64_t t3 = to_us_since_boot(get_absolute_time());
+    memcpy(pong + 20, &t3, sizeof(t3));
+    mqtt_comm_publish(CLOCK_TOPIC_PONG, pong, sizeof(pong));
+    pings_served++;
+}
+
+// Menor atraso entre as amostras guardadas
+static void clock_select_sample(void) {
+    uint32_t count = sample_count < CLOCK_SYNC_WINDOW ? sample_count : CLOCK_SYNC_WINDOW;
+    const clock_sample_t *best = &samples[0];
+    for (uint32_t i = 1; i < count; i++) {
+        if (samples[i].delay_us < best->delay_us) {
+            best = &samples[i];
+        }
+    }
+    offset_us = best->offset_us;
+    offset_delay_us = best->delay_us;
+    synced = true;
+}
+
+static void clock_on_pong(const char *topic, const uint8_t *payload, size_t len) {
+    (void)topic;
+    if (len != CLOCK_PONG_LEN) {
+        return;
+    }
+    uint64_t t4 = arrival_us();
+    uint32_t seq;
+    uint64_t t1, t2, t3;
+    memcpy(&seq, payload, sizeof(seq));
+    memcpy(&t1, payload + 4, sizeof(t1));
+    memcpy(&t2, payload + 12, sizeof(t2));
+    memcpy(&t3, payload + 20, sizeof(t3));
+    // Outro subscriber, ping já substituído ou respostas fora de ordem
+    if (seq != ping_seq || t1 != ping_t1 || t4 < t1 || t3 < t2) {
+        pongs_stale++;
+        return;
+    }
+    ping_t1 = 0; // Uma resposta por ping
+
+    int64_t round_trip = (int64_t)(t4 - t1) - (int64_t)(t3 - t2);
+    clock_sample_t *sample = &samples[sample_count % CLOCK_SYNC_WINDOW];
+    sample->delay_us = round_trip > 0 ? (uint32_t)round_trip : 0;
+    sample->offset_us = ((int64_t)(t2 - t1) + (int64_t)(t3 - t4)) / 2;
+    sample_count++;
+    pongs_used++;
+    clock_select_sample();
+}
+
+void clock_sync_serve(void) {
+    mqtt_comm_subscribe_with_handler(CLOCK_TOPIC_PING, clock_on_ping);
+}
+
+void clock_sync_start(void) {
+    mqtt_comm_subscribe_with_handler(CLOCK_TOPIC_PONG, clock_on_pong);
+}
+
+void clock_sync_poll(uint32_t now_ms) {
+    if (now_ms - last_ping_ms < CLOCK_SYNC_INTERVAL_MS || !mqtt_comm_is_connected()) {
+        return;
+    }
+    last_ping_ms = now_ms;
+
+    uint8_t ping[CLOCK_PING_LEN];
+    uint32_t seq = ping_seq + 1;
+    uint64_t t1 = to_us_since_boot(get_absolute_time());
+    memcpy(ping, &seq, sizeof(seq));
+    memcpy(ping + 4, &t1, sizeof(t1));
+    ping_seq = seq;
+    ping_t1 = t1;
+    mqtt_comm_publish(CLOCK_TOPIC_PING, ping, sizeof(ping));
+    pings_sent++;
+}
+
+bool clock_sync_to_remote(uint64_t local_us, uint64_t *remote_us) {
+    if (!synced) {
+        return false;
+    }
+    *remote_us = (uint64_t)((int64_t)local_us + offset_us);
+    return true;
+}
+
+void clock_sync_print_stats(void) {
+    // O offset de 64 bits é escrito no contexto do lwIP: lê as duas metades juntas
+    uint32_t irq = save_and_disable_interrupts();
+    int64_t offset = offset_us;
+    uint32_t delay = offset_delay_us;
+    restore_interrupts(irq);
+    if (synced) {
+        printf("relogio: offset %lld us (publisher - local), atraso da amostra %lu us\n", (long long)offset,
+               (unsigned long)delay);
+    } else {
+        printf("relogio: sem amostra (o publisher responde em %s)\n", CLOCK_TOPIC_PONG);
+    }
+    printf("pings: %lu enviados, %lu usados, %lu descartados; %lu respondidos\n", (unsigned long)pings_sent,
+           (unsigned long)pongs_used, (unsigned long)pongs_stale, (unsigned long)pings_served);
+}
@@ -0,0 +1,370 @@
+#include "include/compress.h"
+#include "include/frame.h"
+#include "include/nonce.h"
+#include "include/numfmt.h"
+#include "config/config.h"
+#include "pico/stdlib.h"
+#include <stdio.h>
+#include <string.h>
+
+#define COMPRESS_FLAG_KEY 0x08
+#define COMPRESS_DECIMALS_MASK 0x07
+#define COMPRESS_FIXED_LEN 13      // Maior leitura em texto: '-' + 10 dígitos + '.' + ';'
+#define COMPRESS_BENCH_READINGS 512
+#define COMPRESS_BENCH_STORE 8192  // Quadros comprimidos de uma rodada do benchmark
+#define COMPRESS_BENCH_DROP_EVERY 17 // Primo: não coincide com o intervalo dos quadros-chave
+
+typedef struct {
+    bool used;
+    bool synced;         // false depois de uma lacuna: só aceita quadro-chave
+    uint32_t topic_hash;
+    uint32_t epoch;      // Boot do publisher do último quadro aceito
+    uint32_t seq;
+    int32_t last_value;
+    uint64_t last_timestamp;
+    uint32_t last_use;   // LRU entre os tópicos
+} decoder_state_t;
+
+static const char *const status_names[COMPRESS_STATUS_COUNT] = {
+    "ok", "formato", "lacuna", "sem chave", "replay",
+};
+
+static decoder_state_t decoders[COMPRESS_MAX_TOPICS];
+static uint32_t decoder_clock = 0;
+static uint32_t status_counts[COMPRESS_STATUS_COUNT];
+
+/* --- Varints --- */
+static uint8_t *put_varint(uint8_t *p, uint64_t value) {
+    while (value >= 0x80) {
+        *p++ = (uint8_t)value | 0x80;
+        value >>= 7;
+    }
+    *p++ = (uint8_t)value;
+    return p;
+}
+
+// NULL se o varint estiver truncado ou passar de 64 bits
+static const uint8_t *get_varint(const uint8_t *p, const uint8_t *end, uint64_t *value) {
+    uint64_t result = 0;
+    for (unsigned shift = 0; shift < 64 && p < end; shift += 7) {
+        uint8_t byte = *p++;
+        result |= (uint64_t)(byte & 0x7F) << shift;
+        if (!(byte & 0x80)) {
+            *value = result;
+            return p;
+        }
+    }
+    return NULL;
+}
+
+// Diferenças em aritmética de 32 bits sem sinal: o decodificador refaz a mesma volta
+static uint32_t zigzag(uint32_t delta) {
+    return (delta << 1) ^ (uint32_t)((int32_t)delta >> 31);
+}
+
+static uint32_t unzigzag(uint32_t token) {
+    return (token >> 1) ^ (0u - (token & 1));
+}
+
+/* --- Amostras em ponto fixo --- */
+uint8_t compress_sample_decimals(const char *text) {
+    const char *dot = strchr(text, '.');
+    if (dot == NULL) {
+        return 0;
+    }
+    size_t decimals = strlen(dot + 1);
+    return decimals > COMPRESS_MAX_DECIMALS ? COMPRESS_MAX_DECIMALS : (uint8_t)decimals;
+}
+
+/* --- Codificador --- */
+size_t compress_encode(compress_encoder_t *encoder, compress_mode_t mode, const int32_t *values, size_t count,
+                       uint8_t decimals, uint64_t timestamp_us, uint8_t *out, size_t out_size) {
+    if (count == 0 || count > COMPRESS_MAX_READINGS || decimals > COMPRESS_MAX_DECIMALS ||
+        out_size < COMPRESS_MAX_LEN(count)) {
+        return 0;
+    }
+    bool key = mode == COMPRESS_STATELESS || !encoder->valid || encoder->decimals != decimals ||
+               encoder->since_key >= COMPRESS_KEYFRAME_INTERVAL || timestamp_us < encoder->last_timestamp;
+
+    uint8_t *p = out;
+    *p++ = COMPRESS_MARKER | (key ? COMPRESS_FLAG_KEY : 0) | decimals;
+    p = put_varint(p, nonce_boot());
+    p = put_varint(p, ++encoder->seq);
+    p = put_varint(p, count);
+    p = put_varint(p, key ? timestamp_us : timestamp_us - encoder->last_timestamp);
+
+    uint32_t previous = key ? 0 : (uint32_t)encoder->last_value;
+    for (size_t i = 0; i < count;) {
+        uint32_t delta = (uint32_t)values[i] - previous;
+        if (delta != 0) {
+            p = put_varint(p, zigzag(delta));
+            previous = (uint32_t)values[i++];
+            continue;
+        }
+        size_t run = 1; // Leitura repetida: um zero e o número de repetições extras
+        while (i + run < count && values[i + run] == values[i]) {
+            run++;
+        }
+        *p++ = 0;
+        p = put_varint(p, run - 1);
+        i += run;
+    }
+
+    encoder->valid = true;
+    encoder->decimals = decimals;
+    encoder->since_key = key ? 1 : encoder->since_key + 1;
+    encoder->last_value = values[count - 1];
+    encoder->last_timestamp = timestamp_us;
+    return (size_t)(p - out);
+}
+
+/* --- Decodificador --- */
+bool compress_is_packed(const uint8_t *data, size_t len) {
+    return len > 0 && (data[0] & 0xF0) == COMPRESS_MARKER;
+}
+
+static compress_status_t decode_with(decoder_state_t *state, const uint8_t *data, size_t len,
+                                     char *text, size_t text_size, size_t *text_len, size_t *readings) {
+    const uint8_t *p = data + 1;
+    const uint8_t *end = data + len;
+    uint64_t epoch, seq, count, timestamp;
+    if (!compress_is_packed(data, len) || (data[0] & COMPRESS_DECIMALS_MASK) > COMPRESS_MAX_DECIMALS ||
+        (p = get_varint(p, end, &epoch)) == NULL || epoch > UINT32_MAX || (p = get_varint(p, end, &seq)) == NULL || (p = get_varint(p, end, &count)) == NULL ||
+        (p = get_varint(p, end, &timestamp)) == NULL || count == 0 || count > COMPRESS_MAX_READINGS) {
+        return COMPRESS_ERR_FORMAT;
+    }
+    bool key = data[0] & COMPRESS_FLAG_KEY;
+    uint8_t decimals = data[0] & COMPRESS_DECIMALS_MASK;
+
+    bool same_epoch = state->used && epoch == state->epoch;
+    if (state->used && epoch < state->epoch) {
+        return COMPRESS_ERR_REPLAY; // Boot anterior do publisher
+    }
+    if (key) {
+        if (same_epoch && timestamp <= state->last_timestamp) {
+            return COMPRESS_ERR_REPLAY;
+        }
+    } else {
+        if (!state->synced || !same_epoch) {
+            return COMPRESS_ERR_UNSYNCED;
+        }
+        int32_t ahead = (int32_t)((uint32_t)seq - state->seq);
+        if (ahead <= 0) {
+            return COMPRESS_ERR_REPLAY;
+        }
+        if (ahead > 1) {
+            state->synced = false; // Mensagem perdida: a cadeia de deltas quebrou
+            return COMPRESS_ERR_GAP;
+        }
+        timestamp += state->last_timestamp;
+    }
+
+    int32_t values[COMPRESS_MAX_READINGS];
+    uint32_t previous = key ? 0 : (uint32_t)state->last_value;
+    for (size_t n = 0; n < count;) {
+        uint64_t token;
+        if ((p = get_varint(p, end, &token)) == NULL || token > UINT32_MAX) {
+            return COMPRESS_ERR_FORMAT;
+        }
+        if (token != 0) {
+            previous += unzigzag((uint32_t)token);
+            values[n++] = (int32_t)previous;
+            continue;
+        }
+        uint64_t repeats;
+        if ((p = get_varint(p, end, &repeats)) == NULL || repeats >= count - n) {
+            return COMPRESS_ERR_FORMAT;
+        }
+        for (uint64_t r = 0; r <= repeats; r++) {
+            values[n++] = (int32_t)previous;
+        }
+    }
+    if (p != end || text_size < count * COMPRESS_FIXED_LEN + 22) {
+        return COMPRESS_ERR_FORMAT;
+    }
+
+    char *out = text;
+    for (size_t n = 0; n < count; n++) {
+        if (n > 0) {
+            *out++ = ';';
+        }
+        out += numfmt_fixed(out, values[n], decimals);
+    }
+    *out++ = ',';
+    out += numfmt_u64(out, timestamp);
+    *text_len = (size_t)(out - text);
+    *readings = (size_t)count;
+
+    state->used = true;
+    state->synced = true;
+    state->epoch = (uint32_t)epoch;
+    state->seq = (uint32_t)seq;
+    state->last_value = values[count - 1];
+    state->last_timestamp = timestamp;
+    return COMPRESS_OK;
+}
+
+static decoder_state_t *decoder_for(uint32_t topic_hash) {
+    decoder_state_t *slot = &decoders[0];
+    for (size_t i = 0; i < COMPRESS_MAX_TOPICS; i++) {
+        if (decoders[i].used && decoders[i].topic_hash == topic_hash) {
+            return &decoders[i];
+        }
+        if (!decoders[i].used) {
+            if (slot->used) {
+                slot = &decoders[i];
+            }
+        } else if (slot->used && decoders[i].last_use < slot->last_use) {
+            slot = &decoders[i];
+        }
+    }
+    memset(slot, 0, sizeof(*slot)); // Tópico novo (ou o menos recente sai): espera um quadro-chave
+    slot->topic_hash = topic_hash;
+    return slot;
+}
+
+compress_status_t compress_decode(const char *topic, const uint8_t *data, size_t len,
+                                  char *text, size_t text_size, size_t *text_len) {
+    decoder_state_t *state = decoder_for(frame_topic_hash(topic));
+    state->last_use = ++decoder_clock;
+    size_t readings;
+    compress_status_t status = decode_with(state, data, len, text, text_size, text_len, &readings);
+    status_counts[status]++;
+    return status;
+}
+
+/* --- Benchmark --- */
+typedef struct {
+    const char *name;
+    uint8_t decimals;
+    uint32_t period_ms;
+} bench_trace_t;
+
+static const bench_trace_t bench_traces[] = {
+    {"fixo", 1, 5000},        // stream_source_fixed: "26.5" sempre
+    {"temperatura", 2, 1000}, // Sensor interno: leitura do ADC com ruído e deriva lenta
+    {"joystick", 0, 200},     // Parado no centro com ruído, movido de vez em quando
+    {"contador", 0, 100},     // Pior caso para RLE: muda a cada leitura
+};
+
+static uint32_t bench_rng(uint32_t *state) {
+    uint32_t x = *state; // xorshift32: trace reprodutível
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    return *state = x;
+}
+
+static int32_t bench_sample(size_t trace, uint32_t i, uint32_t *rng) {
+    switch (trace) {
+    case 0:
+        return 265;
+    case 1: {
+        // Mesma conversão de stream_source_chip_temp; 1 LSB do ADC vale ~0,47 °C
+        uint32_t raw = 876 + i / 128 + (bench_rng(rng) % 8 == 0 ? 1 : 0);
+        uint32_t millivolts = raw * 3300u / 4096u;
+        return 2700 - ((int32_t)millivolts - 706) * 100000 / 1721;
+    }
+    case 2: {
+        uint32_t phase = i % 256;
+        if (phase >= 200 && phase < 230) {
+            uint32_t moved = 2048 + (phase - 200) * 200;
+            return moved > 4095 ? 4095 : (int32_t)moved;
+        }
+        return 2046 + (int32_t)(bench_rng(rng) % 5);
+    }
+    default:
+        return (int32_t)i + 1;
+    }
+}
+
+// Tamanho do mesmo lote no formato texto "v1;...;vN,timestamp"
+static size_t bench_text_len(const int32_t *values, size_t count, uint8_t decimals, uint64_t timestamp_us) {
+    char scratch[NUMFMT_U64_LEN + 1];
+    size_t len = count; // N - 1 separadores + a vírgula
+    for (size_t i = 0; i < count; i++) {
+        len += numfmt_fixed(scratch, values[i], decimals);
+    }
+    return len + numfmt_u64(scratch, timestamp_us);
+}
+
+static void bench_round(size_t trace, size_t batch, compress_mode_t mode) {
+    static int32_t values[COMPRESS_BENCH_READINGS];
+    static uint64_t timestamps[COMPRESS_BENCH_READINGS];
+    static uint8_t store[COMPRESS_BENCH_STORE];
+    static uint16_t lengths[COMPRESS_BENCH_READINGS];
+    const bench_trace_t *t = &bench_traces[trace];
+    size_t messages = COMPRESS_BENCH_READINGS / batch;
+
+    uint32_t rng = 0x2545F491u;
+    for (uint32_t i = 0; i < COMPRESS_BENCH_READINGS; i++) {
+        values[i] = bench_sample(trace, i, &rng);
+    }
+    size_t text_bytes = 0;
+    for (size_t m = 0; m < messages; m++) {
+        // Publicado na última amostra do lote, com jitter de até 1 ms
+        timestamps[m] = 10000000ull + ((uint64_t)(m + 1) * batch * t->period_ms * 1000) + bench_rng(&rng) % 1000;
+        text_bytes += bench_text_len(&values[m * batch], batch, t->decimals, timestamps[m]);
+    }
+
+    compress_encoder_t encoder = {0};
+    size_t used = 0;
+    uint32_t start_us = time_us_32();
+    for (size_t m = 0; m < messages; m++) {
+        size_t len = compress_encode(&encoder, mode, &values[m * batch], batch, t->decimals, timestamps[m],
+                                     store + used, sizeof(store) - used);
+        lengths[m] = (uint16_t)len;
+        used += len;
+    }
+    uint32_t encode_us = time_us_32() - start_us;
+
+    char text[COMPRESS_MAX_READINGS * COMPRESS_FIXED_LEN + 22];
+    size_t text_len, readings;
+    decoder_state_t decoder = {0};
+    size_t offset = 0;
+    start_us = time_us_32();
+    for (size_t m = 0; m < messages; m++) {
+        decode_with(&decoder, store + offset, lengths[m], text, sizeof(text), &text_len, &readings);
+        offset += lengths[m];
+    }
+    uint32_t decode_us = time_us_32() - start_us;
+
+    // Perda de 1 em cada COMPRESS_BENCH_DROP_EVERY mensagens: leituras descartadas além das perdidas
+    memset(&decoder, 0, sizeof(decoder));
+    size_t delivered = 0, decoded = 0;
+    offset = 0;
+    for (size_t m = 0; m < messages; m++) {
+        if (m % COMPRESS_BENCH_DROP_EVERY != COMPRESS_BENCH_DROP_EVERY - 1) {
+            delivered += batch;
+            if (decode_with(&decoder, store + offset, lengths[m], text, sizeof(text), &text_len, &readings) ==
+                COMPRESS_OK) {
+                decoded += readings;
+            }
+        }
+        offset += lengths[m];
+    }
+
+    uint32_t ratio_tenths = used ? (uint32_t)(text_bytes * 10 / used) : 0;
+    printf("%-11s lote %u %-9s %5lu B -> %5lu B (%2lu.%lux)  cod %5lu ns  dec %5lu ns/leitura  perda: +%lu\n",
+           t->name, (unsigned)batch, mode == COMPRESS_DELTA ? "delta" : "sem estado", (unsigned long)text_bytes,
+           (unsigned long)used, (unsigned long)(ratio_tenths / 10), (unsigned long)(ratio_tenths % 10),
+           (unsigned long)((uint64_t)encode_us * 1000 / COMPRESS_BENCH_READINGS),
+           (unsigned long)((uint64_t)decode_us * 1000 / COMPRESS_BENCH_READINGS),
+           (unsigned long)(delivered - decoded));
+}
+
+void compress_benchmark(void) {
+    printf("descompressao:");
+    for (int i = 0; i < COMPRESS_STATUS_COUNT; i++) {
+        printf(" %lu %s%s", (unsigned long)status_counts[i], status_names[i], i + 1 < COMPRESS_STATUS_COUNT ? "," : "\n");
+    }
+    printf("%u leituras por rodada; perda: leituras descartadas a mais com 1 de cada %u mensagens perdida\n",
+           COMPRESS_BENCH_READINGS, COMPRESS_BENCH_DROP_EVERY);
+    static const size_t batches[] = {1, 8};
+    for (size_t t = 0; t < sizeof(bench_traces) / sizeof(bench_traces[0]); t++) {
+        for (size_t b = 0; b < sizeof(batches) / sizeof(batches[0]); b++) {
+            bench_round(t, batches[b], COMPRESS_STATELESS);
+            bench_round(t, batches[b], COMPRESS_DELTA);
+        }
+    }
+}
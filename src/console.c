@@ -0,0 +1,74 @@
+#include "include/console.h"
+#include "include/net_stats.h"
+#include "include/trace.h"
+#include "include/log.h"
+#include "include/sha256_backend.h"
+#include "include/crypto_bench.h"
+#include "include/key_manager.h"
+#include "include/mac.h"
+#include "include/frame.h"
+#include "include/prefilter.h"
+#include "include/dispatch.h"
+#include "include/stream.h"
+#include "include/compress.h"
+#include "include/journal.h"
+#include "include/pool.h"
+#include "include/encoding.h"
+#include "include/numfmt.h"
+#include "include/joystick.h"
+#include "include/latency.h"
+#include "pico/stdlib.h"
+#include <stdio.h>
+
+typedef struct {
+    char key;                // Caractere que dispara o comando
+    const char *description; // Texto exibido pelo comando de ajuda
+    void (*run)(void);
+} console_command_t;
+
+static void console_print_help(void);
+
+static const console_command_t commands[] = {
+    {'s', "estatisticas de memoria do lwIP", net_stats_print},
+    {'h', "benchmark do SHA-256 por backend (ciclos/byte)", sha256_backend_benchmark},
+    {'c', "benchmark AES-256-GCM x ChaCha20-Poly1305 (setkey e us/msg)", crypto_bench_aead},
+    {'l', "estatisticas do log diferido", log_print_stats},
+    {'a', "tabela de MACs: bytes no ar e us por mensagem", mac_benchmark},
+    {'f', "frames AEAD recusados por motivo e CPU poupada", frame_print_stats},
+    {'p', "pre-filtro: recusas por motivo, CPU e latencia das aceitas", prefilter_print_stats},
+    {'d', "despacho por modo e custo do roteamento (ns/msg)", dispatch_print_stats},
+    {'m', "streams de publicacao: enviadas, falhas e atrasos", stream_print_stats},
+    {'b', "vazao do motor de streams com 1, 10 e 50 streams", stream_benchmark},
+    {'z', "compressao delta/RLE: taxa, ns/leitura e perda por lacuna", compress_benchmark},
+    {'j', "journal na flash: pendentes, descartes e vazao", journal_print_stats},
+    {'J', "benchmark de gravacao e reenvio do journal (so com o journal vazio)", journal_benchmark},
+    {'o', "pool de buffers: em uso, pico e falhas por classe", pool_print_stats},
+    {'O', "benchmark do pool x malloc/free (ns por alocacao)", pool_benchmark},
+    {'x', "hex/base64 por tabela x laco de sprintf (ns/byte, 16 B a 1 KB)", encoding_benchmark},
+    {'n', "numeros das mensagens: numfmt x snprintf/sscanf (ciclos/chamada)", numfmt_benchmark},
+    {'i', "joystick e botoes: rodadas do ADC, CPU na IRQ e fila de eventos", joystick_print_stats},
+    {'y', "latencia de ponta a ponta: offset do relogio e percentis por modo", latency_print_stats},
+    {'k', "sessao de chaves atual e tempo de rotacao", key_manager_print_stats},
+    {'r', "anuncia uma nova sessao de chaves e a aplica se o anuncio sair", key_manager_announce_next},
+    {'t', "despeja o rastreamento dos estagios (tools/trace_histogram.py)", trace_dump},
+    {'?', "lista os comandos", console_print_help},
+};
+
+static void console_print_help(void) {
+    for (size_t i = 0; i < sizeof(commands) / sizeof(commands[0]); i++) {
+        printf("  %c - %s\n", commands[i].key, commands[i].description);
+    }
+}
+
+void console_poll(void) {
+    int c = getchar_timeout_us(0);
+    if (c == PICO_ERROR_TIMEOUT) {
+        return;
+    }
+    for (size_t i = 0; i < sizeof(commands) / sizeof(commands[0]); i++) {
+        if (commands[i].key == (char)c) {
+            commands[i].run();
+            return;
+        }
+    }
+}
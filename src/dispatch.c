@@ -0,0 +1,123 @@
+#include "include/dispatch.h"
+#include "include/prefilter.h"
+#include "pico/stdlib.h"
+#include "mbedtls/gcm.h"
+#include "mbedtls/chachapoly.h"
+#include <stdio.h>
+#include <string.h>
+
+#define DISPATCH_TABLE_SIZE 16        // Um decodificador por valor do nibble baixo do tipo
+#define DISPATCH_BENCH_MESSAGES 20000 // Mensagens roteadas pelo benchmark
+
+typedef struct {
+    uint32_t count;
+    uint64_t total_us;
+} dispatch_stat_t;
+
+static mqtt_message_handler_t table[DISPATCH_TABLE_SIZE];
+static dispatch_stat_t stats[DISPATCH_TABLE_SIZE];
+static uint32_t unknown_count = 0;
+
+static inline mqtt_message_handler_t lookup(mqtt_message_handler_t const *routes, const uint8_t *payload,
+                                            size_t len) {
+    if (len < FRAME_TYPE_LEN || (payload[0] >> 4) != FRAME_VERSION) {
+        return NULL;
+    }
+    return routes[payload[0] & 0x0F];
+}
+
+void dispatch_set_routes(const dispatch_route_t *routes, size_t count) {
+    memset(table, 0, sizeof(table));
+    for (size_t i = 0; i < count; i++) {
+        table[routes[i].kind & 0x0F] = routes[i].decode;
+    }
+}
+
+void dispatch_message(const char *topic, const uint8_t *payload, size_t len) {
+    mqtt_message_handler_t decode = lookup(table, payload, len);
+    if (decode == NULL) {
+        unknown_count++;
+        prefilter_reject(PREFILTER_HEADER);
+        return;
+    }
+    dispatch_stat_t *stat = &stats[payload[0] & 0x0F];
+    uint32_t start_us = time_us_32();
+    decode(topic, payload, len);
+    stat->total_us += time_us_32() - start_us;
+    stat->count++;
+}
+
+/* --- Benchmark do roteamento --- */
+static volatile uint32_t bench_sink;
+
+static void bench_decode(const char *topic, const uint8_t *payload, size_t len) {
+    bench_sink += len;
+}
+
+// Custo de um setkey de cada AEAD, pago a cada troca de modo se os contextos não ficassem quentes
+static void bench_setkey(uint32_t *gcm_us, uint32_t *chacha_us) {
+    static const uint8_t key[32] = {0};
+    mbedtls_gcm_context gcm;
+    mbedtls_chachapoly_context chachapoly;
+    mbedtls_gcm_init(&gcm);
+    mbedtls_chachapoly_init(&chachapoly);
+
+    uint32_t start_us = time_us_32();
+    mbedtls_gcm_setkey(&gcm, MBEDTLS_CIPHER_ID_AES, key, 256);
+    *gcm_us = time_us_32() - start_us;
+    start_us = time_us_32();
+    mbedtls_chachapoly_setkey(&chachapoly, key);
+    *chacha_us = time_us_32() - start_us;
+
+    mbedtls_gcm_free(&gcm);
+    mbedtls_chachapoly_free(&chachapoly);
+}
+
+static void dispatch_benchmark(void) {
+    mqtt_message_handler_t bench_table[DISPATCH_TABLE_SIZE] = {0};
+    uint8_t messages[FRAME_KIND_COUNT - 1][8] = {{0}};
+    for (int kind = 1; kind < FRAME_KIND_COUNT; kind++) {
+        bench_table[kind] = bench_decode;
+        messages[kind - 1][0] = FRAME_TYPE(kind);
+    }
+    mqtt_message_handler_t volatile direct = bench_decode; // Impede o inline na referência
+
+    // Referência: a mesma chamada indireta, sem a consulta ao tipo
+    uint64_t start_us = time_us_64();
+    for (int i = 0; i < DISPATCH_BENCH_MESSAGES; i++) {
+        direct("", messages[i % (FRAME_KIND_COUNT - 1)], sizeof(messages[0]));
+    }
+    uint64_t direct_us = time_us_64() - start_us;
+
+    // Modos intercalados a cada mensagem
+    start_us = time_us_64();
+    for (int i = 0; i < DISPATCH_BENCH_MESSAGES; i++) {
+        const uint8_t *msg = messages[i % (FRAME_KIND_COUNT - 1)];
+        mqtt_message_handler_t decode = lookup(bench_table, msg, sizeof(messages[0]));
+        if (decode != NULL) {
+            decode("", msg, sizeof(messages[0]));
+        }
+    }
+    uint64_t dispatch_us = time_us_64() - start_us;
+
+    uint32_t direct_ns = (uint32_t)(direct_us * 1000 / DISPATCH_BENCH_MESSAGES);
+    uint32_t dispatch_ns = (uint32_t)(dispatch_us * 1000 / DISPATCH_BENCH_MESSAGES);
+    printf("roteamento: %lu ns/msg (chamada direta %lu ns, custo do despacho %ld ns)\n",
+           (unsigned long)dispatch_ns, (unsigned long)direct_ns, (long)dispatch_ns - (long)direct_ns);
+
+    uint32_t gcm_us, chacha_us;
+    bench_setkey(&gcm_us, &chacha_us);
+    printf("setkey evitado por troca de modo: AES-256-GCM %lu us, ChaCha20-Poly1305 %lu us\n",
+           (unsigned long)gcm_us, (unsigned long)chacha_us);
+}
+
+void dispatch_print_stats(void) {
+    for (int kind = 1; kind < FRAME_KIND_COUNT; kind++) {
+        const dispatch_stat_t *stat = &stats[kind];
+        printf("despacho %-8s %8lu  media %5lu us%s\n", frame_kind_name((frame_kind_t)kind),
+               (unsigned long)stat->count, (unsigned long)(stat->count ? stat->total_us / stat->count : 0),
+               table[kind] ? "" : "  (sem rota)");
+    }
+    printf("despacho %-8s %8lu\n", "desconh.", (unsigned long)unknown_count);
+    dispatch_benchmark();
+}
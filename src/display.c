@@ -1,5 +1,6 @@
 #include "display.h"
 #include "config/config.h"
+#include "trace.h"
 #include "pico/stdlib.h"
 #include "hardware/i2c.h"
 #include <stdio.h>
@@ -59,7 +60,23 @@ void display_text_in_line(const char *message, int line, bool is_publisher)
 
     // Exibir mensagem
     ssd1306_draw_string(&display, 5, 15 + ((line - 1) * OLED_LINE_HEIGHT), 1, message);
+    TRACE_BEGIN(TRACE_DISPLAY_FLUSH);
     ssd1306_show(&display);
+    TRACE_END(TRACE_DISPLAY_FLUSH);
+}
+
+/**
+ * @brief Escreve no rodapé (abaixo da linha 4) sem limpar o restante da tela.
+ * @param message Texto do rodapé; substitui o anterior.
+ */
+void display_footer(const char *message)
+{
+    int y_pos = 15 + 4 * OLED_LINE_HEIGHT;
+    ssd1306_clear_square(&display, 0, y_pos - 1, OLED_WIDTH, OLED_HEIGHT - y_pos + 1);
+    ssd1306_draw_string(&display, 5, y_pos, 1, message);
+    TRACE_BEGIN(TRACE_DISPLAY_FLUSH);
+    ssd1306_show(&display);
+    TRACE_END(TRACE_DISPLAY_FLUSH);
 }
 
 /**
@@ -96,10 +113,22 @@ void draw_menu(const char *title, const char **items, int item_count, int select
     ssd1306_draw_string(&display, (OLED_WIDTH - (strlen(title) * 6 /* largura da fonte */)) / 2, 0, 1, title);
     ssd1306_draw_line(&display, 0, OLED_LINE_HEIGHT - 2, OLED_WIDTH, OLED_LINE_HEIGHT - 2); // Linha separadora
 
+    // Janela de itens visíveis: rola para manter o item selecionado na tela
+    int first_visible = 0;
+    if (selected_idx >= OLED_MENU_VISIBLE_ITEMS)
+    {
+        first_visible = selected_idx - OLED_MENU_VISIBLE_ITEMS + 1;
+    }
+    int last_visible = first_visible + OLED_MENU_VISIBLE_ITEMS;
+    if (last_visible > item_count)
+    {
+        last_visible = item_count;
+    }
+
     int y_start = OLED_LINE_HEIGHT + 4; // Posição Y inicial para os itens
-    for (int i = 0; i < item_count; ++i)
+    for (int i = first_visible; i < last_visible; ++i)
     {
-        draw_menu_item(items[i], y_start + (i * (OLED_LINE_HEIGHT + 3 /* espaçamento */)), i == selected_idx);
+        draw_menu_item(items[i], y_start + ((i - first_visible) * (OLED_LINE_HEIGHT + 3 /* espaçamento */)), i == selected_idx);
     }
     ssd1306_show(&display); // Atualiza o display
 }
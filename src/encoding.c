@@ -0,0 +1,263 @@
+#include "include/encoding.h"
+#include "pico/stdlib.h"
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// O M0+ (RP2040) não faz acesso desalinhado: lá o hex vai um byte por vez
+#ifndef ENCODING_WORD_AT_A_TIME
+#if defined(__ARM_ARCH_6M__)
+#define ENCODING_WORD_AT_A_TIME 0
+#else
+#define ENCODING_WORD_AT_A_TIME 1
+#endif
+#endif
+
+#define ENCODING_BENCH_MAX 1024      // Maior entrada do benchmark
+#define ENCODING_BENCH_BYTES 32768u  // Bytes processados por medição
+
+// "00" "01" ... "ff": o par do byte b começa em hex_pairs[2 * b]
+static const char hex_pairs[512] =
+    "000102030405060708090a0b0c0d0e0f101112131415161718191a1b1c1d1e1f"
+    "202122232425262728292a2b2c2d2e2f303132333435363738393a3b3c3d3e3f"
+    "404142434445464748494a4b4c4d4e4f505152535455565758595a5b5c5d5e5f"
+    "606162636465666768696a6b6c6d6e6f707172737475767778797a7b7c7d7e7f"
+    "808182838485868788898a8b8c8d8e8f909192939495969798999a9b9c9d9e9f"
+    "a0a1a2a3a4a5a6a7a8a9aaabacadaeafb0b1b2b3b4b5b6b7b8b9babbbcbdbebf"
+    "c0c1c2c3c4c5c6c7c8c9cacbcccdcecfd0d1d2d3d4d5d6d7d8d9dadbdcdddedf"
+    "e0e1e2e3e4e5e6e7e8e9eaebecedeeeff0f1f2f3f4f5f6f7f8f9fafbfcfdfeff";
+
+// Valor de cada caractere hex; -1 = inválido
+static const int8_t hex_values[256] = {
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+     0,  1,  2,  3,  4,  5,  6,  7,  8,  9, -1, -1, -1, -1, -1, -1,
+    -1, 10, 11, 12, 13, 14, 15, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    -1, 10, 11, 12, 13, 14, 15, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+};
+
+static const char base64_alphabet[64] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+
+// Valor de cada caractere base64; -1 = inválido (inclusive '=', tratado à parte no último grupo)
+static const int8_t base64_values[256] = {
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, 62, -1, -1, -1, 63,
+    52, 53, 54, 55, 56, 57, 58, 59, 60, 61, -1, -1, -1, -1, -1, -1,
+    -1,  0,  1,  2,  3,  4,  5,  6,  7,  8,  9, 10, 11, 12, 13, 14,
+    15, 16, 17, 18, 19, 20, 21, 22, 23, 24, 25, -1, -1, -1, -1, -1,
+    -1, 26, 27, 28, 29, 30, 31, 32, 33, 34, 35, 36, 37, 38, 39, 40,
+    41, 42, 43, 44, 45, 46, 47, 48, 49, 50, 51, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+};
+
+size_t hex_encode(const uint8_t *data, size_t len, char *out) {
+    size_t i = 0;
+#if ENCODING_WORD_AT_A_TIME
+    for (; i + 4 <= len; i += 4) {
+        uint16_t pairs[4];
+        memcpy(&pairs[0], &hex_pairs[2 * data[i]], 2);
+        memcpy(&pairs[1], &hex_pairs[2 * data[i + 1]], 2);
+        memcpy(&pairs[2], &hex_pairs[2 * data[i + 2]], 2);
+        memcpy(&pairs[3], &hex_pairs[2 * data[i + 3]], 2);
+        memcpy(out + 2 * i, pairs, sizeof(pairs)); // 8 caracteres em uma gravação
+    }
+#endif
+    for (; i < len; i++) {
+        out[2 * i] = hex_pairs[2 * data[i]];
+        out[2 * i + 1] = hex_pairs[2 * data[i] + 1];
+    }
+    out[2 * len] = '\0';
+    return 2 * len;
+}
+
+int hex_decode(const char *text, size_t text_len, uint8_t *out, size_t out_size) {
+    size_t len = text_len / 2;
+    if (text_len % 2 != 0 || len > out_size) {
+        return -1;
+    }
+    // Sem desvio por caractere: os inválidos (-1) são acumulados e conferidos no fim
+    int8_t invalid = 0;
+    for (size_t i = 0; i < len; i++) {
+        int8_t high = hex_values[(uint8_t)text[2 * i]];
+        int8_t low = hex_values[(uint8_t)text[2 * i + 1]];
+        invalid |= high | low;
+        out[i] = (uint8_t)(((high & 0x0F) << 4) | (low & 0x0F));
+    }
+    return invalid < 0 ? -1 : (int)len;
+}
+
+size_t base64_encode(const uint8_t *data, size_t len, char *out) {
+    char *start = out;
+    size_t i = 0;
+    for (; i + 3 <= len; i += 3) {
+        uint32_t group = ((uint32_t)data[i] << 16) | ((uint32_t)data[i + 1] << 8) | data[i + 2];
+        out[0] = base64_alphabet[group >> 18];
+        out[1] = base64_alphabet[(group >> 12) & 0x3F];
+        out[2] = base64_alphabet[(group >> 6) & 0x3F];
+        out[3] = base64_alphabet[group & 0x3F];
+        out += 4;
+    }
+    if (i < len) {
+        uint32_t group = (uint32_t)data[i] << 16;
+        if (i + 1 < len) {
+            group |= (uint32_t)data[i + 1] << 8;
+        }
+        out[0] = base64_alphabet[group >> 18];
+        out[1] = base64_alphabet[(group >> 12) & 0x3F];
+        out[2] = i + 1 < len ? base64_alphabet[(group >> 6) & 0x3F] : '=';
+        out[3] = '=';
+        out += 4;
+    }
+    *out = '\0';
+    return (size_t)(out - start);
+}
+
+int base64_decode(const char *text, size_t text_len, uint8_t *out, size_t out_size) {
+    if (text_len == 0) {
+        return 0;
+    }
+    if (text_len % 4 != 0) {
+        return -1;
+    }
+    size_t padding = text[text_len - 1] == '=' ? (text[text_len - 2] == '=' ? 2 : 1) : 0;
+    size_t len = text_len / 4 * 3 - padding;
+    if (len > out_size) {
+        return -1;
+    }
+
+    int8_t invalid = 0;
+    size_t written = 0;
+    for (size_t i = 0; i < text_len; i += 4) {
+        bool last = i + 4 == text_len;
+        int8_t a = base64_values[(uint8_t)text[i]];
+        int8_t b = base64_values[(uint8_t)text[i + 1]];
+        int8_t c = (last && padding == 2) ? 0 : base64_values[(uint8_t)text[i + 2]];
+        int8_t d = (last && padding >= 1) ? 0 : base64_values[(uint8_t)text[i + 3]];
+        invalid |= a | b | c | d;
+        uint32_t group = ((uint32_t)(a & 0x3F) << 18) | ((uint32_t)(b & 0x3F) << 12) |
+                         ((uint32_t)(c & 0x3F) << 6) | (uint32_t)(d & 0x3F);
+        size_t count = last ? 3 - padding : 3;
+        out[written] = (uint8_t)(group >> 16);
+        if (count > 1) {
+            out[written + 1] = (uint8_t)(group >> 8);
+        }
+        if (count > 2) {
+            out[written + 2] = (uint8_t)group;
+        }
+        written += count;
+    }
+    return invalid < 0 ? -1 : (int)len;
+}
+
+/* --- Benchmark --- */
+typedef struct {
+    uint8_t data[ENCODING_BENCH_MAX];
+    char hex[HEX_ENCODED_LEN(ENCODING_BENCH_MAX)];
+    char base64[BASE64_ENCODED_LEN(ENCODING_BENCH_MAX)];
+    char text[HEX_ENCODED_LEN(ENCODING_BENCH_MAX)];
+    uint8_t bytes[ENCODING_BENCH_MAX];
+} bench_buffers_t;
+
+static bench_buffers_t *bench;
+
+// Laço usado antes nos modos XOR e HMAC
+static void run_sprintf_hex(size_t len) {
+    for (size_t i = 0; i < len; ++i) {
+        sprintf(bench->text + (i * 2), "%02x", bench->data[i]);
+    }
+}
+
+static void run_hex_encode(size_t len) {
+    hex_encode(bench->data, len, bench->text);
+}
+
+static void run_hex_decode(size_t len) {
+    hex_decode(bench->hex, 2 * len, bench->bytes, sizeof(bench->bytes));
+}
+
+static void run_base64_encode(size_t len) {
+    base64_encode(bench->data, len, bench->text);
+}
+
+static void run_base64_decode(size_t len) {
+    base64_decode(bench->base64, 4 * ((len + 2) / 3), bench->bytes, sizeof(bench->bytes));
+}
+
+static const struct {
+    const char *name;
+    void (*run)(size_t len);
+} bench_rounds[] = {
+    {"sprintf", run_sprintf_hex},
+    {"hex", run_hex_encode},
+    {"hex->bin", run_hex_decode},
+    {"base64", run_base64_encode},
+    {"b64->bin", run_base64_decode},
+};
+
+void encoding_benchmark(void) {
+    static const size_t sizes[] = {16, 64, 256, ENCODING_BENCH_MAX};
+
+    // Buffers só durante o benchmark (~7 KB), fora do pool de mensagens
+    bench = malloc(sizeof(bench_buffers_t));
+    if (bench == NULL) {
+        printf("Sem memoria para o benchmark de codificacao\n");
+        return;
+    }
+    for (size_t i = 0; i < ENCODING_BENCH_MAX; i++) {
+        bench->data[i] = (uint8_t)(i * 167 + 13);
+    }
+
+    printf("ns/byte  ");
+    for (size_t r = 0; r < sizeof(bench_rounds) / sizeof(bench_rounds[0]); r++) {
+        printf("%10s", bench_rounds[r].name);
+    }
+    printf("\n");
+    for (size_t s = 0; s < sizeof(sizes) / sizeof(sizes[0]); s++) {
+        size_t len = sizes[s];
+        hex_encode(bench->data, len, bench->hex);
+        base64_encode(bench->data, len, bench->base64);
+        uint32_t reps = ENCODING_BENCH_BYTES / len;
+
+        printf("%4u B   ", (unsigned)len);
+        for (size_t r = 0; r < sizeof(bench_rounds) / sizeof(bench_rounds[0]); r++) {
+            uint64_t start_us = time_us_64();
+            for (uint32_t n = 0; n < reps; n++) {
+                bench_rounds[r].run(len);
+            }
+            uint64_t elapsed_us = time_us_64() - start_us;
+            uint32_t tenths_ns = (uint32_t)(elapsed_us * 10000 / ((uint64_t)reps * len));
+            printf("%8lu.%lu", (unsigned long)(tenths_ns / 10), (unsigned long)(tenths_ns % 10));
+        }
+        printf("\n");
+    }
+
+    // Confere a ida e a volta na maior entrada
+    int hex_len = hex_decode(bench->hex, 2 * ENCODING_BENCH_MAX, bench->bytes, sizeof(bench->bytes));
+    bool hex_ok = hex_len == ENCODING_BENCH_MAX && memcmp(bench->bytes, bench->data, ENCODING_BENCH_MAX) == 0;
+    int base64_len = base64_decode(bench->base64, strlen(bench->base64), bench->bytes, sizeof(bench->bytes));
+    bool base64_ok = base64_len == ENCODING_BENCH_MAX && memcmp(bench->bytes, bench->data, ENCODING_BENCH_MAX) == 0;
+    printf("Ida e volta: hex %s, base64 %s\n", hex_ok ? "ok" : "FALHOU", base64_ok ? "ok" : "FALHOU");
+
+    free(bench);
+    bench = NULL;
+}
@@ -0,0 +1,234 @@
+#include "include/frame.h"
+#include "include/key_manager.h"
+#include "include/xor_cipher.h"
+#include "config/config.h"
+#include "pico/stdlib.h"
+#include <stdio.h>
+#include <string.h>
+
+#ifdef FRAME_ALLOWED_SENDERS
+// Publishers aceitos (ID do nonce.c, impresso no boot)
+static const uint32_t allowed_senders[] = {FRAME_ALLOWED_SENDERS};
+#define ALLOWED_SENDER_COUNT (sizeof(allowed_senders) / sizeof(allowed_senders[0]))
+#endif
+
+static const char *const kind_names[FRAME_KIND_COUNT] = {
+    "?", "aes-gcm", "chacha", "normal", "xor", "mac",
+};
+
+static const char *const status_names[FRAME_STATUS_COUNT] = {
+    "ok", "curto", "tipo", "topico", "remetente", "replay", "tag", "cripto",
+};
+
+typedef struct {
+    uint32_t count;
+    uint64_t total_us;
+} frame_stat_t;
+
+static frame_stat_t stats[FRAME_STATUS_COUNT];
+
+static void write_u32_be(uint8_t *out, uint32_t value) {
+    out[0] = (uint8_t)(value >> 24);
+    out[1] = (uint8_t)(value >> 16);
+    out[2] = (uint8_t)(value >> 8);
+    out[3] = (uint8_t)value;
+}
+
+static uint32_t read_u32_be(const uint8_t *in) {
+    return ((uint32_t)in[0] << 24) | ((uint32_t)in[1] << 16) | ((uint32_t)in[2] << 8) | in[3];
+}
+
+uint32_t frame_topic_hash(const char *topic) {
+    uint32_t hash = 2166136261u;
+    while (*topic) {
+        hash ^= (uint8_t)*topic++;
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+static bool sender_allowed(uint32_t sender) {
+#ifdef FRAME_ALLOWED_SENDERS
+    for (size_t i = 0; i < ALLOWED_SENDER_COUNT; i++) {
+        if (allowed_senders[i] == sender) {
+            return true;
+        }
+    }
+    return false;
+#else
+    (void)sender; // Sem lista: qualquer remetente
+    return true;
+#endif
+}
+
+static int aead_encrypt(frame_aead_t aead, key_slot_t *keys, const uint8_t *header,
+                        const uint8_t *plain, size_t len, uint8_t *ct, uint8_t *tag) {
+    const uint8_t *nonce = header + 1;
+    if (aead == FRAME_AEAD_AES_GCM) {
+        return mbedtls_gcm_crypt_and_tag(&keys->gcm, MBEDTLS_GCM_ENCRYPT, len, nonce, NONCE_LEN,
+                                         header, FRAME_HEADER_LEN, plain, ct, FRAME_TAG_LEN, tag);
+    }
+    return mbedtls_chachapoly_encrypt_and_tag(&keys->chachapoly, len, nonce, header, FRAME_HEADER_LEN,
+                                              plain, ct, tag);
+}
+
+// Retorna 0, ou 1 para tag inválida, ou o erro do mbedTLS
+static int aead_decrypt(frame_aead_t aead, key_slot_t *keys, const uint8_t *header,
+                        const uint8_t *tag, const uint8_t *ct, size_t len, uint8_t *plain) {
+    const uint8_t *nonce = header + 1;
+    int ret;
+    if (aead == FRAME_AEAD_AES_GCM) {
+        ret = mbedtls_gcm_auth_decrypt(&keys->gcm, len, nonce, NONCE_LEN, header, FRAME_HEADER_LEN,
+                                       tag, FRAME_TAG_LEN, ct, plain);
+        return ret == MBEDTLS_ERR_GCM_AUTH_FAILED ? 1 : ret;
+    }
+    ret = mbedtls_chachapoly_auth_decrypt(&keys->chachapoly, len, nonce, header, FRAME_HEADER_LEN,
+                                          tag, ct, plain);
+    return ret == MBEDTLS_ERR_CHACHAPOLY_AUTH_FAILED ? 1 : ret;
+}
+
+int frame_seal(frame_aead_t aead, const char *topic, const uint8_t *plain, size_t plain_len,
+               uint8_t *out, size_t out_size, size_t *out_len, nonce_seq_t *seq) {
+    if (FRAME_OVERHEAD + plain_len > out_size) {
+        return -1;
+    }
+    out[0] = FRAME_TYPE(aead);
+    if (nonce_next(out + 1, seq) != 0) {
+        return -1;
+    }
+    write_u32_be(out + 1 + NONCE_LEN, frame_topic_hash(topic));
+
+    int ret = aead_encrypt(aead, key_manager_current(), out, plain, plain_len,
+                           out + FRAME_OVERHEAD, out + FRAME_HEADER_LEN);
+    if (ret == 0) {
+        *out_len = FRAME_OVERHEAD + plain_len;
+    }
+    return ret;
+}
+
+int frame_encode(frame_kind_t kind, const char *topic, const uint8_t *plain, size_t plain_len,
+                 uint8_t *out, size_t out_size, size_t *out_len) {
+    if (kind == FRAME_KIND_AES_GCM || kind == FRAME_KIND_CHACHAPOLY) {
+        return frame_seal((frame_aead_t)kind, topic, plain, plain_len, out, out_size, out_len, NULL);
+    }
+    if (out_size < FRAME_TYPE_LEN) {
+        return -1;
+    }
+    out[0] = FRAME_TYPE(kind);
+    uint8_t *body = out + FRAME_TYPE_LEN;
+    size_t body_size = out_size - FRAME_TYPE_LEN;
+    size_t body_len = plain_len;
+
+    switch (kind) {
+    case FRAME_KIND_PLAIN:
+    case FRAME_KIND_XOR:
+        if (plain_len > body_size) {
+            return -1;
+        }
+        if (kind == FRAME_KIND_XOR) {
+            xor_encrypt(plain, body, plain_len, key_manager_current()->xor_key);
+        } else {
+            memcpy(body, plain, plain_len);
+        }
+        break;
+    case FRAME_KIND_MAC: {
+        int ret = mac_protect(mac_config_for_topic(topic), plain, plain_len, body, body_size, &body_len);
+        if (ret != 0) {
+            return ret;
+        }
+        break;
+    }
+    default:
+        return -1;
+    }
+    *out_len = FRAME_TYPE_LEN + body_len;
+    return 0;
+}
+
+const char *frame_kind_name(frame_kind_t kind) {
+    return kind < FRAME_KIND_COUNT ? kind_names[kind] : "?";
+}
+
+frame_status_t frame_check_header(frame_aead_t aead, const char *topic, const uint8_t *frame, size_t len,
+                                  size_t plain_size, nonce_seq_t *seq) {
+    if (len < FRAME_OVERHEAD || len - FRAME_OVERHEAD > plain_size) {
+        return FRAME_ERR_SHORT;
+    }
+    if (frame[0] != FRAME_TYPE(aead)) {
+        return FRAME_ERR_TYPE;
+    }
+    if (read_u32_be(frame + 1 + NONCE_LEN) != frame_topic_hash(topic)) {
+        return FRAME_ERR_TOPIC;
+    }
+    nonce_parse(frame + 1, seq);
+    if (!sender_allowed(seq->sender)) {
+        return FRAME_ERR_SENDER;
+    }
+    if (!nonce_seq_is_fresh(seq)) {
+        return FRAME_ERR_REPLAY;
+    }
+    return FRAME_OK;
+}
+
+frame_status_t frame_open(frame_aead_t aead, const char *topic, const uint8_t *frame, size_t len,
+                          uint8_t *plain, size_t plain_size, size_t *plain_len, nonce_seq_t *seq) {
+    uint32_t start_us = time_us_32();
+    frame_status_t status = frame_check_header(aead, topic, frame, len, plain_size, seq);
+
+    if (status == FRAME_OK) {
+        // Sessão atual e, durante uma rotação, a anterior
+        size_t ct_len = len - FRAME_OVERHEAD;
+        key_slot_t *sessions[2] = {key_manager_current(), key_manager_previous()};
+        int ret = 1;
+        for (int s = 0; s < 2 && sessions[s] != NULL && ret == 1; s++) {
+            ret = aead_decrypt(aead, sessions[s], frame, frame + FRAME_HEADER_LEN,
+                               frame + FRAME_OVERHEAD, ct_len, plain);
+        }
+        if (ret == 1) {
+            status = FRAME_ERR_AUTH;
+        } else if (ret != 0) {
+            status = FRAME_ERR_CRYPTO;
+        } else if (!nonce_seq_accept(seq)) {
+            status = FRAME_ERR_REPLAY; // Sem janela livre para um remetente novo
+        } else {
+            *plain_len = ct_len;
+        }
+    }
+
+    stats[status].count++;
+    stats[status].total_us += time_us_32() - start_us;
+    return status;
+}
+
+const char *frame_status_name(frame_status_t status) {
+    return status < FRAME_STATUS_COUNT ? status_names[status] : "?";
+}
+
+static uint32_t average_us(const frame_stat_t *stat) {
+    return stat->count ? (uint32_t)(stat->total_us / stat->count) : 0;
+}
+
+void frame_print_stats(void) {
+    uint32_t early_count = 0;
+    uint64_t early_us = 0;
+    for (int i = 0; i < FRAME_STATUS_COUNT; i++) {
+        printf("frame %-10s %8lu  media %5lu us\n", status_names[i], (unsigned long)stats[i].count,
+               (unsigned long)average_us(&stats[i]));
+        if (i >= FRAME_ERR_SHORT && i <= FRAME_ERR_REPLAY) {
+            early_count += stats[i].count;
+            early_us += stats[i].total_us;
+        }
+    }
+    // Sem cabeçalho em claro, cada frame recusado custaria pelo menos uma decifragem completa
+    uint32_t decrypt_us = average_us(&stats[FRAME_ERR_AUTH]);
+    if (decrypt_us == 0) {
+        decrypt_us = average_us(&stats[FRAME_OK]);
+    }
+    uint32_t early_avg_us = early_count ? (uint32_t)(early_us / early_count) : 0;
+    if (early_count > 0 && decrypt_us > early_avg_us) {
+        printf("recusados no cabecalho: %lu, %lu us cada; poupados ~%lu us/frame (%lu ms no total)\n",
+               (unsigned long)early_count, (unsigned long)early_avg_us,
+               (unsigned long)(decrypt_us - early_avg_us),
+               (unsigned long)((uint64_t)(decrypt_us - early_avg_us) * early_count / 1000));
+    }
+}
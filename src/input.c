@@ -0,0 +1,82 @@
+#include "include/input.h"
+#include "config/config.h"
+#include "pico/stdlib.h"
+#include "hardware/sync.h"
+#include <stdio.h>
+
+#if (INPUT_QUEUE_LEN & (INPUT_QUEUE_LEN - 1)) != 0
+#error "INPUT_QUEUE_LEN deve ser potencia de 2"
+#endif
+
+static const char *const type_names[INPUT_EVENT_TYPE_COUNT] = {
+    "cima", "baixo", "esquerda", "direita", "press", "release", "longo", "duplo",
+};
+
+static input_event_t queue[INPUT_QUEUE_LEN];
+static volatile uint32_t queue_head = 0; // Escrito só pelos produtores
+static volatile uint32_t queue_tail = 0; // Escrito só pelo laço principal
+static uint32_t pushed[INPUT_EVENT_TYPE_COUNT];
+static uint32_t dropped = 0;
+static uint32_t expired = 0;
+static uint32_t high_water = 0;
+
+bool input_push(input_event_type_t type, input_source_t source, bool repeat, uint32_t time_ms) {
+    uint32_t head = queue_head;
+    uint32_t used = head - queue_tail;
+    if (used >= INPUT_QUEUE_LEN) {
+        dropped++;
+        return false;
+    }
+    input_event_t *slot = &queue[head & (INPUT_QUEUE_LEN - 1)];
+    slot->type = (uint8_t)type;
+    slot->source = (uint8_t)source;
+    slot->repeat = repeat;
+    slot->time_ms = time_ms;
+    __dmb(); // O evento fica visível antes da cabeça
+    queue_head = head + 1;
+
+    pushed[type]++;
+    if (used + 1 > high_water) {
+        high_water = used + 1;
+    }
+    return true;
+}
+
+bool input_pop(uint32_t type_mask, uint32_t source_mask, input_event_t *event) {
+    uint32_t now_ms = to_ms_since_boot(get_absolute_time());
+    uint32_t tail = queue_tail;
+    uint32_t head = queue_head;
+    __dmb(); // Lê os eventos só depois de ver a cabeça
+    for (uint32_t i = tail; i != head; i++) {
+        const input_event_t *slot = &queue[i & (INPUT_QUEUE_LEN - 1)];
+        if ((type_mask & INPUT_MASK(slot->type)) != 0 && (source_mask & INPUT_MASK(slot->source)) != 0) {
+            *event = *slot;
+            // Fecha o buraco: os eventos entre a cauda e este andam uma posição. Os produtores
+            // só escrevem a partir da cabeça, então só o laço principal mexe nesse trecho.
+            for (uint32_t j = i; j != tail; j--) {
+                queue[j & (INPUT_QUEUE_LEN - 1)] = queue[(j - 1) & (INPUT_QUEUE_LEN - 1)];
+            }
+            __dmb(); // Termina as cópias antes de liberar a posição da cauda
+            queue_tail = tail + 1;
+            return true;
+        }
+        if (i == tail && now_ms - slot->time_ms > INPUT_EVENT_MAX_AGE_MS) {
+            tail++; // Chegou à cauda sem ninguém pedir a tempo
+            expired++;
+        }
+    }
+    if (tail != queue_tail) {
+        __dmb();
+        queue_tail = tail;
+    }
+    return false;
+}
+
+void input_print_stats(void) {
+    for (int i = 0; i < INPUT_EVENT_TYPE_COUNT; i++) {
+        printf("evento %-9s %8lu\n", type_names[i], (unsigned long)pushed[i]);
+    }
+    printf("fila: %lu na fila, pico %lu de %u, %lu descartados, %lu expirados\n",
+           (unsigned long)(queue_head - queue_tail), (unsigned long)high_water, (unsigned)INPUT_QUEUE_LEN,
+           (unsigned long)dropped, (unsigned long)expired);
+}
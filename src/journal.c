@@ -0,0 +1,534 @@
+#include "include/journal.h"
+#include "include/mqtt_comm.h"
+#include "include/log.h"
+#include "config/config.h"
+#include "pico/stdlib.h"
+#include "hardware/flash.h"
+#include "hardware/sync.h"
+#include <stddef.h>
+#include <stdio.h>
+#include <string.h>
+#if !PICO_ON_DEVICE
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#define JOURNAL_SECTOR_MAGIC 0x4A524E4Cu // "JRNL"
+#define JOURNAL_ERASED_WORD 0xFFFFFFFFu
+#define JOURNAL_MAX_TOPIC 64
+#define JOURNAL_MAX_PAYLOAD 512
+#define JOURNAL_BENCH_RECORDS 256
+#define JOURNAL_BENCH_PAYLOAD 64 // Frame AES-GCM com "26.5,timestamp": cabeçalho + tag + texto
+
+typedef struct {
+    uint32_t magic;
+    uint32_t sequence;     // Cresce a cada setor aberto: ordem dos setores no anel
+    uint32_t sequence_inv; // ~sequence, detecta cabeçalho incompleto
+    uint32_t reserved;
+} journal_sector_header_t;
+
+typedef struct {
+    uint16_t length;   // Tópico + payload (0xFFFF = espaço apagado, fim do setor)
+    uint8_t topic_len;
+    uint8_t qos;
+    uint32_t crc;      // CRC-32 de length, topic_len, qos, tópico e payload
+    uint32_t sent;     // JOURNAL_ERASED_WORD até o reenvio; zerado depois, sem apagar o setor
+} journal_record_t;
+
+typedef enum {
+    RECORD_OK,
+    RECORD_BAD,     // CRC não confere (gravação interrompida); o tamanho permite pular
+    RECORD_ERASED,  // Espaço livre: não há mais registros no setor
+    RECORD_INVALID, // Cabeçalho inconsistente: o resto do setor é ignorado
+} record_status_t;
+
+typedef int (*journal_sink_t)(const char *topic, const uint8_t *data, size_t len, uint8_t qos);
+
+#define RECORD_SIZE(length) ((sizeof(journal_record_t) + (length) + 3u) & ~3u)
+#define FIRST_RECORD sizeof(journal_sector_header_t)
+#define NEXT_SECTOR(sector) (((sector) + 1) % JOURNAL_FLASH_SECTORS)
+
+// CRC-32 (polinômio 0xEDB88320) por nibble: 16 entradas em vez de 256
+static const uint32_t crc_nibble[16] = {
+    0x00000000, 0x1DB71064, 0x3B6E20C8, 0x26D930AC, 0x76DC4190, 0x6B6B51F4, 0x4DB26158, 0x5005713C,
+    0xEDB88320, 0xF00F9344, 0xD6D6A3E8, 0xCB61B38C, 0x9B64C2B0, 0x86D3D2D4, 0xA00AE278, 0xBDBDF21C,
+};
+
+// Escrita: setor, posição (inclui o que está no buffer) e página em RAM
+static uint32_t head_sector = JOURNAL_FLASH_SECTORS - 1;
+static uint32_t head_sequence = 0; // 0 = nenhum setor aberto
+static uint32_t head_offset = FLASH_SECTOR_SIZE;
+static uint32_t flushed_offset = FLASH_SECTOR_SIZE; // Até onde o setor de escrita já foi programado
+static uint8_t staging[FLASH_PAGE_SIZE];
+static uint32_t staging_page = 0;   // Offset da página do buffer dentro do setor
+static uint32_t staged_since_ms = 0;
+
+// Reenvio: próximo registro e quantos faltam
+static uint32_t tail_sector = JOURNAL_FLASH_SECTORS - 1;
+static uint32_t tail_offset = FLASH_SECTOR_SIZE;
+static uint32_t pending = 0;
+static uint32_t last_drain_ms = 0;
+
+static uint32_t appended = 0;
+static uint64_t append_us = 0;
+static uint32_t drained = 0;
+static uint64_t drain_us = 0;
+static uint32_t dropped = 0;   // Pendentes descartados com o anel cheio
+static uint32_t corrupt = 0;   // Registros com CRC inválido
+static uint32_t pages_programmed = 0;
+static uint32_t sectors_erased = 0;
+
+/* --- Flash --- */
+#if PICO_ON_DEVICE
+static const uint8_t *sector_base(uint32_t sector) {
+    return (const uint8_t *)(XIP_BASE + JOURNAL_FLASH_OFFSET + sector * FLASH_SECTOR_SIZE);
+}
+
+static void program_page(uint32_t sector, uint32_t page_offset, const uint8_t *page) {
+    uint32_t irq_state = save_and_disable_interrupts();
+    flash_range_program(JOURNAL_FLASH_OFFSET + sector * FLASH_SECTOR_SIZE + page_offset, page, FLASH_PAGE_SIZE);
+    restore_interrupts(irq_state);
+    pages_programmed++;
+}
+
+static void erase_sector(uint32_t sector) {
+    uint32_t irq_state = save_and_disable_interrupts();
+    flash_range_erase(JOURNAL_FLASH_OFFSET + sector * FLASH_SECTOR_SIZE, FLASH_SECTOR_SIZE);
+    restore_interrupts(irq_state);
+    sectors_erased++;
+}
+#else
+// Host: a região do journal é um arquivo mapeado com MAP_SHARED (journal_flash_open), que
+// sobrevive ao fim do processo como a flash a uma queda de energia; sem arquivo, um
+// buffer em RAM. As duas formas seguem a NOR: apagar deixa 0xFF e programar só zera bits.
+#define JOURNAL_REGION_SIZE (JOURNAL_FLASH_SECTORS * FLASH_SECTOR_SIZE)
+
+static uint8_t ram_region[JOURNAL_REGION_SIZE];
+static uint8_t *region = NULL;
+
+int journal_flash_open(const char *path) {
+    int fd = open(path, O_RDWR | O_CREAT, 0644);
+    if (fd < 0) {
+        return -1;
+    }
+    struct stat st;
+    if (fstat(fd, &st) != 0 || (st.st_size < JOURNAL_REGION_SIZE && ftruncate(fd, JOURNAL_REGION_SIZE) != 0)) {
+        close(fd);
+        return -1;
+    }
+    uint8_t *mapped = mmap(NULL, JOURNAL_REGION_SIZE, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (mapped == MAP_FAILED) {
+        return -1;
+    }
+    if (st.st_size < JOURNAL_REGION_SIZE) {
+        memset(mapped + st.st_size, 0xFF, JOURNAL_REGION_SIZE - st.st_size); // Arquivo novo: flash apagada
+    }
+    if (region != NULL && region != ram_region) {
+        munmap(region, JOURNAL_REGION_SIZE);
+    }
+    region = mapped;
+    return 0;
+}
+
+static uint8_t *flash_region(void) {
+    if (region == NULL) {
+        memset(ram_region, 0xFF, sizeof(ram_region));
+        region = ram_region;
+    }
+    return region;
+}
+
+static const uint8_t *sector_base(uint32_t sector) {
+    return flash_region() + sector * FLASH_SECTOR_SIZE;
+}
+
+static void program_page(uint32_t sector, uint32_t page_offset, const uint8_t *page) {
+    uint8_t *dst = flash_region() + sector * FLASH_SECTOR_SIZE + page_offset;
+    for (size_t i = 0; i < FLASH_PAGE_SIZE; i++) {
+        dst[i] &= page[i];
+    }
+    pages_programmed++;
+}
+
+static void erase_sector(uint32_t sector) {
+    memset(flash_region() + sector * FLASH_SECTOR_SIZE, 0xFF, FLASH_SECTOR_SIZE);
+    sectors_erased++;
+}
+#endif
+
+static uint32_t crc32_update(uint32_t crc, const uint8_t *data, size_t len) {
+    for (size_t i = 0; i < len; i++) {
+        crc ^= data[i];
+        crc = (crc >> 4) ^ crc_nibble[crc & 0x0F];
+        crc = (crc >> 4) ^ crc_nibble[crc & 0x0F];
+    }
+    return crc;
+}
+
+static uint32_t record_crc(const journal_record_t *record, const char *topic, const uint8_t *data, size_t len) {
+    uint32_t crc = crc32_update(0xFFFFFFFFu, (const uint8_t *)record, offsetof(journal_record_t, crc));
+    crc = crc32_update(crc, (const uint8_t *)topic, record->topic_len);
+    return ~crc32_update(crc, data, len);
+}
+
+static bool sector_is_valid(uint32_t sector, uint32_t *sequence) {
+    const journal_sector_header_t *header = (const journal_sector_header_t *)sector_base(sector);
+    *sequence = header->sequence;
+    return header->magic == JOURNAL_SECTOR_MAGIC && header->sequence_inv == ~header->sequence;
+}
+
+static record_status_t check_record(uint32_t sector, uint32_t offset) {
+    if (offset + sizeof(journal_record_t) > FLASH_SECTOR_SIZE) {
+        return RECORD_ERASED;
+    }
+    const journal_record_t *record = (const journal_record_t *)(sector_base(sector) + offset);
+    if (record->length == 0xFFFF) {
+        return RECORD_ERASED;
+    }
+    if (record->topic_len > JOURNAL_MAX_TOPIC || record->topic_len > record->length ||
+        offset + RECORD_SIZE(record->length) > FLASH_SECTOR_SIZE) {
+        return RECORD_INVALID;
+    }
+    const char *topic = (const char *)(record + 1);
+    const uint8_t *data = (const uint8_t *)topic + record->topic_len;
+    return record_crc(record, topic, data, record->length - record->topic_len) == record->crc ? RECORD_OK : RECORD_BAD;
+}
+
+/* --- Escrita pelo buffer de página --- */
+// Copia para o buffer, programando cada página que enche
+static void stage(const void *data, size_t len) {
+    const uint8_t *bytes = data;
+    while (len > 0) {
+        size_t in_page = head_offset - staging_page;
+        size_t chunk = FLASH_PAGE_SIZE - in_page < len ? FLASH_PAGE_SIZE - in_page : len;
+        memcpy(staging + in_page, bytes, chunk);
+        head_offset += chunk;
+        bytes += chunk;
+        len -= chunk;
+        if (head_offset - staging_page == FLASH_PAGE_SIZE) {
+            program_page(head_sector, staging_page, staging);
+            flushed_offset = head_offset;
+            staging_page = head_offset;
+            memset(staging, 0xFF, sizeof(staging));
+        }
+    }
+}
+
+void journal_flush(void) {
+    if (head_offset == flushed_offset) {
+        return;
+    }
+    // Página parcial: o resto continua 0xFF e recebe os próximos registros na mesma página
+    program_page(head_sector, staging_page, staging);
+    flushed_offset = head_offset;
+}
+
+// Pendentes de um setor a partir de `offset` (usado ao descartar o setor mais antigo)
+static uint32_t count_unsent(uint32_t sector, uint32_t offset) {
+    uint32_t count = 0;
+    for (record_status_t status; (status = check_record(sector, offset)) == RECORD_OK || status == RECORD_BAD;) {
+        const journal_record_t *record = (const journal_record_t *)(sector_base(sector) + offset);
+        count += status == RECORD_OK && record->sent == JOURNAL_ERASED_WORD;
+        offset += RECORD_SIZE(record->length);
+    }
+    return count;
+}
+
+static void open_next_sector(void) {
+    journal_flush();
+    uint32_t next = NEXT_SECTOR(head_sector);
+    if (pending > 0 && tail_sector == next) {
+        // Anel cheio: o setor mais antigo é sobrescrito
+        uint32_t lost = count_unsent(tail_sector, tail_offset);
+        dropped += lost;
+        pending -= lost < pending ? lost : pending;
+        tail_sector = NEXT_SECTOR(next);
+        tail_offset = FIRST_RECORD;
+    }
+    erase_sector(next);
+
+    head_sector = next;
+    head_sequence++;
+    head_offset = 0;
+    flushed_offset = 0;
+    staging_page = 0;
+    memset(staging, 0xFF, sizeof(staging));
+    journal_sector_header_t header = {JOURNAL_SECTOR_MAGIC, head_sequence, ~head_sequence, JOURNAL_ERASED_WORD};
+    stage(&header, sizeof(header));
+    if (pending == 0) {
+        tail_sector = head_sector;
+        tail_offset = head_offset;
+    }
+}
+
+int journal_append(const char *topic, const uint8_t *data, size_t len, uint8_t qos) {
+    size_t topic_len = strlen(topic);
+    if (topic_len > JOURNAL_MAX_TOPIC || len > JOURNAL_MAX_PAYLOAD) {
+        return -1;
+    }
+    uint32_t start_us = time_us_32();
+    journal_record_t record = {(uint16_t)(topic_len + len), (uint8_t)topic_len, qos, 0, JOURNAL_ERASED_WORD};
+    record.crc = record_crc(&record, topic, data, len);
+    if (head_offset + RECORD_SIZE(record.length) > FLASH_SECTOR_SIZE) {
+        open_next_sector();
+    }
+    if (pending == 0) {
+        tail_sector = head_sector;
+        tail_offset = head_offset;
+    }
+    if (head_offset == flushed_offset) {
+        staged_since_ms = to_ms_since_boot(get_absolute_time());
+    }
+
+    static const uint8_t padding[3] = {0xFF, 0xFF, 0xFF};
+    stage(&record, sizeof(record));
+    stage(topic, topic_len);
+    stage(data, len);
+    stage(padding, RECORD_SIZE(record.length) - sizeof(record) - record.length);
+
+    pending++;
+    appended++;
+    append_us += time_us_32() - start_us;
+    return 0;
+}
+
+/* --- Reenvio --- */
+// Envia até `max` registros na ordem; as palavras "enviado" de uma mesma página são zeradas juntas
+static uint32_t drain(journal_sink_t sink, uint32_t max) {
+    uint8_t marks[FLASH_PAGE_SIZE];
+    uint32_t mark_sector = 0;
+    uint32_t mark_page = UINT32_MAX;
+    uint32_t sent_now = 0;
+
+    while (sent_now < max && pending > 0) {
+        if (tail_sector == head_sector && tail_offset >= flushed_offset) {
+            journal_flush(); // O registro ainda está no buffer de RAM
+        }
+        record_status_t status = check_record(tail_sector, tail_offset);
+        if (status == RECORD_ERASED || status == RECORD_INVALID) {
+            if (tail_sector == head_sector) {
+                pending = 0; // Contagem inconsistente com a flash: nada mais a enviar
+                break;
+            }
+            tail_sector = NEXT_SECTOR(tail_sector);
+            tail_offset = FIRST_RECORD;
+            continue;
+        }
+        const journal_record_t *record = (const journal_record_t *)(sector_base(tail_sector) + tail_offset);
+        uint32_t record_offset = tail_offset;
+        if (status == RECORD_BAD || record->sent != JOURNAL_ERASED_WORD) {
+            corrupt += status == RECORD_BAD;
+            tail_offset += RECORD_SIZE(record->length);
+            continue;
+        }
+
+        char topic[JOURNAL_MAX_TOPIC + 1];
+        memcpy(topic, record + 1, record->topic_len);
+        topic[record->topic_len] = '\0';
+        const uint8_t *data = (const uint8_t *)(record + 1) + record->topic_len;
+        if (sink(topic, data, record->length - record->topic_len, record->qos) != 0) {
+            break; // Fila de saída cheia: tenta de novo no próximo journal_poll
+        }
+        tail_offset += RECORD_SIZE(record->length);
+        pending--;
+        drained++;
+        sent_now++;
+
+        uint32_t sent_word = record_offset + offsetof(journal_record_t, sent);
+        uint32_t page = sent_word - sent_word % FLASH_PAGE_SIZE;
+        if (page != mark_page || tail_sector != mark_sector) {
+            if (mark_page != UINT32_MAX) {
+                program_page(mark_sector, mark_page, marks);
+            }
+            memset(marks, 0xFF, sizeof(marks));
+            mark_sector = tail_sector;
+            mark_page = page;
+        }
+        memset(marks + (sent_word - page), 0, sizeof(uint32_t));
+    }
+    if (mark_page != UINT32_MAX) {
+        program_page(mark_sector, mark_page, marks);
+    }
+    return sent_now;
+}
+
+static int sink_mqtt(const char *topic, const uint8_t *data, size_t len, uint8_t qos) {
+    return mqtt_comm_publish_qos(topic, data, len, qos);
+}
+
+int journal_publish(const char *topic, const uint8_t *data, size_t len, uint8_t qos) {
+    if (pending == 0 && mqtt_comm_is_connected() && mqtt_comm_publish_qos(topic, data, len, qos) == 0) {
+        return 0;
+    }
+    return journal_append(topic, data, len, qos);
+}
+
+void journal_poll(uint32_t now_ms) {
+    if (head_offset != flushed_offset && now_ms - staged_since_ms >= JOURNAL_FLUSH_MS) {
+        journal_flush();
+    }
+    if (pending == 0 || !mqtt_comm_is_connected()) {
+        last_drain_ms = now_ms;
+        return;
+    }
+    uint32_t allowed = (now_ms - last_drain_ms) * JOURNAL_DRAIN_RATE_PER_S / 1000;
+    if (allowed == 0) {
+        return;
+    }
+    uint32_t start_us = time_us_32();
+    drain(sink_mqtt, allowed < JOURNAL_DRAIN_BATCH ? allowed : JOURNAL_DRAIN_BATCH);
+    drain_us += time_us_32() - start_us;
+    last_drain_ms = now_ms;
+    if (pending == 0) {
+        LOG_INFO("Journal: reenvio concluido (%lu mensagens desde o boot)\n", (unsigned long)drained);
+    }
+}
+
+uint32_t journal_pending(void) {
+    return pending;
+}
+
+/* --- Boot --- */
+void journal_init(void) {
+    bool found = false;
+    for (uint32_t sector = 0; sector < JOURNAL_FLASH_SECTORS; sector++) {
+        uint32_t sequence;
+        if (sector_is_valid(sector, &sequence) && (!found || (int32_t)(sequence - head_sequence) > 0)) {
+            head_sector = sector;
+            head_sequence = sequence;
+            found = true;
+        }
+    }
+    memset(staging, 0xFF, sizeof(staging));
+    pending = 0;
+    if (!found) {
+        head_sector = tail_sector = JOURNAL_FLASH_SECTORS - 1;
+        head_sequence = 0;
+        head_offset = flushed_offset = tail_offset = FLASH_SECTOR_SIZE;
+        printf("Journal: vazio (%u setores)\n", (unsigned)JOURNAL_FLASH_SECTORS);
+        return; // A primeira gravação abre o setor 0
+    }
+
+    // Registros do anel, do setor mais antigo ao mais novo: o primeiro não enviado é o próximo a reenviar
+    for (uint32_t age = JOURNAL_FLASH_SECTORS; age-- > 0;) {
+        uint32_t sector = (head_sector + JOURNAL_FLASH_SECTORS - age) % JOURNAL_FLASH_SECTORS;
+        uint32_t sequence;
+        if (!sector_is_valid(sector, &sequence) || sequence != head_sequence - age) {
+            continue;
+        }
+        uint32_t offset = FIRST_RECORD;
+        bool damaged = false; // Registro com CRC inválido: gravação interrompida ou bits alterados
+        record_status_t status;
+        while ((status = check_record(sector, offset)) == RECORD_OK || status == RECORD_BAD) {
+            const journal_record_t *record = (const journal_record_t *)(sector_base(sector) + offset);
+            if (status == RECORD_OK && record->sent == JOURNAL_ERASED_WORD) {
+                if (pending++ == 0) {
+                    tail_sector = sector;
+                    tail_offset = offset;
+                }
+            }
+            damaged |= status == RECORD_BAD;
+            offset += RECORD_SIZE(record->length);
+        }
+        if (sector != head_sector) {
+            continue;
+        }
+
+        // Continua no setor mais novo só se ele está íntegro e o resto da página está apagado;
+        // caso contrário a próxima gravação abre um setor novo
+        head_offset = FLASH_SECTOR_SIZE;
+        if (status == RECORD_ERASED && !damaged && offset < FLASH_SECTOR_SIZE) {
+            const uint8_t *base = sector_base(sector);
+            uint32_t page_end = offset - offset % FLASH_PAGE_SIZE + FLASH_PAGE_SIZE;
+            bool erased = true;
+            for (uint32_t i = offset; i < page_end && erased; i++) {
+                erased = base[i] == 0xFF;
+            }
+            if (erased) {
+                head_offset = offset;
+                staging_page = offset - offset % FLASH_PAGE_SIZE;
+                memcpy(staging, base + staging_page, offset - staging_page);
+            }
+        }
+        flushed_offset = head_offset;
+    }
+    if (pending == 0) {
+        tail_sector = head_sector;
+        tail_offset = head_offset;
+    }
+    printf("Journal: %lu mensagens pendentes, setor %lu (seq %lu)\n", (unsigned long)pending,
+           (unsigned long)head_sector, (unsigned long)head_sequence);
+}
+
+/* --- Estatísticas --- */
+static void print_rate(const char *label, uint32_t count, uint64_t elapsed_us, uint32_t bytes) {
+    printf("%-9s %6lu mensagens", label, (unsigned long)count);
+    if (count > 0 && elapsed_us > 0) {
+        printf(" em %7lu us: %6lu msg/s", (unsigned long)elapsed_us,
+               (unsigned long)((uint64_t)count * 1000000 / elapsed_us));
+        if (bytes > 0) {
+            printf(", %5lu KB/s", (unsigned long)((uint64_t)bytes * 1000000 / 1024 / elapsed_us));
+        }
+    }
+    printf("\n");
+}
+
+void journal_print_stats(void) {
+    uint32_t used = pending == 0 ? 0 : (head_sector + JOURNAL_FLASH_SECTORS - tail_sector) % JOURNAL_FLASH_SECTORS + 1;
+    printf("journal: %lu pendentes em %lu/%u setores, %lu descartados (anel cheio), %lu corrompidos\n",
+           (unsigned long)pending, (unsigned long)used, (unsigned)JOURNAL_FLASH_SECTORS, (unsigned long)dropped,
+           (unsigned long)corrupt);
+    printf("journal: %lu paginas programadas, %lu setores apagados (setor %lu, seq %lu)\n",
+           (unsigned long)pages_programmed, (unsigned long)sectors_erased, (unsigned long)head_sector,
+           (unsigned long)head_sequence);
+    print_rate("gravacao", appended, append_us, 0);
+    print_rate("reenvio", drained, drain_us, 0);
+}
+
+static uint32_t bench_bytes = 0;
+
+static int sink_count(const char *topic, const uint8_t *data, size_t len, uint8_t qos) {
+    bench_bytes += len;
+    return 0;
+}
+
+void journal_benchmark(void) {
+    if (pending > 0) {
+        printf("journal: %lu mensagens pendentes; o benchmark so roda com o journal vazio\n", (unsigned long)pending);
+        return;
+    }
+    uint8_t frame[JOURNAL_BENCH_PAYLOAD];
+    for (size_t i = 0; i < sizeof(frame); i++) {
+        frame[i] = (uint8_t)(i * 37);
+    }
+    uint32_t pages_before = pages_programmed;
+    uint32_t erases_before = sectors_erased;
+
+    uint64_t start_us = time_us_64();
+    for (uint32_t i = 0; i < JOURNAL_BENCH_RECORDS; i++) {
+        journal_append("escola/sala1/temperatura", frame, sizeof(frame), 0);
+    }
+    journal_flush();
+    uint64_t append_elapsed_us = time_us_64() - start_us;
+    uint32_t record_bytes = JOURNAL_BENCH_RECORDS * RECORD_SIZE(sizeof(frame) + strlen("escola/sala1/temperatura"));
+    uint32_t append_pages = pages_programmed - pages_before;
+    uint32_t append_erases = sectors_erased - erases_before;
+
+    bench_bytes = 0;
+    pages_before = pages_programmed;
+    start_us = time_us_64();
+    while (pending > 0 && drain(sink_count, JOURNAL_DRAIN_BATCH) > 0) {
+    }
+    uint64_t drain_elapsed_us = time_us_64() - start_us;
+
+    printf("%u registros de %u B de payload (%lu B na flash):\n", (unsigned)JOURNAL_BENCH_RECORDS,
+           (unsigned)sizeof(frame), (unsigned long)record_bytes);
+    print_rate("gravacao", JOURNAL_BENCH_RECORDS, append_elapsed_us, record_bytes);
+    printf("          %lu paginas programadas, %lu setores apagados\n", (unsigned long)append_pages,
+           (unsigned long)append_erases);
+    print_rate("reenvio", JOURNAL_BENCH_RECORDS, drain_elapsed_us, bench_bytes);
+    printf("          %lu paginas programadas (marcas de enviado)\n", (unsigned long)(pages_programmed - pages_before));
+}
@@ -1,57 +1,86 @@
 #include "joystick.h"
-#include "config/config.h" // Required for joystick pins, ADC channels, and thresholds
+#include "adc_scan.h"
+#include "input.h"
+#include "config/config.h" // Canais do ADC, limiares e tempos de repetição
+#include "pico/stdlib.h"
+#include <stdio.h>
 
-static uint32_t last_joy_y_move_time = 0;
-static bool joystick_y_action_taken = false;
+typedef struct {
+    const char *name;
+    uint8_t channel;
+    uint8_t low_event;  // Evento ao passar de JOYSTICK_MOVE_LOW_THRESHOLD
+    uint8_t high_event; // Evento ao passar de JOYSTICK_MOVE_HIGH_THRESHOLD
+    int8_t zone;        // -1 baixo, 0 neutro, 1 alto
+    int32_t filtered;   // Leitura filtrada x 16, para a média não perder resolução
+    uint32_t next_repeat_ms;
+} joystick_axis_t;
 
-void joystick_init(void)
-{
-    adc_init();
-    adc_gpio_init(JOYSTICK_VRY_PIN); // Enable ADC on joystick Y pin
-}
+static joystick_axis_t axes[] = {
+    {"Y", ADC_JOYSTICK_Y_CHANNEL, INPUT_NAV_DOWN, INPUT_NAV_UP, 0, 2048 * 16, 0},
+    {"X", ADC_JOYSTICK_X_CHANNEL, INPUT_NAV_LEFT, INPUT_NAV_RIGHT, 0, 2048 * 16, 0},
+};
+#define AXIS_COUNT (sizeof(axes) / sizeof(axes[0]))
 
-void joystick_handle_menu_navigation(int item_count, int *selected_idx_ptr)
-{
-    uint32_t now = time_us_32();
-    adc_select_input(ADC_JOYSTICK_Y_CHANNEL); // Select ADC channel for Y-axis
-    uint16_t joy_y_val = adc_read();          // Read ADC value
-
-    // Anti-repeat logic for joystick movement
-    if (!joystick_y_action_taken && (now - last_joy_y_move_time > 200000 /* 200ms delay */))
-    {
-        // Physical UP movement (HIGH ADC value) -> MENU selection UP
-        if (joy_y_val > JOYSTICK_Y_MOVE_UP_THRESHOLD)
-        {
-            if (*selected_idx_ptr > 0)
-                (*selected_idx_ptr)--;
-            else
-                *selected_idx_ptr = item_count - 1; // Wrap to the last item
-            joystick_y_action_taken = true;
-            last_joy_y_move_time = now;
-        }
-        // Physical DOWN movement (LOW ADC value) -> MENU selection DOWN
-        else if (joy_y_val < JOYSTICK_Y_MOVE_DOWN_THRESHOLD)
-        {
-            if (*selected_idx_ptr < item_count - 1)
-                (*selected_idx_ptr)++;
-            else
-                *selected_idx_ptr = 0; // Wrap to the first item
-            joystick_y_action_taken = true;
-            last_joy_y_move_time = now;
+// Filtro, histerese e repetição de um eixo para uma amostra (na IRQ do ADC)
+static void axis_update(joystick_axis_t *axis, uint16_t sample, uint32_t now_ms) {
+    axis->filtered += ((int32_t)sample * 16 - axis->filtered) >> JOYSTICK_FILTER_SHIFT;
+    int32_t value = axis->filtered / 16;
+
+    int8_t zone = axis->zone;
+    if (value > JOYSTICK_MOVE_HIGH_THRESHOLD) {
+        zone = 1;
+    } else if (value < JOYSTICK_MOVE_LOW_THRESHOLD) {
+        zone = -1;
+    } else if (value < JOYSTICK_NEUTRAL_DEADZONE_HIGH && value > JOYSTICK_NEUTRAL_DEADZONE_LOW) {
+        zone = 0;
+    } // Entre um limiar e a zona morta o eixo fica onde estava
+
+    uint8_t event = zone > 0 ? axis->high_event : axis->low_event;
+    if (zone != axis->zone) {
+        axis->zone = zone;
+        if (zone != 0) {
+            input_push((input_event_type_t)event, INPUT_SOURCE_JOYSTICK, false, now_ms);
+            axis->next_repeat_ms = now_ms + JOYSTICK_REPEAT_DELAY_MS;
         }
+    } else if (zone != 0 && (int32_t)(now_ms - axis->next_repeat_ms) >= 0) {
+        input_push((input_event_type_t)event, INPUT_SOURCE_JOYSTICK, true, now_ms);
+        axis->next_repeat_ms = now_ms + JOYSTICK_REPEAT_INTERVAL_MS;
+    }
+}
+
+static void on_adc_round(const uint16_t *samples, uint32_t now_ms) {
+    for (size_t i = 0; i < AXIS_COUNT; i++) {
+        axis_update(&axes[i], samples[axes[i].channel], now_ms);
     }
-    else
-    {
-        // Check if joystick returned to neutral to allow new action
-        if (joy_y_val < JOYSTICK_Y_NEUTRAL_DEADZONE_HIGH &&
-            joy_y_val > JOYSTICK_Y_NEUTRAL_DEADZONE_LOW)
-        {
-            joystick_y_action_taken = false;
+}
+
+void joystick_init(void) {
+    adc_scan_set_handler(on_adc_round);
+    adc_scan_init();
+}
+
+void joystick_handle_menu_navigation(int item_count, int *selected_idx_ptr) {
+    uint32_t now_ms = to_ms_since_boot(get_absolute_time());
+    input_event_t event;
+    while (input_pop(INPUT_MASK_NAV, INPUT_MASK(INPUT_SOURCE_JOYSTICK), &event)) {
+        if (now_ms - event.time_ms > INPUT_EVENT_MAX_AGE_MS) {
+            continue; // Acumulado enquanto o laço dormia em um modo
         }
-        // Timeout to reset action flag if joystick gets stuck
-        if (now - last_joy_y_move_time > 500000 /* 500ms timeout */)
-        {
-            joystick_y_action_taken = false;
+        // Joystick para cima (ADC alto) sobe a seleção
+        if (event.type == INPUT_NAV_UP) {
+            *selected_idx_ptr = *selected_idx_ptr > 0 ? *selected_idx_ptr - 1 : item_count - 1;
+        } else if (event.type == INPUT_NAV_DOWN) {
+            *selected_idx_ptr = *selected_idx_ptr < item_count - 1 ? *selected_idx_ptr + 1 : 0;
         }
     }
 }
+
+void joystick_print_stats(void) {
+    adc_scan_print_stats();
+    for (size_t i = 0; i < AXIS_COUNT; i++) {
+        const joystick_axis_t *axis = &axes[i];
+        printf("eixo %s: bruto %4u, filtrado %4ld, %s\n", axis->name, (unsigned)adc_scan_latest(axis->channel),
+               (long)(axis->filtered / 16), axis->zone > 0 ? "alto" : axis->zone < 0 ? "baixo" : "neutro");
+    }
+    input_print_stats();
+}
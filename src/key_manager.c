@@ -0,0 +1,265 @@
+#include "include/key_manager.h"
+#include "include/sha256_backend.h"
+#include "include/mqtt_comm.h"
+#include "include/log.h"
+#include "config/config.h"
+#include "config/credentials.h"
+#include "pico/stdlib.h"
+#include <stdio.h>
+#include <string.h>
+
+#define KEY_LABEL_MAX 16
+#define KEY_ANNOUNCE_RETRY_MS 1000 // Nova tentativa depois de um anúncio que o lwIP recusou
+
+static uint8_t prk[SHA256_DIGEST_LEN];     // HKDF-Extract do segredo mestre
+static uint8_t control_key[KEY_LEN];       // Autentica os anúncios de rotação
+static key_slot_t slots[2];
+static volatile int active_slot = 0;
+static volatile bool rotation_pending = false;
+static volatile uint32_t pending_session_id = 0;
+static uint32_t last_schedule_ms = 0;
+
+// Estatísticas
+static uint32_t rotation_count = 0;
+static uint32_t rejected_count = 0;
+static uint32_t rotation_last_us = 0;
+static uint32_t rotation_max_us = 0;
+
+static void write_u32_be(uint8_t *out, uint32_t value) {
+    out[0] = (uint8_t)(value >> 24);
+    out[1] = (uint8_t)(value >> 16);
+    out[2] = (uint8_t)(value >> 8);
+    out[3] = (uint8_t)value;
+}
+
+int hkdf_sha256(const uint8_t *salt, size_t salt_len, const uint8_t *ikm, size_t ikm_len,
+                const uint8_t *info, size_t info_len, uint8_t *okm, size_t okm_len) {
+    static const uint8_t zero_salt[SHA256_DIGEST_LEN] = {0};
+    uint8_t prk_local[SHA256_DIGEST_LEN];
+    uint8_t block[SHA256_DIGEST_LEN + KEY_LABEL_MAX + 4 + 1]; // T(i-1) || info || i
+    uint8_t t[SHA256_DIGEST_LEN];
+
+    if (okm_len > 255 * SHA256_DIGEST_LEN || info_len > KEY_LABEL_MAX + 4) {
+        return -1;
+    }
+    if (salt == NULL) {
+        salt = zero_salt;
+        salt_len = sizeof(zero_salt);
+    }
+    int ret = hmac_sha256(salt, salt_len, ikm, ikm_len, prk_local);
+
+    size_t t_len = 0;
+    for (uint8_t i = 1; ret == 0 && okm_len > 0; i++) {
+        memcpy(block, t, t_len);
+        memcpy(block + t_len, info, info_len);
+        block[t_len + info_len] = i;
+        ret = hmac_sha256(prk_local, sizeof(prk_local), block, t_len + info_len + 1, t);
+        size_t n = okm_len < SHA256_DIGEST_LEN ? okm_len : SHA256_DIGEST_LEN;
+        memcpy(okm, t, n);
+        okm += n;
+        okm_len -= n;
+        t_len = SHA256_DIGEST_LEN;
+    }
+    memset(prk_local, 0, sizeof(prk_local));
+    memset(t, 0, sizeof(t));
+    return ret;
+}
+
+// HKDF-Expand(PRK, label || session_id) com o PRK já calculado em key_manager_init
+static int derive_key(const char *label, uint32_t session_id, uint8_t out[KEY_LEN]) {
+    uint8_t info[KEY_LABEL_MAX + 4 + 1];
+    size_t label_len = strlen(label);
+    if (label_len > KEY_LABEL_MAX) {
+        return -1;
+    }
+    memcpy(info, label, label_len);
+    write_u32_be(info + label_len, session_id);
+    info[label_len + 4] = 0x01; // Um único bloco T(1): saída de 32 bytes
+    return hmac_sha256(prk, sizeof(prk), info, label_len + 5, out);
+}
+
+static int derive_slot(key_slot_t *slot, uint32_t session_id) {
+    uint8_t key[KEY_LEN];
+
+    slot->valid = false;
+    mbedtls_gcm_free(&slot->gcm);
+    mbedtls_chachapoly_free(&slot->chachapoly);
+    mbedtls_gcm_init(&slot->gcm);
+    mbedtls_chachapoly_init(&slot->chachapoly);
+
+    int ret = derive_key("xor", session_id, key);
+    if (ret == 0) {
+        slot->xor_key = key[0] | 0x01; // Chave 0 deixaria a mensagem em claro
+        ret = derive_key("hmac", session_id, slot->hmac_key);
+    }
+    if (ret == 0) {
+        ret = derive_key("siphash", session_id, key);
+        memcpy(slot->siphash_key, key, sizeof(slot->siphash_key));
+    }
+    if (ret == 0) {
+        ret = derive_key("aes", session_id, key);
+    }
+    if (ret == 0) {
+        ret = mbedtls_gcm_setkey(&slot->gcm, MBEDTLS_CIPHER_ID_AES, key, KEY_LEN * 8);
+    }
+    if (ret == 0) {
+        ret = derive_key("chacha", session_id, key);
+    }
+    if (ret == 0) {
+        ret = mbedtls_chachapoly_setkey(&slot->chachapoly, key);
+    }
+    memset(key, 0, sizeof(key));
+
+    if (ret == 0) {
+        slot->session_id = session_id;
+        slot->valid = true;
+    }
+    return ret;
+}
+
+// Comparação em tempo constante, para não revelar quantos bytes da tag conferem
+static bool tags_equal(const uint8_t *a, const uint8_t *b, size_t len) {
+    uint8_t diff = 0;
+    for (size_t i = 0; i < len; i++) {
+        diff |= a[i] ^ b[i];
+    }
+    return diff == 0;
+}
+
+static int control_tag(uint32_t session_id, uint8_t out[SHA256_DIGEST_LEN]) {
+    uint8_t msg[3 + 4] = {'r', 'o', 't'};
+    write_u32_be(msg + 3, session_id);
+    return hmac_sha256(control_key, sizeof(control_key), msg, sizeof(msg), out);
+}
+
+bool key_manager_init(void) {
+    int ret = hmac_sha256((const uint8_t *)KEY_HKDF_SALT, strlen(KEY_HKDF_SALT),
+                          (const uint8_t *)KEY_MASTER_SECRET, strlen(KEY_MASTER_SECRET), prk);
+    if (ret == 0) {
+        static const uint8_t control_info[] = {'c', 'o', 'n', 't', 'r', 'o', 'l', 0, 0, 0, 0};
+        ret = hkdf_sha256((const uint8_t *)KEY_HKDF_SALT, strlen(KEY_HKDF_SALT),
+                          (const uint8_t *)KEY_MASTER_SECRET, strlen(KEY_MASTER_SECRET),
+                          control_info, sizeof(control_info), control_key, sizeof(control_key));
+    }
+    if (ret == 0) {
+        mbedtls_gcm_init(&slots[0].gcm);
+        mbedtls_chachapoly_init(&slots[0].chachapoly);
+        mbedtls_gcm_init(&slots[1].gcm);
+        mbedtls_chachapoly_init(&slots[1].chachapoly);
+        ret = derive_slot(&slots[0], 0);
+    }
+    active_slot = 0;
+    if (ret != 0) {
+        printf("Falha ao derivar as chaves: -0x%04X\n", (unsigned int)-ret);
+        return false;
+    }
+    return true;
+}
+
+key_slot_t *key_manager_current(void) {
+    return &slots[active_slot];
+}
+
+key_slot_t *key_manager_previous(void) {
+    key_slot_t *slot = &slots[1 - active_slot];
+    return slot->valid ? slot : NULL;
+}
+
+int key_manager_rotate(uint32_t session_id) {
+    if (session_id <= slots[active_slot].session_id) {
+        return -1;
+    }
+
+    uint32_t start_us = time_us_32();
+    int next = 1 - active_slot;
+    int ret = derive_slot(&slots[next], session_id);
+    if (ret != 0) {
+        LOG_ERROR("Rotacao para a sessao %lu falhou: -0x%04X\n", (unsigned long)session_id, (unsigned int)-ret);
+        return ret;
+    }
+    // Troca de ponteiro: handlers no contexto do lwIP passam a usar a nova sessão a partir daqui
+    active_slot = next;
+
+    rotation_last_us = time_us_32() - start_us;
+    if (rotation_last_us > rotation_max_us) {
+        rotation_max_us = rotation_last_us;
+    }
+    rotation_count++;
+    LOG_INFO("Chaves da sessao %lu derivadas em %lu us\n", (unsigned long)session_id, (unsigned long)rotation_last_us);
+    return 0;
+}
+
+// Anuncia a próxima sessão e só então a aplica; 0 se as duas coisas deram certo
+static int announce(void) {
+    uint32_t session_id = slots[active_slot].session_id + 1;
+    uint8_t msg[KEY_CONTROL_MSG_LEN];
+    write_u32_be(msg, session_id);
+    if (control_tag(session_id, msg + 4) != 0) {
+        return -1;
+    }
+    // Anuncia antes de aplicar: se o anúncio não foi aceito pelo lwIP, a sessão atual continua e
+    // ninguém recebe frames de uma sessão que não foi anunciada. Com QoS 1 o lwIP espera o PUBACK;
+    // um anúncio perdido mesmo assim é reenviado pelo próximo (a sessão só cresce)
+    if (mqtt_comm_publish_retained(MQTT_TOPIC_KEYS, msg, sizeof(msg)) != 0) {
+        LOG_WARN("Anuncio da sessao %lu nao foi enviado; a sessao atual continua\n", (unsigned long)session_id);
+        return -1;
+    }
+    return key_manager_rotate(session_id);
+}
+
+void key_manager_announce_next(void) {
+    announce();
+}
+
+void key_manager_poll(bool schedule) {
+    if (rotation_pending) {
+        rotation_pending = false;
+        key_manager_rotate(pending_session_id);
+    }
+
+#if KEY_ROTATION_INTERVAL_MS > 0
+    uint32_t now_ms = to_ms_since_boot(get_absolute_time());
+    if (schedule && now_ms - last_schedule_ms >= KEY_ROTATION_INTERVAL_MS && mqtt_comm_is_connected()) {
+        last_schedule_ms = now_ms;
+        if (announce() != 0) {
+            // Fila do lwIP cheia: tenta de novo em KEY_ANNOUNCE_RETRY_MS, não um intervalo inteiro depois
+            last_schedule_ms = now_ms - KEY_ROTATION_INTERVAL_MS + KEY_ANNOUNCE_RETRY_MS;
+        }
+    }
+#else
+    (void)schedule;
+    (void)last_schedule_ms;
+#endif
+}
+
+void key_manager_control_handler(const char *topic, const uint8_t *payload, size_t len) {
+    (void)topic;
+    if (len != KEY_CONTROL_MSG_LEN) {
+        rejected_count++;
+        return;
+    }
+    uint32_t session_id = ((uint32_t)payload[0] << 24) | ((uint32_t)payload[1] << 16) |
+                          ((uint32_t)payload[2] << 8) | payload[3];
+    uint8_t expected[SHA256_DIGEST_LEN];
+    if (control_tag(session_id, expected) != 0 || !tags_equal(expected, payload + 4, SHA256_DIGEST_LEN)) {
+        rejected_count++;
+        LOG_WARN("Anuncio de chaves com tag invalida\n");
+        return;
+    }
+    // Eco do próprio anúncio (ou sessão antiga): nada a fazer
+    if (session_id <= slots[active_slot].session_id) {
+        return;
+    }
+    // A derivação fica para o loop principal; aqui só agenda (sem voltar para uma sessão menor)
+    if (!rotation_pending || session_id > pending_session_id) {
+        pending_session_id = session_id;
+        rotation_pending = true;
+    }
+}
+
+void key_manager_print_stats(void) {
+    printf("Chaves: sessao atual=%lu anterior=%s rotacoes=%lu anuncios recusados=%lu\n",
+           (unsigned long)slots[active_slot].session_id, key_manager_previous() ? "sim" : "nao",
+           (unsigned long)rotation_count, (unsigned long)rejected_count);
+    printf("Rotacao: ultima=%lu us max=%lu us\n", (unsigned long)rotation_last_us, (unsigned long)rotation_max_us);
+}
@@ -0,0 +1,179 @@
+#include "include/latency.h"
+#include "include/clock_sync.h"
+#include "include/mqtt_comm.h"
+#include "config/config.h"
+#include "config/credentials.h"
+#include "pico/stdlib.h"
+#include <stdio.h>
+
+#define LATENCY_HALF (1u << (LATENCY_SUB_BITS - 1))
+#define LATENCY_MAX_US ((1u << LATENCY_MAX_BITS) - 1)
+#define LATENCY_BUCKETS ((LATENCY_MAX_BITS - LATENCY_SUB_BITS + 2) * LATENCY_HALF)
+
+typedef struct {
+    uint32_t counts[LATENCY_BUCKETS];
+    uint32_t total;
+    uint32_t negative;
+    uint32_t max_us;
+} latency_hist_t;
+
+static latency_hist_t hists[FRAME_KIND_COUNT];
+static uint32_t published_total = 0;
+static uint32_t last_publish_ms = 0;
+
+static uint32_t bucket_index(uint32_t value_us) {
+    if (value_us < (1u << LATENCY_SUB_BITS)) {
+        return value_us;
+    }
+    uint32_t msb = 31 - (uint32_t)__builtin_clz(value_us);
+    uint32_t shift = msb - (LATENCY_SUB_BITS - 1);
+    return shift * LATENCY_HALF + (value_us >> shift);
+}
+
+// Maior valor que cai no balde
+static uint32_t bucket_upper(uint32_t index) {
+    if (index < (1u << LATENCY_SUB_BITS)) {
+        return index;
+    }
+    uint32_t shift = index / LATENCY_HALF - 1;
+    uint32_t top = index - shift * LATENCY_HALF;
+    return ((top + 1) << shift) - 1;
+}
+
+void latency_record(frame_kind_t kind, uint64_t sent_us) {
+    uint64_t now_remote_us;
+    if (kind >= FRAME_KIND_COUNT || !clock_sync_to_remote(to_us_since_boot(get_absolute_time()), &now_remote_us)) {
+        return;
+    }
+    latency_hist_t *hist = &hists[kind];
+    uint32_t latency_us = 0;
+    if (now_remote_us < sent_us) {
+        hist->negative++;
+    } else if (now_remote_us - sent_us > LATENCY_MAX_US) {
+        latency_us = LATENCY_MAX_US;
+    } else {
+        latency_us = (uint32_t)(now_remote_us - sent_us);
+    }
+    hist->counts[bucket_index(latency_us)]++;
+    hist->total++;
+    if (latency_us > hist->max_us) {
+        hist->max_us = latency_us;
+    }
+}
+
+// Percentil de um conjunto de histogramas (um modo ou todos)
+static uint32_t hist_percentile(const latency_hist_t *first, size_t count, uint32_t permille) {
+    uint32_t total = 0;
+    uint32_t max_us = 0;
+    for (size_t h = 0; h < count; h++) {
+        total += first[h].total;
+        max_us = first[h].max_us > max_us ? first[h].max_us : max_us;
+    }
+    if (total == 0) {
+        return 0;
+    }
+    uint32_t target = (uint32_t)(((uint64_t)total * permille + 999) / 1000);
+    uint32_t seen = 0;
+    for (uint32_t i = 0; i < LATENCY_BUCKETS; i++) {
+        for (size_t h = 0; h < count; h++) {
+            seen += first[h].counts[i];
+        }
+        if (seen >= target) {
+            uint32_t upper = bucket_upper(i);
+            return upper < max_us ? upper : max_us;
+        }
+    }
+    return max_us;
+}
+
+uint32_t latency_percentile_all(uint32_t permille) {
+    return hist_percentile(hists, FRAME_KIND_COUNT, permille);
+}
+
+static uint32_t total_all(void) {
+    uint32_t total = 0;
+    for (int kind = 0; kind < FRAME_KIND_COUNT; kind++) {
+        total += hists[kind].total;
+    }
+    return total;
+}
+
+// µs em ms com uma casa decimal ("9.8"); a partir de 100 ms, sem casa
+static int format_ms(char *out, size_t size, uint32_t us) {
+    if (us >= 100000) {
+        return snprintf(out, size, "%lu", (unsigned long)(us / 1000));
+    }
+    uint32_t tenths = (us + 50) / 100;
+    return snprintf(out, size, "%lu.%lu", (unsigned long)(tenths / 10), (unsigned long)(tenths % 10));
+}
+
+size_t latency_format_summary(char *out, size_t size) {
+    if (size == 0) {
+        return 0;
+    }
+    out[0] = '\0';
+    if (total_all() == 0) {
+        return 0;
+    }
+    char p50[8];
+    char p99[8];
+    format_ms(p50, sizeof(p50), latency_percentile_all(500));
+    format_ms(p99, sizeof(p99), latency_percentile_all(990));
+    int n = snprintf(out, size, "p50 %s p99 %sms", p50, p99);
+    return n < 0 ? 0 : ((size_t)n < size ? (size_t)n : size - 1);
+}
+
+void latency_poll(const char *client_id) {
+    uint32_t now_ms = to_ms_since_boot(get_absolute_time());
+    if (now_ms - last_publish_ms < LATENCY_PUBLISH_INTERVAL_MS || !mqtt_comm_is_connected()) {
+        return;
+    }
+    last_publish_ms = now_ms;
+
+    uint32_t total = total_all();
+    if (total == published_total) {
+        return; // Nada novo desde a última publicação
+    }
+    published_total = total;
+
+    // "<modo>:<n>/<p50>/<p90>/<p99>/<max>;..." em µs, só os modos com mensagens
+    static char topic[64];
+    static char payload[192];
+    snprintf(topic, sizeof(topic), "%s/%s/latencia", MQTT_TOPIC_STATUS, client_id);
+    size_t pos = 0;
+    for (int kind = 0; kind < FRAME_KIND_COUNT && pos < sizeof(payload); kind++) {
+        const latency_hist_t *hist = &hists[kind];
+        if (hist->total == 0) {
+            continue;
+        }
+        int n = snprintf(payload + pos, sizeof(payload) - pos, "%s%s:%lu/%lu/%lu/%lu/%lu", pos > 0 ? ";" : "",
+                         frame_kind_name((frame_kind_t)kind), (unsigned long)hist->total,
+                         (unsigned long)hist_percentile(hist, 1, 500), (unsigned long)hist_percentile(hist, 1, 900),
+                         (unsigned long)hist_percentile(hist, 1, 990), (unsigned long)hist->max_us);
+        if (n < 0) {
+            break;
+        }
+        pos += (size_t)n;
+    }
+    if (pos >= sizeof(payload)) {
+        pos = sizeof(payload) - 1; // snprintf truncou a última entrada
+    }
+    mqtt_comm_publish(topic, (const uint8_t *)payload, pos);
+}
+
+void latency_print_stats(void) {
+    clock_sync_print_stats();
+    printf("%-12s %8s %6s %8s %8s %8s %8s %8s (us)\n", "modo", "msgs", "negat", "p50", "p90", "p99", "p99.9",
+           "max");
+    for (int kind = 0; kind < FRAME_KIND_COUNT; kind++) {
+        const latency_hist_t *hist = &hists[kind];
+        if (hist->total == 0) {
+            continue;
+        }
+        printf("%-12s %8lu %6lu %8lu %8lu %8lu %8lu %8lu\n", frame_kind_name((frame_kind_t)kind),
+               (unsigned long)hist->total, (unsigned long)hist->negative,
+               (unsigned long)hist_percentile(hist, 1, 500), (unsigned long)hist_percentile(hist, 1, 900),
+               (unsigned long)hist_percentile(hist, 1, 990), (unsigned long)hist_percentile(hist, 1, 999),
+               (unsigned long)hist->max_us);
+    }
+}
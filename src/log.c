@@ -0,0 +1,275 @@
+#include "include/log.h"
+#include "pico/stdlib.h"
+#include <stdarg.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <string.h>
+
+#ifndef LOG_RING_SIZE
+#define LOG_RING_SIZE 32 // Potência de 2
+#endif
+#define LOG_MAX_ARGS 6
+#define LOG_STR_LEN 80   // Espaço para os argumentos %s de uma entrada (todos juntos)
+#define LOG_STR_EMPTY (LOG_STR_LEN - 1) // Último byte, sempre '\0': argumentos que não couberam apontam para ele
+#define LOG_SPEC_LEN 16  // Tamanho máximo de uma especificação de conversão ("%-16s", "%02x"...)
+#define LOG_LINE_LEN 192
+
+typedef struct {
+    const char *fmt;
+    volatile bool ready; // Preenchida pelo produtor e ainda não impressa
+    uint8_t level;
+    uint8_t arg_count;
+    uint64_t args[LOG_MAX_ARGS];
+    char str[LOG_STR_LEN];
+} log_entry_t;
+
+static log_entry_t ring[LOG_RING_SIZE];
+static volatile uint32_t head = 0; // Entradas reservadas (produtores)
+static volatile uint32_t tail = 0; // Entradas impressas (somente log_flush)
+
+static uint32_t recorded_count = 0;
+static uint32_t dropped_count = 0;
+static uint32_t flushed_count = 0;
+static uint64_t record_us_total = 0;
+static uint64_t flush_us_total = 0;
+
+static const char level_tags[] = {' ', 'E', 'W', 'I', 'D'};
+
+/* Tipo de um argumento, deduzido da especificação de conversão */
+typedef enum {
+    ARG_NONE,
+    ARG_INT,
+    ARG_LONG,
+    ARG_LLONG,
+    ARG_SIZE,
+    ARG_PTR,
+    ARG_DOUBLE,
+    ARG_STR,
+} arg_kind_t;
+
+/*
+ * Analisa a especificação que começa em fmt (logo após o '%').
+ * Retorna o ponteiro para o caractere seguinte à conversão e preenche kind/is_signed.
+ */
+static const char *parse_spec(const char *fmt, arg_kind_t *kind, bool *is_signed) {
+    while (*fmt && strchr("-+ #0", *fmt)) fmt++;      // flags
+    while (*fmt >= '0' && *fmt <= '9') fmt++;          // largura
+    if (*fmt == '.') {                                 // precisão
+        fmt++;
+        while (*fmt >= '0' && *fmt <= '9') fmt++;
+    }
+    int longs = 0;
+    bool size = false;
+    while (*fmt == 'l' || *fmt == 'h' || *fmt == 'z') {
+        if (*fmt == 'l') longs++;
+        if (*fmt == 'z') size = true;
+        fmt++;
+    }
+
+    *is_signed = false;
+    switch (*fmt) {
+    case 'd':
+    case 'i':
+        *is_signed = true;
+        // fallthrough
+    case 'u':
+    case 'x':
+    case 'X':
+    case 'c':
+        *kind = size ? ARG_SIZE : (longs >= 2 ? ARG_LLONG : (longs == 1 ? ARG_LONG : ARG_INT));
+        break;
+    case 'p':
+        *kind = ARG_PTR;
+        break;
+    case 'f':
+        *kind = ARG_DOUBLE;
+        break;
+    case 's':
+        *kind = ARG_STR;
+        break;
+    default:
+        *kind = ARG_NONE; // "%%" ou conversão não suportada
+        break;
+    }
+    return *fmt ? fmt + 1 : fmt;
+}
+
+void log_record(uint8_t level, const char *fmt, ...) {
+    uint32_t start_us = time_us_32();
+
+    uint32_t irq_state = save_and_disable_interrupts();
+    if (head - tail >= LOG_RING_SIZE) {
+        dropped_count++;
+        restore_interrupts(irq_state);
+        return;
+    }
+    log_entry_t *entry = &ring[head & (LOG_RING_SIZE - 1)];
+    head++;
+    restore_interrupts(irq_state);
+
+    entry->fmt = fmt;
+    entry->level = level;
+    entry->arg_count = 0;
+    entry->str[LOG_STR_EMPTY] = '\0';
+    size_t str_used = 0;
+
+    va_list ap;
+    va_start(ap, fmt);
+    for (const char *p = fmt; *p && entry->arg_count < LOG_MAX_ARGS; p++) {
+        if (*p != '%') {
+            continue;
+        }
+        arg_kind_t kind;
+        bool is_signed;
+        p = parse_spec(p + 1, &kind, &is_signed) - 1;
+
+        uint64_t value = 0;
+        switch (kind) {
+        case ARG_NONE:
+            continue;
+        case ARG_INT:
+            value = is_signed ? (uint64_t)(int64_t)va_arg(ap, int) : va_arg(ap, unsigned int);
+            break;
+        case ARG_LONG:
+            value = is_signed ? (uint64_t)(int64_t)va_arg(ap, long) : va_arg(ap, unsigned long);
+            break;
+        case ARG_LLONG:
+            value = va_arg(ap, unsigned long long);
+            break;
+        case ARG_SIZE:
+            value = va_arg(ap, size_t);
+            break;
+        case ARG_PTR:
+            value = (uintptr_t)va_arg(ap, void *);
+            break;
+        case ARG_DOUBLE: {
+            double d = va_arg(ap, double);
+            memcpy(&value, &d, sizeof(value));
+            break;
+        }
+        case ARG_STR: {
+            // Copia a string para a entrada: o buffer original pode não existir mais no flush
+            const char *s = va_arg(ap, const char *);
+            size_t room = LOG_STR_EMPTY - str_used;
+            if (room == 0) {
+                value = LOG_STR_EMPTY; // Argumentos anteriores ocuparam todo o espaço: imprime vazio
+                break;
+            }
+            value = str_used;
+            size_t n = strnlen(s ? s : "(null)", room - 1);
+            memcpy(entry->str + str_used, s ? s : "(null)", n);
+            entry->str[str_used + n] = '\0';
+            str_used += n + 1;
+            break;
+        }
+        }
+        entry->args[entry->arg_count++] = value;
+    }
+    va_end(ap);
+
+    __dmb();
+    entry->ready = true;
+
+    // Produtores em IRQ também gravam: os contadores são atualizados com as interrupções desligadas
+    irq_state = save_and_disable_interrupts();
+    recorded_count++;
+    record_us_total += time_us_32() - start_us;
+    restore_interrupts(irq_state);
+}
+
+/* Formata uma entrada em line, convertendo um argumento de cada vez com snprintf */
+static void format_entry(const log_entry_t *entry, char *line, size_t line_len) {
+    size_t pos = 0;
+    uint8_t arg_index = 0;
+    const char *p = entry->fmt;
+
+    while (*p && pos < line_len - 1) {
+        if (*p != '%') {
+            line[pos++] = *p++;
+            continue;
+        }
+        arg_kind_t kind;
+        bool is_signed;
+        const char *end = parse_spec(p + 1, &kind, &is_signed);
+        size_t spec_len = (size_t)(end - p);
+
+        if (kind == ARG_NONE || arg_index >= entry->arg_count || spec_len >= LOG_SPEC_LEN) {
+            if (p[1] == '%') {
+                line[pos++] = '%';
+            }
+            p = end;
+            continue;
+        }
+
+        char spec[LOG_SPEC_LEN];
+        memcpy(spec, p, spec_len);
+        spec[spec_len] = '\0';
+        uint64_t v = entry->args[arg_index++];
+        size_t room = line_len - pos;
+        int n = 0;
+
+        switch (kind) {
+        case ARG_INT:
+            n = is_signed ? snprintf(line + pos, room, spec, (int)v) : snprintf(line + pos, room, spec, (unsigned int)v);
+            break;
+        case ARG_LONG:
+            n = is_signed ? snprintf(line + pos, room, spec, (long)v) : snprintf(line + pos, room, spec, (unsigned long)v);
+            break;
+        case ARG_LLONG:
+            n = is_signed ? snprintf(line + pos, room, spec, (long long)v) : snprintf(line + pos, room, spec, (unsigned long long)v);
+            break;
+        case ARG_SIZE:
+            n = snprintf(line + pos, room, spec, (size_t)v);
+            break;
+        case ARG_PTR:
+            n = snprintf(line + pos, room, spec, (void *)(uintptr_t)v);
+            break;
+        case ARG_DOUBLE: {
+            double d;
+            memcpy(&d, &v, sizeof(d));
+            n = snprintf(line + pos, room, spec, d);
+            break;
+        }
+        case ARG_STR:
+            n = snprintf(line + pos, room, spec, entry->str + v);
+            break;
+        default:
+            break;
+        }
+        if (n > 0) {
+            pos += ((size_t)n < room) ? (size_t)n : room - 1;
+        }
+        p = end;
+    }
+    line[pos] = '\0';
+}
+
+void log_flush(void) {
+    static char line[LOG_LINE_LEN];
+
+    while (tail != head) {
+        log_entry_t *entry = &ring[tail & (LOG_RING_SIZE - 1)];
+        if (!entry->ready) {
+            break; // Reservada mas ainda sendo preenchida (callback interrompido)
+        }
+        uint32_t start_us = time_us_32();
+        format_entry(entry, line, sizeof(line));
+        printf("[%c] %s", level_tags[entry->level < sizeof(level_tags) ? entry->level : 0], line);
+        flush_us_total += time_us_32() - start_us;
+        flushed_count++;
+
+        entry->ready = false;
+        tail++;
+    }
+}
+
+void log_print_stats(void) {
+    printf("Log: %lu gravadas, %lu descartadas, %lu impressas\n",
+           (unsigned long)recorded_count, (unsigned long)dropped_count, (unsigned long)flushed_count);
+    if (recorded_count > 0) {
+        printf("  gravacao: %lu us/entrada (caminho critico)\n", (unsigned long)(record_us_total / recorded_count));
+    }
+    if (flushed_count > 0) {
+        printf("  formatacao + USB: %lu us/entrada (ocioso)\n", (unsigned long)(flush_us_total / flushed_count));
+    }
+}
@@ -0,0 +1,270 @@
+#include "include/loopback.h"
+#include "config/credentials.h" // Tópico de loopback
+#include "config/config.h"
+#include "mqtt_comm.h"
+#include "display.h"
+#include "key_manager.h"
+#include "nonce.h"
+#include "mac.h"
+#include "xor_cipher.h"
+#include "pool.h"
+#include "numfmt.h"
+#include "log.h"
+#include "pico/stdlib.h"
+#include <stdio.h>
+#include <string.h>
+
+// Leitura fixa das mensagens ("26.5"), em décimos para numfmt_reading
+#define LOOPBACK_READING_TENTHS 265
+
+// Payload de qualquer modo para o texto de 64 B (classe de 128 B do pool)
+#define LOOPBACK_PAYLOAD_LEN (FRAME_MAX_OVERHEAD + 64)
+
+// Texto decodificado, com o '\0' (classe de 128 B do pool)
+#define LOOPBACK_PLAIN_LEN 128
+
+static const frame_kind_t loopback_kinds[] = {FRAME_KIND_PLAIN, FRAME_KIND_XOR, FRAME_KIND_MAC,
+                                              FRAME_KIND_AES_GCM, FRAME_KIND_CHACHAPOLY};
+#define LOOPBACK_KIND_COUNT (sizeof(loopback_kinds) / sizeof(loopback_kinds[0]))
+
+static const char *const transport_names[] = {"interno", "broker"};
+
+// Mensagem em voo: escrita pelo laço principal antes de publicar, lida pelo handler (contexto do lwIP)
+static volatile uint64_t expected_timestamp = 0;
+static volatile bool reply_done = false;
+static volatile bool reply_ok = false;
+static volatile uint32_t reply_us = 0;
+
+static uint32_t latencies[LOOPBACK_MESSAGES];
+static loopback_result_t last_results[2][FRAME_KIND_COUNT];
+static size_t next_kind = 0;
+
+// Decodifica a mensagem de qualquer modo e confere o timestamp esperado
+static bool loopback_decode(const char *topic, const uint8_t *payload, size_t len, uint64_t expected) {
+    if (len < FRAME_TYPE_LEN) {
+        return false;
+    }
+    char *plain = pool_alloc(LOOPBACK_PLAIN_LEN);
+    if (plain == NULL) {
+        return false;
+    }
+
+    frame_kind_t kind = (frame_kind_t)(payload[0] & 0x0F);
+    bool ok = payload[0] == FRAME_TYPE(kind);
+    size_t plain_len = 0;
+    if (ok && (kind == FRAME_KIND_AES_GCM || kind == FRAME_KIND_CHACHAPOLY)) {
+        nonce_seq_t seq;
+        ok = frame_open((frame_aead_t)kind, topic, payload, len, (uint8_t *)plain, LOOPBACK_PLAIN_LEN - 1,
+                        &plain_len, &seq) == FRAME_OK;
+    } else if (ok && kind == FRAME_KIND_MAC) {
+        const uint8_t *msg = NULL;
+        ok = mac_verify(mac_config_for_topic(topic), payload + FRAME_TYPE_LEN, len - FRAME_TYPE_LEN, &msg, &plain_len) &&
+             plain_len < LOOPBACK_PLAIN_LEN;
+        if (ok) {
+            memcpy(plain, msg, plain_len);
+        }
+    } else if (ok && (kind == FRAME_KIND_XOR || kind == FRAME_KIND_PLAIN)) {
+        plain_len = len - FRAME_TYPE_LEN;
+        ok = plain_len < LOOPBACK_PLAIN_LEN;
+        if (ok && kind == FRAME_KIND_XOR) {
+            xor_encrypt(payload + FRAME_TYPE_LEN, (uint8_t *)plain, plain_len, key_manager_current()->xor_key);
+        } else if (ok) {
+            memcpy(plain, payload + FRAME_TYPE_LEN, plain_len);
+        }
+    } else {
+        ok = false;
+    }
+
+    if (ok) {
+        char value[16];
+        uint64_t timestamp = 0;
+        ok = numfmt_parse_reading(plain, plain_len, value, sizeof(value), &timestamp) == NUMFMT_OK &&
+             timestamp == expected;
+    }
+    pool_free(plain);
+    return ok;
+}
+
+// Handler de MQTT_TOPIC_LOOPBACK: a própria mensagem de volta do broker
+static void loopback_on_message(const char *topic, const uint8_t *payload, size_t len) {
+    uint64_t expected = expected_timestamp;
+    if (expected == 0 || reply_done) {
+        return; // Resposta atrasada de uma mensagem que já expirou
+    }
+    bool ok = loopback_decode(topic, payload, len, expected);
+    reply_us = (uint32_t)(to_us_since_boot(get_absolute_time()) - expected);
+    reply_ok = ok;
+    reply_done = true;
+}
+
+// Espera a resposta do broker; as IRQs do lwIP chamam o handler enquanto isso
+static bool loopback_wait_reply(void) {
+    uint32_t start_ms = to_ms_since_boot(get_absolute_time());
+    while (!reply_done) {
+        if (to_ms_since_boot(get_absolute_time()) - start_ms >= LOOPBACK_TIMEOUT_MS) {
+            return false;
+        }
+        tight_loop_contents();
+    }
+    return true;
+}
+
+static void loopback_percentiles(uint32_t count, loopback_result_t *result) {
+    // Ordenação por inserção: até LOOPBACK_MESSAGES valores, uma vez por rodada
+    for (uint32_t i = 1; i < count; i++) {
+        uint32_t value = latencies[i];
+        uint32_t j = i;
+        for (; j > 0 && latencies[j - 1] > value; j--) {
+            latencies[j] = latencies[j - 1];
+        }
+        latencies[j] = value;
+    }
+    if (count == 0) {
+        return;
+    }
+    result->p50_us = latencies[(count - 1) * 50 / 100];
+    result->p90_us = latencies[(count - 1) * 90 / 100];
+    result->p99_us = latencies[(count - 1) * 99 / 100];
+    result->max_us = latencies[count - 1];
+}
+
+void loopback_run(frame_kind_t kind, loopback_transport_t transport, loopback_result_t *result) {
+    memset(result, 0, sizeof(*result));
+    uint8_t *payload = pool_alloc(LOOPBACK_PAYLOAD_LEN);
+    if (payload == NULL) {
+        return;
+    }
+
+    uint32_t consecutive_timeouts = 0;
+    uint64_t start_us = to_us_since_boot(get_absolute_time());
+    for (uint32_t i = 0; i < LOOPBACK_MESSAGES && consecutive_timeouts < LOOPBACK_MAX_TIMEOUTS; i++) {
+        uint64_t timestamp = to_us_since_boot(get_absolute_time());
+        char message[64];
+        size_t message_len = numfmt_reading(message, sizeof(message), LOOPBACK_READING_TENTHS, 1, timestamp);
+        size_t payload_len = 0;
+        result->sent++;
+        if (frame_encode(kind, MQTT_TOPIC_LOOPBACK, (const uint8_t *)message, message_len, payload,
+                         LOOPBACK_PAYLOAD_LEN, &payload_len) != 0) {
+            result->failed++;
+            continue;
+        }
+
+        bool ok;
+        uint32_t rtt_us;
+        if (transport == LOOPBACK_INTERNAL) {
+            ok = loopback_decode(MQTT_TOPIC_LOOPBACK, payload, payload_len, timestamp);
+            rtt_us = (uint32_t)(to_us_since_boot(get_absolute_time()) - timestamp);
+        } else {
+            reply_done = false;
+            expected_timestamp = timestamp;
+            mqtt_comm_publish(MQTT_TOPIC_LOOPBACK, payload, payload_len);
+            bool replied = loopback_wait_reply();
+            expected_timestamp = 0;
+            if (!replied) {
+                result->timeouts++;
+                consecutive_timeouts++;
+                continue;
+            }
+            consecutive_timeouts = 0;
+            ok = reply_ok;
+            rtt_us = reply_us;
+        }
+
+        if (ok) {
+            latencies[result->received++] = rtt_us;
+        } else {
+            result->failed++;
+        }
+    }
+    uint64_t elapsed_us = to_us_since_boot(get_absolute_time()) - start_us;
+    pool_free(payload);
+
+    if (elapsed_us > 0) {
+        result->msgs_per_s = (uint32_t)((uint64_t)result->received * 1000000u / elapsed_us);
+    }
+    loopback_percentiles(result->received, result);
+}
+
+void loopback_print_results(void) {
+    printf("loopback: %u mensagens por rodada, ida e volta em us\n", (unsigned)LOOPBACK_MESSAGES);
+    printf("%-8s %-12s %8s %8s %8s %8s %8s %6s %6s %6s\n", "entrega", "modo", "p50", "p90", "p99", "max",
+           "msg/s", "ok", "falha", "perda");
+    for (int transport = 0; transport < 2; transport++) {
+        for (size_t i = 0; i < LOOPBACK_KIND_COUNT; i++) {
+            const loopback_result_t *r = &last_results[transport][loopback_kinds[i]];
+            if (r->sent == 0) {
+                continue;
+            }
+            printf("%-8s %-12s %8lu %8lu %8lu %8lu %8lu %6lu %6lu %6lu\n", transport_names[transport],
+                   frame_kind_name(loopback_kinds[i]), (unsigned long)r->p50_us, (unsigned long)r->p90_us,
+                   (unsigned long)r->p99_us, (unsigned long)r->max_us, (unsigned long)r->msgs_per_s,
+                   (unsigned long)r->received, (unsigned long)r->failed, (unsigned long)r->timeouts);
+        }
+    }
+}
+
+// Um modo por passo, com o resultado no display; a tabela completa a cada volta
+static int32_t loopback_step(loopback_transport_t transport) {
+    frame_kind_t kind = loopback_kinds[next_kind];
+    next_kind = (next_kind + 1) % LOOPBACK_KIND_COUNT;
+
+    loopback_result_t *result = &last_results[transport][kind];
+    loopback_run(kind, transport, result);
+    LOG_INFO("Loopback %s %s: p50 %lu us, %lu msg/s\n", transport_names[transport], frame_kind_name(kind),
+             (unsigned long)result->p50_us, (unsigned long)result->msgs_per_s);
+
+    char line[24];
+    snprintf(line, sizeof(line), "%s (%s)", frame_kind_name(kind), transport_names[transport]);
+    display_text_in_line(line, 1, 1);
+    snprintf(line, sizeof(line), "p50 %lu p99 %lu", (unsigned long)result->p50_us, (unsigned long)result->p99_us);
+    display_text_in_line(line, 2, 1);
+    snprintf(line, sizeof(line), "max %lu us", (unsigned long)result->max_us);
+    display_text_in_line(line, 3, 1);
+    snprintf(line, sizeof(line), "%lu msg/s %lu/%lu", (unsigned long)result->msgs_per_s,
+             (unsigned long)result->received, (unsigned long)result->sent);
+    display_text_in_line(line, 4, 1);
+
+    if (next_kind == 0) {
+        loopback_print_results();
+    }
+    return LOOPBACK_STEP_INTERVAL_MS;
+}
+
+static void loopback_enter(void) {
+    next_kind = 0;
+}
+
+static int32_t loopback_step_internal(void) {
+    return loopback_step(LOOPBACK_INTERNAL);
+}
+
+static int32_t loopback_step_broker(void) {
+    if (!mqtt_comm_is_connected()) {
+        display_text_in_line("Sem broker", 1, 1);
+        return LOOPBACK_STEP_INTERVAL_MS;
+    }
+    return loopback_step(LOOPBACK_BROKER);
+}
+
+const app_mode_t loopback_modes[] = {
+    // menu                 título                  init           encode                  decode teardown
+    {"Loopback interno",    "Loopback: interno",    loopback_enter, loopback_step_internal, NULL,  NULL},
+    {"Loopback via broker", "Loopback: broker",     loopback_enter, loopback_step_broker,   NULL,  NULL},
+};
+const size_t loopback_mode_count = sizeof(loopback_modes) / sizeof(loopback_modes[0]);
+
+void loopback_boot(void) {
+    if (!nonce_init()) {
+        printf("Contador de nonces indisponivel: modos AES e ChaCha desabilitados.\n");
+    }
+}
+
+void loopback_connected(void) {
+    mqtt_comm_subscribe_with_handler(MQTT_TOPIC_LOOPBACK, loopback_on_message);
+    mqtt_comm_subscribe_with_handler(MQTT_TOPIC_KEYS, key_manager_control_handler);
+}
+
+void loopback_poll(bool in_mode) {
+    (void)in_mode;
+    key_manager_poll(false); // Deriva as chaves anunciadas no tópico de controle
+}
@@ -0,0 +1,230 @@
+#include "include/mac.h"
+#include "include/key_manager.h"
+#include "include/nonce.h"
+#include "include/sha256_backend.h"
+#include "config/credentials.h"
+#include "pico/stdlib.h"
+#include <stdio.h>
+#include <string.h>
+
+// Algoritmo e tamanho de tag por tópico; o publisher e o subscriber usam a mesma tabela.
+// A última entrada (topic NULL) vale para os demais tópicos.
+static const mac_config_t mac_topics[] = {
+    {MQTT_TOPIC_SUBSCRIBE, MAC_HMAC_SHA256, 32},
+    {NULL, MAC_HMAC_SHA256, 32},
+};
+
+static const char *const alg_names[] = {"HMAC-SHA256", "SipHash-2-4", "Poly1305"};
+
+const mac_config_t *mac_config_for_topic(const char *topic) {
+    size_t count = sizeof(mac_topics) / sizeof(mac_topics[0]);
+    for (size_t i = 0; i + 1 < count; i++) {
+        if (topic != NULL && strcmp(mac_topics[i].topic, topic) == 0) {
+            return &mac_topics[i];
+        }
+    }
+    return &mac_topics[count - 1];
+}
+
+const char *mac_alg_name(mac_alg_t alg) {
+    return alg_names[alg];
+}
+
+size_t mac_overhead(const mac_config_t *config) {
+    return (config->alg == MAC_POLY1305 ? MAC_NONCE_LEN : 0) + config->tag_len;
+}
+
+/* --- SipHash (Aumasson e Bernstein), versão de referência --- */
+#define ROTL64(x, b) (uint64_t)(((x) << (b)) | ((x) >> (64 - (b))))
+
+static uint64_t read_u64_le(const uint8_t *p) {
+    uint64_t v = 0;
+    for (int i = 7; i >= 0; i--) {
+        v = (v << 8) | p[i];
+    }
+    return v;
+}
+
+static void write_u64_le(uint8_t *p, uint64_t v) {
+    for (int i = 0; i < 8; i++) {
+        p[i] = (uint8_t)(v >> (8 * i));
+    }
+}
+
+static void sip_round(uint64_t v[4]) {
+    v[0] += v[1]; v[1] = ROTL64(v[1], 13); v[1] ^= v[0]; v[0] = ROTL64(v[0], 32);
+    v[2] += v[3]; v[3] = ROTL64(v[3], 16); v[3] ^= v[2];
+    v[0] += v[3]; v[3] = ROTL64(v[3], 21); v[3] ^= v[0];
+    v[2] += v[1]; v[1] = ROTL64(v[1], 17); v[1] ^= v[2]; v[2] = ROTL64(v[2], 32);
+}
+
+void siphash(const uint8_t key[16], const uint8_t *msg, size_t len, uint8_t *out, size_t out_len) {
+    uint64_t k0 = read_u64_le(key);
+    uint64_t k1 = read_u64_le(key + 8);
+    uint64_t v[4] = {
+        0x736f6d6570736575ULL ^ k0,
+        0x646f72616e646f6dULL ^ k1,
+        0x6c7967656e657261ULL ^ k0,
+        0x7465646279746573ULL ^ k1,
+    };
+    bool wide = out_len == 16;
+    if (wide) {
+        v[1] ^= 0xee;
+    }
+
+    const uint8_t *end = msg + len - (len % 8);
+    for (; msg != end; msg += 8) {
+        uint64_t m = read_u64_le(msg);
+        v[3] ^= m;
+        sip_round(v);
+        sip_round(v);
+        v[0] ^= m;
+    }
+
+    // Último bloco: bytes restantes + tamanho no byte mais significativo
+    uint64_t b = ((uint64_t)len) << 56;
+    for (size_t i = 0; i < (len % 8); i++) {
+        b |= ((uint64_t)msg[i]) << (8 * i);
+    }
+    v[3] ^= b;
+    sip_round(v);
+    sip_round(v);
+    v[0] ^= b;
+
+    v[2] ^= wide ? 0xee : 0xff;
+    for (int i = 0; i < 4; i++) {
+        sip_round(v);
+    }
+    write_u64_le(out, v[0] ^ v[1] ^ v[2] ^ v[3]);
+    if (wide) {
+        v[1] ^= 0xdd;
+        for (int i = 0; i < 4; i++) {
+            sip_round(v);
+        }
+        write_u64_le(out + 8, v[0] ^ v[1] ^ v[2] ^ v[3]);
+    }
+}
+
+// Tamanho de tag dentro do intervalo aceito pelo algoritmo
+static bool config_is_valid(const mac_config_t *config) {
+    static const uint8_t native_tag_len[] = {32, 16, 16};
+    return config->tag_len >= MAC_MIN_TAG_LEN && config->tag_len <= native_tag_len[config->alg];
+}
+
+// Calcula a tag completa do algoritmo (até 32 bytes) com as chaves de `keys`
+static int compute_tag(const mac_config_t *config, key_slot_t *keys, const uint8_t *nonce,
+                       const uint8_t *msg, size_t msg_len, uint8_t tag[MAC_MAX_TAG_LEN]) {
+    switch (config->alg) {
+    case MAC_HMAC_SHA256:
+        return hmac_sha256(keys->hmac_key, KEY_LEN, msg, msg_len, tag);
+    case MAC_SIPHASH:
+        siphash(keys->siphash_key, msg, msg_len, tag, config->tag_len > 8 ? 16 : 8);
+        return 0;
+    case MAC_POLY1305:
+        // Texto vazio: o ChaCha20 só gera a chave de uso único e o Poly1305 autentica a AAD
+        return mbedtls_chachapoly_encrypt_and_tag(&keys->chachapoly, 0, nonce, msg, msg_len, NULL, NULL, tag);
+    }
+    return -1;
+}
+
+// Comparação em tempo constante, para não revelar quantos bytes da tag conferem
+static bool tags_equal(const uint8_t *a, const uint8_t *b, size_t len) {
+    uint8_t diff = 0;
+    for (size_t i = 0; i < len; i++) {
+        diff |= a[i] ^ b[i];
+    }
+    return diff == 0;
+}
+
+int mac_protect(const mac_config_t *config, const uint8_t *msg, size_t msg_len,
+                uint8_t *frame, size_t frame_size, size_t *frame_len) {
+    size_t overhead = mac_overhead(config);
+    if (!config_is_valid(config) || overhead + msg_len > frame_size) {
+        return -1;
+    }
+
+    uint8_t *nonce = frame;
+    if (config->alg == MAC_POLY1305 && nonce_next(nonce, NULL) != 0) {
+        return -1;
+    }
+
+    uint8_t tag[MAC_MAX_TAG_LEN];
+    int ret = compute_tag(config, key_manager_current(), nonce, msg, msg_len, tag);
+    if (ret != 0) {
+        return ret;
+    }
+    memcpy(frame + overhead - config->tag_len, tag, config->tag_len);
+    memcpy(frame + overhead, msg, msg_len);
+    *frame_len = overhead + msg_len;
+    return 0;
+}
+
+bool mac_verify(const mac_config_t *config, const uint8_t *frame, size_t frame_len,
+                const uint8_t **msg, size_t *msg_len) {
+    size_t overhead = mac_overhead(config);
+    if (!config_is_valid(config) || frame_len < overhead) {
+        return false;
+    }
+    const uint8_t *nonce = frame;
+    const uint8_t *received_tag = frame + overhead - config->tag_len;
+    *msg = frame + overhead;
+    *msg_len = frame_len - overhead;
+
+    key_slot_t *sessions[2] = {key_manager_current(), key_manager_previous()};
+    for (int s = 0; s < 2 && sessions[s] != NULL; s++) {
+        uint8_t tag[MAC_MAX_TAG_LEN];
+        if (compute_tag(config, sessions[s], nonce, *msg, *msg_len, tag) == 0 &&
+            tags_equal(tag, received_tag, config->tag_len)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void mac_benchmark(void) {
+    static const mac_config_t options[] = {
+        {NULL, MAC_HMAC_SHA256, 32},
+        {NULL, MAC_HMAC_SHA256, 16},
+        {NULL, MAC_HMAC_SHA256, 8},
+        {NULL, MAC_SIPHASH, 8},
+        {NULL, MAC_SIPHASH, 16},
+        {NULL, MAC_POLY1305, 16},
+        {NULL, MAC_POLY1305, 8},
+    };
+    static const char msg[] = "26.5,1234567890123"; // Leitura típica: valor + timestamp em µs
+    const size_t msg_len = sizeof(msg) - 1;
+    // PUBLISH QoS 0: cabeçalho fixo (2) + tamanho do tópico (2) + tópico + payload
+    const size_t mqtt_header = 2 + 2 + strlen(MQTT_TOPIC_SUBSCRIBE);
+    const uint32_t iterations = 100;
+    uint8_t frame[MAC_MAX_OVERHEAD + sizeof(msg)];
+    size_t frame_len = 0;
+
+    printf("%-12s %3s %8s %8s %10s %10s\n", "MAC", "tag", "payload", "PUBLISH", "gera(us)", "verif(us)");
+    printf("%-12s %3s %8u %8u %10s %10s\n", "(sem MAC)", "-", (unsigned)msg_len, (unsigned)(mqtt_header + msg_len), "-", "-");
+    for (size_t i = 0; i < sizeof(options) / sizeof(options[0]); i++) {
+        const mac_config_t *config = &options[i];
+        int ret = 0;
+        uint32_t start_us = time_us_32();
+        for (uint32_t n = 0; n < iterations && ret == 0; n++) {
+            ret = mac_protect(config, (const uint8_t *)msg, msg_len, frame, sizeof(frame), &frame_len);
+        }
+        uint32_t protect_us = time_us_32() - start_us;
+
+        bool ok = ret == 0;
+        const uint8_t *payload;
+        size_t payload_len;
+        start_us = time_us_32();
+        for (uint32_t n = 0; n < iterations && ok; n++) {
+            ok = mac_verify(config, frame, frame_len, &payload, &payload_len);
+        }
+        uint32_t verify_us = time_us_32() - start_us;
+
+        if (!ok) {
+            printf("%-12s %3u falhou (%d)\n", mac_alg_name(config->alg), config->tag_len, ret);
+            continue;
+        }
+        printf("%-12s %3u %8u %8u %10lu %10lu\n", mac_alg_name(config->alg), config->tag_len,
+               (unsigned)frame_len, (unsigned)(mqtt_header + frame_len),
+               (unsigned long)(protect_us / iterations), (unsigned long)(verify_us / iterations));
+    }
+}
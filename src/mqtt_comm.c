@@ -2,16 +2,60 @@
 #include "include/mqtt_comm.h"
 #include "lwipopts.h"
 #include "config/credentials.h"
+#include "config/config.h"
+#include "include/trace.h"
+#include "include/log.h"
+#include "pico/cyw43_arch.h"
+#include "pico/stdlib.h"
 #include <stdio.h>
 #include <string.h>
 
+#if MQTT_USE_TLS
+#include "lwip/altcp_tls.h"
+#include "lwip/apps/mqtt_priv.h" // Acesso a client->conn para gerenciar a sessão TLS
+#include "mbedtls/ssl.h"
+#include <malloc.h>              // mallinfo() para medir a RAM usada pelo handshake
+#endif
+
 static mqtt_client_t *client = NULL;
 static mqtt_message_handler_t user_message_handler = NULL;
 
+// --- Parâmetros da conexão, guardados para permitir reconexão
+static ip_addr_t broker_addr;
+static struct mqtt_connect_client_info_t client_info;
+
+// --- Tópicos assinados, reinscritos automaticamente após reconexão
+typedef struct {
+    const char *topic;
+    mqtt_message_handler_t handler; // NULL: usa o handler configurado com mqtt_comm_set_message_handler
+} topic_subscription_t;
+static topic_subscription_t subscriptions[MQTT_COMM_MAX_SUBSCRIPTIONS];
+static size_t subscription_count = 0;
+
 // --- Variáveis estáticas para payload buffer
 static char topic_buffer[128]; // (Se quiser, pode preencher via publish_cb)
 static uint8_t payload_buffer[256];
 static size_t payload_len = 0;
+static bool payload_oversized = false;  // Mensagem não cabe no buffer: descartada sem chamar o handler
+static uint32_t message_start_us = 0;   // Chegada do PUBLISH atual (mqtt_comm_message_age_us)
+static mqtt_rx_stats_t rx_stats;
+
+// --- Espera entre reconexões: dobra a cada tentativa, volta ao mínimo no CONNACK aceito
+static uint32_t reconnect_delay_ms = MQTT_RECONNECT_MIN_MS;
+static uint32_t reconnect_next_ms = 0;
+
+#if MQTT_USE_TLS
+// --- Estado TLS: configuração (CA) e sessão salva para retomada no próximo handshake
+static struct altcp_tls_config *tls_config = NULL;
+static struct altcp_tls_session tls_session;
+static bool tls_session_valid = false;
+static bool tls_resume_attempted = false;
+static unsigned char tls_offered_id[32];   // Session ID oferecido na retomada
+static size_t tls_offered_id_len = 0;
+static uint32_t tls_connect_start_us = 0;
+static int tls_heap_before = 0;
+static mqtt_tls_stats_t tls_stats;
+#endif
 
 // DECLARAÇÃO ANTECIPADA DO CALLBACK DE SUBSCRIBE
 void mqtt_sub_request_cb(void *arg, err_t result);
@@ -22,28 +66,72 @@ static void mqtt_incoming_publish_cb(void *arg, const char *topic, u32_t tot_len
     strncpy(topic_buffer, topic, sizeof(topic_buffer) - 1);
     topic_buffer[sizeof(topic_buffer) - 1] = '\0';
     payload_len = 0; // Sempre zera antes de começar a receber um novo payload!
-    printf("Recebendo mensagem em tópico: %s (tamanho %ld)\n", topic, (long)tot_len);
+    payload_oversized = tot_len >= sizeof(payload_buffer);
+    message_start_us = time_us_32();
+    LOG_DEBUG("Recebendo mensagem em tópico: %s (tamanho %ld)\n", topic, (long)tot_len);
 }
 
 /* Callback dos dados MQTT recebidos */
 static void mqtt_incoming_data_cb(void *arg, const u8_t *data, u16_t len, u8_t flags) {
+    TRACE_BEGIN(TRACE_MQTT_INCOMING_DATA);
     // Acumula os dados no buffer
-    if (payload_len + len < sizeof(payload_buffer)) {
+    if (!payload_oversized && payload_len + len < sizeof(payload_buffer)) {
         memcpy(&payload_buffer[payload_len], data, len);
         payload_len += len;
     }
     // Quando termina a mensagem (MQTT_DATA_FLAG_LAST)
-    if (flags & MQTT_DATA_FLAG_LAST) {
+    if ((flags & MQTT_DATA_FLAG_LAST) && payload_oversized) {
+        rx_stats.oversized++; // Nunca entregue truncada; só o contador registra
+    } else if (flags & MQTT_DATA_FLAG_LAST) {
         payload_buffer[payload_len] = '\0';
-        if (user_message_handler) {
-            user_message_handler(topic_buffer, payload_buffer, payload_len);
+        mqtt_message_handler_t handler = user_message_handler;
+        for (size_t i = 0; i < subscription_count; i++) {
+            if (subscriptions[i].handler != NULL && strcmp(subscriptions[i].topic, topic_buffer) == 0) {
+                handler = subscriptions[i].handler;
+                break;
+            }
         }
+        if (handler) {
+            uint32_t handler_start_us = time_us_32();
+            handler(topic_buffer, payload_buffer, payload_len);
+            rx_stats.busy_us += time_us_32() - handler_start_us;
+            rx_stats.messages++;
+        }
+    }
+    if (flags & MQTT_DATA_FLAG_LAST) {
         payload_len = 0; // Reset para próxima mensagem!
     }
+    TRACE_END(TRACE_MQTT_INCOMING_DATA);
+}
+
+void mqtt_comm_get_rx_stats(mqtt_rx_stats_t *stats) {
+    *stats = rx_stats;
+}
+
+uint32_t mqtt_comm_message_age_us(void) {
+    return time_us_32() - message_start_us;
 }
 
 /* --- Inscrição em tópico --- */
-void mqtt_comm_subscribe(const char *topic) {
+void mqtt_comm_subscribe_with_handler(const char *topic, mqtt_message_handler_t handler) {
+    for (size_t i = 0; i < subscription_count; i++) {
+        if (strcmp(subscriptions[i].topic, topic) == 0) {
+            subscriptions[i].handler = handler; // Já assinado (ex.: ao voltar a um modo): só troca o handler
+            return;
+        }
+    }
+    if (subscription_count >= MQTT_COMM_MAX_SUBSCRIPTIONS) {
+        printf("Limite de tópicos assinados atingido: %s\n", topic);
+        return;
+    }
+    subscriptions[subscription_count].topic = topic;
+    subscriptions[subscription_count].handler = handler;
+    subscription_count++;
+
+    // Desconectado: a inscrição é feita ao receber o CONNACK
+    if (!mqtt_client_is_connected(client)) {
+        return;
+    }
     err_t err = mqtt_subscribe(client, topic, 0, mqtt_sub_request_cb, (void *)topic);
     if (err == ERR_OK) {
         printf("Inscrito no tópico: %s\n", topic);
@@ -52,6 +140,34 @@ void mqtt_comm_subscribe(const char *topic) {
     }
 }
 
+void mqtt_comm_subscribe(const char *topic) {
+    mqtt_comm_subscribe_with_handler(topic, NULL);
+}
+
+void mqtt_comm_unsubscribe(const char *topic) {
+    size_t i = 0;
+    while (i < subscription_count && strcmp(subscriptions[i].topic, topic) != 0) {
+        i++;
+    }
+    if (i == subscription_count) {
+        return;
+    }
+    const char *stored = subscriptions[i].topic;
+    for (; i + 1 < subscription_count; i++) {
+        subscriptions[i] = subscriptions[i + 1];
+    }
+    subscription_count--;
+
+    // Desconectado: basta sair da lista, que é a que se reinscreve no CONNACK
+    if (!mqtt_client_is_connected(client)) {
+        return;
+    }
+    err_t err = mqtt_unsubscribe(client, stored, mqtt_sub_request_cb, (void *)stored);
+    if (err != ERR_OK) {
+        printf("Falha ao cancelar a inscrição no tópico %s, código: %d\n", stored, err);
+    }
+}
+
 /* Handler configurável para chegada de mensagem */
 void mqtt_comm_set_message_handler(mqtt_message_handler_t handler) {
     user_message_handler = handler;
@@ -61,23 +177,114 @@ void mqtt_comm_set_message_handler(mqtt_message_handler_t handler) {
 void mqtt_sub_request_cb(void *arg, err_t result) {
     const char *topic = (const char *)arg;
     if (result == ERR_OK) {
-        printf("Inscrição confirmada no tópico: %s\n", topic);
+        LOG_INFO("Inscrição (ou cancelamento) confirmada no tópico: %s\n", topic);
     } else {
-        printf("Erro na inscrição do tópico %s, código: %d\n", topic, result);
+        LOG_ERROR("Erro na inscrição do tópico %s, código: %d\n", topic, result);
     }
 }
 
+#if MQTT_USE_TLS
+/* Bytes atualmente alocados no heap (o mbedTLS aloca contextos e buffers de registro via calloc) */
+static int tls_heap_in_use(void) {
+    struct mallinfo mi = mallinfo();
+    return mi.uordblks;
+}
+
+/* Registra tempo e RAM do handshake que acabou de terminar e salva a sessão para a próxima conexão */
+static void tls_handshake_done(mqtt_client_t *client) {
+    uint32_t elapsed_us = time_us_32() - tls_connect_start_us;
+    int heap_used = tls_heap_in_use() - tls_heap_before;
+
+    // Sessão negociada (session ID / ticket), guardada para pular o ECDHE na próxima conexão
+    struct altcp_tls_session negotiated;
+    altcp_tls_init_session(&negotiated);
+    bool negotiated_valid = altcp_tls_get_session(client->conn, &negotiated) == ERR_OK;
+
+    // Só é retomada se o servidor aceitou a sessão oferecida: ele devolve o mesmo session ID.
+    // Um ID diferente significa que o servidor recusou e fez o handshake completo.
+    bool resumed = false;
+    if (tls_resume_attempted && negotiated_valid) {
+        size_t id_len = negotiated.data.MBEDTLS_PRIVATE(id_len);
+        resumed = id_len > 0 && id_len == tls_offered_id_len &&
+                  memcmp(negotiated.data.MBEDTLS_PRIVATE(id), tls_offered_id, id_len) == 0;
+    }
+    if (tls_resume_attempted && !resumed) {
+        tls_stats.resume_refused_count++;
+    }
+
+    if (resumed) {
+        tls_stats.resumed_count++;
+        tls_stats.resumed_last_us = elapsed_us;
+        tls_stats.resumed_heap_bytes = heap_used;
+    } else {
+        tls_stats.full_count++;
+        tls_stats.full_last_us = elapsed_us;
+        tls_stats.full_heap_bytes = heap_used;
+    }
+    LOG_INFO("Handshake TLS %s: %lu us, heap +%d bytes\n",
+           resumed ? "retomado" : (tls_resume_attempted ? "completo (sessao recusada)" : "completo"),
+           (unsigned long)elapsed_us, heap_used);
+
+    if (tls_session_valid) {
+        altcp_tls_free_session(&tls_session);
+        tls_session_valid = false;
+    }
+    if (negotiated_valid) {
+        tls_session = negotiated;
+        tls_session_valid = true;
+    } else {
+        altcp_tls_free_session(&negotiated);
+    }
+}
+#endif
+
 static void mqtt_connection_cb(mqtt_client_t *client, void *arg, mqtt_connection_status_t status) {
     if (status == MQTT_CONNECT_ACCEPTED) {
-        printf("Conectado ao broker MQTT com sucesso!\n");
+        LOG_INFO("Conectado ao broker MQTT com sucesso!\n");
+        reconnect_delay_ms = MQTT_RECONNECT_MIN_MS;
+#if MQTT_USE_TLS
+        tls_handshake_done(client);
+#endif
         mqtt_set_inpub_callback(client, mqtt_incoming_publish_cb, mqtt_incoming_data_cb, NULL);
+        for (size_t i = 0; i < subscription_count; i++) {
+            mqtt_subscribe(client, subscriptions[i].topic, 0, mqtt_sub_request_cb, (void *)subscriptions[i].topic);
+        }
     } else {
-        printf("Falha ao conectar ao broker, código: %d\n", status);
+        LOG_ERROR("Falha ao conectar ao broker, código: %d\n", status);
+    }
+}
+
+/* Abre a conexão com o broker usando os parâmetros guardados em mqtt_setup */
+static err_t mqtt_comm_connect(void) {
+#if MQTT_USE_TLS
+    uint32_t start_us = time_us_32();
+    int heap_before = tls_heap_in_use();
+#endif
+
+    err_t err = mqtt_client_connect(client, &broker_addr, MQTT_BROKER_PORT, mqtt_connection_cb, NULL, &client_info);
+
+#if MQTT_USE_TLS
+    // O handshake só começa quando o TCP conecta, então ainda dá tempo de
+    // configurar o SNI e oferecer a sessão salva ao servidor.
+    if (err == ERR_OK) {
+        tls_connect_start_us = start_us;
+        tls_heap_before = heap_before;
+        tls_resume_attempted = false;
+        mbedtls_ssl_set_hostname(altcp_tls_context(client->conn), MQTT_TLS_SERVER_NAME);
+        if (tls_session_valid && altcp_tls_set_session(client->conn, &tls_session) == ERR_OK) {
+            tls_resume_attempted = true;
+            tls_offered_id_len = tls_session.data.MBEDTLS_PRIVATE(id_len);
+            if (tls_offered_id_len > sizeof(tls_offered_id)) {
+                tls_offered_id_len = sizeof(tls_offered_id);
+            }
+            memcpy(tls_offered_id, tls_session.data.MBEDTLS_PRIVATE(id), tls_offered_id_len);
+        }
     }
+#endif
+    return err;
 }
 
 void mqtt_setup(const char *client_id, const char *broker_ip, const char *user, const char *pass) {
-    ip_addr_t broker_addr;
     if (!ip4addr_aton(broker_ip, &broker_addr)) {
         printf("Erro no IP\n");
         return;
@@ -89,40 +296,101 @@ void mqtt_setup(const char *client_id, const char *broker_ip, const char *user,
         return;
     }
 
-    struct mqtt_connect_client_info_t ci = {
-        .client_id = client_id,
-        .client_user = user,
-        .client_pass = pass
-    };
+    memset(&client_info, 0, sizeof(client_info));
+    client_info.client_id = client_id;
+    client_info.client_user = user;
+    client_info.client_pass = pass;
+
+#if MQTT_USE_TLS
+    // Certificado da CA em PEM: o tamanho inclui o '\0' final, exigido pelo parser do mbedTLS
+    tls_config = altcp_tls_create_config_client((const u8_t *)MQTT_TLS_CA_CERT, sizeof(MQTT_TLS_CA_CERT));
+    if (tls_config == NULL) {
+        printf("Falha ao criar a configuração TLS\n");
+        return;
+    }
+    client_info.tls_config = tls_config;
+#endif
+
+    cyw43_arch_lwip_begin();
+    mqtt_comm_connect();
+    cyw43_arch_lwip_end();
+}
+
+int mqtt_comm_reconnect(void) {
+    if (client == NULL) {
+        return -1;
+    }
+
+    // Broker recusando o CONNACK ou handshake TLS falhando: sem espera, cada volta do laço
+    // principal repetiria a tentativa (no TLS, um ECDHE completo e a alocação dos buffers)
+    uint32_t now_ms = to_ms_since_boot(get_absolute_time());
+    if ((int32_t)(now_ms - reconnect_next_ms) < 0) {
+        return 0;
+    }
+    reconnect_next_ms = now_ms + reconnect_delay_ms;
+    reconnect_delay_ms = reconnect_delay_ms * 2 < MQTT_RECONNECT_MAX_MS ? reconnect_delay_ms * 2 : MQTT_RECONNECT_MAX_MS;
+
+    cyw43_arch_lwip_begin();
+    if (mqtt_client_is_connected(client)) {
+        mqtt_disconnect(client);
+    }
+    err_t err = mqtt_comm_connect();
+    cyw43_arch_lwip_end();
+
+    // ERR_ISCONN: uma tentativa anterior ainda está em andamento
+    return (err == ERR_OK || err == ERR_ISCONN) ? 0 : -1;
+}
 
-    mqtt_client_connect(client, &broker_addr, MQTT_BROKER_PORT, mqtt_connection_cb, NULL, &ci);
+#if MQTT_USE_TLS
+void mqtt_comm_get_tls_stats(mqtt_tls_stats_t *stats) {
+    *stats = tls_stats;
 }
+#endif
 
 static void mqtt_pub_request_cb(void *arg, err_t result) {
     if (result == ERR_OK) {
-        printf("Publicação MQTT enviada com sucesso!\n");
+        LOG_DEBUG("Publicação MQTT enviada com sucesso!\n");
     } else {
-        printf("Erro ao publicar via MQTT: %d\n", result);
+        LOG_ERROR("Erro ao publicar via MQTT: %d\n", result);
     }
 }
 
-void mqtt_comm_publish(const char *topic, const uint8_t *data, size_t len) {
+static err_t mqtt_comm_publish_flags(const char *topic, const uint8_t *data, size_t len, u8_t qos, u8_t retain) {
+    if (client == NULL) {
+        return ERR_CONN;
+    }
+    TRACE_BEGIN(TRACE_MQTT_PUBLISH);
     err_t status = mqtt_publish(
         client,
         topic,
         data,
         len,
-        0,
-        0,
+        qos,
+        retain,
         mqtt_pub_request_cb,
         NULL
     );
+    TRACE_END(TRACE_MQTT_PUBLISH);
 
     if (status != ERR_OK) {
-        printf("mqtt_publish falhou ao ser enviada: %d\n", status);
+        LOG_ERROR("mqtt_publish falhou ao ser enviada: %d\n", status);
     }
+    return status;
+}
+
+void mqtt_comm_publish(const char *topic, const uint8_t *data, size_t len) {
+    mqtt_comm_publish_flags(topic, data, len, 0, 0);
+}
+
+int mqtt_comm_publish_retained(const char *topic, const uint8_t *data, size_t len) {
+    return mqtt_comm_publish_flags(topic, data, len, 1, 1) == ERR_OK ? 0 : -1;
+}
+
+int mqtt_comm_publish_qos(const char *topic, const uint8_t *data, size_t len, uint8_t qos) {
+    return mqtt_comm_publish_flags(topic, data, len, qos, 0) == ERR_OK ? 0 : -1;
 }
 
 int mqtt_comm_is_connected() {
-    return mqtt_client_is_connected(client);
+    // Sem cliente quando o boot seguiu sem rede (firmware de loopback)
+    return client != NULL && mqtt_client_is_connected(client);
 }
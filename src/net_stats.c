@@ -0,0 +1,83 @@
+#include "include/net_stats.h"
+#include "include/mqtt_comm.h"
+#include "config/config.h"
+#include "config/credentials.h"
+#include "pico/stdlib.h"
+#include "lwip/stats.h"
+#include "lwip/memp.h"
+#include <stdio.h>
+#include <string.h>
+
+static uint32_t last_publish_ms = 0;
+
+#if LWIP_POOL_STATS
+// Nomes dos pools na mesma ordem do enum memp_t
+static const char *const pool_names[MEMP_MAX] = {
+#define LWIP_MEMPOOL(name, num, size, desc) #name,
+#include "lwip/priv/memp_std.h"
+};
+#endif
+
+void net_stats_print(void) {
+#if LWIP_POOL_STATS
+    printf("lwIP heap: usado=%u max=%u disp=%u falhas=%u\n",
+           (unsigned)lwip_stats.mem.used, (unsigned)lwip_stats.mem.max,
+           (unsigned)lwip_stats.mem.avail, (unsigned)lwip_stats.mem.err);
+    for (int i = 0; i < MEMP_MAX; i++) {
+        const struct stats_mem *pool = lwip_stats.memp[i];
+        printf("  %-16s usado=%u max=%u disp=%u falhas=%u\n", pool_names[i],
+               (unsigned)pool->used, (unsigned)pool->max, (unsigned)pool->avail, (unsigned)pool->err);
+    }
+#else
+    printf("Estatisticas do lwIP desabilitadas (compile com LWIP_POOL_STATS=ON)\n");
+#endif
+}
+
+size_t net_stats_format(char *buf, size_t len) {
+    if (len == 0) {
+        return 0;
+    }
+#if LWIP_POOL_STATS
+    int n = snprintf(buf, len, "MEM:%u/%u/%u", (unsigned)lwip_stats.mem.used,
+                     (unsigned)lwip_stats.mem.max, (unsigned)lwip_stats.mem.err);
+    size_t pos = (n < 0) ? 0 : (size_t)n;
+    for (int i = 0; i < MEMP_MAX && pos < len; i++) {
+        const struct stats_mem *pool = lwip_stats.memp[i];
+        if (pool->max == 0 && pool->err == 0) {
+            continue; // Pool nunca utilizado: não ocupa espaço no payload
+        }
+        n = snprintf(buf + pos, len - pos, ";%s:%u/%u/%u/%u", pool_names[i], (unsigned)pool->used,
+                     (unsigned)pool->max, (unsigned)pool->avail, (unsigned)pool->err);
+        if (n < 0) {
+            break;
+        }
+        pos += (size_t)n;
+    }
+    if (pos >= len) {
+        pos = len - 1; // snprintf truncou a última entrada
+    }
+    return pos;
+#else
+    buf[0] = '\0';
+    return 0;
+#endif
+}
+
+void net_stats_poll(const char *client_id) {
+#if LWIP_POOL_STATS
+    uint32_t now_ms = to_ms_since_boot(get_absolute_time());
+    if (now_ms - last_publish_ms < NET_STATS_PUBLISH_INTERVAL_MS || !mqtt_comm_is_connected()) {
+        return;
+    }
+    last_publish_ms = now_ms;
+
+    static char topic[64];
+    static char payload[256];
+    snprintf(topic, sizeof(topic), "%s/%s", MQTT_TOPIC_STATUS, client_id);
+    size_t payload_len = net_stats_format(payload, sizeof(payload));
+    mqtt_comm_publish(topic, (const uint8_t *)payload, payload_len);
+#else
+    (void)client_id;
+    (void)last_publish_ms;
+#endif
+}
@@ -0,0 +1,213 @@
+#include "include/nonce.h"
+#include "config/config.h"
+#include "pico/stdlib.h"
+#include "pico/unique_id.h"
+#include "hardware/flash.h"
+#include "hardware/sync.h"
+#include <stdio.h>
+#include <string.h>
+
+#define NONCE_RECORD_MAGIC 0x4E4F4E43u // "NONC"
+#define NONCE_RECORD_SLOTS (FLASH_SECTOR_SIZE / sizeof(nonce_record_t))
+
+// Registro gravado a cada boot; o setor é preenchido sequencialmente e só é apagado quando enche
+typedef struct {
+    uint32_t magic;
+    uint32_t boot;
+    uint32_t boot_inv; // ~boot, detecta gravação interrompida
+    uint32_t reserved;
+} nonce_record_t;
+
+typedef struct {
+    bool used;
+    nonce_seq_t last;
+} nonce_window_t;
+
+static uint32_t sender_id = 0;
+static uint32_t boot_counter = 0; // 0 = nonce_init() não executado
+static uint32_t message_counter = 0;
+static nonce_window_t windows[NONCE_MAX_SENDERS];
+
+// Dois setores alternados: ao encher um, o outro é apagado e recebe o próximo registro, de modo
+// que uma queda de energia durante o apagamento nunca perde o último valor gravado
+static const nonce_record_t *flash_records(int sector) {
+    return (const nonce_record_t *)(XIP_BASE + NONCE_FLASH_OFFSET + (size_t)sector * FLASH_SECTOR_SIZE);
+}
+
+static bool record_is_valid(const nonce_record_t *record) {
+    return record->magic == NONCE_RECORD_MAGIC && record->boot_inv == ~record->boot;
+}
+
+static bool record_is_erased(const nonce_record_t *record) {
+    const uint32_t *words = (const uint32_t *)record;
+    for (size_t i = 0; i < sizeof(nonce_record_t) / sizeof(uint32_t); i++) {
+        if (words[i] != 0xFFFFFFFFu) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static void write_u32_be(uint8_t *out, uint32_t value) {
+    out[0] = (uint8_t)(value >> 24);
+    out[1] = (uint8_t)(value >> 16);
+    out[2] = (uint8_t)(value >> 8);
+    out[3] = (uint8_t)value;
+}
+
+static uint32_t read_u32_be(const uint8_t *in) {
+    return ((uint32_t)in[0] << 24) | ((uint32_t)in[1] << 16) | ((uint32_t)in[2] << 8) | in[3];
+}
+
+// Grava `record` no slot indicado, apagando o setor antes se `erase` for verdadeiro
+static void program_record(int sector, size_t slot, const nonce_record_t *record, bool erase) {
+    // A gravação é feita por página; bytes 0xFF não alteram o conteúdo já gravado
+    static uint8_t page[FLASH_PAGE_SIZE];
+    uint32_t sector_offset = NONCE_FLASH_OFFSET + (uint32_t)sector * FLASH_SECTOR_SIZE;
+    size_t offset_in_sector = slot * sizeof(nonce_record_t);
+    size_t page_offset = offset_in_sector - (offset_in_sector % FLASH_PAGE_SIZE);
+    memset(page, 0xFF, sizeof(page));
+    memcpy(page + (offset_in_sector - page_offset), record, sizeof(*record));
+
+    uint32_t irq_state = save_and_disable_interrupts();
+    if (erase) {
+        flash_range_erase(sector_offset, FLASH_SECTOR_SIZE);
+    }
+    flash_range_program(sector_offset + page_offset, page, FLASH_PAGE_SIZE);
+    restore_interrupts(irq_state);
+}
+
+bool nonce_init(void) {
+    pico_unique_board_id_t board_id;
+    pico_get_unique_board_id(&board_id);
+    sender_id = read_u32_be(&board_id.id[0]) ^ read_u32_be(&board_id.id[4]);
+
+    // Procura o maior contador gravado e o primeiro slot livre de cada setor
+    uint32_t last_boot = 0;
+    int active_sector = 0;
+    size_t next_slot[2] = {0, 0};
+    for (int sector = 0; sector < 2; sector++) {
+        const nonce_record_t *records = flash_records(sector);
+        for (size_t i = 0; i < NONCE_RECORD_SLOTS; i++) {
+            if (record_is_valid(&records[i]) && records[i].boot > last_boot) {
+                last_boot = records[i].boot;
+                active_sector = sector;
+            }
+            // Slots válidos e gravações interrompidas não podem ser reaproveitados sem apagar
+            if (!record_is_erased(&records[i])) {
+                next_slot[sector] = i + 1;
+            }
+        }
+    }
+
+    if (last_boot == UINT32_MAX) {
+        printf("Nonce: contador de boots esgotado\n");
+        return false;
+    }
+
+    nonce_record_t record = {
+        .magic = NONCE_RECORD_MAGIC,
+        .boot = last_boot + 1,
+        .boot_inv = ~(last_boot + 1),
+        .reserved = 0xFFFFFFFFu,
+    };
+    int sector = active_sector;
+    size_t slot = next_slot[active_sector];
+    bool erase = false;
+    if (slot >= NONCE_RECORD_SLOTS) {
+        sector = 1 - active_sector;
+        slot = 0;
+        erase = true;
+    }
+    program_record(sector, slot, &record, erase);
+
+    // Confere a gravação antes de liberar o uso de nonces
+    const nonce_record_t *written = &flash_records(sector)[slot];
+    if (!record_is_valid(written) || written->boot != record.boot) {
+        printf("Nonce: falha ao gravar o contador de boots\n");
+        return false;
+    }
+
+    boot_counter = record.boot;
+    message_counter = 0;
+    printf("Nonce: remetente %08lx, boot %lu\n", (unsigned long)sender_id, (unsigned long)boot_counter);
+    return true;
+}
+
+int nonce_next(uint8_t out[NONCE_LEN], nonce_seq_t *seq) {
+    // Contador esgotado: reutilizar o nonce quebraria o AEAD, é preciso reiniciar a placa
+    if (boot_counter == 0 || message_counter == UINT32_MAX) {
+        return -1;
+    }
+    message_counter++;
+
+    write_u32_be(out, sender_id);
+    write_u32_be(out + 4, boot_counter);
+    write_u32_be(out + 8, message_counter);
+    if (seq != NULL) {
+        seq->sender = sender_id;
+        seq->boot = boot_counter;
+        seq->counter = message_counter;
+    }
+    return 0;
+}
+
+uint32_t nonce_boot(void) {
+    return boot_counter;
+}
+
+void nonce_parse(const uint8_t nonce[NONCE_LEN], nonce_seq_t *seq) {
+    seq->sender = read_u32_be(nonce);
+    seq->boot = read_u32_be(nonce + 4);
+    seq->counter = read_u32_be(nonce + 8);
+}
+
+static nonce_window_t *find_window(uint32_t sender) {
+    for (size_t i = 0; i < NONCE_MAX_SENDERS; i++) {
+        if (windows[i].used && windows[i].last.sender == sender) {
+            return &windows[i];
+        }
+    }
+    return NULL;
+}
+
+static nonce_window_t *find_free_window(void) {
+    for (size_t i = 0; i < NONCE_MAX_SENDERS; i++) {
+        if (!windows[i].used) {
+            return &windows[i];
+        }
+    }
+    return NULL;
+}
+
+static bool seq_is_newer(const nonce_seq_t *seq, const nonce_seq_t *last) {
+    return seq->boot > last->boot || (seq->boot == last->boot && seq->counter > last->counter);
+}
+
+bool nonce_seq_is_fresh(const nonce_seq_t *seq) {
+    nonce_window_t *window = find_window(seq->sender);
+    if (window != NULL) {
+        return seq_is_newer(seq, &window->last);
+    }
+    return find_free_window() != NULL;
+}
+
+bool nonce_seq_accept(const nonce_seq_t *seq) {
+    nonce_window_t *window = find_window(seq->sender);
+    if (window != NULL) {
+        if (!seq_is_newer(seq, &window->last)) {
+            return false;
+        }
+        window->last = *seq;
+        return true;
+    }
+
+    // Remetente desconhecido: ocupa uma janela livre; sem janela livre a mensagem é recusada
+    window = find_free_window();
+    if (window == NULL) {
+        return false;
+    }
+    window->used = true;
+    window->last = *seq;
+    return true;
+}
@@ -0,0 +1,289 @@
+#include "include/numfmt.h"
+#include "pico/stdlib.h"
+#include "hardware/clocks.h"
+#include <stdbool.h>
+#include <stdio.h>
+#include <string.h>
+
+#ifndef NUMFMT_BENCH_SSCANF
+#define NUMFMT_BENCH_SSCANF 0 // 1 = compara com o sscanf (volta a linkar o scanf da newlib)
+#endif
+#define NUMFMT_BENCH_CALLS 10000
+
+// "00" "01" ... "99": o par de n começa em digit_pairs[2 * n]
+static const char digit_pairs[200] =
+    "0001020304050607080910111213141516171819"
+    "2021222324252627282930313233343536373839"
+    "4041424344454647484950515253545556575859"
+    "6061626364656667686970717273747576777879"
+    "8081828384858687888990919293949596979899";
+
+// 10^8 = 2^8 * 390625: floor(x / 10^8) = (x * M) >> (64 + 26) para todo x de 64 bits
+#define RECIPROCAL_1E8 0xABCC77118461CEFDull
+#define RECIPROCAL_1E8_SHIFT 26
+
+// Metade alta de a * b sem inteiro de 128 bits (o M0+ só multiplica 32 x 32)
+static uint64_t mul_high(uint64_t a, uint64_t b) {
+    uint64_t a_lo = (uint32_t)a, a_hi = a >> 32;
+    uint64_t b_lo = (uint32_t)b, b_hi = b >> 32;
+    uint64_t lo_lo = a_lo * b_lo;
+    uint64_t hi_lo = a_hi * b_lo;
+    uint64_t lo_hi = a_lo * b_hi;
+    uint64_t cross = (lo_lo >> 32) + (uint32_t)hi_lo + lo_hi;
+    return a_hi * b_hi + (hi_lo >> 32) + (cross >> 32);
+}
+
+static uint64_t div_1e8(uint64_t x) {
+    return mul_high(x, RECIPROCAL_1E8) >> RECIPROCAL_1E8_SHIFT;
+}
+
+// 4 dígitos de n < 10^4, com zeros à esquerda
+static void put4(char *out, uint32_t n) {
+    uint32_t high = (n * 5243u) >> 19; // n / 100, exato para n < 43699
+    memcpy(out, &digit_pairs[2 * high], 2);
+    memcpy(out + 2, &digit_pairs[2 * (n - high * 100)], 2);
+}
+
+// 8 dígitos de n < 10^8, com zeros à esquerda
+static void put8(char *out, uint32_t n) {
+    uint32_t high = (uint32_t)(((uint64_t)n * 109951163u) >> 40); // n / 10^4, exato para n < 10^8
+    put4(out, high);
+    put4(out + 4, n - high * 10000);
+}
+
+// Escreve value em digits[0..23] (3 blocos de 8) e devolve o índice do primeiro dígito
+// significativo, mantendo pelo menos min_digits dígitos
+static size_t put_digits(char digits[24], uint64_t value, size_t min_digits) {
+    size_t start = 16;
+    if (value < 100000000u) {
+        put8(digits + 16, (uint32_t)value);
+    } else {
+        uint64_t high = div_1e8(value);
+        put8(digits + 16, (uint32_t)(value - high * 100000000u));
+        start = 8;
+        if (high < 100000000u) {
+            put8(digits + 8, (uint32_t)high);
+        } else {
+            uint64_t top = div_1e8(high); // < 1845
+            put8(digits + 8, (uint32_t)(high - top * 100000000u));
+            put8(digits, (uint32_t)top);
+            start = 0;
+        }
+    }
+    while (start < 24 - min_digits && digits[start] == '0') {
+        start++;
+    }
+    if (start > 24 - min_digits) {
+        memset(digits + 24 - min_digits, '0', start - (24 - min_digits)); // Valor pequeno com muitas casas
+        start = 24 - min_digits;
+    }
+    return start;
+}
+
+size_t numfmt_u64(char *out, uint64_t value) {
+    char digits[24];
+    size_t start = put_digits(digits, value, 1);
+    size_t len = 24 - start;
+    memcpy(out, digits + start, len);
+    out[len] = '\0';
+    return len;
+}
+
+size_t numfmt_fixed(char *out, int32_t value, uint8_t decimals) {
+    uint32_t magnitude = value < 0 ? 0u - (uint32_t)value : (uint32_t)value;
+    char digits[24];
+    size_t start = put_digits(digits, magnitude, (size_t)decimals + 1);
+    size_t whole = 24 - start - decimals;
+    char *p = out;
+    if (value < 0) {
+        *p++ = '-';
+    }
+    memcpy(p, digits + start, whole);
+    p += whole;
+    if (decimals > 0) {
+        *p++ = '.';
+        memcpy(p, digits + 24 - decimals, decimals);
+        p += decimals;
+    }
+    *p = '\0';
+    return (size_t)(p - out);
+}
+
+size_t numfmt_reading(char *out, size_t size, int32_t value, uint8_t decimals, uint64_t timestamp) {
+    if (size < NUMFMT_FIXED_LEN + 1 + NUMFMT_U64_LEN + 1) {
+        // Buffer justo: monta em um rascunho e confere o tamanho
+        char scratch[NUMFMT_FIXED_LEN + 1 + NUMFMT_U64_LEN + 1];
+        size_t len = numfmt_reading(scratch, sizeof(scratch), value, decimals, timestamp);
+        if (len + 1 > size) {
+            return 0;
+        }
+        memcpy(out, scratch, len + 1);
+        return len;
+    }
+    size_t len = numfmt_fixed(out, value, decimals);
+    out[len++] = ',';
+    return len + numfmt_u64(out + len, timestamp);
+}
+
+numfmt_status_t numfmt_parse_u64(const char *text, size_t len, uint64_t *value) {
+    static const uint32_t powers[10] = {1, 10, 100, 1000, 10000, 100000, 1000000, 10000000, 100000000, 1000000000};
+    if (len == 0) {
+        return NUMFMT_ERR_EMPTY;
+    }
+    size_t i = 0;
+    while (i + 1 < len && text[i] == '0') {
+        i++; // Zeros à esquerda não contam para o limite de 20 dígitos
+    }
+    if (len - i > NUMFMT_U64_LEN) {
+        return NUMFMT_ERR_RANGE;
+    }
+    bool at_limit = len - i == NUMFMT_U64_LEN;
+    const char *significant = text + i;
+
+    uint64_t result = 0;
+    while (i < len) {
+        size_t chunk_len = len - i < 9 ? len - i : 9;
+        uint32_t chunk = 0;
+        for (size_t k = 0; k < chunk_len; k++) {
+            uint32_t digit = (uint32_t)(uint8_t)text[i + k] - '0';
+            if (digit > 9) {
+                return NUMFMT_ERR_SYNTAX;
+            }
+            chunk = chunk * 10 + digit;
+        }
+        result = result * powers[chunk_len] + chunk;
+        i += chunk_len;
+    }
+    // Com 20 dígitos só cabe até UINT64_MAX; a comparação do texto evita a divisão de 64 bits
+    if (at_limit && memcmp(significant, "18446744073709551615", NUMFMT_U64_LEN) > 0) {
+        return NUMFMT_ERR_RANGE;
+    }
+    *value = result;
+    return NUMFMT_OK;
+}
+
+numfmt_status_t numfmt_parse_fixed(const char *text, size_t len, uint8_t decimals, int32_t *value) {
+    size_t i = len > 0 && text[0] == '-';
+    bool negative = i == 1;
+    int32_t result = 0;
+    bool seen = false;
+    unsigned digits = 0; // Significativos: zeros à esquerda não contam ("0.000000001")
+    int fraction = -1; // Casas lidas depois do ponto (-1 antes do ponto)
+    for (; i < len; i++) {
+        if (text[i] == '.' && fraction < 0) {
+            fraction = 0;
+            continue;
+        }
+        uint32_t digit = (uint32_t)(uint8_t)text[i] - '0';
+        if (digit > 9) {
+            return NUMFMT_ERR_SYNTAX;
+        }
+        if (fraction >= decimals) {
+            continue; // Casas além da precisão pedida
+        }
+        seen = true;
+        if ((result != 0 || digit != 0) && ++digits > 9) {
+            return NUMFMT_ERR_RANGE;
+        }
+        result = result * 10 + (int32_t)digit;
+        fraction += fraction >= 0;
+    }
+    if (!seen) {
+        return NUMFMT_ERR_EMPTY;
+    }
+    for (int pad = fraction < 0 ? 0 : fraction; pad < decimals; pad++) {
+        if (result != 0 && ++digits > 9) {
+            return NUMFMT_ERR_RANGE;
+        }
+        result *= 10;
+    }
+    *value = negative ? -result : result;
+    return NUMFMT_OK;
+}
+
+numfmt_status_t numfmt_parse_reading(const char *text, size_t len, char *value, size_t value_size,
+                                     uint64_t *timestamp) {
+    const char *comma = memchr(text, ',', len);
+    if (comma == NULL) {
+        return NUMFMT_ERR_SYNTAX;
+    }
+    size_t value_len = (size_t)(comma - text);
+    if (value_len == 0) {
+        return NUMFMT_ERR_EMPTY;
+    }
+    numfmt_status_t status = numfmt_parse_u64(comma + 1, len - value_len - 1, timestamp);
+    if (status != NUMFMT_OK || value == NULL || value_size == 0) {
+        return status;
+    }
+    if (value_len > value_size - 1) {
+        value_len = value_size - 1;
+    }
+    memcpy(value, text, value_len);
+    value[value_len] = '\0';
+    return NUMFMT_OK;
+}
+
+/* --- Benchmark --- */
+// Timestamps de um boot recente, de depois de 71 min (acima de 32 bits) e de meses ligado
+static const uint64_t bench_timestamps[] = {5123456ull, 5000123456ull, 31536000123456ull, UINT64_MAX};
+#define BENCH_TIMESTAMP_COUNT (sizeof(bench_timestamps) / sizeof(bench_timestamps[0]))
+
+static volatile uint32_t bench_sink; // Impede o compilador de descartar os resultados
+
+static void print_cycles(const char *name, uint64_t elapsed_us, uint32_t mhz) {
+    uint64_t centi_cycles = elapsed_us * mhz * 100 / NUMFMT_BENCH_CALLS;
+    printf("%-26s %6lu.%02lu ciclos/chamada\n", name, (unsigned long)(centi_cycles / 100),
+           (unsigned long)(centi_cycles % 100));
+}
+
+void numfmt_benchmark(void) {
+    const uint32_t mhz = clock_get_hz(clk_sys) / 1000000;
+    char text[NUMFMT_FIXED_LEN + NUMFMT_U64_LEN + 3];
+    char messages[BENCH_TIMESTAMP_COUNT][sizeof(text)];
+    size_t lengths[BENCH_TIMESTAMP_COUNT];
+    for (size_t t = 0; t < BENCH_TIMESTAMP_COUNT; t++) {
+        lengths[t] = numfmt_reading(messages[t], sizeof(messages[t]), 265, 1, bench_timestamps[t]);
+    }
+
+    uint64_t start_us = time_us_64();
+    for (uint32_t n = 0; n < NUMFMT_BENCH_CALLS; n++) {
+        bench_sink += snprintf(text, sizeof(text), "%llu", bench_timestamps[n % BENCH_TIMESTAMP_COUNT]);
+    }
+    print_cycles("u64: snprintf(\"%llu\")", time_us_64() - start_us, mhz);
+
+    start_us = time_us_64();
+    for (uint32_t n = 0; n < NUMFMT_BENCH_CALLS; n++) {
+        bench_sink += numfmt_u64(text, bench_timestamps[n % BENCH_TIMESTAMP_COUNT]);
+    }
+    print_cycles("u64: numfmt_u64", time_us_64() - start_us, mhz);
+
+    start_us = time_us_64();
+    for (uint32_t n = 0; n < NUMFMT_BENCH_CALLS; n++) {
+        bench_sink += snprintf(text, sizeof(text), "26.5,%llu", bench_timestamps[n % BENCH_TIMESTAMP_COUNT]);
+    }
+    print_cycles("mensagem: snprintf", time_us_64() - start_us, mhz);
+
+    start_us = time_us_64();
+    for (uint32_t n = 0; n < NUMFMT_BENCH_CALLS; n++) {
+        bench_sink += numfmt_reading(text, sizeof(text), 265, 1, bench_timestamps[n % BENCH_TIMESTAMP_COUNT]);
+    }
+    print_cycles("mensagem: numfmt_reading", time_us_64() - start_us, mhz);
+
+    char value[32];
+    uint64_t timestamp = 0;
+#if NUMFMT_BENCH_SSCANF
+    start_us = time_us_64();
+    for (uint32_t n = 0; n < NUMFMT_BENCH_CALLS; n++) {
+        bench_sink += sscanf(messages[n % BENCH_TIMESTAMP_COUNT], "%31[^,],%llu", value, &timestamp);
+    }
+    print_cycles("parse: sscanf", time_us_64() - start_us, mhz);
+#endif
+
+    start_us = time_us_64();
+    for (uint32_t n = 0; n < NUMFMT_BENCH_CALLS; n++) {
+        size_t t = n % BENCH_TIMESTAMP_COUNT;
+        bench_sink += numfmt_parse_reading(messages[t], lengths[t], value, sizeof(value), &timestamp);
+    }
+    print_cycles("parse: numfmt_parse_reading", time_us_64() - start_us, mhz);
+    bench_sink += (uint32_t)timestamp;
+}
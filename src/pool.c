@@ -0,0 +1,204 @@
+#include "include/pool.h"
+#include "pico/stdlib.h"
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#define POOL_BENCH_PAIRS 10000 // Pares alocação/liberação por rodada do benchmark
+#define POOL_BENCH_BURST 4     // Blocos alocados de uma vez nas rodadas em rajada
+
+typedef struct {
+    uint16_t block_size;
+    uint8_t block_count; // Até 32 (bits do mapa de livres)
+    uint8_t *storage;
+    uint32_t free_mask;  // Bit i ligado = bloco i livre
+    uint8_t in_use;
+    uint8_t high_water;  // Maior in_use desde o boot
+    uint32_t allocs;
+    uint32_t borrowed;   // Pedidos desta classe atendidos por uma classe maior
+    uint32_t failures;   // Pedidos desta classe sem bloco em nenhuma classe
+} pool_class_t;
+
+// Blocos múltiplos de 8 para manter o alinhamento dentro de cada vetor
+static uint8_t pool_blocks_64[4][64] __attribute__((aligned(8)));    // Lote comprimido de um stream (COMPRESS_MAX_LEN(8))
+static uint8_t pool_blocks_128[4][128] __attribute__((aligned(8)));  // Payload do publisher: FRAME_MAX_OVERHEAD + texto de 64 B
+static uint8_t pool_blocks_256[4][256] __attribute__((aligned(8)));  // Payload de um stream; texto decifrado/descomprimido do subscriber
+static uint8_t pool_blocks_512[2][512] __attribute__((aligned(8)));  // Hex do payload XOR no subscriber (2 * 255 + 1)
+static uint8_t pool_blocks_1032[2][1032] __attribute__((aligned(8))); // Framebuffer do SSD1306 128x64 + byte de comando; reserva da classe de 512
+
+#define POOL_CLASS(blocks) {sizeof((blocks)[0]), sizeof(blocks) / sizeof((blocks)[0]), &(blocks)[0][0], \
+                            (uint32_t)((1ull << (sizeof(blocks) / sizeof((blocks)[0]))) - 1), 0, 0, 0, 0, 0}
+
+// Em ordem crescente de tamanho: pool_alloc pega a primeira classe que comporta o pedido
+static pool_class_t classes[] = {
+    POOL_CLASS(pool_blocks_64),
+    POOL_CLASS(pool_blocks_128),
+    POOL_CLASS(pool_blocks_256),
+    POOL_CLASS(pool_blocks_512),
+    POOL_CLASS(pool_blocks_1032),
+};
+#define POOL_CLASS_COUNT (sizeof(classes) / sizeof(classes[0]))
+
+void *pool_alloc(size_t size) {
+    pool_class_t *wanted = NULL;
+    for (size_t i = 0; i < POOL_CLASS_COUNT; i++) {
+        pool_class_t *class = &classes[i];
+        if (class->block_size < size) {
+            continue;
+        }
+        if (wanted == NULL) {
+            wanted = class;
+        }
+        // O M0+ não tem LDREX/STREX: o bitmap é atualizado com as interrupções desabilitadas
+        uint32_t irq_state = save_and_disable_interrupts();
+        if (class->free_mask == 0) {
+            restore_interrupts(irq_state);
+            continue;
+        }
+        uint32_t index = (uint32_t)__builtin_ctz(class->free_mask);
+        class->free_mask &= class->free_mask - 1;
+        if (++class->in_use > class->high_water) {
+            class->high_water = class->in_use;
+        }
+        class->allocs++;
+        if (class != wanted) {
+            wanted->borrowed++;
+        }
+        restore_interrupts(irq_state);
+        return class->storage + index * class->block_size;
+    }
+    if (wanted != NULL) {
+        wanted->failures++;
+    }
+    return NULL;
+}
+
+void pool_free(void *block) {
+    if (block == NULL) {
+        return;
+    }
+    uintptr_t address = (uintptr_t)block;
+    for (size_t i = 0; i < POOL_CLASS_COUNT; i++) {
+        pool_class_t *class = &classes[i];
+        size_t offset = (size_t)(address - (uintptr_t)class->storage);
+        if (address < (uintptr_t)class->storage || offset >= (size_t)class->block_size * class->block_count) {
+            continue;
+        }
+        uint32_t bit = 1u << (offset / class->block_size);
+        if (offset % class->block_size != 0 || (class->free_mask & bit) != 0) {
+            panic("pool_free: ponteiro invalido ou bloco ja livre (%p)", block);
+        }
+        uint32_t irq_state = save_and_disable_interrupts();
+        class->free_mask |= bit;
+        class->in_use--;
+        restore_interrupts(irq_state);
+        return;
+    }
+    panic("pool_free: ponteiro fora do pool (%p)", block);
+}
+
+size_t pool_arena_bytes(void) {
+    size_t total = 0;
+    for (size_t i = 0; i < POOL_CLASS_COUNT; i++) {
+        total += (size_t)classes[i].block_size * classes[i].block_count;
+    }
+    return total;
+}
+
+void pool_print_stats(void) {
+    printf("bloco  qtd  em uso  pico   alocacoes  emprestados  falhas\n");
+    for (size_t i = 0; i < POOL_CLASS_COUNT; i++) {
+        const pool_class_t *class = &classes[i];
+        printf("%5u  %3u  %6u  %4u  %10lu  %11lu  %6lu\n", class->block_size, class->block_count, class->in_use,
+               class->high_water, (unsigned long)class->allocs, (unsigned long)class->borrowed,
+               (unsigned long)class->failures);
+    }
+    printf("Arena: %u B reservados na linkagem\n", (unsigned)pool_arena_bytes());
+}
+
+/* --- Benchmark --- */
+static void *volatile bench_sink; // Impede o compilador de eliminar pares malloc/free
+
+// Falhas contam os pedidos sem bloco: com elas o tempo mede um NULL, não a alocação
+static uint32_t bench_pool(size_t size, size_t burst, uint32_t *failures) {
+    void *blocks[POOL_BENCH_BURST];
+    *failures = 0;
+    uint64_t start_us = time_us_64();
+    for (uint32_t n = 0; n < POOL_BENCH_PAIRS; n += burst) {
+        for (size_t b = 0; b < burst; b++) {
+            blocks[b] = pool_alloc(size);
+            bench_sink = blocks[b];
+            *failures += blocks[b] == NULL;
+        }
+        for (size_t b = 0; b < burst; b++) {
+            pool_free(blocks[b]);
+        }
+    }
+    return (uint32_t)((time_us_64() - start_us) * 1000 / POOL_BENCH_PAIRS);
+}
+
+// Blocos livres agora na classe que atende o pedido (a que o pool_alloc tenta primeiro)
+static size_t bench_free_blocks(size_t size) {
+    for (size_t i = 0; i < POOL_CLASS_COUNT; i++) {
+        if (classes[i].block_size >= size) {
+            return (size_t)__builtin_popcount(classes[i].free_mask);
+        }
+    }
+    return 0;
+}
+
+static uint32_t bench_malloc(size_t size, size_t burst) {
+    void *blocks[POOL_BENCH_BURST];
+    uint64_t start_us = time_us_64();
+    for (uint32_t n = 0; n < POOL_BENCH_PAIRS; n += burst) {
+        for (size_t b = 0; b < burst; b++) {
+            blocks[b] = malloc(size);
+            bench_sink = blocks[b];
+        }
+        for (size_t b = 0; b < burst; b++) {
+            free(blocks[b]);
+        }
+    }
+    return (uint32_t)((time_us_64() - start_us) * 1000 / POOL_BENCH_PAIRS);
+}
+
+void pool_benchmark(void) {
+    static const struct {
+        size_t size;
+        size_t burst;
+    } rounds[] = {{64, 1}, {256, 1}, {1024, 1}, {128, POOL_BENCH_BURST}};
+
+    // As estatísticas mostram o uso real: o benchmark não entra nelas
+    pool_class_t saved[POOL_CLASS_COUNT];
+    for (size_t i = 0; i < POOL_CLASS_COUNT; i++) {
+        saved[i] = classes[i];
+    }
+
+    printf("pedido  rajada  pool ns/par  malloc ns/par\n");
+    for (size_t r = 0; r < sizeof(rounds) / sizeof(rounds[0]); r++) {
+        // Blocos em uso pelo firmware (ex.: framebuffer) deixariam a rodada medindo empréstimos ou NULL
+        if (bench_free_blocks(rounds[r].size) < rounds[r].burst) {
+            printf("%5u B  %6u  rodada pulada: classe sem %u blocos livres\n", (unsigned)rounds[r].size,
+                   (unsigned)rounds[r].burst, (unsigned)rounds[r].burst);
+            continue;
+        }
+        uint32_t failures;
+        uint32_t pool_ns = bench_pool(rounds[r].size, rounds[r].burst, &failures);
+        uint32_t malloc_ns = bench_malloc(rounds[r].size, rounds[r].burst);
+        printf("%5u B  %6u  %11lu  %13lu", (unsigned)rounds[r].size, (unsigned)rounds[r].burst,
+               (unsigned long)pool_ns, (unsigned long)malloc_ns);
+        if (failures > 0) {
+            printf("  (%lu pedidos sem bloco: tempo do pool invalido)", (unsigned long)failures);
+        }
+        printf("\n");
+    }
+
+    uint32_t irq_state = save_and_disable_interrupts();
+    for (size_t i = 0; i < POOL_CLASS_COUNT; i++) {
+        classes[i].allocs = saved[i].allocs;
+        classes[i].high_water = saved[i].high_water > classes[i].in_use ? saved[i].high_water : classes[i].in_use;
+        classes[i].borrowed = saved[i].borrowed;
+        classes[i].failures = saved[i].failures;
+    }
+    restore_interrupts(irq_state);
+}
@@ -0,0 +1,209 @@
+#include "include/prefilter.h"
+#include "include/mqtt_comm.h"
+#include "include/compress.h"
+#include "include/numfmt.h"
+#include "config/config.h"
+#include "pico/stdlib.h"
+#include <stdio.h>
+
+typedef struct {
+    bool used;
+    uint32_t tokens_milli; // Tokens x 1000, para recarregar sem ponto flutuante
+    uint64_t last_us;      // Última recarga
+} token_bucket_t;
+
+// Remetente já autenticado: o balde `unverified` limita a decifragem dos frames que dizem
+// vir dele (o ID em claro pode ser copiado); `verified` só é debitado depois da tag conferir
+typedef struct {
+    bool used;
+    uint32_t sender;
+    token_bucket_t unverified;
+    token_bucket_t verified; // last_us também serve de LRU
+} sender_slot_t;
+
+static const char *const reason_names[PREFILTER_REASON_COUNT] = {
+    "aceitas", "tamanho", "cabecalho", "replay", "taxa", "tag", "formato",
+};
+
+static token_bucket_t shared_bucket; // Sem ID ou remetente ainda não autenticado
+static sender_slot_t senders[NONCE_MAX_SENDERS];
+static uint32_t counts[PREFILTER_REASON_COUNT];
+// Latência das aceitas desde o último prefilter_print_stats
+static uint32_t latency_count = 0;
+static uint32_t latency_max_us = 0;
+static uint64_t latency_total_us = 0;
+
+static sender_slot_t *slot_for(uint32_t sender) {
+    if (sender != PREFILTER_SENDER_NONE) {
+        for (size_t i = 0; i < NONCE_MAX_SENDERS; i++) {
+            if (senders[i].used && senders[i].sender == sender) {
+                return &senders[i];
+            }
+        }
+    }
+    return NULL;
+}
+
+// Balde cobrado antes da tag: o do ID declarado, se já autenticado, ou o compartilhado
+static token_bucket_t *pre_auth_bucket(uint32_t sender) {
+    sender_slot_t *slot = slot_for(sender);
+    return slot != NULL ? &slot->unverified : &shared_bucket;
+}
+
+static bool take_token(token_bucket_t *bucket) {
+    uint64_t now_us = time_us_64();
+    uint64_t tokens = bucket->tokens_milli;
+    if (!bucket->used) {
+        bucket->used = true;
+        tokens = PREFILTER_BURST * 1000u;
+    } else {
+        tokens += (now_us - bucket->last_us) * PREFILTER_RATE_PER_S / 1000u;
+        if (tokens > PREFILTER_BURST * 1000u) {
+            tokens = PREFILTER_BURST * 1000u;
+        }
+    }
+    bucket->last_us = now_us;
+
+    bool ok = tokens >= 1000u;
+    bucket->tokens_milli = (uint32_t)(ok ? tokens - 1000u : tokens);
+    return ok;
+}
+
+static void refund_token(token_bucket_t *bucket) {
+    bucket->tokens_milli += 1000u;
+    if (bucket->tokens_milli > PREFILTER_BURST * 1000u) {
+        bucket->tokens_milli = PREFILTER_BURST * 1000u;
+    }
+}
+
+static prefilter_reason_t finish(prefilter_reason_t reason) {
+    if (reason != PREFILTER_PASS) {
+        counts[reason]++;
+    }
+    return reason;
+}
+
+prefilter_reason_t prefilter_frame(frame_aead_t aead, const char *topic, const uint8_t *frame, size_t len,
+                                   size_t plain_size, nonce_seq_t *seq) {
+    switch (frame_check_header(aead, topic, frame, len, plain_size, seq)) {
+    case FRAME_OK:
+        break;
+    case FRAME_ERR_SHORT:
+        return finish(PREFILTER_LENGTH);
+    case FRAME_ERR_REPLAY:
+        return finish(PREFILTER_REPLAY);
+    default:
+        return finish(PREFILTER_HEADER);
+    }
+    return finish(take_token(pre_auth_bucket(seq->sender)) ? PREFILTER_PASS : PREFILTER_RATE);
+}
+
+prefilter_reason_t prefilter_verified(uint32_t sender) {
+    // O frame autêntico devolve o token cobrado antes da tag: o balde pré-tag só perde
+    // tokens com frames que falham na tag
+    refund_token(pre_auth_bucket(sender));
+    sender_slot_t *slot = slot_for(sender);
+    if (slot == NULL) {
+        return PREFILTER_PASS; // Primeiro frame autêntico: prefilter_accept cria o balde próprio
+    }
+    return finish(take_token(&slot->verified) ? PREFILTER_PASS : PREFILTER_RATE);
+}
+
+prefilter_reason_t prefilter_plain(frame_kind_t kind, const uint8_t *payload, size_t len, size_t overhead,
+                                   size_t max_msg_len, const uint64_t *last_timestamp) {
+    if (len < FRAME_TYPE_LEN + overhead || len - FRAME_TYPE_LEN - overhead > max_msg_len) {
+        return finish(PREFILTER_LENGTH);
+    }
+    if (payload[0] != FRAME_TYPE(kind)) {
+        return finish(PREFILTER_HEADER);
+    }
+    payload += FRAME_TYPE_LEN;
+    len -= FRAME_TYPE_LEN;
+    // Lotes comprimidos não têm timestamp em texto: o replay é conferido em compress_decode
+    if (last_timestamp != NULL && !compress_is_packed(payload + overhead, len - overhead)) {
+        uint64_t timestamp;
+        // Mesmo parse estrito dos handlers (include/numfmt.h), só que sem copiar o valor
+        if (numfmt_parse_reading((const char *)payload + overhead, len - overhead, NULL, 0, &timestamp) != NUMFMT_OK) {
+            return finish(PREFILTER_FORMAT);
+        }
+        if (timestamp <= *last_timestamp) {
+            return finish(PREFILTER_REPLAY);
+        }
+    }
+    return finish(take_token(&shared_bucket) ? PREFILTER_PASS : PREFILTER_RATE);
+}
+
+void prefilter_accept(uint32_t sender) {
+    uint32_t latency_us = mqtt_comm_message_age_us();
+    counts[PREFILTER_PASS]++;
+    latency_count++;
+    latency_total_us += latency_us;
+    if (latency_us > latency_max_us) {
+        latency_max_us = latency_us;
+    }
+
+    if (sender == PREFILTER_SENDER_NONE || slot_for(sender) != NULL) {
+        return;
+    }
+    // Baldes próprios para o remetente autenticado: slot livre ou o menos recente
+    sender_slot_t *slot = &senders[0];
+    for (size_t i = 0; i < NONCE_MAX_SENDERS; i++) {
+        if (!senders[i].used) {
+            slot = &senders[i];
+            break;
+        }
+        if (senders[i].verified.last_us < slot->verified.last_us) {
+            slot = &senders[i];
+        }
+    }
+    uint64_t now_us = time_us_64();
+    slot->used = true;
+    slot->sender = sender;
+    slot->unverified = (token_bucket_t){.used = true, .tokens_milli = PREFILTER_BURST * 1000u, .last_us = now_us};
+    slot->verified = (token_bucket_t){.used = true, .tokens_milli = PREFILTER_BURST * 1000u, .last_us = now_us};
+}
+
+void prefilter_reject(prefilter_reason_t reason) {
+    if (reason > PREFILTER_PASS && reason < PREFILTER_REASON_COUNT) {
+        counts[reason]++;
+    }
+}
+
+uint32_t prefilter_rejected_total(void) {
+    mqtt_rx_stats_t rx;
+    mqtt_comm_get_rx_stats(&rx);
+    uint32_t total = rx.oversized;
+    for (int i = PREFILTER_PASS + 1; i < PREFILTER_REASON_COUNT; i++) {
+        total += counts[i];
+    }
+    return total;
+}
+
+void prefilter_print_stats(void) {
+    static uint64_t last_busy_us = 0;
+    static uint64_t last_print_us = 0;
+
+    mqtt_rx_stats_t rx;
+    mqtt_comm_get_rx_stats(&rx);
+    for (int i = 0; i < PREFILTER_REASON_COUNT; i++) {
+        printf("pre-filtro %-10s %8lu\n", reason_names[i], (unsigned long)counts[i]);
+    }
+    printf("pre-filtro %-10s %8lu\n", "grandes", (unsigned long)rx.oversized);
+
+    uint64_t now_us = time_us_64();
+    uint64_t window_us = now_us - last_print_us;
+    uint64_t busy_us = rx.busy_us - last_busy_us;
+    printf("CPU nos handlers: %lu.%lu%% em %lu ms (%lu mensagens no total)\n",
+           (unsigned long)(busy_us * 100 / window_us), (unsigned long)(busy_us * 1000 / window_us % 10),
+           (unsigned long)(window_us / 1000), (unsigned long)rx.messages);
+    last_busy_us = rx.busy_us;
+    last_print_us = now_us;
+
+    if (latency_count > 0) {
+        printf("latencia local das %lu aceitas: media %lu us, max %lu us\n", (unsigned long)latency_count,
+               (unsigned long)(latency_total_us / latency_count), (unsigned long)latency_max_us);
+    }
+    latency_count = 0;
+    latency_max_us = 0;
+    latency_total_us = 0;
+}
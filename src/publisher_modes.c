@@ -0,0 +1,345 @@
+#include "include/publisher_modes.h"
+#include "config/credentials.h" // Tópicos MQTT
+#include "config/config.h"
+#include "mqtt_comm.h"
+#include "display.h"
+#include "trace.h"
+#include "log.h"
+#include "nonce.h"
+#include "key_manager.h"
+#include "mac.h"
+#include "frame.h"
+#include "stream.h"
+#include "journal.h"
+#include "pool.h"
+#include "encoding.h"
+#include "numfmt.h"
+#include "clock_sync.h"
+#include "mbedtls/error.h" // Para mbedtls_strerror
+#include "pico/stdlib.h"
+#include <stdio.h>
+#include <string.h>
+
+// Intervalo entre publicações dos modos de um só tipo
+#define PUBLISH_INTERVAL_MS 5000
+
+// Tempo com a mensagem de erro no display antes de voltar ao menu
+#define PUBLISH_ERROR_SHOW_MS 3000
+
+// Leitura fixa dos modos do menu ("26.5"), em décimos para numfmt_reading
+#define FIXED_READING_TENTHS 265
+
+// Payload de qualquer modo para o texto de 64 B: vem da classe de 128 B do pool
+#define PUBLISH_PAYLOAD_LEN (FRAME_MAX_OVERHEAD + 64)
+
+// Modo intercalado: um modo diferente a cada mensagem, no mesmo tópico (o subscriber usa o byte de tipo)
+static const frame_kind_t mixed_kinds[] = {FRAME_KIND_PLAIN, FRAME_KIND_XOR, FRAME_KIND_MAC,
+                                           FRAME_KIND_AES_GCM, FRAME_KIND_CHACHAPOLY};
+static size_t mixed_next = 0;
+static uint32_t mixed_sent = 0;
+static uint32_t mixed_failed = 0;
+
+// Modo multi-stream: cada linha é um stream independente (src/stream.c)
+static const stream_config_t publish_streams[] = {
+    // tópico                        fonte                     período  modo                   QoS lote compressão
+    {MQTT_TOPIC_SUBSCRIBE,           stream_source_fixed,      5000,    FRAME_KIND_AES_GCM,    0,  1,   COMPRESS_NONE},
+    {MQTT_TOPIC_SENSORS "/chip",     stream_source_chip_temp,  1000,    FRAME_KIND_MAC,        0,  5,   COMPRESS_DELTA},
+    {MQTT_TOPIC_SENSORS "/joystick", stream_source_joystick_y, 200,     FRAME_KIND_CHACHAPOLY, 1,  4,   COMPRESS_STATELESS},
+};
+#define PUBLISH_STREAM_COUNT (sizeof(publish_streams) / sizeof(publish_streams[0]))
+static uint32_t streams_last_draw_ms = 0;
+
+// Só falha se algum bloco não foi devolvido (ver 'o' no console); a publicação é pulada
+static uint8_t *payload_alloc(void) {
+    uint8_t *payload = pool_alloc(PUBLISH_PAYLOAD_LEN);
+    if (payload == NULL) {
+        LOG_ERROR("Pool sem bloco livre para o payload\n");
+        sleep_ms(1000);
+    }
+    return payload;
+}
+
+// Mensagem dos modos do menu: leitura fixa com o timestamp atual
+static size_t build_reading(char *out, size_t size, uint64_t *timestamp) {
+    TRACE_BEGIN(TRACE_SAMPLE);
+    *timestamp = to_us_since_boot(get_absolute_time());
+    TRACE_END(TRACE_SAMPLE);
+    TRACE_BEGIN(TRACE_FRAME_BUILD);
+    size_t len = numfmt_reading(out, size, FIXED_READING_TENTHS, 1, *timestamp);
+    TRACE_END(TRACE_FRAME_BUILD);
+    return len;
+}
+
+static int32_t encode_plain(void) {
+    uint64_t timestamp;
+    char mensagem[64];
+    size_t mensagem_len = build_reading(mensagem, sizeof(mensagem), &timestamp);
+
+    // Publica a mensagem original (não criptografada), precedida só pelo byte de tipo (include/frame.h)
+    uint8_t *payload_to_send = payload_alloc();
+    if (payload_to_send == NULL) {
+        return 0;
+    }
+    size_t total_payload_len = 0;
+    int ret = frame_encode(FRAME_KIND_PLAIN, MQTT_TOPIC_SUBSCRIBE, (const uint8_t *)mensagem, mensagem_len,
+                           payload_to_send, PUBLISH_PAYLOAD_LEN, &total_payload_len);
+    if (ret != 0) {
+        // Nada vai para o journal: um payload vazio seria publicado e gravado na flash
+        LOG_ERROR("Normal: frame_encode falhou: %d\n", ret);
+        pool_free(payload_to_send);
+        return PUBLISH_INTERVAL_MS;
+    }
+    journal_publish(MQTT_TOPIC_SUBSCRIBE, payload_to_send, total_payload_len, 0);
+    pool_free(payload_to_send);
+
+    display_text_in_line("Msg Enviada:", 1, 1);
+    display_text_in_line(mensagem, 2, 1);
+    char ts_str[4 + NUMFMT_U64_LEN + 1] = "TS: ";
+    numfmt_u64(ts_str + 4, timestamp);
+    display_text_in_line(ts_str, 3, 1);
+    display_text_in_line("", 4, 1);
+    return PUBLISH_INTERVAL_MS;
+}
+
+static int32_t encode_xor(void) {
+    uint64_t timestamp;
+    char mensagem[64];
+    size_t mensagem_len = build_reading(mensagem, sizeof(mensagem), &timestamp);
+
+    uint8_t *criptografada = payload_alloc();
+    char *hex_string_buffer = pool_alloc(HEX_ENCODED_LEN(mensagem_len));
+    if (criptografada == NULL || hex_string_buffer == NULL) {
+        pool_free(criptografada);
+        pool_free(hex_string_buffer);
+        return 0;
+    }
+
+    // Publica a mensagem criptografada: [tipo] [texto ^ chave]
+    size_t criptografada_len = 0;
+    TRACE_BEGIN(TRACE_CRYPTO);
+    int ret = frame_encode(FRAME_KIND_XOR, MQTT_TOPIC_SUBSCRIBE, (const uint8_t *)mensagem, mensagem_len,
+                           criptografada, PUBLISH_PAYLOAD_LEN, &criptografada_len);
+    TRACE_END(TRACE_CRYPTO);
+    if (ret != 0) {
+        LOG_ERROR("XOR: frame_encode falhou: %d\n", ret);
+        pool_free(hex_string_buffer);
+        pool_free(criptografada);
+        return PUBLISH_INTERVAL_MS;
+    }
+
+    journal_publish(MQTT_TOPIC_SUBSCRIBE, criptografada, criptografada_len, 0);
+    hex_encode(criptografada + FRAME_TYPE_LEN, mensagem_len, hex_string_buffer);
+    LOG_INFO("Mensagem original: %s\n", mensagem);
+    LOG_DEBUG("Mensagem criptografada (hex): %s\n", hex_string_buffer);
+
+    display_text_in_line("Msg Original:", 1, 1);
+    display_text_in_line(mensagem, 2, 1);
+    display_text_in_line("Msg Cript (XOR):", 3, 1);
+    display_text_in_line(hex_string_buffer, 4, 1); // Exibe a string hexadecimal
+    pool_free(hex_string_buffer);
+    pool_free(criptografada);
+    return PUBLISH_INTERVAL_MS;
+}
+
+static int32_t encode_hmac(void) {
+    uint64_t timestamp;
+    char mensagem_original[64];
+    size_t mensagem_original_len = build_reading(mensagem_original, sizeof(mensagem_original), &timestamp);
+
+    // Algoritmo e tamanho da tag configurados para o tópico (tabela em src/mac.c)
+    const mac_config_t *mac_config = mac_config_for_topic(MQTT_TOPIC_SUBSCRIBE);
+    uint8_t *payload_to_send = payload_alloc();
+    if (payload_to_send == NULL) {
+        return 0;
+    }
+    size_t total_payload_len = 0;
+
+    uint32_t crypto_start_us = time_us_32(); // Mede o custo do MAC por mensagem
+    TRACE_BEGIN(TRACE_CRYPTO);
+    int ret = frame_encode(FRAME_KIND_MAC, MQTT_TOPIC_SUBSCRIBE, (const uint8_t *)mensagem_original, mensagem_original_len,
+                           payload_to_send, PUBLISH_PAYLOAD_LEN, &total_payload_len);
+    TRACE_END(TRACE_CRYPTO);
+    uint32_t crypto_us = time_us_32() - crypto_start_us;
+
+    if (ret != 0) {
+        char error_buf[100];
+        mbedtls_strerror(ret, error_buf, sizeof(error_buf));
+        LOG_ERROR("HMAC Pub Error: %s falhou: -0x%04X - %s\n", mac_alg_name(mac_config->alg), (unsigned int)-ret, error_buf);
+        display_text_in_line("HMAC Err: Calc", 1, 1);
+        snprintf(error_buf, sizeof(error_buf), "Code: -0x%04X", (unsigned int)-ret);
+        display_text_in_line(error_buf, 2, 1);
+        pool_free(payload_to_send);
+        sleep_ms(PUBLISH_ERROR_SHOW_MS);
+        return APP_MODE_EXIT;
+    }
+
+    journal_publish(MQTT_TOPIC_SUBSCRIBE, payload_to_send, total_payload_len, 0);
+
+    const uint8_t *tag = payload_to_send + FRAME_TYPE_LEN + mac_overhead(mac_config) - mac_config->tag_len;
+    LOG_INFO("HMAC Pub: Original: %s\n", mensagem_original);
+    char tag_hex_display_full[HEX_ENCODED_LEN(MAC_MAX_TAG_LEN)];
+    hex_encode(tag, mac_config->tag_len, tag_hex_display_full);
+    LOG_DEBUG("HMAC Pub: tag (hex): %s\n", tag_hex_display_full);
+    LOG_INFO("HMAC Pub: %s/%u calculado em %lu us\n", mac_alg_name(mac_config->alg), mac_config->tag_len, (unsigned long)crypto_us);
+
+    display_text_in_line("Msg Original (HMAC):", 1, 1);
+    display_text_in_line(mensagem_original, 2, 1);
+
+    char hmac_short_display[20];
+    snprintf(hmac_short_display, sizeof(hmac_short_display), "Tag: %02x%02x%02x%02x...",
+             tag[0], tag[1], tag[2], tag[3]);
+    display_text_in_line(hmac_short_display, 3, 1);
+    display_text_in_line(mac_alg_name(mac_config->alg), 4, 1);
+    pool_free(payload_to_send);
+    return PUBLISH_INTERVAL_MS;
+}
+
+// AES-GCM e ChaCha20-Poly1305 usam o mesmo frame; muda só a cifra e os textos
+static int32_t encode_aead(frame_aead_t aead, const char *name, const char *original_label, const char *error_label) {
+    uint64_t timestamp_us;
+    char mensagem_original[64];
+    size_t mensagem_len = build_reading(mensagem_original, sizeof(mensagem_original), &timestamp_us);
+
+    // Frame: [cabeçalho em claro (tipo, remetente, boot, contador, hash do tópico)] [TAG (16)] [Ciphertext]
+    // O cabeçalho contém o nonce e é autenticado como AAD (ver include/frame.h)
+    uint8_t *payload_to_send = payload_alloc();
+    if (payload_to_send == NULL) {
+        return 0;
+    }
+    size_t total_payload_len = 0;
+    nonce_seq_t seq;
+
+    uint32_t crypto_start_us = time_us_32(); // Mede a cifragem por mensagem
+    TRACE_BEGIN(TRACE_CRYPTO);
+    int ret = frame_seal(aead, MQTT_TOPIC_SUBSCRIBE, (const uint8_t *)mensagem_original, mensagem_len,
+                         payload_to_send, PUBLISH_PAYLOAD_LEN, &total_payload_len, &seq);
+    TRACE_END(TRACE_CRYPTO);
+    uint32_t crypto_us = time_us_32() - crypto_start_us;
+
+    if (ret != 0) {
+        LOG_ERROR("%s Pub Error: cifragem falhou: -0x%04X\n", name, (unsigned int)-ret);
+        display_text_in_line(error_label, 1, 1);
+        pool_free(payload_to_send);
+        sleep_ms(PUBLISH_ERROR_SHOW_MS);
+        return APP_MODE_EXIT;
+    }
+    const uint8_t *tag = payload_to_send + FRAME_HEADER_LEN;
+
+    journal_publish(MQTT_TOPIC_SUBSCRIBE, payload_to_send, total_payload_len, 0);
+
+    LOG_INFO("%s Pub: Original: %s\n", name, mensagem_original);
+    LOG_INFO("%s Pub: cifrado em %lu us\n", name, (unsigned long)crypto_us);
+    display_text_in_line(original_label, 1, 1);
+    display_text_in_line(mensagem_original, 2, 1);
+    char info_str[40];
+    snprintf(info_str, sizeof(info_str), "B:%lu S:%lu Tag:%02x%02x", (unsigned long)seq.boot, (unsigned long)seq.counter, tag[0], tag[1]);
+    display_text_in_line(info_str, 3, 1);
+    display_text_in_line("Cripto Enviada!", 4, 1);
+    pool_free(payload_to_send);
+    return PUBLISH_INTERVAL_MS;
+}
+
+static int32_t encode_aes(void) {
+    return encode_aead(FRAME_AEAD_AES_GCM, "AES", "Msg Original (AES):", "AES Err: Encrypt");
+}
+
+static int32_t encode_chacha(void) {
+    return encode_aead(FRAME_AEAD_CHACHAPOLY, "ChaCha", "Msg Original (ChaCha):", "ChaCha Err: Encrypt");
+}
+
+static int32_t encode_mixed(void) {
+    frame_kind_t kind = mixed_kinds[mixed_next];
+    mixed_next = (mixed_next + 1) % (sizeof(mixed_kinds) / sizeof(mixed_kinds[0]));
+
+    uint64_t timestamp_us;
+    char mensagem_original[64];
+    size_t mensagem_len = build_reading(mensagem_original, sizeof(mensagem_original), &timestamp_us);
+
+    uint8_t *payload_to_send = payload_alloc();
+    if (payload_to_send == NULL) {
+        return 0;
+    }
+    size_t total_payload_len = 0;
+    TRACE_BEGIN(TRACE_CRYPTO);
+    int ret = frame_encode(kind, MQTT_TOPIC_SUBSCRIBE, (const uint8_t *)mensagem_original, mensagem_len,
+                           payload_to_send, PUBLISH_PAYLOAD_LEN, &total_payload_len);
+    TRACE_END(TRACE_CRYPTO);
+
+    if (ret == 0) {
+        journal_publish(MQTT_TOPIC_SUBSCRIBE, payload_to_send, total_payload_len, 0);
+        mixed_sent++;
+    } else {
+        LOG_ERROR("Intercalado: %s falhou: -0x%04X\n", frame_kind_name(kind), (unsigned int)-ret);
+        mixed_failed++;
+    }
+    pool_free(payload_to_send);
+
+    // Uma volta completa pelos modos por atualização do display (o I2C custa mais que a publicação)
+    if (mixed_next == 0) {
+        char count_str[24];
+        snprintf(count_str, sizeof(count_str), "Enviadas: %lu", (unsigned long)mixed_sent);
+        display_text_in_line("Msgs intercaladas:", 1, 1);
+        display_text_in_line(count_str, 2, 1);
+        snprintf(count_str, sizeof(count_str), "Falhas: %lu", (unsigned long)mixed_failed);
+        display_text_in_line(count_str, 3, 1);
+        display_text_in_line(mensagem_original, 4, 1);
+    }
+    return PUBLISH_MIXED_INTERVAL_MS;
+}
+
+static void init_streams(void) {
+    stream_init(publish_streams, PUBLISH_STREAM_COUNT, NULL);
+}
+
+static int32_t encode_streams(void) {
+    uint32_t now_ms = to_ms_since_boot(get_absolute_time());
+    uint32_t wait_ms = stream_poll(now_ms);
+
+    if (now_ms - streams_last_draw_ms >= 1000) {
+        char count_str[24];
+        snprintf(count_str, sizeof(count_str), "Streams: %u", (unsigned)PUBLISH_STREAM_COUNT);
+        display_text_in_line(count_str, 1, 1);
+        snprintf(count_str, sizeof(count_str), "Enviadas: %lu", (unsigned long)stream_published_total());
+        display_text_in_line(count_str, 2, 1);
+        display_text_in_line("'m' no console:", 3, 1);
+        display_text_in_line("detalhe por stream", 4, 1);
+        streams_last_draw_ms = now_ms;
+    }
+
+    // Dorme até o próximo vencimento, sem passar de 10 ms para o botão e o console responderem
+    return wait_ms < 10 ? (int32_t)wait_ms : 10;
+}
+
+const app_mode_t publisher_modes[] = {
+    // menu                  título                   init          encode          decode teardown
+    {"Sem seguranca",        "Modo: Sem Seguranca",   NULL,         encode_plain,   NULL,  NULL},
+    {"Encriptacao XOR",      "Modo: Encriptacao XOR", NULL,         encode_xor,     NULL,  NULL},
+    {"Autenticacao HMAC",    "Modo: Autent. HMAC",    NULL,         encode_hmac,    NULL,  NULL},
+    {"AES-GCM",              "Modo: AES-GCM",         NULL,         encode_aes,     NULL,  NULL},
+    {"ChaCha20-Poly1305",    "Modo: ChaCha20-Poly",   NULL,         encode_chacha,  NULL,  NULL},
+    {"Todos intercalados",   "Modo: Intercalado",     NULL,         encode_mixed,   NULL,  NULL},
+    {"Multi-stream",         "Modo: Multi-stream",    init_streams, encode_streams, NULL,  NULL},
+};
+const size_t publisher_mode_count = sizeof(publisher_modes) / sizeof(publisher_modes[0]);
+
+void publisher_boot(void) {
+    // Reserva um novo boot para os nonces AEAD
+    if (!nonce_init()) {
+        printf("Contador de nonces indisponivel: modos AES e ChaCha desabilitados.\n");
+    }
+    // Mensagens guardadas durante quedas anteriores
+    journal_init();
+}
+
+void publisher_connected(void) {
+    // Anúncios de rotação (o retido traz a sessão em uso quando a placa reinicia)
+    mqtt_comm_subscribe_with_handler(MQTT_TOPIC_KEYS, key_manager_control_handler);
+    // Responde os pings dos subscribers: o relógio deste publisher é a referência dos timestamps
+    clock_sync_serve();
+}
+
+void publisher_poll(bool in_mode) {
+    (void)in_mode;
+    key_manager_poll(true);                              // Aplica rotações recebidas e anuncia as agendadas
+    journal_poll(to_ms_since_boot(get_absolute_time())); // Reenvia, com taxa limitada, o que ficou no journal
+}
@@ -0,0 +1,176 @@
+#include "include/sha256_backend.h"
+#include "include/sha256_vectors.h"
+#include "pico/stdlib.h"
+#include "hardware/clocks.h"
+#include <stdio.h>
+#include <string.h>
+
+#define BACKEND_AUTO (-1)
+
+static const char *const backend_names[] = {"software (mbedTLS)", "hardware (RP2350)"};
+
+int sha256_backend_start_with(sha256_backend_ctx_t *ctx, sha256_backend_t backend, size_t expected_len) {
+    ctx->backend = backend;
+    if (backend == SHA256_BACKEND_HARDWARE) {
+#if PICO_RP2350
+        // Para mensagens pequenas a configuração do DMA custa mais que a escrita direta nos registradores
+        bool use_dma = expected_len >= SHA256_DMA_THRESHOLD;
+        return (pico_sha256_try_start(&ctx->u.hw, SHA256_BIG_ENDIAN, use_dma) == PICO_OK) ? 0 : -1;
+#else
+        (void)expected_len;
+        return -1;
+#endif
+    }
+    mbedtls_sha256_init(&ctx->u.sw);
+    return mbedtls_sha256_starts(&ctx->u.sw, 0);
+}
+
+int sha256_backend_start(sha256_backend_ctx_t *ctx, size_t expected_len) {
+    // O acelerador é um recurso único: se estiver ocupado, cai para o software
+    if (sha256_backend_start_with(ctx, SHA256_BACKEND_HARDWARE, expected_len) == 0) {
+        return 0;
+    }
+    return sha256_backend_start_with(ctx, SHA256_BACKEND_SOFTWARE, expected_len);
+}
+
+int sha256_backend_update(sha256_backend_ctx_t *ctx, const uint8_t *data, size_t len) {
+#if PICO_RP2350
+    if (ctx->backend == SHA256_BACKEND_HARDWARE) {
+        pico_sha256_update(&ctx->u.hw, data, len);
+        return 0;
+    }
+#endif
+    return mbedtls_sha256_update(&ctx->u.sw, data, len);
+}
+
+int sha256_backend_finish(sha256_backend_ctx_t *ctx, uint8_t out[SHA256_DIGEST_LEN]) {
+#if PICO_RP2350
+    if (ctx->backend == SHA256_BACKEND_HARDWARE) {
+        sha256_result_t result;
+        pico_sha256_finish(&ctx->u.hw, &result);
+        memcpy(out, result.bytes, SHA256_DIGEST_LEN);
+        return 0;
+    }
+#endif
+    int ret = mbedtls_sha256_finish(&ctx->u.sw, out);
+    mbedtls_sha256_free(&ctx->u.sw);
+    return ret;
+}
+
+static int start_backend(sha256_backend_ctx_t *ctx, int backend, size_t expected_len) {
+    if (backend == BACKEND_AUTO) {
+        return sha256_backend_start(ctx, expected_len);
+    }
+    return sha256_backend_start_with(ctx, (sha256_backend_t)backend, expected_len);
+}
+
+/* HMAC(K, m) = H((K ^ opad) || H((K ^ ipad) || m)) */
+static int hmac_sha256_with(int backend, const uint8_t *key, size_t key_len, const uint8_t *msg, size_t msg_len,
+                            uint8_t out[SHA256_DIGEST_LEN]) {
+    uint8_t block[SHA256_BLOCK_LEN];
+    uint8_t inner[SHA256_DIGEST_LEN];
+    sha256_backend_ctx_t ctx;
+    int ret;
+
+    memset(block, 0, sizeof(block));
+    if (key_len > SHA256_BLOCK_LEN) {
+        // Chaves maiores que o bloco são substituídas pelo seu hash
+        if ((ret = start_backend(&ctx, backend, key_len)) != 0 ||
+            (ret = sha256_backend_update(&ctx, key, key_len)) != 0 ||
+            (ret = sha256_backend_finish(&ctx, block)) != 0) {
+            return ret;
+        }
+    } else {
+        memcpy(block, key, key_len);
+    }
+
+    for (size_t i = 0; i < SHA256_BLOCK_LEN; i++) {
+        block[i] ^= 0x36;
+    }
+    if ((ret = start_backend(&ctx, backend, SHA256_BLOCK_LEN + msg_len)) != 0 ||
+        (ret = sha256_backend_update(&ctx, block, SHA256_BLOCK_LEN)) != 0 ||
+        (ret = sha256_backend_update(&ctx, msg, msg_len)) != 0 ||
+        (ret = sha256_backend_finish(&ctx, inner)) != 0) {
+        return ret;
+    }
+
+    for (size_t i = 0; i < SHA256_BLOCK_LEN; i++) {
+        block[i] ^= 0x36 ^ 0x5c; // ipad -> opad
+    }
+    if ((ret = start_backend(&ctx, backend, SHA256_BLOCK_LEN + SHA256_DIGEST_LEN)) != 0 ||
+        (ret = sha256_backend_update(&ctx, block, SHA256_BLOCK_LEN)) != 0 ||
+        (ret = sha256_backend_update(&ctx, inner, SHA256_DIGEST_LEN)) != 0 ||
+        (ret = sha256_backend_finish(&ctx, out)) != 0) {
+        return ret;
+    }
+    return 0;
+}
+
+int hmac_sha256(const uint8_t *key, size_t key_len, const uint8_t *msg, size_t msg_len,
+                uint8_t out[SHA256_DIGEST_LEN]) {
+    return hmac_sha256_with(BACKEND_AUTO, key, key_len, msg, msg_len, out);
+}
+
+// --- Autoteste (RFC 4231, casos 1, 2 e 6) e comparação entre backends ---
+
+static uint8_t test_buffer[SHA256_VECTOR_1K_LEN]; // Mensagem de 1 KB do caminho com DMA
+
+static int backend_count(void) {
+#if PICO_RP2350
+    return 2;
+#else
+    return 1;
+#endif
+}
+
+bool sha256_backend_selftest(void) {
+    uint8_t out[SHA256_DIGEST_LEN];
+    bool ok = true;
+
+    sha256_vector_fill_1k(test_buffer);
+    for (int backend = 0; backend < backend_count(); backend++) {
+        for (size_t v = 0; v < SHA256_RFC4231_VECTOR_COUNT; v++) {
+            const hmac_vector_t *vec = &sha256_rfc4231_vectors[v];
+            int ret = hmac_sha256_with(backend, vec->key, vec->key_len, (const uint8_t *)vec->msg,
+                                       strlen(vec->msg), out);
+            if (ret != 0 || memcmp(out, vec->expected, SHA256_DIGEST_LEN) != 0) {
+                printf("SHA-256 autoteste: vetor %u falhou no backend %s\n", (unsigned)v, backend_names[backend]);
+                ok = false;
+            }
+        }
+        int ret = hmac_sha256_with(backend, (const uint8_t *)sha256_vector_1k_key, strlen(sha256_vector_1k_key),
+                                   test_buffer, sizeof(test_buffer), out);
+        if (ret != 0 || memcmp(out, sha256_vector_1k_expected, SHA256_DIGEST_LEN) != 0) {
+            printf("SHA-256 autoteste: mensagem de 1 KB falhou no backend %s\n", backend_names[backend]);
+            ok = false;
+        }
+    }
+    return ok;
+}
+
+void sha256_backend_benchmark(void) {
+    static const size_t sizes[] = {64, 256, 1024};
+    const uint32_t iterations = 100;
+    const uint32_t mhz = clock_get_hz(clk_sys) / 1000000;
+    uint8_t out[SHA256_DIGEST_LEN];
+
+    sha256_vector_fill_1k(test_buffer);
+    for (int backend = 0; backend < backend_count(); backend++) {
+        for (size_t s = 0; s < sizeof(sizes) / sizeof(sizes[0]); s++) {
+            uint32_t start_us = time_us_32();
+            for (uint32_t i = 0; i < iterations; i++) {
+                sha256_backend_ctx_t ctx;
+                if (sha256_backend_start_with(&ctx, (sha256_backend_t)backend, sizes[s]) != 0) {
+                    break;
+                }
+                sha256_backend_update(&ctx, test_buffer, sizes[s]);
+                sha256_backend_finish(&ctx, out);
+            }
+            uint32_t elapsed_us = time_us_32() - start_us;
+            uint64_t cycles = (uint64_t)elapsed_us * mhz;
+            printf("SHA-256 %-20s %5u B: %lu.%02lu ciclos/byte\n", backend_names[backend], (unsigned)sizes[s],
+                   (unsigned long)(cycles / (iterations * sizes[s])),
+                   (unsigned long)((cycles * 100 / (iterations * sizes[s])) % 100));
+        }
+    }
+}
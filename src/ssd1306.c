@@ -32,6 +32,7 @@ SOFTWARE.
 
 #include "ssd1306.h"
 #include "font.h"
+#include "pool.h"
 
 inline static void swap(int32_t *a, int32_t *b) {
     int32_t *t=a;
@@ -68,7 +69,8 @@ bool ssd1306_init(ssd1306_t *p, uint16_t width, uint16_t height, uint8_t address
 
 
     p->bufsize=(p->pages)*(p->width);
-    if((p->buffer=malloc(p->bufsize+1))==NULL) {
+    // framebuffer vem da classe de 1032 B do pool (include/pool.h), não do heap
+    if((p->buffer=pool_alloc(p->bufsize+1))==NULL) {
         p->bufsize=0;
         return false;
     }
@@ -116,7 +118,7 @@ bool ssd1306_init(ssd1306_t *p, uint16_t width, uint16_t height, uint8_t address
 }
 
 inline void ssd1306_deinit(ssd1306_t *p) {
-    free(p->buffer-1);
+    pool_free(p->buffer-1);
 }
 
 inline void ssd1306_poweroff(ssd1306_t *p) {
@@ -0,0 +1,273 @@
+#include "include/stream.h"
+#include "include/journal.h"
+#include "include/pool.h"
+#include "include/numfmt.h"
+#include "include/adc_scan.h"
+#include "config/config.h"
+#include "pico/stdlib.h"
+#include <stdio.h>
+#include <string.h>
+
+#define STREAM_TEXT_LEN (STREAM_MAX_BATCH * (STREAM_SAMPLE_LEN + 1) + 22) // Lote + ',' + timestamp + '\0'
+#define STREAM_PACKED_LEN COMPRESS_MAX_LEN(STREAM_MAX_BATCH)              // Pior caso do lote comprimido
+#define STREAM_PAYLOAD_LEN (FRAME_MAX_OVERHEAD + STREAM_TEXT_LEN)         // Lote com o maior overhead de frame
+#define STREAM_BENCH_MS 1000                                              // Duração de cada rodada do benchmark
+
+typedef struct {
+    uint32_t next_due_ms;
+    uint8_t pending;    // Amostras já no lote
+    uint8_t text_len;   // Tamanho do lote em texto (nos comprimidos, o que ele teria)
+    uint8_t decimals;   // Casas do ponto fixo do lote comprimido (as da primeira amostra)
+    union {
+        char text[STREAM_TEXT_LEN];
+        int32_t values[STREAM_MAX_BATCH]; // Streams comprimidos
+    };
+    compress_encoder_t encoder;
+    uint32_t published;
+    uint32_t failed;
+    uint32_t late;      // Vencimentos perdidos (agenda realinhada)
+    uint32_t text_bytes; // Comprimidos: bytes que o texto teria
+    uint32_t sent_bytes; // Comprimidos: bytes entregues ao modo de segurança
+} stream_state_t;
+
+static const stream_config_t *table = NULL;
+static size_t table_count = 0;
+static stream_sink_t table_sink = NULL;
+static stream_state_t states[STREAM_MAX_STREAMS];
+static uint32_t next_wakeup_ms = 0;
+static uint32_t published_total = 0;
+
+/* --- Fontes --- */
+// Copia como o snprintf: trunca em size - 1 e devolve o tamanho completo
+static int copy_sample(char *out, size_t size, const char *text, size_t len) {
+    if (size > 0) {
+        size_t copied = len < size ? len : size - 1;
+        memcpy(out, text, copied);
+        out[copied] = '\0';
+    }
+    return (int)len;
+}
+
+int stream_source_fixed(char *out, size_t size) {
+    char text[NUMFMT_FIXED_LEN + 1];
+    return copy_sample(out, size, text, numfmt_fixed(text, 265, 1));
+}
+
+int stream_source_chip_temp(char *out, size_t size) {
+    uint32_t millivolts = adc_scan_latest(ADC_TEMP_SENSOR_CHANNEL) * 3300u / 4096u;
+    // Datasheet do RP2040: T = 27 - (V - 0,706) / 0,001721, em centésimos de grau
+    int32_t centi = 2700 - ((int32_t)millivolts - 706) * 100000 / 1721;
+    char text[NUMFMT_FIXED_LEN + 1];
+    return copy_sample(out, size, text, numfmt_fixed(text, centi, 2));
+}
+
+int stream_source_joystick_y(char *out, size_t size) {
+    char text[NUMFMT_U64_LEN + 1];
+    return copy_sample(out, size, text, numfmt_u64(text, adc_scan_latest(ADC_JOYSTICK_Y_CHANNEL)));
+}
+
+int stream_source_counter(char *out, size_t size) {
+    static uint32_t counter = 0;
+    char text[NUMFMT_U64_LEN + 1];
+    return copy_sample(out, size, text, numfmt_u64(text, ++counter));
+}
+
+// Sem conexão (ou com a fila de saída cheia), a mensagem vai para o journal na flash
+static int sink_mqtt(const char *topic, const uint8_t *data, size_t len, uint8_t qos) {
+    return journal_publish(topic, data, len, qos);
+}
+
+/* --- Agendamento --- */
+void stream_init(const stream_config_t *streams, size_t count, stream_sink_t sink) {
+    table = streams;
+    table_count = count < STREAM_MAX_STREAMS ? count : STREAM_MAX_STREAMS;
+    table_sink = sink != NULL ? sink : sink_mqtt;
+    memset(states, 0, sizeof(states));
+    published_total = 0;
+
+    uint32_t now_ms = to_ms_since_boot(get_absolute_time());
+    for (size_t i = 0; i < table_count; i++) {
+        states[i].next_due_ms = now_ms;
+    }
+    next_wakeup_ms = now_ms;
+}
+
+static bool is_due(uint32_t due_ms, uint32_t now_ms) {
+    return (int32_t)(now_ms - due_ms) >= 0;
+}
+
+// Amostra, acrescenta ao lote e publica quando o lote completa
+static void service(const stream_config_t *config, stream_state_t *state) {
+    char sample[STREAM_SAMPLE_LEN + 1];
+    int written = config->source(sample, sizeof(sample));
+    if (written < 0) {
+        return;
+    }
+    if (written > STREAM_SAMPLE_LEN) {
+        written = STREAM_SAMPLE_LEN;
+    }
+    size_t separator = state->pending > 0;
+    if (config->compression != COMPRESS_NONE) {
+        if (state->pending == 0) {
+            state->decimals = compress_sample_decimals(sample);
+        }
+        if (numfmt_parse_fixed(sample, (size_t)written, state->decimals, &state->values[state->pending]) != NUMFMT_OK) {
+            state->failed++;
+            return;
+        }
+    } else {
+        if (separator) {
+            state->text[state->text_len] = ';';
+        }
+        memcpy(state->text + state->text_len + separator, sample, (size_t)written);
+    }
+    state->text_len += separator + (size_t)written;
+    uint8_t batch = config->batch > STREAM_MAX_BATCH ? STREAM_MAX_BATCH : config->batch;
+    if (++state->pending < batch) {
+        return;
+    }
+
+    uint64_t timestamp_us = to_us_since_boot(get_absolute_time());
+    char timestamp_text[NUMFMT_U64_LEN + 1];
+    size_t timestamp_len = numfmt_u64(timestamp_text, timestamp_us);
+    size_t text_len = state->text_len;
+    state->pending = 0;
+    state->text_len = 0;
+
+    // Lote comprimido e payload vêm do pool (include/pool.h); sem bloco livre, a mensagem conta como falha
+    const uint8_t *plain = (const uint8_t *)state->text;
+    size_t plain_len = 0;
+    uint8_t *packed = NULL;
+    if (config->compression != COMPRESS_NONE) {
+        packed = pool_alloc(STREAM_PACKED_LEN);
+        if (packed != NULL) {
+            plain_len = compress_encode(&state->encoder, config->compression, state->values, batch, state->decimals,
+                                        timestamp_us, packed, STREAM_PACKED_LEN);
+        }
+        plain = packed;
+        state->text_bytes += text_len + 1 + timestamp_len;
+        state->sent_bytes += plain_len;
+    } else {
+        state->text[text_len] = ',';
+        memcpy(state->text + text_len + 1, timestamp_text, timestamp_len + 1);
+        plain_len = text_len + 1 + timestamp_len;
+    }
+
+    uint8_t *payload = pool_alloc(STREAM_PAYLOAD_LEN);
+    size_t payload_len = 0;
+    bool sent = payload != NULL && plain_len != 0 &&
+                frame_encode(config->security, config->topic, plain, plain_len, payload, STREAM_PAYLOAD_LEN,
+                             &payload_len) == 0 &&
+                table_sink(config->topic, payload, payload_len, config->qos) == 0;
+    pool_free(payload);
+    pool_free(packed);
+    if (!sent) {
+        state->failed++;
+        return;
+    }
+    state->published++;
+    published_total++;
+}
+
+uint32_t stream_poll(uint32_t now_ms) {
+    if (!is_due(next_wakeup_ms, now_ms)) {
+        return next_wakeup_ms - now_ms; // Caminho comum: nada vencido, nenhuma varredura
+    }
+
+    int32_t wait_ms = INT32_MAX; // Até o vencimento mais próximo; negativo se já passou
+    for (size_t i = 0; i < table_count; i++) {
+        const stream_config_t *config = &table[i];
+        stream_state_t *state = &states[i];
+        if (is_due(state->next_due_ms, now_ms)) {
+            service(config, state);
+            state->next_due_ms += config->period_ms;
+            if (is_due(state->next_due_ms, now_ms) && config->period_ms > 0) {
+                // Atrasou um período inteiro ou mais: realinha em vez de disparar em rajada
+                state->late++;
+                state->next_due_ms = now_ms + config->period_ms;
+            }
+        }
+        int32_t due_in_ms = (int32_t)(state->next_due_ms - now_ms);
+        if (due_in_ms < wait_ms) {
+            wait_ms = due_in_ms;
+        }
+    }
+    next_wakeup_ms = now_ms + wait_ms;
+    return wait_ms > 0 ? (uint32_t)wait_ms : 0;
+}
+
+uint32_t stream_published_total(void) {
+    return published_total;
+}
+
+void stream_print_stats(void) {
+    for (size_t i = 0; i < table_count; i++) {
+        const stream_config_t *config = &table[i];
+        printf("%-32s %-7s %6lu ms lote %u qos %u: %lu enviadas, %lu falhas, %lu atrasos", config->topic,
+               frame_kind_name(config->security), (unsigned long)config->period_ms, config->batch, config->qos,
+               (unsigned long)states[i].published, (unsigned long)states[i].failed, (unsigned long)states[i].late);
+        if (config->compression != COMPRESS_NONE) {
+            printf(", %lu B comprimidos (texto: %lu B)", (unsigned long)states[i].sent_bytes,
+                   (unsigned long)states[i].text_bytes);
+        }
+        printf("\n");
+    }
+}
+
+/* --- Benchmark --- */
+static uint32_t bench_bytes = 0;
+
+static int sink_count(const char *topic, const uint8_t *data, size_t len, uint8_t qos) {
+    bench_bytes += len;
+    return 0;
+}
+
+static void bench_round(const stream_config_t *streams, size_t count, const char *label) {
+    stream_init(streams, count, sink_count);
+    bench_bytes = 0;
+    uint64_t start_us = time_us_64();
+    uint64_t end_us = start_us + STREAM_BENCH_MS * 1000u;
+    uint32_t polls = 0;
+    while (time_us_64() < end_us) {
+        stream_poll(to_ms_since_boot(get_absolute_time()));
+        polls++;
+    }
+    uint64_t elapsed_us = time_us_64() - start_us;
+    uint32_t total = stream_published_total();
+    uint32_t tenths_us = total ? (uint32_t)(elapsed_us * 10 / total) : 0;
+    printf("%2u streams %-8s %7lu msg/s  %5lu.%lu us/msg  %7lu B/s  (%lu varreduras)\n", (unsigned)count, label,
+           (unsigned long)((uint64_t)total * 1000000 / elapsed_us),
+           (unsigned long)(tenths_us / 10), (unsigned long)(tenths_us % 10),
+           (unsigned long)((uint64_t)bench_bytes * 1000000 / elapsed_us), (unsigned long)polls);
+}
+
+void stream_benchmark(void) {
+    // Com 1 stream, a rodada "misto" mede só o AES-GCM
+    static const frame_kind_t mixed[] = {FRAME_KIND_AES_GCM, FRAME_KIND_CHACHAPOLY, FRAME_KIND_MAC,
+                                         FRAME_KIND_XOR, FRAME_KIND_PLAIN};
+    static const size_t counts[] = {1, 10, 50};
+    static stream_config_t bench_streams[STREAM_MAX_STREAMS];
+
+    const stream_config_t *saved_table = table;
+    size_t saved_count = table_count;
+    stream_sink_t saved_sink = table_sink;
+
+    for (size_t c = 0; c < sizeof(counts) / sizeof(counts[0]); c++) {
+        // Só o motor: sem segurança
+        for (size_t i = 0; i < counts[c]; i++) {
+            bench_streams[i] = (stream_config_t){"escola/bench", stream_source_counter, 0, FRAME_KIND_PLAIN, 0, 1};
+        }
+        bench_round(bench_streams, counts[c], "normal");
+        // Modos intercalados entre os streams
+        for (size_t i = 0; i < counts[c]; i++) {
+            bench_streams[i].security = mixed[i % (sizeof(mixed) / sizeof(mixed[0]))];
+        }
+        bench_round(bench_streams, counts[c], "misto");
+    }
+
+    if (saved_table != NULL) {
+        stream_init(saved_table, saved_count, saved_sink);
+    } else {
+        table_count = 0;
+    }
+}
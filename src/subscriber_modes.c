@@ -0,0 +1,386 @@
+#include "include/subscriber_modes.h"
+#include "config/credentials.h" // Tópicos MQTT
+#include "config/config.h"
+#include "mqtt_comm.h"
+#include "xor_cipher.h"
+#include "display.h"
+#include "trace.h"
+#include "log.h"         // Log diferido (os handlers rodam no contexto do lwIP)
+#include "nonce.h"
+#include "key_manager.h"
+#include "mac.h"
+#include "frame.h"
+#include "prefilter.h"
+#include "dispatch.h"
+#include "compress.h"
+#include "pool.h"
+#include "encoding.h"
+#include "numfmt.h"
+#include "clock_sync.h" // Relógio do publisher para a latência de ponta a ponta
+#include "latency.h"
+#include "pico/stdlib.h"
+#include <stdio.h>
+#include <string.h>
+
+// Buffer para descriptografia: um bloco da classe de 256 B do pool por mensagem
+#define PAYLOAD_MAX_LEN 256
+
+static uint64_t global_last_timestamp = 0;
+
+// Decodificador de um modo: recebe o buffer de PAYLOAD_MAX_LEN bytes da mensagem
+typedef void (*message_decoder_t)(const char *topic, const uint8_t *payload, size_t len, uint8_t *buffer);
+
+// Empresta o buffer do pool durante o decodificador; sem bloco livre, a mensagem é
+// descartada e aparece nas falhas do pool (comando 'o')
+static void decode_with_buffer(message_decoder_t decoder, const char *topic, const uint8_t *payload, size_t len) {
+    uint8_t *buffer = pool_alloc(PAYLOAD_MAX_LEN);
+    if (buffer == NULL) {
+        return;
+    }
+    decoder(topic, payload, len, buffer);
+    pool_free(buffer);
+}
+
+// Lotes comprimidos voltam ao texto "v1;v2;...,timestamp" antes do parse, no próprio buffer.
+// Mensagens perdidas no modo delta só aparecem no comando 'z' (descartes até o quadro-chave).
+static bool unpack_message(const char *topic, char *text, size_t *len) {
+    if (!compress_is_packed((const uint8_t *)text, *len)) {
+        return true;
+    }
+    char *unpacked = pool_alloc(PAYLOAD_MAX_LEN);
+    if (unpacked == NULL) {
+        return false;
+    }
+    size_t unpacked_len = 0;
+    compress_status_t status = compress_decode(topic, (const uint8_t *)text, *len, unpacked, PAYLOAD_MAX_LEN, &unpacked_len);
+    if (status == COMPRESS_OK) {
+        memcpy(text, unpacked, unpacked_len + 1);
+        *len = unpacked_len;
+    } else if (status == COMPRESS_ERR_REPLAY) {
+        prefilter_reject(PREFILTER_REPLAY);
+    }
+    pool_free(unpacked);
+    return status == COMPRESS_OK;
+}
+
+// Modo sem segurança
+static void decode_normal(const char *topic, const uint8_t *payload, size_t len, uint8_t *buffer) {
+    // Tamanho, replay pelo timestamp e taxa antes de qualquer cópia; recusas só incrementam contadores
+    if (prefilter_plain(FRAME_KIND_PLAIN, payload, len, 0, PAYLOAD_MAX_LEN - 1, &global_last_timestamp) != PREFILTER_PASS) {
+        return;
+    }
+    payload += FRAME_TYPE_LEN; // Byte de tipo já conferido
+    len -= FRAME_TYPE_LEN;
+
+    char valor[32] = {0};
+    uint64_t timestamp = 0;
+    char *mensagem = (char *)buffer;
+
+    memcpy(mensagem, payload, len);
+    mensagem[len] = '\0';
+    if (!unpack_message(topic, mensagem, &len)) {
+        return;
+    }
+
+    TRACE_BEGIN(TRACE_PARSE);
+    numfmt_status_t parsed = numfmt_parse_reading(mensagem, len, valor, sizeof(valor), &timestamp);
+    TRACE_END(TRACE_PARSE);
+    if (parsed != NUMFMT_OK) {
+        prefilter_reject(PREFILTER_FORMAT);
+        return;
+    }
+
+    if (timestamp <= global_last_timestamp) {
+        prefilter_reject(PREFILTER_REPLAY);
+        return;
+    }
+
+    LOG_INFO("[NORMAL] Mensagem NOVA recebida: valor=%s, timestamp=%llu\n", valor, timestamp);
+    global_last_timestamp = timestamp;
+    latency_record(FRAME_KIND_PLAIN, timestamp);
+    prefilter_accept(PREFILTER_SENDER_NONE);
+
+    display_text_in_line("Msg Recebida:", 1, 0);
+    display_text_in_line(mensagem, 2, 0);
+    char ts_str[4 + NUMFMT_U64_LEN + 1] = "TS: ";
+    numfmt_u64(ts_str + 4, timestamp);
+    display_text_in_line(ts_str, 3, 0);
+    display_text_in_line("", 4, 0); // Clear last line
+}
+
+static void on_message_normal_mode(const char *topic, const uint8_t *payload, size_t len) {
+    decode_with_buffer(decode_normal, topic, payload, len);
+}
+
+// Modo XOR
+static void decode_xor(const char *topic, const uint8_t *payload, size_t len, uint8_t *decrypted_buffer) {
+    // Texto cifrado: o replay só é conhecido depois do XOR (barato); antes, tamanho e taxa
+    if (prefilter_plain(FRAME_KIND_XOR, payload, len, 0, PAYLOAD_MAX_LEN - 1, NULL) != PREFILTER_PASS) {
+        return;
+    }
+    payload += FRAME_TYPE_LEN;
+    len -= FRAME_TYPE_LEN;
+
+    char valor[32] = {0};
+    uint64_t timestamp = 0;
+
+    size_t process_len = len;
+    TRACE_BEGIN(TRACE_DECRYPT_VERIFY);
+    xor_encrypt(payload, decrypted_buffer, process_len, key_manager_current()->xor_key);
+    decrypted_buffer[process_len] = '\0';
+    TRACE_END(TRACE_DECRYPT_VERIFY);
+    size_t plain_len = process_len;
+    if (!unpack_message(topic, (char *)decrypted_buffer, &plain_len)) {
+        return;
+    }
+
+    TRACE_BEGIN(TRACE_PARSE);
+    numfmt_status_t parsed = numfmt_parse_reading((char *)decrypted_buffer, plain_len, valor, sizeof(valor), &timestamp);
+    TRACE_END(TRACE_PARSE);
+    if (parsed != NUMFMT_OK) {
+        prefilter_reject(PREFILTER_FORMAT);
+        return;
+    }
+
+    if (timestamp <= global_last_timestamp) {
+        prefilter_reject(PREFILTER_REPLAY);
+        return;
+    }
+
+    LOG_INFO("[XOR] Mensagem NOVA (descriptografada): valor=%s, timestamp=%llu\n", valor, timestamp);
+    global_last_timestamp = timestamp;
+    latency_record(FRAME_KIND_XOR, timestamp);
+    prefilter_accept(PREFILTER_SENDER_NONE);
+
+    // Até 2 * 255 + 1 bytes: classe de 512 B do pool; sem bloco livre, a linha do hex fica vazia
+    char *hex_string_buffer = pool_alloc(HEX_ENCODED_LEN(process_len));
+    if (hex_string_buffer != NULL) {
+        hex_encode(payload, process_len, hex_string_buffer);
+        LOG_DEBUG("Mensagem criptografada (hex): %s\n", hex_string_buffer);
+    }
+    LOG_DEBUG("Mensagem descriptografada: %s\n", decrypted_buffer);
+
+    display_text_in_line("Msg Cript (XOR):", 1, 0);
+    display_text_in_line(hex_string_buffer != NULL ? hex_string_buffer : "", 2, 0);
+    display_text_in_line("Msg Descriptografada:", 3, 0);
+    display_text_in_line((char *)decrypted_buffer, 4, 0);
+    pool_free(hex_string_buffer);
+}
+
+static void on_message_xor_mode(const char *topic, const uint8_t *payload, size_t len) {
+    decode_with_buffer(decode_xor, topic, payload, len);
+}
+
+// Modo HMAC
+static void decode_hmac(const char *topic, const uint8_t *payload, size_t len, uint8_t *buffer) {
+    // Algoritmo e tamanho da tag configurados para o tópico (tabela em src/mac.c)
+    const mac_config_t *mac_config = mac_config_for_topic(topic);
+    size_t overhead = mac_overhead(mac_config);
+
+    // A mensagem vai em claro depois da tag: tamanho, replay pelo timestamp e taxa antes do MAC
+    if (prefilter_plain(FRAME_KIND_MAC, payload, len, overhead, PAYLOAD_MAX_LEN - 1, &global_last_timestamp) != PREFILTER_PASS) {
+        return;
+    }
+    payload += FRAME_TYPE_LEN;
+    len -= FRAME_TYPE_LEN;
+
+    const uint8_t *received_tag = payload + overhead - mac_config->tag_len;
+    const uint8_t *message_data_ptr = NULL;
+    size_t message_data_len = 0;
+
+    uint32_t crypto_start_us = time_us_32(); // Mede o custo da verificação por mensagem
+    TRACE_BEGIN(TRACE_DECRYPT_VERIFY);
+    bool tag_ok = mac_verify(mac_config, payload, len, &message_data_ptr, &message_data_len);
+    TRACE_END(TRACE_DECRYPT_VERIFY);
+    uint32_t crypto_us = time_us_32() - crypto_start_us;
+
+    if (!tag_ok) {
+        prefilter_reject(PREFILTER_AUTH);
+        return;
+    }
+
+    // Copia a mensagem para um buffer com '\0' (exibida no display)
+    char *extracted_message_str = (char *)buffer;
+    memcpy(extracted_message_str, message_data_ptr, message_data_len);
+    extracted_message_str[message_data_len] = '\0'; // Null-terminate
+    if (!unpack_message(topic, extracted_message_str, &message_data_len)) {
+        return;
+    }
+
+    char valor[32] = {0};
+    uint64_t timestamp = 0;
+    TRACE_BEGIN(TRACE_PARSE);
+    numfmt_status_t parsed = numfmt_parse_reading(extracted_message_str, message_data_len, valor, sizeof(valor), &timestamp);
+    TRACE_END(TRACE_PARSE);
+    if (parsed != NUMFMT_OK) {
+        prefilter_reject(PREFILTER_FORMAT);
+        return;
+    }
+
+    if (timestamp <= global_last_timestamp) {
+        prefilter_reject(PREFILTER_REPLAY);
+        return;
+    }
+
+    global_last_timestamp = timestamp;
+    latency_record(FRAME_KIND_MAC, timestamp);
+    prefilter_accept(PREFILTER_SENDER_NONE);
+    LOG_INFO("[HMAC Sub] Mensagem AUTENTICADA e NOVA: msg='%s', ts=%llu (%s/%u em %lu us)\n", extracted_message_str,
+             timestamp, mac_alg_name(mac_config->alg), mac_config->tag_len, (unsigned long)crypto_us);
+
+    display_text_in_line("Msg Autenticada:", 1, 0);
+    display_text_in_line(extracted_message_str, 2, 0);
+    char ts_str[4 + NUMFMT_U64_LEN + 1] = "TS: ";
+    numfmt_u64(ts_str + 4, timestamp);
+    display_text_in_line(ts_str, 3, 0);
+    char hmac_ok_disp[20];
+    sprintf(hmac_ok_disp, "Tag OK: %02x%02x..", received_tag[0], received_tag[1]);
+    display_text_in_line(hmac_ok_disp, 4, 0);
+}
+
+static void on_message_hmac_mode(const char *topic, const uint8_t *payload, size_t len) {
+    decode_with_buffer(decode_hmac, topic, payload, len);
+}
+
+// AES-GCM e ChaCha20-Poly1305 usam o mesmo frame; muda só a cifra e os textos
+static void decode_aead(frame_aead_t aead, const char *name, const char *ok_label, const char *topic,
+                        const uint8_t *payload, size_t len, uint8_t *decrypted_buffer) {
+    // Cabeçalho em claro (tipo, tópico, remetente, replay) e taxa pré-tag antes da decifragem
+    nonce_seq_t seq = {0};
+    if (prefilter_frame(aead, topic, payload, len, PAYLOAD_MAX_LEN - 1, &seq) != PREFILTER_PASS) {
+        return;
+    }
+
+    uint32_t crypto_start_us = time_us_32(); // Mede validação + decifragem por mensagem
+    TRACE_BEGIN(TRACE_DECRYPT_VERIFY);
+    size_t plain_len = 0;
+    frame_status_t status = frame_open(aead, topic, payload, len,
+                                       decrypted_buffer, PAYLOAD_MAX_LEN - 1, &plain_len, &seq);
+    TRACE_END(TRACE_DECRYPT_VERIFY);
+    uint32_t crypto_us = time_us_32() - crypto_start_us;
+
+    if (status != FRAME_OK) {
+        prefilter_reject(status == FRAME_ERR_REPLAY ? PREFILTER_REPLAY : PREFILTER_AUTH);
+        return;
+    }
+    // Só agora o ID é confiável: cota do remetente autenticado
+    if (prefilter_verified(seq.sender) != PREFILTER_PASS) {
+        return;
+    }
+
+    decrypted_buffer[plain_len] = '\0';
+    if (!unpack_message(topic, (char *)decrypted_buffer, &plain_len)) {
+        return;
+    }
+    prefilter_accept(seq.sender);
+    char valor[32];
+    uint64_t timestamp = 0;
+    if (numfmt_parse_reading((char *)decrypted_buffer, plain_len, valor, sizeof(valor), &timestamp) == NUMFMT_OK) {
+        latency_record((frame_kind_t)aead, timestamp);
+    }
+    LOG_INFO("[%s Sub] Mensagem DESCRIPTOGRAFADA, AUTENTICADA e NOVA: msg='%s', boot=%lu, seq=%lu (%lu us)\n", name,
+             (char *)decrypted_buffer, (unsigned long)seq.boot, (unsigned long)seq.counter, (unsigned long)crypto_us);
+
+    char seq_str[21];
+    snprintf(seq_str, sizeof(seq_str), "B:%lu S:%lu", (unsigned long)seq.boot, (unsigned long)seq.counter);
+    display_text_in_line(ok_label, 1, 0);
+    display_text_in_line((char *)decrypted_buffer, 2, 0);
+    display_text_in_line(seq_str, 3, 0);
+    display_text_in_line("Tag OK", 4, 0);
+}
+
+static void decode_aes(const char *topic, const uint8_t *payload, size_t len, uint8_t *decrypted_buffer) {
+    decode_aead(FRAME_AEAD_AES_GCM, "AES", "Msg AES OK:", topic, payload, len, decrypted_buffer);
+}
+
+static void on_message_aes_mode(const char *topic, const uint8_t *payload, size_t len) {
+    decode_with_buffer(decode_aes, topic, payload, len);
+}
+
+static void decode_chacha(const char *topic, const uint8_t *payload, size_t len, uint8_t *decrypted_buffer) {
+    decode_aead(FRAME_AEAD_CHACHAPOLY, "ChaCha", "Msg ChaCha OK:", topic, payload, len, decrypted_buffer);
+}
+
+static void on_message_chacha_mode(const char *topic, const uint8_t *payload, size_t len) {
+    decode_with_buffer(decode_chacha, topic, payload, len);
+}
+
+// Decodificadores do modo automático, escolhidos pelo byte de tipo de cada mensagem
+static const dispatch_route_t dispatch_routes[] = {
+    {FRAME_KIND_PLAIN, on_message_normal_mode},
+    {FRAME_KIND_XOR, on_message_xor_mode},
+    {FRAME_KIND_MAC, on_message_hmac_mode},
+    {FRAME_KIND_AES_GCM, on_message_aes_mode},
+    {FRAME_KIND_CHACHAPOLY, on_message_chacha_mode},
+};
+
+// Recusas não desenham nada nos handlers; o total e os percentis da latência aparecem no
+// rodapé do OLED, no máximo uma vez a cada PREFILTER_DISPLAY_INTERVAL_MS, a partir do loop principal
+static void display_footer_stats(void) {
+    static char shown[22];
+    static uint32_t last_draw_ms = 0;
+    uint32_t now_ms = to_ms_since_boot(get_absolute_time());
+    if (now_ms - last_draw_ms < PREFILTER_DISPLAY_INTERVAL_MS) {
+        return;
+    }
+
+    char summary[22];
+    char footer[22];
+    uint32_t rejected = prefilter_rejected_total();
+    if (latency_format_summary(summary, sizeof(summary)) > 0) {
+        snprintf(footer, sizeof(footer), "R%lu %s", (unsigned long)rejected, summary);
+    } else if (rejected > 0) {
+        snprintf(footer, sizeof(footer), "Recusadas: %lu", (unsigned long)rejected);
+    } else {
+        return; // Nada a mostrar ainda
+    }
+    if (strcmp(footer, shown) == 0) {
+        return;
+    }
+    memcpy(shown, footer, sizeof(shown));
+    last_draw_ms = now_ms;
+    display_footer(footer);
+}
+
+// Os streams de MQTT_TOPIC_SENSORS (multi-stream) só fazem sentido no automático: num modo
+// fixo eles chegariam ao decodificador de outro frame e seriam contados como recusas
+static void auto_mode_init(void) {
+    mqtt_comm_subscribe(MQTT_TOPIC_SENSORS "/#");
+}
+
+static void auto_mode_teardown(void) {
+    mqtt_comm_unsubscribe(MQTT_TOPIC_SENSORS "/#");
+}
+
+const app_mode_t subscriber_modes[] = {
+    // menu                  título                   init            encode decode                  teardown
+    {"Sem seguranca",        "Modo: Sem Seguranca",   NULL,           NULL,  on_message_normal_mode, NULL},
+    {"Encriptacao XOR",      "Modo: Encriptacao XOR", NULL,           NULL,  on_message_xor_mode,    NULL},
+    {"Autenticacao HMAC",    "Modo: Autent. HMAC",    NULL,           NULL,  on_message_hmac_mode,   NULL},
+    {"AES-GCM",              "Modo: AES-GCM",         NULL,           NULL,  on_message_aes_mode,    NULL},
+    {"ChaCha20-Poly1305",    "Modo: ChaCha20-Poly",   NULL,           NULL,  on_message_chacha_mode, NULL},
+    {"Automatico (todos)",   "Modo: Automatico",      auto_mode_init, NULL,  dispatch_message,       auto_mode_teardown},
+};
+const size_t subscriber_mode_count = sizeof(subscriber_modes) / sizeof(subscriber_modes[0]);
+
+void subscriber_boot(void) {
+    dispatch_set_routes(dispatch_routes, sizeof(dispatch_routes) / sizeof(dispatch_routes[0]));
+}
+
+void subscriber_connected(void) {
+    // Inscreve no tópico de interesse e no de anúncios de rotação das chaves
+    // (os streams de MQTT_TOPIC_SENSORS só são assinados no modo automático)
+    mqtt_comm_subscribe(MQTT_TOPIC_SUBSCRIBE);
+    mqtt_comm_subscribe_with_handler(MQTT_TOPIC_KEYS, key_manager_control_handler);
+    clock_sync_start(); // Offset do relógio do publisher, para a latência de ponta a ponta
+    printf("Aguardando mensagens no tópico: %s\n", MQTT_TOPIC_SUBSCRIBE);
+}
+
+void subscriber_poll(bool in_mode) {
+    key_manager_poll(false);                                // Deriva as chaves anunciadas no tópico de controle
+    clock_sync_poll(to_ms_since_boot(get_absolute_time())); // Ping de sincronização com o publisher
+    latency_poll(MQTT_CLIENT_ID_SUBSCRIBER);                // Percentis da latência no tópico de status
+    if (in_mode) {
+        display_footer_stats(); // Recusas e latência no rodapé, com taxa limitada
+    }
+}
@@ -0,0 +1,67 @@
+#include "include/trace.h"
+#include "pico/stdlib.h"
+#include <stdio.h>
+
+#ifndef TRACE_RING_SIZE
+#define TRACE_RING_SIZE 512 // Potência de 2: o índice é mascarado em vez de usar módulo
+#endif
+
+#if TRACE_ENABLED
+typedef struct {
+    uint32_t timestamp_us;
+    uint8_t stage;
+    uint8_t is_begin;
+} trace_event_t;
+
+static trace_event_t ring[TRACE_RING_SIZE];
+static volatile uint32_t write_count = 0; // Total de eventos gravados (não é mascarado)
+static volatile bool dumping = false;
+
+static const char *const stage_names[TRACE_STAGE_COUNT] = {
+    "sample", "frame_build", "crypto", "mqtt_publish",
+    "mqtt_incoming_data", "decrypt_verify", "parse", "display_flush",
+};
+#endif
+
+void trace_record(trace_stage_t stage, bool is_begin) {
+#if TRACE_ENABLED
+    uint32_t now = time_us_32();
+    if (dumping) {
+        return;
+    }
+    // O M0+ não tem LDREX/STREX: a reserva do slot é feita com as interrupções
+    // desabilitadas por poucas instruções, já que os callbacks do lwIP também gravam.
+    uint32_t irq_state = save_and_disable_interrupts();
+    uint32_t slot = write_count++;
+    restore_interrupts(irq_state);
+
+    trace_event_t *event = &ring[slot & (TRACE_RING_SIZE - 1)];
+    event->timestamp_us = now;
+    event->stage = (uint8_t)stage;
+    event->is_begin = is_begin;
+#else
+    (void)stage;
+    (void)is_begin;
+#endif
+}
+
+void trace_dump(void) {
+#if TRACE_ENABLED
+    dumping = true;
+    uint32_t count = write_count;
+    uint32_t first = (count > TRACE_RING_SIZE) ? count - TRACE_RING_SIZE : 0;
+
+    printf("TRACE-BEGIN %lu eventos (%lu perdidos)\n", (unsigned long)(count - first), (unsigned long)first);
+    for (uint32_t i = first; i < count; i++) {
+        const trace_event_t *event = &ring[i & (TRACE_RING_SIZE - 1)];
+        printf("TRACE,%s,%c,%lu\n", stage_names[event->stage], event->is_begin ? 'B' : 'E',
+               (unsigned long)event->timestamp_us);
+    }
+    printf("TRACE-END\n");
+
+    write_count = 0;
+    dumping = false;
+#else
+    printf("Rastreamento desabilitado (compile com TRACE=ON)\n");
+#endif
+}
@@ -0,0 +1,43 @@
+#ifndef CHECK_H
+#define CHECK_H
+
+/*
+ * Verificações dos testes de host: cada falha imprime arquivo, linha e a expressão e o
+ * teste continua; CHECK_EXIT() no fim do main() devolve 1 se alguma falhou (CTest).
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+static int check_failures = 0;
+
+#define CHECK(cond)                                                                  \
+    do {                                                                             \
+        if (!(cond)) {                                                               \
+            fprintf(stderr, "%s:%d: falhou: %s\n", __FILE__, __LINE__, #cond);      \
+            check_failures++;                                                        \
+        }                                                                            \
+    } while (0)
+
+#define CHECK_STR(actual, expected)                                                  \
+    do {                                                                             \
+        const char *check_a_ = (actual);                                             \
+        const char *check_e_ = (expected);                                           \
+        if (strcmp(check_a_, check_e_) != 0) {                                       \
+            fprintf(stderr, "%s:%d: falhou: %s = \"%s\", esperado \"%s\"\n", __FILE__, \
+                    __LINE__, #actual, check_a_, check_e_);                          \
+            check_failures++;                                                        \
+        }                                                                            \
+    } while (0)
+
+#define CHECK_EXIT()                                                                 \
+    do {                                                                             \
+        if (check_failures > 0) {                                                    \
+            fprintf(stderr, "%d verificacoes falharam\n", check_failures);          \
+            return 1;                                                                \
+        }                                                                            \
+        printf("ok\n");                                                              \
+        return 0;                                                                    \
+    } while (0)
+
+#endif // CHECK_H
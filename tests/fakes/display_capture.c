@@ -0,0 +1,55 @@
+#include "fakes.h"
+#include "display.h"
+#include <stdio.h>
+#include <string.h>
+
+// Coluna 0 = subscriber, 1 = publisher (como o is_publisher de display_text_in_line)
+static char lines[2][FAKE_DISPLAY_LINES][FAKE_DISPLAY_LINE_LEN];
+static char footer[FAKE_DISPLAY_LINE_LEN];
+
+void display_init() {
+    fake_display_reset();
+}
+
+void display_draw_initial_message() {
+}
+
+void display_text_in_line(const char *message, int line, bool is_publisher) {
+    if (line >= 0 && line < FAKE_DISPLAY_LINES) {
+        snprintf(lines[is_publisher ? 1 : 0][line], FAKE_DISPLAY_LINE_LEN, "%s", message);
+    }
+}
+
+void display_footer(const char *message) {
+    snprintf(footer, sizeof(footer), "%s", message);
+}
+
+void draw_menu(const char *title, const char *items[], int item_count, int selected_idx) {
+    (void)title;
+    (void)items;
+    (void)item_count;
+    (void)selected_idx;
+}
+
+void draw_top_title_publisher() {
+}
+
+void draw_top_title_subscriber() {
+}
+
+void display_clear() {
+    fake_display_reset();
+}
+
+const char *fake_display_line(int line, bool is_publisher) {
+    return line >= 0 && line < FAKE_DISPLAY_LINES ? lines[is_publisher ? 1 : 0][line] : "";
+}
+
+const char *fake_display_footer(void) {
+    return footer;
+}
+
+void fake_display_reset(void) {
+    memset(lines, 0, sizeof(lines));
+    memset(footer, 0, sizeof(footer));
+}
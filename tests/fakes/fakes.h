@@ -0,0 +1,48 @@
+#ifndef FAKES_H
+#define FAKES_H
+
+/*
+ * Dublês de teste dos módulos que falam com o hardware ou com a rede: o display guarda
+ * o texto de cada linha (display_capture.c) e o mqtt_comm guarda as publicações numa
+ * fila e entrega mensagens aos handlers assinados (mqtt_capture.c). Os testes de ida e
+ * volta ligam os plugins reais a estes dois.
+ */
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#define FAKE_DISPLAY_LINES 6
+#define FAKE_DISPLAY_LINE_LEN 48
+#define FAKE_MQTT_TOPIC_LEN 64
+#define FAKE_MQTT_PAYLOAD_LEN 512
+#define FAKE_MQTT_QUEUE_LEN 16
+
+/* Display */
+const char *fake_display_line(int line, bool is_publisher);
+const char *fake_display_footer(void);
+void fake_display_reset(void);
+
+/* MQTT */
+typedef struct {
+    char topic[FAKE_MQTT_TOPIC_LEN];
+    uint8_t payload[FAKE_MQTT_PAYLOAD_LEN];
+    size_t len;
+    uint8_t qos;
+    bool retain;
+} fake_mqtt_message_t;
+
+void fake_mqtt_set_connected(bool connected);
+void fake_mqtt_set_publish_result(int result); // Retorno das próximas publicações (0 ou -1)
+size_t fake_mqtt_published(void);              // Publicações na fila
+bool fake_mqtt_take(fake_mqtt_message_t *message);
+void fake_mqtt_clear(void);
+void fake_mqtt_deliver(const char *topic, const uint8_t *payload, size_t len); // Só se algum filtro assinado casar
+bool fake_mqtt_is_subscribed(const char *topic);
+
+// Destino das publicações no lugar da fila (ex.: a saída do cliente MQTT simulada); o
+// retorno, 0 ou -1, é o da publicação. NULL volta para a fila.
+typedef int (*fake_mqtt_output_t)(const char *topic, size_t len, uint8_t qos);
+void fake_mqtt_set_output(fake_mqtt_output_t handler);
+
+#endif // FAKES_H
@@ -0,0 +1,184 @@
+#include "fakes.h"
+#include "mqtt_comm.h"
+#include <stdio.h>
+#include <string.h>
+
+typedef struct {
+    char topic[FAKE_MQTT_TOPIC_LEN];
+    mqtt_message_handler_t handler; // NULL = handler geral
+} subscription_t;
+
+static fake_mqtt_message_t queue[FAKE_MQTT_QUEUE_LEN];
+static size_t queue_head = 0;
+static size_t queue_count = 0;
+static subscription_t subscriptions[MQTT_COMM_MAX_SUBSCRIPTIONS];
+static size_t subscription_count = 0;
+static mqtt_message_handler_t general_handler = NULL;
+static bool connected = true;
+static int publish_result = 0;
+static uint32_t delivered = 0;
+static fake_mqtt_output_t output = NULL;
+
+static int capture(const char *topic, const uint8_t *data, size_t len, uint8_t qos, bool retain) {
+    if (connected && output != NULL) {
+        return output(topic, len, qos);
+    }
+    if (!connected || publish_result != 0 || queue_count == FAKE_MQTT_QUEUE_LEN || len > FAKE_MQTT_PAYLOAD_LEN) {
+        return -1;
+    }
+    fake_mqtt_message_t *message = &queue[(queue_head + queue_count++) % FAKE_MQTT_QUEUE_LEN];
+    snprintf(message->topic, sizeof(message->topic), "%s", topic);
+    memcpy(message->payload, data, len);
+    message->len = len;
+    message->qos = qos;
+    message->retain = retain;
+    return 0;
+}
+
+void mqtt_setup(const char *client_id, const char *broker_ip, const char *user, const char *pass) {
+    (void)client_id;
+    (void)broker_ip;
+    (void)user;
+    (void)pass;
+}
+
+int mqtt_comm_reconnect(void) {
+    return 0;
+}
+
+void mqtt_comm_get_rx_stats(mqtt_rx_stats_t *stats) {
+    memset(stats, 0, sizeof(*stats));
+    stats->messages = delivered;
+}
+
+uint32_t mqtt_comm_message_age_us(void) {
+    return 0; // Entregue na hora: sem fila de recepção
+}
+
+void mqtt_comm_publish(const char *topic, const uint8_t *data, size_t len) {
+    capture(topic, data, len, 0, false);
+}
+
+int mqtt_comm_publish_retained(const char *topic, const uint8_t *data, size_t len) {
+    return capture(topic, data, len, 1, true);
+}
+
+int mqtt_comm_publish_qos(const char *topic, const uint8_t *data, size_t len, uint8_t qos) {
+    return capture(topic, data, len, qos, false);
+}
+
+void fake_mqtt_set_output(fake_mqtt_output_t handler) {
+    output = handler;
+}
+
+int mqtt_comm_is_connected(void) {
+    return connected;
+}
+
+void mqtt_comm_subscribe(const char *topic) {
+    mqtt_comm_subscribe_with_handler(topic, NULL);
+}
+
+void mqtt_comm_subscribe_with_handler(const char *topic, mqtt_message_handler_t handler) {
+    for (size_t i = 0; i < subscription_count; i++) {
+        if (strcmp(subscriptions[i].topic, topic) == 0) {
+            subscriptions[i].handler = handler;
+            return;
+        }
+    }
+    if (subscription_count < MQTT_COMM_MAX_SUBSCRIPTIONS) {
+        snprintf(subscriptions[subscription_count].topic, FAKE_MQTT_TOPIC_LEN, "%s", topic);
+        subscriptions[subscription_count++].handler = handler;
+    }
+}
+
+void mqtt_comm_unsubscribe(const char *topic) {
+    for (size_t i = 0; i < subscription_count; i++) {
+        if (strcmp(subscriptions[i].topic, topic) == 0) {
+            subscriptions[i] = subscriptions[--subscription_count];
+            return;
+        }
+    }
+}
+
+void mqtt_comm_set_message_handler(mqtt_message_handler_t handler) {
+    general_handler = handler;
+}
+
+void fake_mqtt_set_connected(bool value) {
+    connected = value;
+}
+
+void fake_mqtt_set_publish_result(int result) {
+    publish_result = result;
+}
+
+size_t fake_mqtt_published(void) {
+    return queue_count;
+}
+
+bool fake_mqtt_take(fake_mqtt_message_t *message) {
+    if (queue_count == 0) {
+        return false;
+    }
+    *message = queue[queue_head];
+    queue_head = (queue_head + 1) % FAKE_MQTT_QUEUE_LEN;
+    queue_count--;
+    return true;
+}
+
+void fake_mqtt_clear(void) {
+    queue_head = 0;
+    queue_count = 0;
+}
+
+bool fake_mqtt_is_subscribed(const char *topic) {
+    for (size_t i = 0; i < subscription_count; i++) {
+        if (strcmp(subscriptions[i].topic, topic) == 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// Handler próprio do tópico (comparação exata, como em mqtt_comm.c) ou o geral
+// Filtro de tópico do MQTT: '+' casa um nível, '#' no fim casa o resto
+static bool topic_matches(const char *filter, const char *topic) {
+    while (*filter != '\0') {
+        if (filter[0] == '#') {
+            return true;
+        }
+        if (filter[0] == '+') {
+            while (*topic != '\0' && *topic != '/') {
+                topic++;
+            }
+            filter++;
+            continue;
+        }
+        if (*filter != *topic) {
+            // "a/#" também casa "a"
+            return *topic == '\0' && filter[0] == '/' && filter[1] == '#' && filter[2] == '\0';
+        }
+        filter++;
+        topic++;
+    }
+    return *topic == '\0';
+}
+
+void fake_mqtt_deliver(const char *topic, const uint8_t *payload, size_t len) {
+    // Como o broker: só chega o que casa com alguma inscrição
+    mqtt_message_handler_t handler = general_handler;
+    bool subscribed = false;
+    for (size_t i = 0; i < subscription_count; i++) {
+        if (topic_matches(subscriptions[i].topic, topic)) {
+            subscribed = true;
+            if (subscriptions[i].handler != NULL && strcmp(subscriptions[i].topic, topic) == 0) {
+                handler = subscriptions[i].handler;
+            }
+        }
+    }
+    if (subscribed && handler != NULL) {
+        delivered++;
+        handler(topic, payload, len);
+    }
+}
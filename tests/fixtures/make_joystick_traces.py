@@ -0,0 +1,79 @@
+#!/usr/bin/env python3
+"""
+Gera os traços do ADC do joystick usados por tests/test_joystick_trace.c.
+
+Cada traço é uma sequência de rodadas do round-robin (uma linha "t_ms,y,x" a cada 2 ms,
+os 500 Hz de ADC_SCAN_RATE_HZ) montada por trechos de nível constante com ruído uniforme
+limitado, como o que se vê numa captura do Pico W: ~±60 LSB com o joystick solto, menos
+com o eixo encostado no fim de curso. O ruído tem semente fixa, então os arquivos são
+reproduzíveis. As linhas "# esperado:" são os eventos que o filtro e a histerese devem
+gerar; elas foram derivadas à mão da média móvel (peso 1/4) e dos limiares de
+config/config.h, não do código, e o teste aceita uma rodada de diferença no instante.
+
+Uso: python3 make_joystick_traces.py   (reescreve os .csv deste diretório)
+"""
+import os
+import random
+
+ROUND_MS = 2
+NEUTRAL = (2048, 60)
+
+# nome: (duração em ms, trechos [(início, fim, (nível Y, ruído), (nível X, ruído))], eventos, descrição)
+TRACES = {
+    "joystick_tap_up": (
+        800,
+        [(200, 340, (4000, 40), NEUTRAL)],
+        [(204, "cima", 0)],
+        "Toque rapido para cima (140 ms): um evento na terceira rodada, sem repeticao.",
+    ),
+    "joystick_hold_down": (
+        1600,
+        [(100, 1350, (50, 30), NEUTRAL)],
+        [(104, "baixo", 0), (604, "baixo", 1), (804, "baixo", 1), (1004, "baixo", 1), (1204, "baixo", 1)],
+        "Segurando para baixo por 1250 ms: evento, repeticao em 500 ms e depois a cada 200 ms.",
+    ),
+    "joystick_spikes": (
+        1000,
+        [(100, 102, (4095, 0), NEUTRAL), (200, 204, (4095, 0), NEUTRAL), (300, 304, NEUTRAL, (0, 0)),
+         (400, 402, NEUTRAL, (4095, 0)), (500, 504, (0, 0), (4095, 0)), (700, 704, (4095, 0), (0, 0))],
+        [],
+        "Picos de uma e duas amostras no fim de escala com o joystick solto: o filtro nao gera eventos.",
+    ),
+    "joystick_x_hysteresis": (
+        1400,
+        [(100, 400, NEUTRAL, (3800, 200)), (400, 900, NEUTRAL, (2750, 200)), (1000, 1300, NEUTRAL, (2750, 200))],
+        [(104, "direita", 0), (604, "direita", 1), (804, "direita", 1)],
+        "Direita com ruido de +-200; a leitura cai para 2750 (entre a zona morta e o limiar): o eixo "
+        "continua alto e repete. Depois do neutro, 2750 nao basta para um evento novo.",
+    ),
+}
+
+
+def level_at(t, segments, axis):
+    for start, end, y, x in segments:
+        if start <= t < end:
+            return (y, x)[axis]
+    return NEUTRAL
+
+
+def main():
+    directory = os.path.dirname(os.path.abspath(__file__))
+    rng = random.Random(4231)
+    for name, (duration, segments, events, description) in TRACES.items():
+        lines = [
+            f"# {description}",
+            "# Gerado por make_joystick_traces.py; formato: t_ms,y,x (uma rodada do ADC por linha)",
+        ]
+        lines += [f"# esperado: {t} {kind} {repeat}" for t, kind, repeat in events]
+        for t in range(0, duration, ROUND_MS):
+            sample = []
+            for axis in (0, 1):
+                level, noise = level_at(t, segments, axis)
+                sample.append(min(4095, max(0, level + rng.randint(-noise, noise))))
+            lines.append(f"{t},{sample[0]},{sample[1]}")
+        with open(os.path.join(directory, name + ".csv"), "w") as out:
+            out.write("\n".join(lines) + "\n")
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,42 @@
+/*
+ * Benchmarks do console (src/console.c) compilados para o host: as mesmas funções,
+ * com o relógio real, para comparar mudanças no código sem gravar a placa. Os números
+ * medem o x86 e o OpenSSL, não o RP2040: valem como comparação entre versões.
+ *   host_bench <nome>   (um dos nomes da tabela abaixo)
+ */
+#include "include/encoding.h"
+#include "include/key_manager.h"
+#include "include/nonce.h"
+#include "include/pool.h"
+#include "include/stream.h"
+#include <stdio.h>
+#include <string.h>
+
+static const struct {
+    const char *name;
+    void (*run)(void);
+} benchmarks[] = {
+    {"stream", stream_benchmark},
+    {"pool", pool_benchmark},
+    {"encoding", encoding_benchmark},
+};
+
+int main(int argc, char **argv) {
+    for (size_t i = 0; argc == 2 && i < sizeof(benchmarks) / sizeof(benchmarks[0]); i++) {
+        if (strcmp(argv[1], benchmarks[i].name) == 0) {
+            // Os streams misto cifram e autenticam: precisam das chaves e dos nonces do boot
+            if (!key_manager_init() || !nonce_init()) {
+                fprintf(stderr, "falha ao iniciar chaves/nonces\n");
+                return 1;
+            }
+            benchmarks[i].run();
+            return 0;
+        }
+    }
+    fprintf(stderr, "uso: %s <", argv[0]);
+    for (size_t i = 0; i < sizeof(benchmarks) / sizeof(benchmarks[0]); i++) {
+        fprintf(stderr, "%s%s", i ? "|" : "", benchmarks[i].name);
+    }
+    fprintf(stderr, ">\n");
+    return 2;
+}
@@ -0,0 +1,70 @@
+/*
+ * O caminho do firmware de loopback (src/loopback.c) no Linux: cada modo é montado por
+ * frame_encode, sai pelo mqtt_comm real sobre sockets (tests/shims/host_mqtt.c), volta
+ * do tools/mini_broker.py e é aberto por frame_open, mac_verify, xor_encrypt e
+ * numfmt_parse_reading, com o timestamp conferido. A espera pela volta é a do firmware
+ * (tight_loop_contents), que aqui atende o socket. tools/host_loadtest.py --loopback
+ * sobe o broker e chama este programa.
+ *   host_loopback <porta>
+ * Roda uma rodada de LOOPBACK_MESSAGES por modo, interna e pelo broker, e falha se alguma
+ * mensagem não decodificou ou não voltou.
+ */
+#include "check.h"
+#include "shims/host.h"
+#include "include/key_manager.h"
+#include "include/loopback.h"
+#include "include/mqtt_comm.h"
+#include "config/config.h"
+#include "config/credentials.h"
+#include "pico/stdlib.h"
+#include <stdlib.h>
+
+#define HOST_CONNECT_TIMEOUT_MS 5000
+#define HOST_SUBSCRIBE_SETTLE_MS 300 // SUBACKs do broker local antes da primeira rodada
+
+static const frame_kind_t kinds[] = {FRAME_KIND_PLAIN, FRAME_KIND_XOR, FRAME_KIND_MAC, FRAME_KIND_AES_GCM,
+                                     FRAME_KIND_CHACHAPOLY};
+
+static uint32_t now_ms(void) {
+    return to_ms_since_boot(get_absolute_time());
+}
+
+int main(int argc, char **argv) {
+    if (argc != 2) {
+        fprintf(stderr, "uso: %s <porta>\n", argv[0]);
+        return 2;
+    }
+    host_mqtt_set_port((uint16_t)atoi(argv[1]));
+    CHECK(key_manager_init());
+    loopback_boot();
+    mqtt_setup(MQTT_CLIENT_ID_LOOPBACK, "127.0.0.1", MQTT_USER, MQTT_PASS);
+    uint32_t start_ms = now_ms();
+    while (!mqtt_comm_is_connected() && now_ms() - start_ms < HOST_CONNECT_TIMEOUT_MS) {
+        sleep_ms(10);
+    }
+    if (!mqtt_comm_is_connected()) {
+        fprintf(stderr, "sem conexao com o broker na porta %s\n", argv[1]);
+        return 1;
+    }
+    loopback_connected();
+    sleep_ms(HOST_SUBSCRIBE_SETTLE_MS);
+
+    static const char *const transport_names[] = {"interno", "broker"};
+    printf("%-8s %-8s %8s %8s %8s %8s %6s %6s %6s\n", "entrega", "modo", "p50", "p99", "max", "msg/s", "ok",
+           "falha", "perda");
+    for (int transport = LOOPBACK_INTERNAL; transport <= LOOPBACK_BROKER; transport++) {
+        for (size_t i = 0; i < sizeof(kinds) / sizeof(kinds[0]); i++) {
+            loopback_result_t r;
+            loopback_run(kinds[i], (loopback_transport_t)transport, &r);
+            printf("%-8s %-8s %8lu %8lu %8lu %8lu %6lu %6lu %6lu\n", transport_names[transport],
+                   frame_kind_name(kinds[i]), (unsigned long)r.p50_us, (unsigned long)r.p99_us,
+                   (unsigned long)r.max_us, (unsigned long)r.msgs_per_s, (unsigned long)r.received,
+                   (unsigned long)r.failed, (unsigned long)r.timeouts);
+            CHECK(r.sent == LOOPBACK_MESSAGES);
+            CHECK(r.received == r.sent);
+            CHECK(r.failed == 0);
+            CHECK(r.timeouts == 0);
+        }
+    }
+    CHECK_EXIT();
+}
@@ -0,0 +1,91 @@
+/*
+ * O subscriber do firmware no Linux: src/mqtt_comm.c sobre o cliente de sockets de
+ * tests/shims/host_mqtt.c e os plugins de src/subscriber_modes.c, ligado a um broker
+ * local (tools/mini_broker.py). O laço é o do app_run com o modo já escolhido; a rede é
+ * atendida dentro do sleep_ms, como o background do cyw43_arch. tools/host_loadtest.py
+ * o usa com o load_gen.py e as falhas do mini_broker.
+ *   host_subscriber <porta> <segundos> [modo]   (modo: rótulo do menu, padrão o automático)
+ * Imprime "pronto" depois de assinar e, no fim, as contagens do pré-filtro e das
+ * mensagens entregues pelo mqtt_comm aos handlers.
+ */
+#include "shims/host.h"
+#include "include/key_manager.h"
+#include "include/log.h"
+#include "include/mqtt_comm.h"
+#include "include/prefilter.h"
+#include "include/subscriber_modes.h"
+#include "config/credentials.h"
+#include "pico/stdlib.h"
+#include <stdlib.h>
+#include <string.h>
+
+#define HOST_CONNECT_TIMEOUT_MS 5000
+#define HOST_SUBSCRIBE_SETTLE_MS 300 // SUBACKs do broker local antes de liberar a carga
+#define HOST_LOOP_SLEEP_MS 10
+
+static uint32_t now_ms(void) {
+    return to_ms_since_boot(get_absolute_time());
+}
+
+int main(int argc, char **argv) {
+    if (argc < 3 || argc > 4) {
+        fprintf(stderr, "uso: %s <porta> <segundos> [modo]\n", argv[0]);
+        return 2;
+    }
+    const char *label = argc == 4 ? argv[3] : "Automatico (todos)";
+    const app_mode_t *mode = NULL;
+    for (size_t i = 0; i < subscriber_mode_count; i++) {
+        if (strcmp(subscriber_modes[i].label, label) == 0) {
+            mode = &subscriber_modes[i];
+        }
+    }
+    if (mode == NULL) {
+        fprintf(stderr, "modo desconhecido: %s\n", label);
+        return 2;
+    }
+
+    host_mqtt_set_port((uint16_t)atoi(argv[1]));
+    key_manager_init();
+    subscriber_boot();
+    mqtt_setup(MQTT_CLIENT_ID_SUBSCRIBER, "127.0.0.1", MQTT_USER, MQTT_PASS);
+    uint32_t start_ms = now_ms();
+    while (!mqtt_comm_is_connected() && now_ms() - start_ms < HOST_CONNECT_TIMEOUT_MS) {
+        sleep_ms(HOST_LOOP_SLEEP_MS);
+    }
+    if (!mqtt_comm_is_connected()) {
+        fprintf(stderr, "sem conexao com o broker na porta %s\n", argv[1]);
+        return 1;
+    }
+    subscriber_connected();
+    if (mode->init != NULL) {
+        mode->init();
+    }
+    mqtt_comm_set_message_handler(mode->decode);
+    sleep_ms(HOST_SUBSCRIBE_SETTLE_MS);
+    log_flush();
+    printf("pronto\n");
+    fflush(stdout);
+
+    uint32_t run_ms = (uint32_t)atoi(argv[2]) * 1000u;
+    start_ms = now_ms();
+    while (now_ms() - start_ms < run_ms) {
+        log_flush();
+        subscriber_poll(true);
+        if (!mqtt_comm_is_connected()) {
+            mqtt_comm_reconnect();
+        }
+        sleep_ms(HOST_LOOP_SLEEP_MS);
+    }
+
+    if (mode->teardown != NULL) {
+        mode->teardown();
+    }
+    mqtt_comm_set_message_handler(NULL);
+    log_flush();
+    prefilter_print_stats();
+    mqtt_rx_stats_t rx;
+    mqtt_comm_get_rx_stats(&rx);
+    printf("mqtt: %lu mensagens entregues, %lu grandes demais\n", (unsigned long)rx.messages,
+           (unsigned long)rx.oversized);
+    return 0;
+}
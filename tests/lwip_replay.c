@@ -0,0 +1,604 @@
+/*
+ * Replay do dimensionamento do lwIP no perfil de telemetria (include/lwipopts.h com
+ * LWIPOPTS_PROFILE_TELEMETRY=1). O tráfego é o real: os plugins de publicação rodam no
+ * relógio congelado e cada publicação que sai pelo mqtt_comm de teste vira um pacote
+ * PUBLISH com o tamanho exato. O lwIP não faz parte do build de host, então a pilha é
+ * uma contabilidade das regras de alocação do lwIP 2.1 que consomem esses recursos:
+ *   - anel de saída do cliente MQTT (MQTT_OUTPUT_RINGBUF_SIZE) e mqtt_output_send;
+ *   - tcp_write com TCP_WRITE_FLAG_COPY: pbufs PBUF_RAM no heap (MEM_SIZE), inclusive o
+ *     "oversize" de TCP_OVERSIZE, e um tcp_seg (MEMP_NUM_TCP_SEG) por segmento novo;
+ *   - Nagle, janela de congestionamento, ACK atrasado do broker, retransmissão rápida e
+ *     por RTO, com os segmentos presos no heap até o ACK;
+ *   - recepção (placa subscriber): um pbuf de PBUF_POOL por quadro, processado na hora,
+ *     mais os segmentos fora de ordem (pbuf e tcp_seg) guardados até a lacuna fechar.
+ * Cada cenário imprime os high-water marks e falha se algum passar do limite do perfil
+ * ou se alguma alocação falhar (é assim que os valores do perfil foram conferidos).
+ *   lwip_replay <cenário>   (plain, xor, hmac, aes, chacha, mixed, streams, mixed_perdas,
+ *                            streams_perdas, mixed_queda)
+ */
+#include "check.h"
+#include "fakes/fakes.h"
+#include "shims/host.h"
+#include "include/publisher_modes.h"
+#include "include/key_manager.h"
+#include "include/adc_scan.h"
+#include "lwipopts.h"
+#include "pico/stdlib.h"
+#include <stdlib.h>
+
+#ifndef TCP_OOSEQ_MAX_PBUFS
+#define TCP_OOSEQ_MAX_PBUFS 0 // Sem limite (padrão do lwIP)
+#endif
+#ifndef MQTT_OUTPUT_RINGBUF_SIZE
+#define MQTT_OUTPUT_RINGBUF_SIZE 256 // Padrão do lwIP (mqtt_opts.h)
+#endif
+
+#define REPLAY_RUN_MS 60000
+#define REPLAY_STEP_MS 5       // Passo do loop principal simulado
+#define MAX_PACKETS 4096
+#define MAX_SEGMENTS 64
+#define NEVER UINT32_MAX
+
+/* --- Constantes do lwIP 2.1 num Cortex-M0+ (MEM_ALIGNMENT 4, MEM_SIZE < 64 KB) --- */
+#define ALIGN4(x) (((x) + 3u) & ~3u)
+#define PBUF_STRUCT_SIZE 16      // SIZEOF_STRUCT_PBUF
+#define MEM_STRUCT_SIZE 8        // SIZEOF_STRUCT_MEM: next e prev de 16 bits e o byte used
+#define MEM_MIN_SIZE 12          // MIN_SIZE_ALIGNED do mem.c
+#define TRANSPORT_HLEN 56        // PBUF_TRANSPORT: TCP 20 + IP 20 + Ethernet 14, alinhado
+#define MQTT_CLIENT_SIZE (256 + MQTT_OUTPUT_RINGBUF_SIZE) // mqtt_client_new: campos, rx_buffer e o anel
+#define DHCP_STRUCT_SIZE 60      // dhcp_start: struct dhcp
+#define INITIAL_CWND 4380        // LWIP_TCP_CALC_INITIAL_CWND com MSS 1460
+#define LWIP_RTO_MS 1500         // RTO a que o tcp_slowtmr (500 ms) chega com RTT abaixo de um tick
+#define BROKER_MIN_RTO_MS 200    // TCP_RTO_MIN do Linux
+#define DUPACK_THRESHOLD 3
+#define MQTT_POLL_MS 1000        // altcp_poll do cliente MQTT: dois ticks do tcp_slowtmr
+
+typedef struct {
+    uint32_t t_ms;
+    uint16_t len; // Pacote PUBLISH inteiro: cabeçalho fixo, tópico, id e payload
+    uint8_t qos;
+} packet_t;
+
+typedef struct {
+    uint32_t rtt_ms;
+    uint32_t ack_delay_ms;  // ACK atrasado do broker para segmentos pequenos
+    uint32_t loss_per_mille;
+} network_t;
+
+typedef struct {
+    const char *name;
+    const char *mode;       // Rótulo do plugin em publisher_modes
+    uint32_t outage_ms;     // Broker fora do ar no início: o journal guarda e depois reenvia
+    network_t net;
+} scenario_t;
+
+#define NET_NOMINAL {20, 40, 0} // Wi-Fi limpo até um broker na mesma rede
+#define NET_LOSSY {60, 40, 30}   // 3% de perda em cada sentido
+
+static const scenario_t scenarios[] = {
+    {"plain", "Sem seguranca", 0, NET_NOMINAL},
+    {"xor", "Encriptacao XOR", 0, NET_NOMINAL},
+    {"hmac", "Autenticacao HMAC", 0, NET_NOMINAL},
+    {"aes", "AES-GCM", 0, NET_NOMINAL},
+    {"chacha", "ChaCha20-Poly1305", 0, NET_NOMINAL},
+    {"mixed", "Todos intercalados", 0, NET_NOMINAL},
+    {"streams", "Multi-stream", 0, NET_NOMINAL},
+    {"mixed_perdas", "Todos intercalados", 0, NET_LOSSY},
+    {"streams_perdas", "Multi-stream", 0, NET_LOSSY},
+    {"mixed_queda", "Todos intercalados", 20000, {60, 40, 10}}, // 20 s sem broker e o journal reenviando
+};
+
+/* --- Picos e falhas: o maior dos dois papéis (cada placa é publisher ou subscriber) --- */
+typedef struct {
+    uint32_t heap_peak;
+    uint32_t seg_peak;
+    uint32_t pool_peak;
+    uint32_t ring_peak;
+    uint32_t req_peak;
+    uint32_t heap_fail;   // tcp_write com ERR_MEM por falta de heap
+    uint32_t seg_fail;    // ... ou de tcp_seg / TCP_SND_QUEUELEN
+    uint32_t ring_full;   // mqtt_publish recusado (anel cheio): a mensagem fica no journal
+    uint32_t pool_fail;   // Quadro descartado pelo driver: PBUF_POOL vazio
+    uint32_t ooseq_drop;  // Fora de ordem além de TCP_OOSEQ_MAX_PBUFS: o broker retransmite
+} usage_t;
+
+static uint32_t rng_state;
+
+static bool lost(const network_t *net) {
+    rng_state ^= rng_state << 13;
+    rng_state ^= rng_state >> 17;
+    rng_state ^= rng_state << 5;
+    return rng_state % 1000 < net->loss_per_mille;
+}
+
+static uint32_t heap_cost(uint32_t size) {
+    size = ALIGN4(size);
+    return MEM_STRUCT_SIZE + (size < MEM_MIN_SIZE ? MEM_MIN_SIZE : size);
+}
+
+static void peak(uint32_t *max, uint32_t value) {
+    if (value > *max) {
+        *max = value;
+    }
+}
+
+/* --- Envio (placa publisher): anel do MQTT, tcp_write, Nagle e ACKs do broker --- */
+typedef struct {
+    uint32_t seq;
+    uint32_t len;
+    uint32_t heap;        // Soma dos pbufs do segmento, com o cabeçalho do heap
+    uint32_t pbufs;       // Conta em snd_queuelen
+    uint32_t arrive_ms;   // Chegada ao broker (NEVER: perdido ou ainda não enviado)
+    bool sent;
+    bool at_broker;
+} tx_segment_t;
+
+typedef struct {
+    const network_t *net;
+    usage_t *usage;
+    uint32_t heap_used;
+    uint32_t queuelen;
+    tx_segment_t segs[MAX_SEGMENTS];  // Não confirmados (os `sent`) seguidos dos não enviados
+    size_t seg_count;
+    uint32_t oversize;                // Sobra do último pbuf não enviado (pcb->unsent_oversize)
+    uint32_t snd_nxt;                 // Próximo byte a entrar num segmento
+    uint32_t cwnd;
+    uint32_t rto_start_ms;
+    uint32_t dupacks;
+    // Anel de saída do cliente MQTT
+    uint32_t ring_get;
+    uint32_t ring_len;
+    uint32_t reqs;                    // PUBLISH QoS 1 esperando o PUBACK
+    // Broker
+    uint32_t broker_rcv_nxt;
+    uint32_t broker_unacked;          // Bytes recebidos em ordem e ainda não confirmados
+    uint32_t ack_due_ms;
+    uint32_t ack_seq[MAX_SEGMENTS];   // ACKs a caminho da placa
+    uint32_t ack_arrive_ms[MAX_SEGMENTS];
+    size_t ack_count;
+} tx_state_t;
+
+static uint32_t tx_unsent_index(const tx_state_t *s) {
+    uint32_t i = 0;
+    while (i < s->seg_count && s->segs[i].sent) {
+        i++;
+    }
+    return i;
+}
+
+// tcp_pbuf_prealloc: com dados na fila (ou MORE) o pbuf já sai do tamanho de um MSS
+static uint32_t prealloc(const tx_state_t *s, uint32_t length, uint32_t max_length, bool more, bool first_seg) {
+    if (length < max_length && (more || !first_seg || s->seg_count > 0)) {
+        uint32_t oversized = ALIGN4(length + TCP_MSS);
+        return oversized < max_length ? oversized : max_length;
+    }
+    return length;
+}
+
+// tcp_write com cópia: tudo ou nada, como no lwIP
+static bool tx_write(tx_state_t *s, uint32_t len, bool more) {
+    uint32_t heap = 0;
+    uint32_t pbufs = 0;
+    uint32_t new_segs = 0;
+    uint32_t left = len;
+    bool has_unsent = tx_unsent_index(s) < s->seg_count;
+    tx_segment_t *last = has_unsent ? &s->segs[s->seg_count - 1] : NULL;
+
+    // Fase 1: a sobra do último pbuf; fase 2: um pbuf novo encadeado no último segmento
+    uint32_t use_oversize = has_unsent ? (left < s->oversize ? left : s->oversize) : 0;
+    left -= use_oversize;
+    uint32_t chain_len = 0;
+    uint32_t chain_alloc = 0;
+    if (left > 0 && has_unsent && last->len + use_oversize < TCP_MSS) {
+        uint32_t space = TCP_MSS - last->len - use_oversize;
+        chain_len = left < space ? left : space;
+        chain_alloc = prealloc(s, chain_len, space, more, true);
+        heap += heap_cost(PBUF_STRUCT_SIZE + chain_alloc);
+        pbufs++;
+        left -= chain_len;
+    }
+    // Fase 3: segmentos novos de até um MSS
+    uint32_t new_len[MAX_SEGMENTS];
+    uint32_t new_alloc[MAX_SEGMENTS];
+    for (bool first = true; left > 0 && new_segs < MAX_SEGMENTS; first = false) {
+        uint32_t seg_len = left < TCP_MSS ? left : TCP_MSS;
+        new_len[new_segs] = seg_len;
+        new_alloc[new_segs] = prealloc(s, seg_len, TCP_MSS, more, first);
+        heap += heap_cost(PBUF_STRUCT_SIZE + TRANSPORT_HLEN + new_alloc[new_segs]);
+        pbufs++;
+        new_segs++;
+        left -= seg_len;
+    }
+
+    if (s->queuelen + pbufs > TCP_SND_QUEUELEN || s->seg_count + new_segs > MEMP_NUM_TCP_SEG) {
+        s->usage->seg_fail++;
+        return false;
+    }
+    if (s->heap_used + heap > MEM_SIZE) {
+        s->usage->heap_fail++;
+        return false;
+    }
+
+    s->heap_used += heap;
+    s->queuelen += pbufs;
+    if (has_unsent) {
+        last->len += use_oversize + chain_len;
+        s->oversize -= use_oversize;
+        if (chain_len > 0) {
+            last->heap += heap_cost(PBUF_STRUCT_SIZE + chain_alloc);
+            last->pbufs++;
+            s->oversize = chain_alloc - chain_len;
+        }
+    }
+    uint32_t seq = s->snd_nxt + use_oversize + chain_len;
+    for (uint32_t i = 0; i < new_segs; i++) {
+        uint32_t cost = heap_cost(PBUF_STRUCT_SIZE + TRANSPORT_HLEN + new_alloc[i]);
+        s->segs[s->seg_count++] = (tx_segment_t){seq, new_len[i], cost, 1, NEVER, false, false};
+        s->oversize = new_alloc[i] - new_len[i];
+        seq += new_len[i];
+    }
+    s->snd_nxt += len;
+    peak(&s->usage->heap_peak, s->heap_used);
+    peak(&s->usage->seg_peak, (uint32_t)s->seg_count);
+    return true;
+}
+
+static void tx_send(tx_state_t *s, tx_segment_t *seg, uint32_t now_ms) {
+    seg->sent = true;
+    seg->arrive_ms = lost(s->net) ? NEVER : now_ms + s->net->rtt_ms / 2;
+}
+
+// tcp_output: Nagle segura um segmento pequeno enquanto houver dado sem confirmação
+static void tx_output(tx_state_t *s, uint32_t now_ms) {
+    uint32_t first_unsent = tx_unsent_index(s);
+    uint32_t in_flight = 0;
+    for (uint32_t i = 0; i < first_unsent; i++) {
+        in_flight += s->segs[i].len;
+    }
+    for (uint32_t i = first_unsent; i < s->seg_count; i++) {
+        tx_segment_t *seg = &s->segs[i];
+        bool nagle_ok = first_unsent == 0 || i + 1 < s->seg_count || seg->len >= TCP_MSS ||
+                        s->queuelen >= TCP_SND_QUEUELEN;
+        if (!nagle_ok || in_flight + seg->len > s->cwnd) {
+            break;
+        }
+        if (first_unsent == 0) {
+            s->rto_start_ms = now_ms;
+        }
+        tx_send(s, seg, now_ms);
+        in_flight += seg->len;
+        first_unsent = i + 1;
+        if (i + 1 == s->seg_count) {
+            s->oversize = 0; // O pbuf foi para a rede: a sobra não recebe mais dados
+        }
+    }
+}
+
+// mqtt_output_send: do anel para o TCP, no máximo o que cabe em tcp_sndbuf
+static void tx_mqtt_output(tx_state_t *s, uint32_t now_ms) {
+    uint32_t queued = s->snd_nxt - (s->seg_count > 0 ? s->segs[0].seq : s->snd_nxt);
+    uint32_t sndbuf = TCP_SND_BUF > queued ? TCP_SND_BUF - queued : 0;
+    if (sndbuf == 0 || s->ring_len == 0) {
+        return;
+    }
+    uint32_t linear = MQTT_OUTPUT_RINGBUF_SIZE - s->ring_get;
+    linear = linear < s->ring_len ? linear : s->ring_len;
+    uint32_t send_len = sndbuf < linear ? sndbuf : linear;
+    bool wrap = send_len == linear && s->ring_len > linear;
+    if (!tx_write(s, send_len, wrap)) {
+        return;
+    }
+    s->ring_get = (s->ring_get + send_len) % MQTT_OUTPUT_RINGBUF_SIZE;
+    s->ring_len -= send_len;
+    if (wrap) {
+        queued += send_len;
+        sndbuf = TCP_SND_BUF > queued ? TCP_SND_BUF - queued : 0;
+        send_len = sndbuf < s->ring_len ? sndbuf : s->ring_len;
+        if (send_len > 0 && tx_write(s, send_len, false)) {
+            s->ring_get = (s->ring_get + send_len) % MQTT_OUTPUT_RINGBUF_SIZE;
+            s->ring_len -= send_len;
+        }
+    }
+    tx_output(s, now_ms);
+}
+
+static bool tx_publish(tx_state_t *s, const packet_t *packet, uint32_t now_ms) {
+    if (s->ring_len + packet->len > MQTT_OUTPUT_RINGBUF_SIZE || (packet->qos > 0 && s->reqs >= MQTT_REQ_MAX_IN_FLIGHT)) {
+        s->usage->ring_full++;
+        return false;
+    }
+    s->ring_len += packet->len;
+    peak(&s->usage->ring_peak, s->ring_len);
+    if (packet->qos > 0) {
+        // O PUBACK volta junto com o ACK do segmento; até lá a requisição fica ocupada
+        s->reqs++;
+        peak(&s->usage->req_peak, s->reqs);
+    }
+    tx_mqtt_output(s, now_ms);
+    return true;
+}
+
+static void tx_free_acked(tx_state_t *s, uint32_t ack, uint32_t now_ms) {
+    size_t freed = 0;
+    while (freed < s->seg_count && s->segs[freed].sent && s->segs[freed].seq + s->segs[freed].len <= ack) {
+        s->heap_used -= s->segs[freed].heap;
+        s->queuelen -= s->segs[freed].pbufs;
+        freed++;
+    }
+    if (freed == 0) {
+        return;
+    }
+    memmove(s->segs, s->segs + freed, (s->seg_count - freed) * sizeof(s->segs[0]));
+    s->seg_count -= freed;
+    s->cwnd += TCP_MSS;
+    if (s->cwnd > TCP_SND_BUF) {
+        s->cwnd = TCP_SND_BUF;
+    }
+    s->dupacks = 0;
+    s->rto_start_ms = now_ms;
+    s->reqs = 0; // O broker responde o PUBACK junto com o ACK do segmento do PUBLISH
+}
+
+static void tx_step(tx_state_t *s, uint32_t now_ms) {
+    // Broker: segmentos que chegam; fora de ordem gera ACK duplicado imediato
+    for (size_t i = 0; i < s->seg_count; i++) {
+        tx_segment_t *seg = &s->segs[i];
+        if (seg->arrive_ms > now_ms || seg->at_broker) {
+            continue;
+        }
+        seg->at_broker = true;
+        bool immediate = seg->seq != s->broker_rcv_nxt;
+        while (true) {
+            size_t j = 0;
+            while (j < s->seg_count && !(s->segs[j].at_broker && s->segs[j].seq == s->broker_rcv_nxt)) {
+                j++;
+            }
+            if (j == s->seg_count) {
+                break;
+            }
+            s->broker_rcv_nxt += s->segs[j].len;
+            s->broker_unacked += s->segs[j].len;
+        }
+        if (immediate || s->broker_unacked >= 2 * TCP_MSS) {
+            s->ack_due_ms = now_ms;
+        } else if (s->ack_due_ms == NEVER) {
+            s->ack_due_ms = now_ms + s->net->ack_delay_ms;
+        }
+    }
+    if (s->ack_due_ms <= now_ms && s->ack_count < MAX_SEGMENTS) {
+        s->ack_seq[s->ack_count] = s->broker_rcv_nxt;
+        s->ack_arrive_ms[s->ack_count++] = now_ms + s->net->rtt_ms / 2;
+        s->broker_unacked = 0;
+        s->ack_due_ms = NEVER;
+    }
+
+    // Placa: ACKs que chegam (cada um ocupa um pbuf do pool só durante o tcp_input)
+    size_t kept = 0;
+    for (size_t i = 0; i < s->ack_count; i++) {
+        if (s->ack_arrive_ms[i] > now_ms) {
+            s->ack_seq[kept] = s->ack_seq[i];
+            s->ack_arrive_ms[kept++] = s->ack_arrive_ms[i];
+            continue;
+        }
+        peak(&s->usage->pool_peak, 1);
+        uint32_t before = (uint32_t)s->seg_count;
+        tx_free_acked(s, s->ack_seq[i], now_ms);
+        if (before == s->seg_count && s->seg_count > 0 && s->segs[0].sent && ++s->dupacks == DUPACK_THRESHOLD) {
+            tx_send(s, &s->segs[0], now_ms); // Retransmissão rápida
+        }
+    }
+    s->ack_count = kept;
+
+    // RTO: volta a janela para um MSS e reenvia o primeiro não confirmado
+    if (s->seg_count > 0 && s->segs[0].sent && now_ms - s->rto_start_ms >= LWIP_RTO_MS) {
+        s->cwnd = TCP_MSS;
+        s->rto_start_ms = now_ms;
+        tx_send(s, &s->segs[0], now_ms);
+    }
+    tx_mqtt_output(s, now_ms);
+    tx_output(s, now_ms);
+}
+
+/* --- Tráfego: o plugin roda REPLAY_RUN_MS e cada publicação entra no anel simulado --- */
+static tx_state_t tx;
+static packet_t packets[MAX_PACKETS]; // Aceitos pelo anel, para o replay da recepção
+static size_t packet_count;
+static uint32_t replay_now_ms;
+
+static uint16_t publish_size(const char *topic, size_t len, uint8_t qos) {
+    uint32_t remaining = 2 + (uint32_t)strlen(topic) + (qos > 0 ? 2 : 0) + (uint32_t)len;
+    return (uint16_t)(1 + (remaining < 128 ? 1 : 2) + remaining);
+}
+
+// mqtt_publish: anel cheio é ERR_MEM, e o journal guarda a mensagem para depois
+static int replay_output(const char *topic, size_t len, uint8_t qos) {
+    packet_t packet = {replay_now_ms, publish_size(topic, len, qos), qos};
+    if (!tx_publish(&tx, &packet, replay_now_ms)) {
+        return -1;
+    }
+    if (packet_count < MAX_PACKETS) {
+        packets[packet_count++] = packet;
+    }
+    return 0;
+}
+
+static const app_mode_t *start_publisher(const scenario_t *scenario) {
+    const app_mode_t *mode = NULL;
+    for (size_t i = 0; i < publisher_mode_count; i++) {
+        if (strcmp(publisher_modes[i].label, scenario->mode) == 0) {
+            mode = &publisher_modes[i];
+        }
+    }
+    if (mode == NULL) {
+        fprintf(stderr, "plugin \"%s\" nao encontrado\n", scenario->mode);
+        exit(2);
+    }
+    // Joystick Y, X e temperatura para as fontes do multi-stream
+    const uint16_t adc_round[3] = {3100, 2048, 876};
+    host_clock_freeze(1000000);
+    CHECK(key_manager_init());
+    publisher_boot();
+    adc_scan_init();
+    host_adc_push_round(adc_round, 3);
+    fake_mqtt_set_output(replay_output);
+    fake_mqtt_set_connected(scenario->outage_ms == 0);
+    if (mode->init != NULL) {
+        mode->init();
+    }
+    return mode;
+}
+
+static void replay_tx(const scenario_t *scenario, usage_t *usage) {
+    memset(&tx, 0, sizeof(tx));
+    tx.net = &scenario->net;
+    tx.usage = usage;
+    tx.cwnd = INITIAL_CWND;
+    tx.ack_due_ms = NEVER;
+    tx.heap_used = heap_cost(MQTT_CLIENT_SIZE) + heap_cost(DHCP_STRUCT_SIZE);
+    peak(&usage->heap_peak, tx.heap_used);
+
+    const app_mode_t *mode = start_publisher(scenario);
+    uint32_t next_encode_ms = 0;
+    uint32_t end_ms = REPLAY_RUN_MS + 10 * LWIP_RTO_MS;
+    for (replay_now_ms = 0; replay_now_ms < end_ms; replay_now_ms++) {
+        uint32_t now = replay_now_ms;
+        // Loop principal do publisher a cada REPLAY_STEP_MS, até o fim da gravação
+        if (now < REPLAY_RUN_MS && now % REPLAY_STEP_MS == 0) {
+            if (scenario->outage_ms > 0 && now == scenario->outage_ms) {
+                fake_mqtt_set_connected(true);
+            }
+            if (now >= next_encode_ms) {
+                int32_t wait_ms = mode->encode();
+                CHECK(wait_ms != APP_MODE_EXIT);
+                next_encode_ms = now + (wait_ms > 0 ? (uint32_t)wait_ms : 1);
+            }
+            publisher_poll(true);
+        }
+        tx_step(&tx, now);
+        if (now % MQTT_POLL_MS == 0) {
+            tx_mqtt_output(&tx, now);
+        }
+        host_clock_advance_ms(1);
+    }
+    if (mode->teardown != NULL) {
+        mode->teardown();
+    }
+    CHECK(packet_count > 0 && packet_count < MAX_PACKETS);
+    CHECK(tx.seg_count == 0 && tx.ring_len == 0); // Tudo confirmado no fim
+}
+
+/* --- Recepção (placa subscriber): o broker repassa cada PUBLISH num segmento --- */
+typedef struct {
+    uint32_t seq;
+    uint32_t len;
+    uint32_t arrive_ms;   // NEVER: perdido
+    uint32_t sent_ms;
+    uint32_t later;       // Segmentos posteriores que já chegaram (ACKs duplicados)
+    bool delivered;       // Chegou à placa (em ordem ou na fila fora de ordem)
+} rx_segment_t;
+
+static void replay_rx(const scenario_t *scenario, const packet_t *packets, size_t count, usage_t *usage) {
+    static rx_segment_t segs[MAX_PACKETS];
+    const network_t *net = &scenario->net;
+    uint32_t rcv_nxt = 0;
+    uint32_t sent = 0;       // Segmentos já enviados pelo broker
+    uint32_t acked = 0;      // Primeiro segmento ainda não entregue em ordem
+    uint32_t seq = 0;
+
+    for (size_t i = 0; i < count; i++) {
+        segs[i] = (rx_segment_t){seq, packets[i].len, NEVER, NEVER, 0, false};
+        seq += packets[i].len;
+    }
+    uint32_t end_ms = REPLAY_RUN_MS + 10 * LWIP_RTO_MS;
+    for (uint32_t now = 0; now < end_ms && acked < count; now++) {
+        // Broker: envia o que chegou do publisher, dentro da janela anunciada pela placa
+        while (sent < count && packets[sent].t_ms <= now && segs[sent].seq + segs[sent].len - rcv_nxt <= TCP_WND) {
+            segs[sent].sent_ms = now;
+            segs[sent].arrive_ms = lost(net) ? NEVER : now + net->rtt_ms / 2;
+            sent++;
+        }
+        // Broker: retransmite a lacuna com três ACKs duplicados ou pelo RTO
+        if (acked < sent && segs[acked].arrive_ms == NEVER) {
+            rx_segment_t *gap = &segs[acked];
+            bool fast = gap->later >= DUPACK_THRESHOLD;
+            if (fast || now - gap->sent_ms >= net->rtt_ms + BROKER_MIN_RTO_MS) {
+                // Na rápida, o terceiro ACK duplicado ainda tem que chegar ao broker
+                gap->sent_ms = now;
+                gap->later = 0;
+                gap->arrive_ms = lost(net) ? NEVER : now + (fast ? net->rtt_ms : net->rtt_ms / 2);
+            }
+        }
+        // Placa: cada quadro ocupa um pbuf do pool; fora de ordem ele fica preso com um tcp_seg
+        for (uint32_t i = acked; i < sent; i++) {
+            if (segs[i].delivered || segs[i].arrive_ms > now) {
+                continue;
+            }
+            uint32_t ooseq = 0;
+            for (uint32_t j = acked; j < sent; j++) {
+                ooseq += segs[j].delivered;
+            }
+            if (ooseq + 1 > PBUF_POOL_SIZE) {
+                usage->pool_fail++;
+                segs[i].arrive_ms = NEVER; // Descartado pelo driver: o broker retransmite
+                continue;
+            }
+            if (segs[i].seq != rcv_nxt && TCP_OOSEQ_MAX_PBUFS > 0 && ooseq >= TCP_OOSEQ_MAX_PBUFS) {
+                usage->ooseq_drop++;
+                segs[i].arrive_ms = NEVER;
+                continue;
+            }
+            peak(&usage->pool_peak, ooseq + 1);
+            segs[i].delivered = true;
+            if (segs[i].seq == rcv_nxt) {
+                while (acked < sent && segs[acked].delivered) {
+                    rcv_nxt += segs[acked++].len;
+                }
+            } else {
+                peak(&usage->seg_peak, ooseq + 1);
+                if (ooseq + 1 > MEMP_NUM_TCP_SEG) {
+                    usage->seg_fail++;
+                }
+                segs[acked].later++;
+            }
+        }
+    }
+    CHECK(acked == count);
+}
+
+static int run(const scenario_t *scenario) {
+    usage_t usage = {0};
+    rng_state = 4231;
+    replay_tx(scenario, &usage);
+    replay_rx(scenario, packets, packet_count, &usage);
+
+    uint32_t bytes = 0;
+    uint32_t largest = 0;
+    for (size_t i = 0; i < packet_count; i++) {
+        bytes += packets[i].len;
+        peak(&largest, packets[i].len);
+    }
+    printf("%s: %lu PUBLISH (%lu B, maior %lu B), RTT %lu ms, perda %lu/1000\n", scenario->name,
+           (unsigned long)packet_count, (unsigned long)bytes, (unsigned long)largest,
+           (unsigned long)scenario->net.rtt_ms, (unsigned long)scenario->net.loss_per_mille);
+    printf("  heap %lu/%d B, tcp_seg %lu/%d, pbuf do pool %lu/%d, anel MQTT %lu/%d B, QoS 1 em voo %lu/%d\n",
+           (unsigned long)usage.heap_peak, MEM_SIZE, (unsigned long)usage.seg_peak, MEMP_NUM_TCP_SEG,
+           (unsigned long)usage.pool_peak, PBUF_POOL_SIZE, (unsigned long)usage.ring_peak, MQTT_OUTPUT_RINGBUF_SIZE,
+           (unsigned long)usage.req_peak, MQTT_REQ_MAX_IN_FLIGHT);
+    printf("  falhas: heap %lu, tcp_seg %lu, pool %lu; anel cheio %lu (ficaram no journal), fora de ordem "
+           "descartados %lu\n",
+           (unsigned long)usage.heap_fail, (unsigned long)usage.seg_fail, (unsigned long)usage.pool_fail,
+           (unsigned long)usage.ring_full, (unsigned long)usage.ooseq_drop);
+    CHECK(usage.heap_fail == 0 && usage.seg_fail == 0 && usage.pool_fail == 0);
+    CHECK(usage.heap_peak <= MEM_SIZE && usage.seg_peak <= MEMP_NUM_TCP_SEG && usage.pool_peak <= PBUF_POOL_SIZE);
+    CHECK_EXIT();
+}
+
+int main(int argc, char **argv) {
+    for (size_t i = 0; argc == 2 && i < sizeof(scenarios) / sizeof(scenarios[0]); i++) {
+        if (strcmp(argv[1], scenarios[i].name) == 0) {
+            return run(&scenarios[i]);
+        }
+    }
+    fprintf(stderr, "uso: %s <cenario>\n", argv[0]);
+    return 2;
+}
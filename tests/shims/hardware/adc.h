@@ -0,0 +1,54 @@
+#ifndef HOST_HARDWARE_ADC_H
+#define HOST_HARDWARE_ADC_H
+
+#include "pico/stdlib.h"
+
+/*
+ * ADC em modo livre simulado: as amostras entram na FIFO por host_adc_push_round
+ * (tests/shims/host.h), que chama a IRQ da FIFO como o hardware faria ao atingir o
+ * limiar. A FIFO tem 4 posições, como no RP2040; acima disso o bit OVER é ligado.
+ */
+
+typedef struct {
+    volatile uint32_t cs;
+    volatile uint32_t result;
+    volatile uint32_t fcs;
+    volatile uint32_t fifo;
+    volatile uint32_t div;
+    volatile uint32_t intr;
+    volatile uint32_t inte;
+    volatile uint32_t intf;
+    volatile uint32_t ints;
+} adc_hw_t;
+
+extern adc_hw_t *const adc_hw;
+
+#define ADC_FCS_OVER_BITS 0x00000800u
+#define ADC_FCS_UNDER_BITS 0x00000400u
+#define ADC_FIFO_ERR_BITS 0x00008000u
+
+static inline void hw_set_bits(volatile uint32_t *addr, uint32_t mask) {
+    // FCS.OVER/UNDER são "write 1 to clear" no hardware
+    if (addr == &adc_hw->fcs) {
+        *addr &= ~(mask & (ADC_FCS_OVER_BITS | ADC_FCS_UNDER_BITS));
+        *addr |= mask & ~(ADC_FCS_OVER_BITS | ADC_FCS_UNDER_BITS);
+    } else {
+        *addr |= mask;
+    }
+}
+
+void adc_init(void);
+void adc_gpio_init(uint gpio);
+void adc_select_input(uint input);
+void adc_set_round_robin(uint input_mask);
+void adc_set_temp_sensor_enabled(bool enable);
+void adc_fifo_setup(bool en, bool dreq_en, uint16_t dreq_thresh, bool err_in_fifo, bool byte_shift);
+void adc_set_clkdiv(float clkdiv);
+void adc_irq_set_enabled(bool enabled);
+void adc_run(bool run);
+uint8_t adc_fifo_get_level(void);
+uint16_t adc_fifo_get(void);
+void adc_fifo_drain(void);
+uint16_t adc_read(void);
+
+#endif // HOST_HARDWARE_ADC_H
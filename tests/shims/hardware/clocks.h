@@ -0,0 +1,14 @@
+#ifndef HOST_HARDWARE_CLOCKS_H
+#define HOST_HARDWARE_CLOCKS_H
+
+#include <stdint.h>
+
+enum clock_index { clk_gpout0 = 0, clk_ref = 4, clk_sys = 5, clk_peri = 6, clk_usb = 7, clk_adc = 8, clk_rtc = 9 };
+
+/**
+ * Frequência do clock. clk_sys devolve 125 MHz, como na placa: os benchmarks convertem
+ * µs em ciclos com ela, então no host os "ciclos" são µs x 125, não ciclos da CPU.
+ */
+uint32_t clock_get_hz(enum clock_index clk_index);
+
+#endif // HOST_HARDWARE_CLOCKS_H
@@ -0,0 +1,24 @@
+#ifndef HOST_HARDWARE_FLASH_H
+#define HOST_HARDWARE_FLASH_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/*
+ * Flash emulada em RAM (host_platform.c), com a semântica da NOR: o apagamento deixa
+ * 0xFF e a programação só zera bits. XIP_BASE aponta para o início da cópia em RAM,
+ * então as leituras diretas (XIP_BASE + offset) funcionam como na placa.
+ */
+
+#define PICO_FLASH_SIZE_BYTES (2 * 1024 * 1024)
+#define FLASH_PAGE_SIZE (1u << 8)
+#define FLASH_SECTOR_SIZE (1u << 12)
+#define FLASH_UNIQUE_ID_SIZE_BYTES 8
+
+extern uint8_t host_flash_memory[PICO_FLASH_SIZE_BYTES];
+#define XIP_BASE ((uintptr_t)host_flash_memory)
+
+void flash_range_erase(uint32_t flash_offs, size_t count);
+void flash_range_program(uint32_t flash_offs, const uint8_t *data, size_t count);
+
+#endif // HOST_HARDWARE_FLASH_H
@@ -0,0 +1,46 @@
+#ifndef HOST_H
+#define HOST_H
+
+/*
+ * Controles da plataforma simulada (host_platform.c), usados só pelos testes e
+ * ferramentas de host. Os módulos do firmware não incluem este cabeçalho.
+ *
+ * Relógio: por padrão segue o CLOCK_MONOTONIC desde o início do processo (benchmarks).
+ * Congelado com host_clock_freeze, só anda por host_clock_advance_us ou sleep_ms, e os
+ * alarmes vencidos rodam na hora em que o relógio passa por eles, na ordem.
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/* Relógio */
+void host_clock_freeze(uint64_t now_us);
+void host_clock_advance_us(uint64_t us);
+static inline void host_clock_advance_ms(uint32_t ms) {
+    host_clock_advance_us((uint64_t)ms * 1000);
+}
+
+/* GPIO: nível de um pino de entrada; a borda dispara o callback se a IRQ do pino estiver ligada */
+void host_gpio_set(unsigned gpio, bool level);
+
+/* ADC: uma rodada do round-robin entra na FIFO (samples na ordem da varredura) e a IRQ roda */
+void host_adc_push_round(const uint16_t *samples, unsigned count);
+
+/* ID único da placa (o padrão é 01 02 03 04 05 06 07 08) */
+void host_set_board_id(const uint8_t id[8]);
+
+/* Flash: volta tudo para 0xFF */
+void host_flash_erase_all(void);
+
+/*
+ * Trabalho de background (o MQTT de host_mqtt.c): com o relógio real, sleep_us passa a
+ * espera dentro de `poll` (que bloqueia no máximo max_wait_us) e tight_loop_contents
+ * chama `poll` com 0, como o contexto de background do cyw43_arch no firmware.
+ */
+typedef void (*host_background_t)(uint64_t max_wait_us);
+void host_set_background(host_background_t poll);
+
+/* MQTT: porta do broker no lugar da MQTT_BROKER_PORT passada a mqtt_client_connect (0 = a passada) */
+void host_mqtt_set_port(uint16_t port);
+
+#endif // HOST_H
@@ -0,0 +1,193 @@
+#include "mbedtls/gcm.h"
+#include "mbedtls/chachapoly.h"
+#include "mbedtls/sha256.h"
+#include "mbedtls/error.h"
+#include <openssl/evp.h>
+#include <stdio.h>
+#include <string.h>
+
+// Uma operação AEAD completa no EVP; devolve 0, `auth_failed` se a tag não confere ou `bad_input`
+static int aead_crypt(const EVP_CIPHER *cipher, int encrypt, const unsigned char *key, const unsigned char *iv,
+                      size_t iv_len, const unsigned char *aad, size_t aad_len, const unsigned char *input,
+                      size_t length, unsigned char *output, unsigned char *tag, size_t tag_len, int auth_failed,
+                      int bad_input) {
+    EVP_CIPHER_CTX *ctx = EVP_CIPHER_CTX_new();
+    int out_len = 0;
+    int ret = bad_input;
+    if (ctx == NULL) {
+        return bad_input;
+    }
+    if (EVP_CipherInit_ex(ctx, cipher, NULL, NULL, NULL, encrypt) != 1 ||
+        EVP_CIPHER_CTX_ctrl(ctx, EVP_CTRL_AEAD_SET_IVLEN, (int)iv_len, NULL) != 1 ||
+        EVP_CipherInit_ex(ctx, NULL, NULL, key, iv, encrypt) != 1) {
+        goto done;
+    }
+    if (aad_len > 0 && EVP_CipherUpdate(ctx, NULL, &out_len, aad, (int)aad_len) != 1) {
+        goto done;
+    }
+    if (length > 0 && EVP_CipherUpdate(ctx, output, &out_len, input, (int)length) != 1) {
+        goto done;
+    }
+    if (encrypt) {
+        if (EVP_CipherFinal_ex(ctx, output + length, &out_len) == 1 &&
+            EVP_CIPHER_CTX_ctrl(ctx, EVP_CTRL_AEAD_GET_TAG, (int)tag_len, tag) == 1) {
+            ret = 0;
+        }
+    } else {
+        if (EVP_CIPHER_CTX_ctrl(ctx, EVP_CTRL_AEAD_SET_TAG, (int)tag_len, tag) != 1) {
+            goto done;
+        }
+        if (EVP_CipherFinal_ex(ctx, output + length, &out_len) == 1) {
+            ret = 0;
+        } else {
+            memset(output, 0, length); // Como o mbedTLS: nada do texto aberto sobra com a tag errada
+            ret = auth_failed;
+        }
+    }
+done:
+    EVP_CIPHER_CTX_free(ctx);
+    return ret;
+}
+
+/* --- AES-GCM --- */
+void mbedtls_gcm_init(mbedtls_gcm_context *ctx) {
+    memset(ctx, 0, sizeof(*ctx));
+}
+
+void mbedtls_gcm_free(mbedtls_gcm_context *ctx) {
+    if (ctx != NULL) {
+        memset(ctx, 0, sizeof(*ctx));
+    }
+}
+
+int mbedtls_gcm_setkey(mbedtls_gcm_context *ctx, mbedtls_cipher_id_t cipher, const unsigned char *key,
+                       unsigned int keybits) {
+    if (cipher != MBEDTLS_CIPHER_ID_AES || (keybits != 128 && keybits != 192 && keybits != 256)) {
+        return MBEDTLS_ERR_GCM_BAD_INPUT;
+    }
+    memcpy(ctx->key, key, keybits / 8);
+    ctx->keybits = keybits;
+    return 0;
+}
+
+static const EVP_CIPHER *gcm_cipher(const mbedtls_gcm_context *ctx) {
+    switch (ctx->keybits) {
+    case 128:
+        return EVP_aes_128_gcm();
+    case 192:
+        return EVP_aes_192_gcm();
+    case 256:
+        return EVP_aes_256_gcm();
+    default:
+        return NULL;
+    }
+}
+
+int mbedtls_gcm_crypt_and_tag(mbedtls_gcm_context *ctx, int mode, size_t length, const unsigned char *iv,
+                              size_t iv_len, const unsigned char *add, size_t add_len, const unsigned char *input,
+                              unsigned char *output, size_t tag_len, unsigned char *tag) {
+    const EVP_CIPHER *cipher = gcm_cipher(ctx);
+    if (cipher == NULL || iv_len == 0 || tag_len < 4 || tag_len > 16) {
+        return MBEDTLS_ERR_GCM_BAD_INPUT;
+    }
+    if (mode != MBEDTLS_GCM_ENCRYPT) {
+        // Decifrar sem conferir a tag: o firmware não usa
+        return MBEDTLS_ERR_GCM_BAD_INPUT;
+    }
+    return aead_crypt(cipher, 1, ctx->key, iv, iv_len, add, add_len, input, length, output, tag, tag_len,
+                      MBEDTLS_ERR_GCM_AUTH_FAILED, MBEDTLS_ERR_GCM_BAD_INPUT);
+}
+
+int mbedtls_gcm_auth_decrypt(mbedtls_gcm_context *ctx, size_t length, const unsigned char *iv, size_t iv_len,
+                             const unsigned char *add, size_t add_len, const unsigned char *tag, size_t tag_len,
+                             const unsigned char *input, unsigned char *output) {
+    const EVP_CIPHER *cipher = gcm_cipher(ctx);
+    if (cipher == NULL || iv_len == 0 || tag_len < 4 || tag_len > 16) {
+        return MBEDTLS_ERR_GCM_BAD_INPUT;
+    }
+    unsigned char tag_copy[16];
+    memcpy(tag_copy, tag, tag_len);
+    return aead_crypt(cipher, 0, ctx->key, iv, iv_len, add, add_len, input, length, output, tag_copy, tag_len,
+                      MBEDTLS_ERR_GCM_AUTH_FAILED, MBEDTLS_ERR_GCM_BAD_INPUT);
+}
+
+/* --- ChaCha20-Poly1305 --- */
+void mbedtls_chachapoly_init(mbedtls_chachapoly_context *ctx) {
+    memset(ctx, 0, sizeof(*ctx));
+}
+
+void mbedtls_chachapoly_free(mbedtls_chachapoly_context *ctx) {
+    if (ctx != NULL) {
+        memset(ctx, 0, sizeof(*ctx));
+    }
+}
+
+int mbedtls_chachapoly_setkey(mbedtls_chachapoly_context *ctx, const unsigned char key[32]) {
+    memcpy(ctx->key, key, sizeof(ctx->key));
+    ctx->has_key = 1;
+    return 0;
+}
+
+int mbedtls_chachapoly_encrypt_and_tag(mbedtls_chachapoly_context *ctx, size_t length, const unsigned char nonce[12],
+                                       const unsigned char *aad, size_t aad_len, const unsigned char *input,
+                                       unsigned char *output, unsigned char tag[16]) {
+    if (!ctx->has_key) {
+        return MBEDTLS_ERR_CHACHAPOLY_BAD_STATE;
+    }
+    return aead_crypt(EVP_chacha20_poly1305(), 1, ctx->key, nonce, 12, aad, aad_len, input, length, output, tag, 16,
+                      MBEDTLS_ERR_CHACHAPOLY_AUTH_FAILED, MBEDTLS_ERR_CHACHAPOLY_BAD_STATE);
+}
+
+int mbedtls_chachapoly_auth_decrypt(mbedtls_chachapoly_context *ctx, size_t length, const unsigned char nonce[12],
+                                    const unsigned char *aad, size_t aad_len, const unsigned char tag[16],
+                                    const unsigned char *input, unsigned char *output) {
+    if (!ctx->has_key) {
+        return MBEDTLS_ERR_CHACHAPOLY_BAD_STATE;
+    }
+    unsigned char tag_copy[16];
+    memcpy(tag_copy, tag, sizeof(tag_copy));
+    return aead_crypt(EVP_chacha20_poly1305(), 0, ctx->key, nonce, 12, aad, aad_len, input, length, output, tag_copy,
+                      16, MBEDTLS_ERR_CHACHAPOLY_AUTH_FAILED, MBEDTLS_ERR_CHACHAPOLY_BAD_STATE);
+}
+
+/* --- SHA-256 --- */
+void mbedtls_sha256_init(mbedtls_sha256_context *ctx) {
+    ctx->md = NULL;
+}
+
+void mbedtls_sha256_free(mbedtls_sha256_context *ctx) {
+    if (ctx != NULL && ctx->md != NULL) {
+        EVP_MD_CTX_free(ctx->md);
+        ctx->md = NULL;
+    }
+}
+
+int mbedtls_sha256_starts(mbedtls_sha256_context *ctx, int is224) {
+    if (ctx->md == NULL && (ctx->md = EVP_MD_CTX_new()) == NULL) {
+        return -1;
+    }
+    return EVP_DigestInit_ex(ctx->md, is224 ? EVP_sha224() : EVP_sha256(), NULL) == 1 ? 0 : -1;
+}
+
+int mbedtls_sha256_update(mbedtls_sha256_context *ctx, const unsigned char *input, size_t ilen) {
+    return EVP_DigestUpdate(ctx->md, input, ilen) == 1 ? 0 : -1;
+}
+
+int mbedtls_sha256_finish(mbedtls_sha256_context *ctx, unsigned char *output) {
+    return EVP_DigestFinal_ex(ctx->md, output, NULL) == 1 ? 0 : -1;
+}
+
+/* --- Erros --- */
+void mbedtls_strerror(int errnum, char *buffer, size_t buflen) {
+    const char *text = "erro desconhecido";
+    if (errnum == MBEDTLS_ERR_GCM_AUTH_FAILED) {
+        text = "GCM - Authenticated decryption failed";
+    } else if (errnum == MBEDTLS_ERR_GCM_BAD_INPUT) {
+        text = "GCM - Bad input parameters to function";
+    } else if (errnum == MBEDTLS_ERR_CHACHAPOLY_AUTH_FAILED) {
+        text = "CHACHAPOLY - Authenticated decryption failed";
+    } else if (errnum == MBEDTLS_ERR_CHACHAPOLY_BAD_STATE) {
+        text = "CHACHAPOLY - The requested operation is not permitted in the current state";
+    }
+    snprintf(buffer, buflen, "%s (-0x%04X)", text, (unsigned int)-errnum);
+}
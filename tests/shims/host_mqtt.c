@@ -0,0 +1,580 @@
+/*
+ * Cliente MQTT 3.1.1 do build de host por trás da API do lwIP (lwip/apps/mqtt.h), para
+ * rodar src/mqtt_comm.c contra o tools/mini_broker.py por um socket TCP não bloqueante.
+ * Segue o mqtt.c do lwIP 2.1 no que o mqtt_comm depende:
+ *  - mqtt_client_connect monta o CONNECT no anel de saída e volta na hora; o resultado
+ *    chega depois no callback de conexão (DISCONNECTED se o TCP falhar ou cair);
+ *  - publish, subscribe e unsubscribe recusam com ERR_MEM quando o pacote não cabe nos
+ *    MQTT_OUTPUT_RINGBUF_SIZE bytes do anel ou faltam vagas de requisição
+ *    (MQTT_REQ_MAX_IN_FLIGHT, que o QoS 0 também ocupa até o pacote sair);
+ *  - um PUBLISH recebido chega como pub_cb com o tamanho total e data_cb em pedaços de
+ *    até MQTT_VAR_HEADER_BUFFER_LEN bytes, o último com MQTT_DATA_FLAG_LAST;
+ *  - mqtt_disconnect fecha sem chamar o callback de conexão.
+ * Os callbacks rodam em host_mqtt_poll, que a plataforma chama nas esperas do firmware
+ * (host_set_background). Entregas com QoS 2 não são suportadas: o mini_broker entrega
+ * tudo com QoS 0.
+ */
+#define _GNU_SOURCE // ppoll
+#include "host.h"
+#include "lwip/apps/mqtt.h"
+#include "pico/stdlib.h"
+#include <arpa/inet.h>
+#include <errno.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <time.h>
+#include <unistd.h>
+
+#define HOST_MQTT_MAX_CLIENTS 2
+#define HOST_MQTT_RX_LEN 1024 // Pacotes de controle inteiros e o cabeçalho variável do PUBLISH
+
+enum {
+    MQTT_CONNECT = 1,
+    MQTT_CONNACK = 2,
+    MQTT_PUBLISH = 3,
+    MQTT_PUBACK = 4,
+    MQTT_SUBSCRIBE = 8,
+    MQTT_SUBACK = 9,
+    MQTT_UNSUBSCRIBE = 10,
+    MQTT_UNSUBACK = 11,
+    MQTT_PINGREQ = 12,
+    MQTT_PINGRESP = 13,
+};
+
+typedef enum {
+    STATE_DISCONNECTED,
+    STATE_TCP_CONNECTING, // connect() em andamento; o CONNECT espera no anel
+    STATE_CONNECTING,     // CONNECT enviado, esperando o CONNACK
+    STATE_CONNECTED,
+} client_state_t;
+
+typedef struct {
+    bool used;
+    u16_t pkt_id; // 0: PUBLISH QoS 0, liberado quando o anel esvazia
+    mqtt_request_cb_t cb;
+    void *arg;
+} request_t;
+
+struct mqtt_client_s {
+    int fd;
+    client_state_t state;
+    bool connect_failed; // connect() recusado na hora: avisado no próximo poll
+    mqtt_connection_cb_t connect_cb;
+    void *connect_arg;
+    mqtt_incoming_publish_cb_t pub_cb;
+    mqtt_incoming_data_cb_t data_cb;
+    void *inpub_arg;
+    u16_t keep_alive_s;
+    uint64_t last_tx_us;
+    u16_t next_pkt_id;
+    request_t requests[MQTT_REQ_MAX_IN_FLIGHT];
+
+    uint8_t out[MQTT_OUTPUT_RINGBUF_SIZE];
+    size_t out_len;
+
+    uint8_t in[HOST_MQTT_RX_LEN];
+    size_t in_len;
+    uint32_t payload_left; // Bytes do payload do PUBLISH atual ainda por entregar
+    uint8_t pub_qos;
+    u16_t pub_id;
+};
+
+static mqtt_client_t *clients[HOST_MQTT_MAX_CLIENTS];
+static uint16_t port_override = 0;
+
+static void host_mqtt_poll(uint64_t max_wait_us);
+
+void host_mqtt_set_port(uint16_t port) {
+    port_override = port;
+}
+
+int ip4addr_aton(const char *cp, ip_addr_t *addr) {
+    struct in_addr in;
+    if (inet_aton(cp, &in) == 0) {
+        return 0;
+    }
+    addr->addr = in.s_addr;
+    return 1;
+}
+
+mqtt_client_t *mqtt_client_new(void) {
+    for (size_t i = 0; i < HOST_MQTT_MAX_CLIENTS; i++) {
+        if (clients[i] == NULL) {
+            clients[i] = calloc(1, sizeof(mqtt_client_t));
+            if (clients[i] != NULL) {
+                clients[i]->fd = -1;
+                host_set_background(host_mqtt_poll);
+            }
+            return clients[i];
+        }
+    }
+    return NULL;
+}
+
+/* --- Requisições em voo --- */
+
+static request_t *request_new(mqtt_client_t *c, u16_t pkt_id, mqtt_request_cb_t cb, void *arg) {
+    for (size_t i = 0; i < MQTT_REQ_MAX_IN_FLIGHT; i++) {
+        if (!c->requests[i].used) {
+            c->requests[i] = (request_t){true, pkt_id, cb, arg};
+            return &c->requests[i];
+        }
+    }
+    return NULL;
+}
+
+// Libera a requisição antes do callback, que pode abrir outra
+static void request_finish(request_t *r, err_t err) {
+    mqtt_request_cb_t cb = r->cb;
+    void *arg = r->arg;
+    r->used = false;
+    if (cb != NULL) {
+        cb(arg, err);
+    }
+}
+
+static void request_ack(mqtt_client_t *c, u16_t pkt_id, err_t err) {
+    for (size_t i = 0; i < MQTT_REQ_MAX_IN_FLIGHT; i++) {
+        if (c->requests[i].used && c->requests[i].pkt_id == pkt_id && pkt_id != 0) {
+            request_finish(&c->requests[i], err);
+            return;
+        }
+    }
+}
+
+// Anel vazio: os PUBLISH QoS 0 saíram
+static void requests_sent(mqtt_client_t *c) {
+    for (size_t i = 0; i < MQTT_REQ_MAX_IN_FLIGHT && c->out_len == 0; i++) {
+        if (c->requests[i].used && c->requests[i].pkt_id == 0) {
+            request_finish(&c->requests[i], ERR_OK);
+        }
+    }
+}
+
+static u16_t packet_id_next(mqtt_client_t *c) {
+    c->next_pkt_id = c->next_pkt_id == 0xFFFF ? 1 : c->next_pkt_id + 1;
+    return c->next_pkt_id;
+}
+
+/* --- Anel de saída --- */
+
+static size_t length_field_len(uint32_t remaining) {
+    return remaining < 128 ? 1 : remaining < 16384 ? 2 : remaining < 2097152 ? 3 : 4;
+}
+
+static bool out_fits(const mqtt_client_t *c, uint32_t remaining) {
+    return c->out_len + 1 + length_field_len(remaining) + remaining <= MQTT_OUTPUT_RINGBUF_SIZE;
+}
+
+static void out_put(mqtt_client_t *c, const void *data, size_t len) {
+    memcpy(c->out + c->out_len, data, len);
+    c->out_len += len;
+}
+
+static void out_byte(mqtt_client_t *c, uint8_t value) {
+    c->out[c->out_len++] = value;
+}
+
+static void out_u16(mqtt_client_t *c, u16_t value) {
+    out_byte(c, (uint8_t)(value >> 8));
+    out_byte(c, (uint8_t)value);
+}
+
+static void out_string(mqtt_client_t *c, const char *text, size_t len) {
+    out_u16(c, (u16_t)len);
+    out_put(c, text, len);
+}
+
+static void out_header(mqtt_client_t *c, uint8_t type, uint8_t flags, uint32_t remaining) {
+    out_byte(c, (uint8_t)(type << 4 | flags));
+    do {
+        uint8_t digit = remaining % 128;
+        remaining /= 128;
+        out_byte(c, remaining > 0 ? digit | 0x80 : digit);
+    } while (remaining > 0);
+}
+
+static void client_close(mqtt_client_t *c, mqtt_connection_status_t reason) {
+    if (c->fd >= 0) {
+        close(c->fd);
+        c->fd = -1;
+    }
+    c->connect_failed = false;
+    c->out_len = 0;
+    c->in_len = 0;
+    c->payload_left = 0;
+    memset(c->requests, 0, sizeof(c->requests)); // Como mqtt_clear_requests: sem callback
+    if (c->state != STATE_DISCONNECTED) {
+        c->state = STATE_DISCONNECTED;
+        if (c->connect_cb != NULL) {
+            c->connect_cb(c, c->connect_arg, reason);
+        }
+    }
+}
+
+static void out_flush(mqtt_client_t *c) {
+    if (c->fd < 0 || c->state == STATE_TCP_CONNECTING) {
+        return;
+    }
+    while (c->out_len > 0) {
+        ssize_t sent = send(c->fd, c->out, c->out_len, MSG_NOSIGNAL);
+        if (sent < 0) {
+            if (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR) {
+                client_close(c, MQTT_CONNECT_DISCONNECTED);
+            }
+            return;
+        }
+        memmove(c->out, c->out + sent, c->out_len - (size_t)sent);
+        c->out_len -= (size_t)sent;
+        c->last_tx_us = time_us_64();
+    }
+}
+
+/* --- API --- */
+
+err_t mqtt_client_connect(mqtt_client_t *c, const ip_addr_t *ipaddr, u16_t port, mqtt_connection_cb_t cb, void *arg,
+                          const struct mqtt_connect_client_info_t *info) {
+    if (c->state != STATE_DISCONNECTED) {
+        return ERR_ISCONN;
+    }
+    size_t id_len = strlen(info->client_id);
+    bool will = info->will_topic != NULL;
+    size_t will_topic_len = will ? strlen(info->will_topic) : 0;
+    size_t will_msg_len = will && info->will_msg != NULL ? strlen(info->will_msg) : 0;
+    size_t user_len = info->client_user != NULL ? strlen(info->client_user) : 0;
+    size_t pass_len = info->client_pass != NULL ? strlen(info->client_pass) : 0;
+    uint32_t remaining = 10 + 2 + id_len + (will ? 4 + will_topic_len + will_msg_len : 0) +
+                         (info->client_user != NULL ? 2 + user_len : 0) + (info->client_pass != NULL ? 2 + pass_len : 0);
+    c->out_len = 0;
+    if (!out_fits(c, remaining)) {
+        return ERR_MEM;
+    }
+
+    int fd = socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (fd < 0) {
+        return ERR_MEM;
+    }
+    struct sockaddr_in addr = {0};
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(port_override != 0 ? port_override : port);
+    addr.sin_addr.s_addr = ipaddr->addr;
+    c->connect_failed = connect(fd, (struct sockaddr *)&addr, sizeof(addr)) != 0 && errno != EINPROGRESS;
+    c->fd = fd;
+    c->state = STATE_TCP_CONNECTING;
+    c->connect_cb = cb;
+    c->connect_arg = arg;
+    c->keep_alive_s = info->keep_alive;
+    c->in_len = 0;
+    c->payload_left = 0;
+
+    uint8_t flags = 0x02; // Sessão limpa, como o lwIP
+    if (will) {
+        flags |= 0x04 | (uint8_t)(info->will_qos << 3) | (info->will_retain ? 0x20 : 0);
+    }
+    flags |= info->client_user != NULL ? 0x80 : 0;
+    flags |= info->client_pass != NULL ? 0x40 : 0;
+    out_header(c, MQTT_CONNECT, 0, remaining);
+    out_string(c, "MQTT", 4);
+    out_byte(c, 4); // 3.1.1
+    out_byte(c, flags);
+    out_u16(c, info->keep_alive);
+    out_string(c, info->client_id, id_len);
+    if (will) {
+        out_string(c, info->will_topic, will_topic_len);
+        out_string(c, info->will_msg != NULL ? info->will_msg : "", will_msg_len);
+    }
+    if (info->client_user != NULL) {
+        out_string(c, info->client_user, user_len);
+    }
+    if (info->client_pass != NULL) {
+        out_string(c, info->client_pass, pass_len);
+    }
+    return ERR_OK;
+}
+
+void mqtt_disconnect(mqtt_client_t *c) {
+    if (c->state != STATE_DISCONNECTED) {
+        c->state = STATE_DISCONNECTED; // Antes do close: sem callback
+        client_close(c, MQTT_CONNECT_DISCONNECTED);
+    }
+}
+
+u8_t mqtt_client_is_connected(mqtt_client_t *c) {
+    return c->state == STATE_CONNECTED;
+}
+
+void mqtt_set_inpub_callback(mqtt_client_t *c, mqtt_incoming_publish_cb_t pub_cb, mqtt_incoming_data_cb_t data_cb,
+                             void *arg) {
+    c->pub_cb = pub_cb;
+    c->data_cb = data_cb;
+    c->inpub_arg = arg;
+}
+
+err_t mqtt_sub_unsub(mqtt_client_t *c, const char *topic, u8_t qos, mqtt_request_cb_t cb, void *arg, u8_t sub) {
+    if (c->state == STATE_DISCONNECTED) {
+        return ERR_CONN;
+    }
+    size_t topic_len = strlen(topic);
+    uint32_t remaining = 2 + 2 + topic_len + (sub ? 1 : 0);
+    u16_t pkt_id = packet_id_next(c);
+    request_t *r = request_new(c, pkt_id, cb, arg);
+    if (r == NULL) {
+        return ERR_MEM;
+    }
+    if (!out_fits(c, remaining)) {
+        r->used = false;
+        return ERR_MEM;
+    }
+    out_header(c, sub ? MQTT_SUBSCRIBE : MQTT_UNSUBSCRIBE, 0x02, remaining);
+    out_u16(c, pkt_id);
+    out_string(c, topic, topic_len);
+    if (sub) {
+        out_byte(c, qos);
+    }
+    out_flush(c);
+    return ERR_OK;
+}
+
+err_t mqtt_publish(mqtt_client_t *c, const char *topic, const void *payload, u16_t payload_length, u8_t qos,
+                   u8_t retain, mqtt_request_cb_t cb, void *arg) {
+    if (c->state == STATE_DISCONNECTED) {
+        return ERR_CONN;
+    }
+    if (qos > 1) {
+        return ERR_VAL;
+    }
+    size_t topic_len = strlen(topic);
+    uint32_t remaining = 2 + topic_len + (qos > 0 ? 2 : 0) + payload_length;
+    u16_t pkt_id = qos > 0 ? packet_id_next(c) : 0;
+    request_t *r = request_new(c, pkt_id, cb, arg);
+    if (r == NULL) {
+        return ERR_MEM;
+    }
+    if (!out_fits(c, remaining)) {
+        r->used = false;
+        return ERR_MEM;
+    }
+    out_header(c, MQTT_PUBLISH, (uint8_t)(qos << 1 | (retain ? 1 : 0)), remaining);
+    out_string(c, topic, topic_len);
+    if (qos > 0) {
+        out_u16(c, pkt_id);
+    }
+    out_put(c, payload, payload_length);
+    out_flush(c);
+    return ERR_OK;
+}
+
+/* --- Recepção --- */
+
+static u16_t read_u16(const uint8_t *p) {
+    return (u16_t)(p[0] << 8 | p[1]);
+}
+
+// Tamanho restante do cabeçalho fixo: 1 lido, 0 incompleto, -1 malformado
+static int read_remaining(const uint8_t *p, size_t avail, uint32_t *remaining, size_t *header_len) {
+    uint32_t value = 0;
+    for (size_t i = 1; i <= 4; i++) {
+        if (i >= avail) {
+            return 0;
+        }
+        value |= (uint32_t)(p[i] & 0x7F) << (7 * (i - 1));
+        if (!(p[i] & 0x80)) {
+            *remaining = value;
+            *header_len = i + 1;
+            return 1;
+        }
+    }
+    return -1;
+}
+
+static void publish_done(mqtt_client_t *c) {
+    if (c->pub_qos == 1 && out_fits(c, 2)) {
+        out_header(c, MQTT_PUBACK, 0, 2);
+        out_u16(c, c->pub_id);
+    }
+}
+
+static void handle_packet(mqtt_client_t *c, uint8_t type, const uint8_t *body, uint32_t len) {
+    switch (type) {
+    case MQTT_CONNACK:
+        if (c->state != STATE_CONNECTING || len < 2) {
+            return;
+        }
+        if (body[1] != 0) {
+            client_close(c, (mqtt_connection_status_t)body[1]);
+            return;
+        }
+        c->state = STATE_CONNECTED;
+        if (c->connect_cb != NULL) {
+            c->connect_cb(c, c->connect_arg, MQTT_CONNECT_ACCEPTED);
+        }
+        return;
+    case MQTT_SUBACK:
+        if (len >= 3) {
+            request_ack(c, read_u16(body), body[2] == 0x80 ? ERR_ABRT : ERR_OK);
+        }
+        return;
+    case MQTT_PUBACK:
+    case MQTT_UNSUBACK:
+        if (len >= 2) {
+            request_ack(c, read_u16(body), ERR_OK);
+        }
+        return;
+    default:
+        return; // PINGRESP e o que o cliente do lwIP também ignora
+    }
+}
+
+static void rx_parse(mqtt_client_t *c) {
+    size_t pos = 0;
+    while (pos < c->in_len && c->fd >= 0) {
+        if (c->payload_left > 0) {
+            size_t chunk = c->in_len - pos;
+            chunk = chunk < c->payload_left ? chunk : c->payload_left;
+            chunk = chunk < MQTT_VAR_HEADER_BUFFER_LEN ? chunk : MQTT_VAR_HEADER_BUFFER_LEN;
+            c->payload_left -= (uint32_t)chunk;
+            if (c->data_cb != NULL) {
+                c->data_cb(c->inpub_arg, c->in + pos, (u16_t)chunk, c->payload_left == 0 ? MQTT_DATA_FLAG_LAST : 0);
+            }
+            pos += chunk;
+            if (c->payload_left == 0) {
+                publish_done(c);
+            }
+            continue;
+        }
+
+        uint32_t remaining = 0;
+        size_t header_len = 0;
+        int status = read_remaining(c->in + pos, c->in_len - pos, &remaining, &header_len);
+        if (status < 0) {
+            client_close(c, MQTT_CONNECT_DISCONNECTED);
+            return;
+        }
+        if (status == 0) {
+            break;
+        }
+        uint8_t type = c->in[pos] >> 4;
+        size_t avail = c->in_len - pos - header_len;
+        const uint8_t *body = c->in + pos + header_len;
+
+        if (type == MQTT_PUBLISH) {
+            if (avail < 2) {
+                break;
+            }
+            uint8_t qos = (c->in[pos] >> 1) & 0x03;
+            size_t topic_len = read_u16(body);
+            size_t var_len = 2 + topic_len + (qos > 0 ? 2 : 0);
+            // Como no lwIP: o tópico precisa caber no buffer do cabeçalho variável
+            if (qos > 1 || var_len > remaining || topic_len + 1 > MQTT_VAR_HEADER_BUFFER_LEN) {
+                client_close(c, MQTT_CONNECT_DISCONNECTED);
+                return;
+            }
+            if (avail < var_len) {
+                break;
+            }
+            char topic[MQTT_VAR_HEADER_BUFFER_LEN];
+            memcpy(topic, body + 2, topic_len);
+            topic[topic_len] = '\0';
+            c->pub_qos = qos;
+            c->pub_id = qos > 0 ? read_u16(body + 2 + topic_len) : 0;
+            c->payload_left = remaining - (uint32_t)var_len;
+            pos += header_len + var_len;
+            if (c->pub_cb != NULL) {
+                c->pub_cb(c->inpub_arg, topic, c->payload_left);
+            }
+            if (c->payload_left == 0) {
+                if (c->data_cb != NULL) {
+                    c->data_cb(c->inpub_arg, NULL, 0, MQTT_DATA_FLAG_LAST);
+                }
+                publish_done(c);
+            }
+            continue;
+        }
+
+        if (header_len + remaining > sizeof(c->in)) {
+            client_close(c, MQTT_CONNECT_DISCONNECTED);
+            return;
+        }
+        if (avail < remaining) {
+            break;
+        }
+        pos += header_len + remaining;
+        handle_packet(c, type, body, remaining);
+    }
+    if (c->fd < 0) {
+        return; // Fechado num callback: client_close já zerou o buffer
+    }
+    memmove(c->in, c->in + pos, c->in_len - pos);
+    c->in_len -= pos;
+}
+
+static void client_service(mqtt_client_t *c, short revents) {
+    if (c->state == STATE_TCP_CONNECTING) {
+        if (!(revents & (POLLOUT | POLLERR | POLLHUP))) {
+            return;
+        }
+        int error = 0;
+        socklen_t error_len = sizeof(error);
+        if (getsockopt(c->fd, SOL_SOCKET, SO_ERROR, &error, &error_len) != 0 || error != 0) {
+            client_close(c, MQTT_CONNECT_DISCONNECTED);
+            return;
+        }
+        c->state = STATE_CONNECTING;
+        out_flush(c);
+        return;
+    }
+    if (revents & (POLLIN | POLLHUP | POLLERR)) {
+        ssize_t received = recv(c->fd, c->in + c->in_len, sizeof(c->in) - c->in_len, 0);
+        if (received == 0 || (received < 0 && errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR)) {
+            client_close(c, MQTT_CONNECT_DISCONNECTED);
+            return;
+        }
+        if (received > 0) {
+            c->in_len += (size_t)received;
+            rx_parse(c);
+        }
+    }
+    out_flush(c);
+}
+
+// PINGREQ depois de keep_alive segundos sem enviar nada, e os QoS 0 que já saíram
+static void client_tick(mqtt_client_t *c) {
+    if (c->state == STATE_CONNECTED && c->keep_alive_s > 0 &&
+        time_us_64() - c->last_tx_us >= (uint64_t)c->keep_alive_s * 1000000u && out_fits(c, 0)) {
+        out_header(c, MQTT_PINGREQ, 0, 0);
+        out_flush(c);
+    }
+    if (c->out_len == 0) {
+        requests_sent(c);
+    }
+}
+
+static void host_mqtt_poll(uint64_t max_wait_us) {
+    struct pollfd fds[HOST_MQTT_MAX_CLIENTS];
+    mqtt_client_t *owners[HOST_MQTT_MAX_CLIENTS];
+    nfds_t count = 0;
+    for (size_t i = 0; i < HOST_MQTT_MAX_CLIENTS; i++) {
+        mqtt_client_t *c = clients[i];
+        if (c != NULL && c->connect_failed) {
+            client_close(c, MQTT_CONNECT_DISCONNECTED);
+        }
+        if (c == NULL || c->fd < 0) {
+            continue;
+        }
+        bool want_out = c->state == STATE_TCP_CONNECTING || c->out_len > 0;
+        fds[count] = (struct pollfd){c->fd, (short)(POLLIN | (want_out ? POLLOUT : 0)), 0};
+        owners[count++] = c;
+    }
+
+    struct timespec timeout = {(time_t)(max_wait_us / 1000000u), (long)(max_wait_us % 1000000u) * 1000};
+    int ready = ppoll(fds, count, &timeout, NULL);
+    for (nfds_t i = 0; i < count; i++) {
+        if (ready > 0 && fds[i].revents != 0 && owners[i]->fd == fds[i].fd) {
+            client_service(owners[i], fds[i].revents);
+        }
+        client_tick(owners[i]);
+    }
+}
@@ -0,0 +1,436 @@
+#include "host.h"
+#include "pico/stdlib.h"
+#include "pico/unique_id.h"
+#include "hardware/adc.h"
+#include "hardware/clocks.h"
+#include "hardware/flash.h"
+#include "hardware/i2c.h"
+#include "hardware/irq.h"
+#include <stdarg.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define HOST_ALARMS 16
+#define HOST_GPIOS 30
+#define HOST_ADC_FIFO_DEPTH 4
+
+/* --- Relógio --- */
+static bool clock_frozen = false;
+static uint64_t frozen_us = 0;
+
+static uint64_t monotonic_us(void) {
+    static uint64_t origin_us = 0;
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    uint64_t now_us = (uint64_t)ts.tv_sec * 1000000u + (uint64_t)ts.tv_nsec / 1000u;
+    if (origin_us == 0) {
+        origin_us = now_us;
+    }
+    return now_us - origin_us;
+}
+
+uint64_t time_us_64(void) {
+    return clock_frozen ? frozen_us : monotonic_us();
+}
+
+uint32_t time_us_32(void) {
+    return (uint32_t)time_us_64();
+}
+
+absolute_time_t get_absolute_time(void) {
+    return time_us_64();
+}
+
+/* --- Alarmes --- */
+typedef struct {
+    alarm_id_t id; // 0 = livre
+    uint64_t due_us;
+    alarm_callback_t callback;
+    void *user_data;
+} host_alarm_t;
+
+static host_alarm_t alarms[HOST_ALARMS];
+static alarm_id_t next_alarm_id = 1;
+
+// Roda, em ordem de vencimento, os alarmes até `now_us`
+static void run_alarms(uint64_t now_us) {
+    for (;;) {
+        host_alarm_t *due = NULL;
+        for (size_t i = 0; i < HOST_ALARMS; i++) {
+            if (alarms[i].id != 0 && alarms[i].due_us <= now_us && (due == NULL || alarms[i].due_us < due->due_us)) {
+                due = &alarms[i];
+            }
+        }
+        if (due == NULL) {
+            return;
+        }
+        host_alarm_t fired = *due;
+        due->id = 0;
+        if (clock_frozen) {
+            frozen_us = fired.due_us; // O callback vê o instante do vencimento
+        }
+        int64_t again = fired.callback(fired.id, fired.user_data);
+        if (again != 0) {
+            uint64_t base = again > 0 ? fired.due_us : time_us_64();
+            uint64_t delay = (uint64_t)(again > 0 ? again : -again);
+            for (size_t i = 0; i < HOST_ALARMS; i++) {
+                if (alarms[i].id == 0) {
+                    alarms[i] = (host_alarm_t){fired.id, base + delay, fired.callback, fired.user_data};
+                    break;
+                }
+            }
+        }
+    }
+}
+
+alarm_id_t add_alarm_in_us(uint64_t us, alarm_callback_t callback, void *user_data, bool fire_if_past) {
+    (void)fire_if_past;
+    for (size_t i = 0; i < HOST_ALARMS; i++) {
+        if (alarms[i].id == 0) {
+            alarm_id_t id = next_alarm_id++;
+            if (next_alarm_id <= 0) {
+                next_alarm_id = 1;
+            }
+            alarms[i] = (host_alarm_t){id, time_us_64() + us, callback, user_data};
+            return id;
+        }
+    }
+    return -1; // Como o SDK sem alarme livre
+}
+
+alarm_id_t add_alarm_in_ms(uint32_t ms, alarm_callback_t callback, void *user_data, bool fire_if_past) {
+    return add_alarm_in_us((uint64_t)ms * 1000, callback, user_data, fire_if_past);
+}
+
+bool cancel_alarm(alarm_id_t id) {
+    for (size_t i = 0; i < HOST_ALARMS; i++) {
+        if (alarms[i].id == id && id != 0) {
+            alarms[i].id = 0;
+            return true;
+        }
+    }
+    return false;
+}
+
+void host_clock_freeze(uint64_t now_us) {
+    clock_frozen = true;
+    frozen_us = now_us;
+}
+
+void host_clock_advance_us(uint64_t us) {
+    uint64_t target_us = time_us_64() + us;
+    run_alarms(target_us);
+    if (clock_frozen) {
+        frozen_us = target_us;
+    }
+}
+
+/* --- Background (host_set_background) --- */
+static host_background_t background = NULL;
+static bool in_background = false; // Um callback do MQTT que espera não reentra no poll
+
+void host_set_background(host_background_t poll) {
+    background = poll;
+}
+
+static bool run_background(uint64_t max_wait_us) {
+    if (background == NULL || in_background) {
+        return false;
+    }
+    in_background = true;
+    background(max_wait_us);
+    in_background = false;
+    return true;
+}
+
+void host_background_poll(void) {
+    if (!clock_frozen) {
+        run_background(0);
+    }
+}
+
+void sleep_us(uint64_t us) {
+    if (clock_frozen) {
+        host_clock_advance_us(us);
+        return;
+    }
+    uint64_t now_us = time_us_64();
+    uint64_t deadline_us = now_us + us;
+    do {
+        uint64_t left_us = deadline_us - now_us;
+        if (!run_background(left_us)) {
+            struct timespec ts = {(time_t)(left_us / 1000000u), (long)(left_us % 1000000u) * 1000};
+            nanosleep(&ts, NULL);
+        }
+        now_us = time_us_64();
+        run_alarms(now_us);
+    } while (now_us < deadline_us);
+}
+
+void sleep_ms(uint32_t ms) {
+    sleep_us((uint64_t)ms * 1000);
+}
+
+/* --- GPIO --- */
+typedef struct {
+    bool level;      // Entradas com pull-up começam em 1
+    uint32_t enabled; // Eventos com IRQ ligada
+    uint32_t latched; // Bordas registradas e não reconhecidas
+} host_gpio_t;
+
+static host_gpio_t gpios[HOST_GPIOS];
+static gpio_irq_callback_t gpio_callback = NULL;
+
+static void gpio_dispatch(uint gpio) {
+    uint32_t events = gpios[gpio].latched & gpios[gpio].enabled;
+    if (events != 0 && gpio_callback != NULL) {
+        gpios[gpio].latched &= ~events; // O handler padrão do SDK reconhece antes do callback
+        gpio_callback(gpio, events);
+    }
+}
+
+void gpio_init(uint gpio) {
+    if (gpio < HOST_GPIOS) {
+        gpios[gpio] = (host_gpio_t){true, 0, 0};
+    }
+}
+
+void gpio_set_dir(uint gpio, bool out) {
+    (void)gpio;
+    (void)out;
+}
+
+void gpio_pull_up(uint gpio) {
+    if (gpio < HOST_GPIOS) {
+        gpios[gpio].level = true;
+    }
+}
+
+bool gpio_get(uint gpio) {
+    return gpio < HOST_GPIOS && gpios[gpio].level;
+}
+
+void gpio_set_function(uint gpio, enum gpio_function fn) {
+    (void)gpio;
+    (void)fn;
+}
+
+void gpio_acknowledge_irq(uint gpio, uint32_t event_mask) {
+    if (gpio < HOST_GPIOS) {
+        gpios[gpio].latched &= ~event_mask;
+    }
+}
+
+void gpio_set_irq_enabled(uint gpio, uint32_t event_mask, bool enabled) {
+    if (gpio >= HOST_GPIOS) {
+        return;
+    }
+    gpio_acknowledge_irq(gpio, event_mask); // Como no SDK: descarta as bordas antigas
+    if (enabled) {
+        gpios[gpio].enabled |= event_mask;
+    } else {
+        gpios[gpio].enabled &= ~event_mask;
+    }
+}
+
+void gpio_set_irq_enabled_with_callback(uint gpio, uint32_t event_mask, bool enabled, gpio_irq_callback_t callback) {
+    gpio_callback = callback;
+    gpio_set_irq_enabled(gpio, event_mask, enabled);
+}
+
+void host_gpio_set(unsigned gpio, bool level) {
+    if (gpio >= HOST_GPIOS || gpios[gpio].level == level) {
+        return;
+    }
+    gpios[gpio].level = level;
+    gpios[gpio].latched |= level ? GPIO_IRQ_EDGE_RISE : GPIO_IRQ_EDGE_FALL;
+    gpio_dispatch(gpio);
+}
+
+/* --- ADC --- */
+static adc_hw_t adc_registers;
+adc_hw_t *const adc_hw = &adc_registers;
+static uint16_t adc_fifo[HOST_ADC_FIFO_DEPTH];
+static uint8_t adc_fifo_level = 0;
+static bool adc_irq_enabled = false;
+static irq_handler_t adc_irq_handler = NULL;
+static bool adc_irq_line_enabled = false;
+
+void adc_init(void) {
+    memset(&adc_registers, 0, sizeof(adc_registers));
+    adc_fifo_level = 0;
+}
+
+void adc_gpio_init(uint gpio) {
+    (void)gpio;
+}
+
+void adc_select_input(uint input) {
+    (void)input;
+}
+
+void adc_set_round_robin(uint input_mask) {
+    (void)input_mask;
+}
+
+void adc_set_temp_sensor_enabled(bool enable) {
+    (void)enable;
+}
+
+void adc_fifo_setup(bool en, bool dreq_en, uint16_t dreq_thresh, bool err_in_fifo, bool byte_shift) {
+    (void)en;
+    (void)dreq_en;
+    (void)dreq_thresh;
+    (void)err_in_fifo;
+    (void)byte_shift;
+}
+
+void adc_set_clkdiv(float clkdiv) {
+    (void)clkdiv;
+}
+
+void adc_irq_set_enabled(bool enabled) {
+    adc_irq_enabled = enabled;
+}
+
+void adc_run(bool run) {
+    (void)run;
+}
+
+uint8_t adc_fifo_get_level(void) {
+    return adc_fifo_level;
+}
+
+uint16_t adc_fifo_get(void) {
+    if (adc_fifo_level == 0) {
+        adc_registers.fcs |= ADC_FCS_UNDER_BITS;
+        return 0;
+    }
+    uint16_t sample = adc_fifo[0];
+    memmove(adc_fifo, adc_fifo + 1, (size_t)(--adc_fifo_level) * sizeof(adc_fifo[0]));
+    return sample;
+}
+
+void adc_fifo_drain(void) {
+    adc_fifo_level = 0;
+}
+
+uint16_t adc_read(void) {
+    return adc_fifo_level > 0 ? adc_fifo_get() : 0;
+}
+
+void irq_set_exclusive_handler(uint num, irq_handler_t handler) {
+    if (num == ADC_IRQ_FIFO) {
+        adc_irq_handler = handler;
+    }
+}
+
+void irq_set_enabled(uint num, bool enabled) {
+    if (num == ADC_IRQ_FIFO) {
+        adc_irq_line_enabled = enabled;
+    }
+}
+
+void host_adc_push_round(const uint16_t *samples, unsigned count) {
+    for (unsigned i = 0; i < count; i++) {
+        if (adc_fifo_level == HOST_ADC_FIFO_DEPTH) {
+            adc_registers.fcs |= ADC_FCS_OVER_BITS; // A amostra se perde, como no hardware
+            continue;
+        }
+        adc_fifo[adc_fifo_level++] = samples[i];
+    }
+    if (adc_irq_enabled && adc_irq_line_enabled && adc_irq_handler != NULL) {
+        adc_irq_handler();
+    }
+}
+
+/* --- Clocks --- */
+uint32_t clock_get_hz(enum clock_index clk_index) {
+    return clk_index == clk_adc || clk_index == clk_usb ? 48000000u : 125000000u;
+}
+
+/* --- Flash --- */
+uint8_t host_flash_memory[PICO_FLASH_SIZE_BYTES];
+
+void host_flash_erase_all(void) {
+    memset(host_flash_memory, 0xFF, sizeof(host_flash_memory));
+}
+
+void flash_range_erase(uint32_t flash_offs, size_t count) {
+    if (flash_offs % FLASH_SECTOR_SIZE != 0 || count % FLASH_SECTOR_SIZE != 0 ||
+        flash_offs + count > PICO_FLASH_SIZE_BYTES) {
+        panic("flash_range_erase: %lu + %lu fora do alinhamento ou da flash", (unsigned long)flash_offs,
+              (unsigned long)count);
+    }
+    memset(host_flash_memory + flash_offs, 0xFF, count);
+}
+
+void flash_range_program(uint32_t flash_offs, const uint8_t *data, size_t count) {
+    if (flash_offs % FLASH_PAGE_SIZE != 0 || count % FLASH_PAGE_SIZE != 0 ||
+        flash_offs + count > PICO_FLASH_SIZE_BYTES) {
+        panic("flash_range_program: %lu + %lu fora do alinhamento ou da flash", (unsigned long)flash_offs,
+              (unsigned long)count);
+    }
+    for (size_t i = 0; i < count; i++) {
+        host_flash_memory[flash_offs + i] &= data[i]; // A programação só zera bits
+    }
+}
+
+// Flash apagada e origem do relógio antes do main()
+__attribute__((constructor)) static void host_platform_init(void) {
+    host_flash_erase_all();
+    monotonic_us();
+}
+
+/* --- ID da placa --- */
+static uint8_t board_id[PICO_UNIQUE_BOARD_ID_SIZE_BYTES] = {1, 2, 3, 4, 5, 6, 7, 8};
+
+void host_set_board_id(const uint8_t id[8]) {
+    memcpy(board_id, id, sizeof(board_id));
+}
+
+void pico_get_unique_board_id(pico_unique_board_id_t *id_out) {
+    memcpy(id_out->id, board_id, sizeof(board_id));
+}
+
+/* --- I2C (sem dispositivos) --- */
+struct i2c_inst {
+    int unused;
+};
+static struct i2c_inst i2c1_instance;
+i2c_inst_t *const i2c1 = &i2c1_instance;
+
+uint i2c_init(i2c_inst_t *i2c, uint baudrate) {
+    (void)i2c;
+    return baudrate;
+}
+
+int i2c_write_blocking(i2c_inst_t *i2c, uint8_t addr, const uint8_t *src, size_t len, bool nostop) {
+    (void)i2c;
+    (void)addr;
+    (void)src;
+    (void)nostop;
+    return (int)len;
+}
+
+/* --- stdio --- */
+bool stdio_init_all(void) {
+    setvbuf(stdout, NULL, _IOLBF, 0);
+    return true;
+}
+
+int getchar_timeout_us(uint32_t timeout_us) {
+    (void)timeout_us;
+    return PICO_ERROR_TIMEOUT; // Sem console interativo no host
+}
+
+void panic(const char *fmt, ...) {
+    va_list args;
+    va_start(args, fmt);
+    fputs("*** PANIC ***\n", stderr);
+    vfprintf(stderr, fmt, args);
+    fputs("\n", stderr);
+    va_end(args);
+    abort();
+}
@@ -0,0 +1,119 @@
+#ifndef HOST_LWIP_APPS_MQTT_H
+#define HOST_LWIP_APPS_MQTT_H
+
+/*
+ * Subconjunto da API do cliente MQTT do lwIP 2.1 (lwip/apps/mqtt.h, com os tipos de
+ * lwip/err.h e lwip/ip_addr.h) usado por src/mqtt_comm.c, para o build de host. A
+ * implementação em tests/shims/host_mqtt.c fala MQTT 3.1.1 por um socket TCP não
+ * bloqueante e chama os callbacks nas esperas do firmware (sleep_ms, tight_loop_contents),
+ * como o contexto de background do cyw43_arch. Os limites são os do lwipopts.h.
+ */
+
+#include "lwipopts.h"
+#include <stdint.h>
+
+typedef uint8_t u8_t;
+typedef uint16_t u16_t;
+typedef uint32_t u32_t;
+typedef int8_t err_t;
+
+// Códigos de lwip/err.h usados pelo cliente MQTT
+#define ERR_OK 0
+#define ERR_MEM -1
+#define ERR_TIMEOUT -3
+#define ERR_VAL -6
+#define ERR_ISCONN -10
+#define ERR_CONN -11
+#define ERR_ABRT -13
+#define ERR_RST -14
+
+// Padrões de lwip/apps/mqtt_opts.h
+#ifndef MQTT_OUTPUT_RINGBUF_SIZE
+#define MQTT_OUTPUT_RINGBUF_SIZE 256
+#endif
+#ifndef MQTT_VAR_HEADER_BUFFER_LEN
+#define MQTT_VAR_HEADER_BUFFER_LEN 128
+#endif
+#ifndef MQTT_REQ_MAX_IN_FLIGHT
+#define MQTT_REQ_MAX_IN_FLIGHT 4
+#endif
+
+typedef struct {
+    u32_t addr; // Ordem de rede
+} ip_addr_t;
+
+/**
+ * Converte "a.b.c.d".
+ * @return 1 em sucesso, 0 se o texto não for um IPv4
+ */
+int ip4addr_aton(const char *cp, ip_addr_t *addr);
+
+typedef struct mqtt_client_s mqtt_client_t;
+
+struct mqtt_connect_client_info_t {
+    const char *client_id;
+    const char *client_user;
+    const char *client_pass;
+    u16_t keep_alive; // Segundos; 0 desliga o PINGREQ
+    const char *will_topic;
+    const char *will_msg;
+    u8_t will_qos;
+    u8_t will_retain;
+};
+
+typedef enum {
+    MQTT_CONNECT_ACCEPTED = 0,
+    MQTT_CONNECT_REFUSED_PROTOCOL_VERSION = 1,
+    MQTT_CONNECT_REFUSED_IDENTIFIER = 2,
+    MQTT_CONNECT_REFUSED_SERVER = 3,
+    MQTT_CONNECT_REFUSED_USERNAME_PASS = 4,
+    MQTT_CONNECT_REFUSED_NOT_AUTHORIZED_ = 5,
+    MQTT_CONNECT_DISCONNECTED = 256,
+    MQTT_CONNECT_TIMEOUT = 257,
+} mqtt_connection_status_t;
+
+enum {
+    MQTT_DATA_FLAG_LAST = 1,
+};
+
+typedef void (*mqtt_connection_cb_t)(mqtt_client_t *client, void *arg, mqtt_connection_status_t status);
+typedef void (*mqtt_incoming_publish_cb_t)(void *arg, const char *topic, u32_t tot_len);
+typedef void (*mqtt_incoming_data_cb_t)(void *arg, const u8_t *data, u16_t len, u8_t flags);
+typedef void (*mqtt_request_cb_t)(void *arg, err_t err);
+
+mqtt_client_t *mqtt_client_new(void);
+
+/**
+ * Abre o TCP e envia o CONNECT; o resultado chega em `cb`, depois, nas esperas.
+ * @return ERR_OK, ERR_ISCONN se já há uma conexão ou tentativa, ou ERR_MEM
+ */
+err_t mqtt_client_connect(mqtt_client_t *client, const ip_addr_t *ipaddr, u16_t port, mqtt_connection_cb_t cb,
+                          void *arg, const struct mqtt_connect_client_info_t *client_info);
+
+/**
+ * Fecha a conexão sem chamar o callback de conexão (como no lwIP).
+ */
+void mqtt_disconnect(mqtt_client_t *client);
+
+u8_t mqtt_client_is_connected(mqtt_client_t *client);
+
+void mqtt_set_inpub_callback(mqtt_client_t *client, mqtt_incoming_publish_cb_t pub_cb,
+                             mqtt_incoming_data_cb_t data_cb, void *arg);
+
+/**
+ * SUBSCRIBE (sub = 1) ou UNSUBSCRIBE; `cb` roda com o SUBACK/UNSUBACK.
+ * @return ERR_OK, ERR_CONN sem conexão, ou ERR_MEM sem espaço no anel ou sem vaga de requisição
+ */
+err_t mqtt_sub_unsub(mqtt_client_t *client, const char *topic, u8_t qos, mqtt_request_cb_t cb, void *arg, u8_t sub);
+
+#define mqtt_subscribe(client, topic, qos, cb, arg) mqtt_sub_unsub(client, topic, qos, cb, arg, 1)
+#define mqtt_unsubscribe(client, topic, cb, arg) mqtt_sub_unsub(client, topic, 0, cb, arg, 0)
+
+/**
+ * PUBLISH; `cb` roda quando o pacote sai pelo socket (QoS 0) ou com o PUBACK (QoS 1).
+ * @return ERR_OK, ERR_CONN sem conexão, ou ERR_MEM sem espaço no anel ou sem vaga de requisição
+ */
+err_t mqtt_publish(mqtt_client_t *client, const char *topic, const void *payload, u16_t payload_length, u8_t qos,
+                   u8_t retain, mqtt_request_cb_t cb, void *arg);
+
+#endif // HOST_LWIP_APPS_MQTT_H
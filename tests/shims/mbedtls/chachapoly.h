@@ -0,0 +1,26 @@
+#ifndef HOST_MBEDTLS_CHACHAPOLY_H
+#define HOST_MBEDTLS_CHACHAPOLY_H
+
+// ChaCha20-Poly1305 do mbedTLS 3.x sobre o OpenSSL (ver mbedtls/gcm.h)
+
+#include <stddef.h>
+
+#define MBEDTLS_ERR_CHACHAPOLY_BAD_STATE -0x0054
+#define MBEDTLS_ERR_CHACHAPOLY_AUTH_FAILED -0x0056
+
+typedef struct {
+    unsigned char key[32];
+    int has_key;
+} mbedtls_chachapoly_context;
+
+void mbedtls_chachapoly_init(mbedtls_chachapoly_context *ctx);
+void mbedtls_chachapoly_free(mbedtls_chachapoly_context *ctx);
+int mbedtls_chachapoly_setkey(mbedtls_chachapoly_context *ctx, const unsigned char key[32]);
+int mbedtls_chachapoly_encrypt_and_tag(mbedtls_chachapoly_context *ctx, size_t length, const unsigned char nonce[12],
+                                       const unsigned char *aad, size_t aad_len, const unsigned char *input,
+                                       unsigned char *output, unsigned char tag[16]);
+int mbedtls_chachapoly_auth_decrypt(mbedtls_chachapoly_context *ctx, size_t length, const unsigned char nonce[12],
+                                    const unsigned char *aad, size_t aad_len, const unsigned char tag[16],
+                                    const unsigned char *input, unsigned char *output);
+
+#endif // HOST_MBEDTLS_CHACHAPOLY_H
@@ -0,0 +1,8 @@
+#ifndef HOST_MBEDTLS_ERROR_H
+#define HOST_MBEDTLS_ERROR_H
+
+#include <stddef.h>
+
+void mbedtls_strerror(int errnum, char *buffer, size_t buflen);
+
+#endif // HOST_MBEDTLS_ERROR_H
@@ -0,0 +1,15 @@
+#ifndef HOST_PICO_CYW43_ARCH_H
+#define HOST_PICO_CYW43_ARCH_H
+
+/*
+ * Só a trava do lwIP usada por src/mqtt_comm.c. No host os callbacks do MQTT rodam na
+ * mesma thread, dentro das esperas (tests/shims/host_mqtt.c), então não há o que travar.
+ */
+
+static inline void cyw43_arch_lwip_begin(void) {
+}
+
+static inline void cyw43_arch_lwip_end(void) {
+}
+
+#endif // HOST_PICO_CYW43_ARCH_H
@@ -0,0 +1,95 @@
+#ifndef HOST_PICO_STDLIB_H
+#define HOST_PICO_STDLIB_H
+
+/*
+ * Subconjunto do pico/stdlib.h usado pelos módulos portáveis, para o build de host
+ * (tests/). O relógio, os alarmes e os GPIOs são simulados em host_platform.c e
+ * controlados pelos testes por tests/shims/host.h.
+ */
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+
+#ifndef PICO_ON_DEVICE
+#define PICO_ON_DEVICE 0
+#endif
+
+typedef unsigned int uint;
+typedef uint64_t absolute_time_t;
+
+#define PICO_OK 0
+#define PICO_ERROR_TIMEOUT (-1)
+#define PICO_ERROR_GENERIC (-2)
+
+#define __not_in_flash_func(func) func
+#define __time_critical_func(func) func
+#define __dmb() __atomic_thread_fence(__ATOMIC_SEQ_CST)
+#define count_of(a) (sizeof(a) / sizeof((a)[0]))
+
+/* Tempo */
+absolute_time_t get_absolute_time(void);
+uint64_t time_us_64(void);
+uint32_t time_us_32(void);
+void sleep_ms(uint32_t ms);
+void sleep_us(uint64_t us);
+
+static inline uint64_t to_us_since_boot(absolute_time_t t) {
+    return t;
+}
+
+static inline uint32_t to_ms_since_boot(absolute_time_t t) {
+    return (uint32_t)(t / 1000);
+}
+
+// Atende a rede do host (host_set_background) nas esperas ativas do firmware
+void host_background_poll(void);
+
+static inline void tight_loop_contents(void) {
+    host_background_poll();
+}
+
+/* Alarmes (executados por host_clock_advance_us ou dentro de sleep_ms) */
+typedef int32_t alarm_id_t;
+typedef int64_t (*alarm_callback_t)(alarm_id_t id, void *user_data);
+alarm_id_t add_alarm_in_us(uint64_t us, alarm_callback_t callback, void *user_data, bool fire_if_past);
+alarm_id_t add_alarm_in_ms(uint32_t ms, alarm_callback_t callback, void *user_data, bool fire_if_past);
+bool cancel_alarm(alarm_id_t id);
+
+/* GPIO */
+#define GPIO_IN false
+#define GPIO_OUT true
+#define GPIO_IRQ_LEVEL_LOW 0x1u
+#define GPIO_IRQ_LEVEL_HIGH 0x2u
+#define GPIO_IRQ_EDGE_FALL 0x4u
+#define GPIO_IRQ_EDGE_RISE 0x8u
+
+enum gpio_function { GPIO_FUNC_I2C = 3, GPIO_FUNC_SIO = 5 };
+typedef void (*gpio_irq_callback_t)(uint gpio, uint32_t event_mask);
+
+void gpio_init(uint gpio);
+void gpio_set_dir(uint gpio, bool out);
+void gpio_pull_up(uint gpio);
+bool gpio_get(uint gpio);
+void gpio_set_function(uint gpio, enum gpio_function fn);
+void gpio_set_irq_enabled(uint gpio, uint32_t event_mask, bool enabled);
+void gpio_set_irq_enabled_with_callback(uint gpio, uint32_t event_mask, bool enabled, gpio_irq_callback_t callback);
+void gpio_acknowledge_irq(uint gpio, uint32_t event_mask);
+
+/* stdio */
+bool stdio_init_all(void);
+int getchar_timeout_us(uint32_t timeout_us);
+
+void panic(const char *fmt, ...);
+
+/* Interrupções: no host não há IRQ de verdade, os "handlers" rodam na mesma thread */
+static inline uint32_t save_and_disable_interrupts(void) {
+    return 0;
+}
+
+static inline void restore_interrupts(uint32_t status) {
+    (void)status;
+}
+
+#endif // HOST_PICO_STDLIB_H
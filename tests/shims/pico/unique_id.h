@@ -0,0 +1,17 @@
+#ifndef HOST_PICO_UNIQUE_ID_H
+#define HOST_PICO_UNIQUE_ID_H
+
+#include <stdint.h>
+
+#define PICO_UNIQUE_BOARD_ID_SIZE_BYTES 8
+
+typedef struct {
+    uint8_t id[PICO_UNIQUE_BOARD_ID_SIZE_BYTES];
+} pico_unique_board_id_t;
+
+/**
+ * ID da "placa" do host: fixo, ou o de host_set_board_id (tests/shims/host.h).
+ */
+void pico_get_unique_board_id(pico_unique_board_id_t *id_out);
+
+#endif // HOST_PICO_UNIQUE_ID_H
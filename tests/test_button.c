@@ -0,0 +1,227 @@
+/*
+ * Botões (src/button.c) e retirada com máscara da fila de entrada (src/input.c). As
+ * bordas entram pelos GPIOs simulados e o debounce, o toque longo e o duplo rodam nos
+ * alarmes do relógio congelado, então cada evento tem instante exato.
+ *   test_button <caso>   (debounce, longo, duplo, fila, menu)
+ */
+#include "check.h"
+#include "shims/host.h"
+#include "include/button.h"
+#include "include/input.h"
+#include "config/config.h"
+#include "pico/stdlib.h"
+
+#define T0_MS 1000u
+
+static uint32_t now_ms(void) {
+    return to_ms_since_boot(get_absolute_time());
+}
+
+static void press(unsigned pin) {
+    host_gpio_set(pin, false); // Ativos em nível baixo
+}
+
+static void release(unsigned pin) {
+    host_gpio_set(pin, true);
+}
+
+// Quica `bounces` vezes, 1 ms entre bordas, e termina pressionado ou solto
+static void bounce_to(unsigned pin, bool pressed, int bounces) {
+    bool level = !pressed;
+    for (int i = 0; i < bounces; i++) {
+        host_gpio_set(pin, level);
+        host_clock_advance_ms(1);
+        host_gpio_set(pin, !level);
+        host_clock_advance_ms(1);
+    }
+    host_gpio_set(pin, level);
+}
+
+// Retira o próximo evento dos botões e confere tipo, origem e instante
+static void expect(input_event_type_t type, input_source_t source, uint32_t time_ms) {
+    input_event_t event;
+    bool found = input_pop(INPUT_MASK_ALL, INPUT_MASK_ALL, &event);
+    if (!found || event.type != type || event.source != source || event.time_ms != time_ms) {
+        fprintf(stderr, "esperado tipo %d origem %d em %lu, recebido %s tipo %d origem %d em %lu\n", type, source,
+                (unsigned long)time_ms, found ? "" : "(nada)", found ? event.type : -1, found ? event.source : -1,
+                found ? (unsigned long)event.time_ms : 0ul);
+        check_failures++;
+    }
+}
+
+static void expect_empty(void) {
+    input_event_t event;
+    CHECK(!input_pop(INPUT_MASK_ALL, INPUT_MASK_ALL, &event));
+}
+
+static void case_debounce(void) {
+    // Press com quatro quiques: um evento, com o instante da primeira borda
+    uint32_t edge = now_ms();
+    bounce_to(BTN_A_PIN, true, 4);
+    host_clock_advance_ms(BTN_DEBOUNCE_TIME_MS + 5);
+    expect(INPUT_BTN_PRESS, INPUT_SOURCE_BTN_A, edge);
+    expect_empty();
+
+    // Soltar e voltar a pressionar dentro do debounce não muda o nível estável
+    release(BTN_A_PIN);
+    host_clock_advance_ms(BTN_DEBOUNCE_TIME_MS / 2);
+    press(BTN_A_PIN);
+    host_clock_advance_ms(BTN_DEBOUNCE_TIME_MS);
+    expect_empty();
+
+    // Release quicando no botão A e press limpo no B ao mesmo tempo: cada um com o seu debounce
+    uint32_t release_edge = now_ms();
+    bounce_to(BTN_A_PIN, false, 3);
+    uint32_t b_edge = now_ms();
+    press(BTN_B_PIN);
+    host_clock_advance_ms(BTN_DEBOUNCE_TIME_MS + 5);
+    expect(INPUT_BTN_RELEASE, INPUT_SOURCE_BTN_A, release_edge);
+    expect(INPUT_BTN_PRESS, INPUT_SOURCE_BTN_B, b_edge);
+    expect_empty();
+
+    // Pulso mais curto que o debounce com o botão solto: nada
+    press(JOYSTICK_BTN_PIN);
+    host_clock_advance_ms(BTN_DEBOUNCE_TIME_MS / 4);
+    release(JOYSTICK_BTN_PIN);
+    host_clock_advance_ms(BTN_DEBOUNCE_TIME_MS * 2);
+    expect_empty();
+}
+
+static void case_long(void) {
+    // Segurando: press e, BTN_LONG_PRESS_MS depois do nível estável, o toque longo
+    uint32_t edge = now_ms();
+    press(BTN_A_PIN);
+    host_clock_advance_ms(BTN_DEBOUNCE_TIME_MS + BTN_LONG_PRESS_MS + 50);
+    expect(INPUT_BTN_PRESS, INPUT_SOURCE_BTN_A, edge);
+    expect(INPUT_BTN_LONG, INPUT_SOURCE_BTN_A, edge + BTN_DEBOUNCE_TIME_MS + BTN_LONG_PRESS_MS);
+    uint32_t release_edge = now_ms();
+    release(BTN_A_PIN);
+    host_clock_advance_ms(BTN_DEBOUNCE_TIME_MS);
+    expect(INPUT_BTN_RELEASE, INPUT_SOURCE_BTN_A, release_edge);
+
+    // Um press logo depois do longo é um toque simples, sem duplo
+    edge = now_ms();
+    press(BTN_A_PIN);
+    host_clock_advance_ms(BTN_DEBOUNCE_TIME_MS);
+    expect(INPUT_BTN_PRESS, INPUT_SOURCE_BTN_A, edge);
+    expect_empty();
+
+    // Soltar antes de BTN_LONG_PRESS_MS cancela o alarme do longo
+    host_clock_advance_ms(BTN_LONG_PRESS_MS / 2);
+    release_edge = now_ms();
+    release(BTN_A_PIN);
+    host_clock_advance_ms(BTN_LONG_PRESS_MS * 2);
+    expect(INPUT_BTN_RELEASE, INPUT_SOURCE_BTN_A, release_edge);
+    expect_empty();
+}
+
+static uint32_t tap(unsigned pin, uint32_t gap_ms) {
+    uint32_t edge = now_ms();
+    press(pin);
+    host_clock_advance_ms(BTN_DEBOUNCE_TIME_MS + 30);
+    release(pin);
+    host_clock_advance_ms(gap_ms);
+    return edge;
+}
+
+static void case_double(void) {
+    // Dois toques na janela: press, release, press e o duplo logo depois, com o mesmo instante
+    uint32_t first = tap(BTN_B_PIN, 100);
+    uint32_t second = tap(BTN_B_PIN, 100);
+    expect(INPUT_BTN_PRESS, INPUT_SOURCE_BTN_B, first);
+    expect(INPUT_BTN_RELEASE, INPUT_SOURCE_BTN_B, first + BTN_DEBOUNCE_TIME_MS + 30);
+    expect(INPUT_BTN_PRESS, INPUT_SOURCE_BTN_B, second);
+    expect(INPUT_BTN_DOUBLE, INPUT_SOURCE_BTN_B, second);
+    expect(INPUT_BTN_RELEASE, INPUT_SOURCE_BTN_B, second + BTN_DEBOUNCE_TIME_MS + 30);
+
+    // Um terceiro toque na janela começa outro par em vez de outro duplo
+    uint32_t third = tap(BTN_B_PIN, BTN_DOUBLE_PRESS_MS + 100);
+    expect(INPUT_BTN_PRESS, INPUT_SOURCE_BTN_B, third);
+    expect(INPUT_BTN_RELEASE, INPUT_SOURCE_BTN_B, third + BTN_DEBOUNCE_TIME_MS + 30);
+
+    // Segundo press fora da janela: dois toques simples
+    uint32_t late = tap(BTN_B_PIN, 0);
+    CHECK(late - third > BTN_DOUBLE_PRESS_MS);
+    expect(INPUT_BTN_PRESS, INPUT_SOURCE_BTN_B, late);
+    host_clock_advance_ms(BTN_DEBOUNCE_TIME_MS);
+    expect(INPUT_BTN_RELEASE, INPUT_SOURCE_BTN_B, late + BTN_DEBOUNCE_TIME_MS + 30);
+    expect_empty();
+}
+
+static void case_queue(void) {
+    input_event_t event;
+    // Leva a cabeça para perto do fim do vetor, para a retirada no meio atravessar a volta
+    for (uint32_t i = 0; i < INPUT_QUEUE_LEN - 2; i++) {
+        CHECK(input_push(INPUT_NAV_UP, INPUT_SOURCE_JOYSTICK, false, now_ms()));
+        CHECK(input_pop(INPUT_MASK_ALL, INPUT_MASK_ALL, &event));
+    }
+
+    uint32_t t = now_ms();
+    CHECK(input_push(INPUT_BTN_PRESS, INPUT_SOURCE_BTN_A, false, t));
+    CHECK(input_push(INPUT_NAV_UP, INPUT_SOURCE_JOYSTICK, false, t + 1));
+    CHECK(input_push(INPUT_BTN_PRESS, INPUT_SOURCE_BTN_B, false, t + 2));
+    CHECK(input_push(INPUT_BTN_RELEASE, INPUT_SOURCE_BTN_A, false, t + 3));
+    CHECK(input_push(INPUT_NAV_DOWN, INPUT_SOURCE_JOYSTICK, false, t + 4));
+
+    // Tipo e origem precisam combinar os dois: o press do B sai do meio da fila
+    CHECK(!input_pop(INPUT_MASK(INPUT_BTN_LONG), INPUT_MASK_ALL, &event));
+    CHECK(!input_pop(INPUT_MASK(INPUT_BTN_PRESS), INPUT_MASK(INPUT_SOURCE_BTN_JOYSTICK), &event));
+    CHECK(input_pop(INPUT_MASK(INPUT_BTN_PRESS), INPUT_MASK(INPUT_SOURCE_BTN_B), &event) &&
+          event.source == INPUT_SOURCE_BTN_B && event.time_ms == t + 2);
+    // O último da fila sai sem tirar os anteriores
+    CHECK(input_pop(INPUT_MASK(INPUT_NAV_DOWN), INPUT_MASK_ALL, &event) && event.time_ms == t + 4);
+
+    // Sem buraco: o espaço liberado volta a caber e o resto segue na ordem de chegada
+    for (uint32_t i = 0; i < INPUT_QUEUE_LEN - 3; i++) {
+        CHECK(input_push(INPUT_NAV_LEFT, INPUT_SOURCE_JOYSTICK, false, t + 10 + i));
+    }
+    CHECK(!input_push(INPUT_NAV_LEFT, INPUT_SOURCE_JOYSTICK, false, t));
+    CHECK(input_pop(INPUT_MASK_ALL, INPUT_MASK_ALL, &event) && event.type == INPUT_BTN_PRESS && event.time_ms == t);
+    CHECK(input_pop(INPUT_MASK_ALL, INPUT_MASK_ALL, &event) && event.type == INPUT_NAV_UP && event.time_ms == t + 1);
+    CHECK(input_pop(INPUT_MASK_ALL, INPUT_MASK_ALL, &event) && event.type == INPUT_BTN_RELEASE &&
+          event.time_ms == t + 3);
+    for (uint32_t i = 0; i < INPUT_QUEUE_LEN - 3; i++) {
+        CHECK(input_pop(INPUT_MASK_ALL, INPUT_MASK_ALL, &event) && event.time_ms == t + 10 + i);
+    }
+    expect_empty();
+}
+
+static void case_menu(void) {
+    // Dois presses do A acumulados valem uma ação; o do B não confirma e continua na fila
+    tap(BTN_A_PIN, 50);
+    tap(BTN_B_PIN, 50);
+    tap(BTN_A_PIN, BTN_DOUBLE_PRESS_MS);
+    CHECK(button_get_pressed_and_reset());
+    CHECK(!button_get_pressed_and_reset());
+
+    // Um press novo do botão do joystick confirma
+    tap(JOYSTICK_BTN_PIN, 50);
+    CHECK(button_get_pressed_and_reset());
+
+    input_event_t event;
+    CHECK(input_pop(INPUT_MASK(INPUT_BTN_PRESS), INPUT_MASK_ALL, &event) && event.source == INPUT_SOURCE_BTN_B);
+}
+
+static const struct {
+    const char *name;
+    void (*run)(void);
+} cases[] = {
+    {"debounce", case_debounce},
+    {"longo", case_long},
+    {"duplo", case_double},
+    {"fila", case_queue},
+    {"menu", case_menu},
+};
+
+int main(int argc, char **argv) {
+    for (size_t i = 0; argc == 2 && i < sizeof(cases) / sizeof(cases[0]); i++) {
+        if (strcmp(argv[1], cases[i].name) == 0) {
+            host_clock_freeze((uint64_t)T0_MS * 1000);
+            button_init();
+            cases[i].run();
+            CHECK_EXIT();
+        }
+    }
+    fprintf(stderr, "uso: %s <debounce|longo|duplo|fila|menu>\n", argv[0]);
+    return 2;
+}
@@ -0,0 +1,158 @@
+/*
+ * Conferência cruzada com o tools/load_gen.py: os frames gravados com --dump são abertos
+ * pelo código do firmware (frame_open, mac_verify, xor_encrypt e numfmt_parse_reading),
+ * com as chaves da sessão 0 derivadas pelo key_manager. Os modos sem nonce (normal, xor
+ * e mac) também são remontados com frame_encode e comparados byte a byte, e uma cópia
+ * adulterada dos frames autenticados precisa ser recusada.
+ *   test_frame_crosscheck <arquivo do --dump>
+ */
+#include "check.h"
+#include "shims/host.h"
+#include "include/frame.h"
+#include "include/key_manager.h"
+#include "include/mac.h"
+#include "include/numfmt.h"
+#include "include/xor_cipher.h"
+#include "config/credentials.h"
+
+#define LINE_MAX_LEN 512
+#define FRAME_MAX_LEN 200
+
+// Nomes de modo do load_gen.py (KIND)
+static const struct {
+    const char *name;
+    frame_kind_t kind;
+} modes[] = {
+    {"plain", FRAME_KIND_PLAIN},
+    {"xor", FRAME_KIND_XOR},
+    {"hmac", FRAME_KIND_MAC},
+    {"aes", FRAME_KIND_AES_GCM},
+    {"chacha", FRAME_KIND_CHACHAPOLY},
+};
+#define MODE_COUNT (sizeof(modes) / sizeof(modes[0]))
+
+static size_t hex_decode(const char *hex, uint8_t *out, size_t size) {
+    size_t len = strlen(hex);
+    if (len % 2 != 0 || len / 2 > size) {
+        return 0;
+    }
+    for (size_t i = 0; i < len / 2; i++) {
+        unsigned int byte;
+        if (sscanf(hex + 2 * i, "%2x", &byte) != 1) {
+            return 0;
+        }
+        out[i] = (uint8_t)byte;
+    }
+    return len / 2;
+}
+
+// Abre o frame como o subscriber; devolve o tamanho do texto em `text` ou -1
+static int open_frame(frame_kind_t kind, const uint8_t *frame, size_t len, uint8_t *text) {
+    const char *topic = MQTT_TOPIC_SUBSCRIBE;
+    const uint8_t *msg = NULL;
+    size_t msg_len = 0;
+    switch (kind) {
+    case FRAME_KIND_PLAIN:
+        memcpy(text, frame + FRAME_TYPE_LEN, len - FRAME_TYPE_LEN);
+        return (int)(len - FRAME_TYPE_LEN);
+    case FRAME_KIND_XOR:
+        xor_encrypt(frame + FRAME_TYPE_LEN, text, len - FRAME_TYPE_LEN, key_manager_current()->xor_key);
+        return (int)(len - FRAME_TYPE_LEN);
+    case FRAME_KIND_MAC:
+        if (!mac_verify(mac_config_for_topic(topic), frame + FRAME_TYPE_LEN, len - FRAME_TYPE_LEN, &msg, &msg_len)) {
+            return -1;
+        }
+        memcpy(text, msg, msg_len);
+        return (int)msg_len;
+    default: {
+        nonce_seq_t seq = {0};
+        frame_status_t status = frame_open((frame_aead_t)kind, topic, frame, len, text, FRAME_MAX_LEN, &msg_len, &seq);
+        return status == FRAME_OK ? (int)msg_len : -1;
+    }
+    }
+}
+
+static void check_frame(frame_kind_t kind, uint64_t expected_ts, const uint8_t *frame, size_t len) {
+    uint8_t text[FRAME_MAX_LEN];
+    CHECK(len > FRAME_TYPE_LEN && frame[0] == FRAME_TYPE(kind));
+
+    // Autenticados: um bit trocado no último byte (texto ou tag) é recusado antes do original
+    if (kind == FRAME_KIND_MAC || kind == FRAME_KIND_AES_GCM || kind == FRAME_KIND_CHACHAPOLY) {
+        uint8_t forged[FRAME_MAX_LEN];
+        memcpy(forged, frame, len);
+        forged[len - 1] ^= 0x01;
+        CHECK(open_frame(kind, forged, len, text) < 0);
+    }
+
+    int text_len = open_frame(kind, frame, len, text);
+    CHECK(text_len > 0);
+    if (text_len <= 0) {
+        return;
+    }
+    char value[16];
+    uint64_t timestamp = 0;
+    CHECK(numfmt_parse_reading((const char *)text, (size_t)text_len, value, sizeof(value), &timestamp) == NUMFMT_OK);
+    CHECK_STR(value, "26.5");
+    CHECK(timestamp == expected_ts);
+
+    if (kind == FRAME_KIND_AES_GCM || kind == FRAME_KIND_CHACHAPOLY) {
+        // A mesma sequência de novo é replay
+        nonce_seq_t seq = {0};
+        size_t plain_len = 0;
+        CHECK(frame_open((frame_aead_t)kind, MQTT_TOPIC_SUBSCRIBE, frame, len, text, FRAME_MAX_LEN, &plain_len, &seq) ==
+              FRAME_ERR_REPLAY);
+        return;
+    }
+    // Sem nonce: o frame do firmware para o mesmo texto é idêntico
+    uint8_t encoded[FRAME_MAX_LEN];
+    size_t encoded_len = 0;
+    CHECK(frame_encode(kind, MQTT_TOPIC_SUBSCRIBE, text, (size_t)text_len, encoded, sizeof(encoded), &encoded_len) == 0);
+    CHECK(encoded_len == len && memcmp(encoded, frame, len) == 0);
+}
+
+int main(int argc, char **argv) {
+    if (argc != 2) {
+        fprintf(stderr, "uso: %s <arquivo do load_gen.py --dump>\n", argv[0]);
+        return 2;
+    }
+    FILE *f = fopen(argv[1], "r");
+    if (f == NULL) {
+        perror(argv[1]);
+        return 2;
+    }
+    host_clock_freeze(1000000);
+    CHECK(key_manager_init());
+
+    char line[LINE_MAX_LEN];
+    unsigned counts[MODE_COUNT] = {0};
+    unsigned total = 0;
+    while (fgets(line, sizeof(line), f) != NULL) {
+        char mode[16];
+        char hex[LINE_MAX_LEN];
+        unsigned long long timestamp;
+        if (line[0] == '#' || sscanf(line, "%15s %llu %511s", mode, &timestamp, hex) != 3) {
+            continue;
+        }
+        size_t m = 0;
+        while (m < MODE_COUNT && strcmp(modes[m].name, mode) != 0) {
+            m++;
+        }
+        uint8_t frame[FRAME_MAX_LEN];
+        size_t len = hex_decode(hex, frame, sizeof(frame));
+        if (m == MODE_COUNT || len == 0) {
+            fprintf(stderr, "linha invalida: %s", line);
+            check_failures++;
+            continue;
+        }
+        check_frame(modes[m].kind, timestamp, frame, len);
+        counts[m]++;
+        total++;
+    }
+    fclose(f);
+
+    CHECK(total > 0);
+    for (size_t m = 0; m < MODE_COUNT; m++) {
+        printf("%-7s %u frames\n", modes[m].name, counts[m]);
+    }
+    CHECK_EXIT();
+}
@@ -0,0 +1,139 @@
+/*
+ * Journal (src/journal.c) sobre a flash emulada em arquivo (journal_flash_open).
+ * Cada "boot" que grava roda num processo filho que termina com _exit(): o que estava
+ * no buffer de página em RAM se perde e só fica o que foi programado no arquivo, como
+ * numa queda de energia. O processo pai reabre o arquivo, confere o que journal_init()
+ * recuperou, estraga um registro como uma gravação interrompida e reenvia tudo pelo
+ * mqtt_comm de teste, conferindo a ordem.
+ */
+#define _GNU_SOURCE // memmem
+#include "check.h"
+#include "fakes/fakes.h"
+#include "shims/host.h"
+#include "include/journal.h"
+#include "config/config.h"
+#include "pico/stdlib.h"
+#include "hardware/flash.h"
+#include <stdlib.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#define TOPIC "escola/sala1/temperatura"
+// Registro de 256 B (12 de cabeçalho + 24 de tópico + 220): como o setor começa com um
+// cabeçalho de 16 B, todo registro termina 16 B depois de uma fronteira de página, e o
+// último gravado antes da queda sempre fica pela metade na flash. 80 registros = 6 setores.
+#define PAYLOAD_LEN 220
+
+static char path[] = "/tmp/journal_flashXXXXXX";
+
+static size_t make_payload(int n, uint8_t payload[PAYLOAD_LEN]) {
+    memset(payload, '.', PAYLOAD_LEN);
+    snprintf((char *)payload, PAYLOAD_LEN, "msg %03d", n);
+    return PAYLOAD_LEN;
+}
+
+static void boot(void) {
+    CHECK(journal_flash_open(path) == 0);
+    journal_init();
+}
+
+static void append_range(int first, int last) {
+    uint8_t payload[PAYLOAD_LEN];
+    for (int n = first; n <= last; n++) {
+        CHECK(journal_append(TOPIC, payload, make_payload(n, payload), 1) == 0);
+    }
+}
+
+// Boot em processo filho: grava [first, last] com um journal_flush() depois de flushed_last
+static void boot_and_cut_power(int first, int flushed_last, int last) {
+    pid_t pid = fork();
+    if (pid == 0) {
+        check_failures = 0;
+        boot();
+        append_range(first, flushed_last);
+        journal_flush();
+        append_range(flushed_last + 1, last);
+        _exit(check_failures);
+    }
+    int status;
+    CHECK(waitpid(pid, &status, 0) == pid && WIFEXITED(status) && WEXITSTATUS(status) == 0);
+}
+
+// Gravação interrompida: o último byte do payload de `n` ficou sem programar (0xFF)
+static void tear_record(int n) {
+    FILE *file = fopen(path, "r+b");
+    CHECK(file != NULL);
+    static uint8_t flash[JOURNAL_FLASH_SECTORS * FLASH_SECTOR_SIZE];
+    size_t size = fread(flash, 1, sizeof(flash), file);
+    char marker[16];
+    snprintf(marker, sizeof(marker), "msg %03d", n);
+    uint8_t *found = memmem(flash, size, marker, strlen(marker));
+    CHECK(found != NULL);
+    if (found != NULL) {
+        fseek(file, (long)(found - flash) + PAYLOAD_LEN - 1, SEEK_SET);
+        fputc(0xFF, file);
+    }
+    fclose(file);
+}
+
+// Reenvia tudo pelo journal_poll e confere que chega exatamente `expected`, na ordem
+static void drain_and_check(const int *expected, size_t count) {
+    fake_mqtt_set_connected(true);
+    journal_poll(to_ms_since_boot(get_absolute_time()));
+    size_t received = 0;
+    for (int round = 0; round < 100 && journal_pending() > 0; round++) {
+        host_clock_advance_ms(200);
+        journal_poll(to_ms_since_boot(get_absolute_time()));
+        fake_mqtt_message_t message;
+        while (fake_mqtt_take(&message)) {
+            uint8_t payload[PAYLOAD_LEN];
+            CHECK_STR(message.topic, TOPIC);
+            CHECK(message.qos == 1);
+            CHECK(received < count && message.len == PAYLOAD_LEN &&
+                  memcmp(message.payload, payload, make_payload(expected[received], payload)) == 0);
+            received++;
+        }
+    }
+    CHECK(received == count);
+    CHECK(journal_pending() == 0);
+}
+
+int main(void) {
+    int fd = mkstemp(path);
+    CHECK(fd >= 0);
+    close(fd);
+    unlink(path); // journal_flash_open cria o arquivo já apagado
+    host_clock_freeze(1000000);
+    fake_mqtt_set_connected(false);
+
+    // 1. Queda de energia com o fim do registro 40 no buffer de RAM: ele chega à flash
+    // pela metade, o CRC não confere e só os 40 anteriores voltam
+    boot_and_cut_power(0, 39, 40);
+    boot();
+    CHECK(journal_pending() == 40);
+
+    // 2. O boot seguinte abre um setor novo; o último registro programado fica corrompido
+    boot_and_cut_power(41, 59, 59);
+    tear_record(59);
+    boot();
+    CHECK(journal_pending() == 40 + 18);
+
+    // 3. Gravações depois da recuperação vão para outro setor, atrás das anteriores
+    append_range(60, 79);
+    CHECK(journal_pending() == 40 + 18 + 20);
+    int expected[80];
+    size_t count = 0;
+    for (int n = 0; n <= 79; n++) {
+        if (n != 40 && n != 59) {
+            expected[count++] = n;
+        }
+    }
+    drain_and_check(expected, count);
+
+    // 4. As marcas de enviado estão na flash: depois de outra queda nada é reenviado
+    boot();
+    CHECK(journal_pending() == 0);
+
+    unlink(path);
+    CHECK_EXIT();
+}
@@ -0,0 +1,164 @@
+/*
+ * Joystick e fila de entrada com traços do ADC (tests/fixtures/joystick_*.csv): cada
+ * linha do traço vira uma rodada na FIFO simulada, com o relógio congelado no instante
+ * da linha, e os eventos que saem da fila têm que ser os "# esperado:" do arquivo (tipo e
+ * repetição iguais, instante com no máximo uma rodada de diferença).
+ *   test_joystick_trace <traço.csv>
+ *   test_joystick_trace expiracao   (input_push/input_pop: idade máxima e fila cheia)
+ */
+#include "check.h"
+#include "shims/host.h"
+#include "include/joystick.h"
+#include "include/input.h"
+#include "config/config.h"
+#include "pico/stdlib.h"
+#include <stdlib.h>
+
+#define BASE_MS 1000u         // Instante do relógio na linha t_ms = 0
+#define TEMP_SAMPLE 876       // Canal da temperatura: fora do que o joystick olha
+#define ROUND_TOLERANCE_MS 2  // Uma rodada do ADC a 500 Hz
+#define MAX_EVENTS 64
+
+typedef struct {
+    uint32_t time_ms;
+    int type;
+    bool repeat;
+} trace_event_t;
+
+static const char *const nav_names[] = {"cima", "baixo", "esquerda", "direita"};
+
+static int nav_type(const char *name) {
+    for (int i = 0; i < 4; i++) {
+        if (strcmp(name, nav_names[i]) == 0) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+static void print_events(const char *label, const trace_event_t *events, size_t count) {
+    fprintf(stderr, "%s:", label);
+    for (size_t i = 0; i < count; i++) {
+        fprintf(stderr, " %lu %s%s", (unsigned long)events[i].time_ms, nav_names[events[i].type],
+                events[i].repeat ? " (rep)" : "");
+    }
+    fprintf(stderr, "\n");
+}
+
+static int run_trace(const char *path) {
+    FILE *file = fopen(path, "r");
+    if (file == NULL) {
+        fprintf(stderr, "nao abriu %s\n", path);
+        return 2;
+    }
+    trace_event_t expected[MAX_EVENTS];
+    trace_event_t seen[MAX_EVENTS];
+    size_t expected_count = 0;
+    size_t seen_count = 0;
+    size_t rounds = 0;
+
+    host_clock_freeze((uint64_t)BASE_MS * 1000);
+    joystick_init();
+
+    char line[256];
+    while (fgets(line, sizeof(line), file) != NULL) {
+        unsigned t, y, x, repeat;
+        char name[16];
+        if (sscanf(line, "# esperado: %u %15s %u", &t, name, &repeat) == 3) {
+            CHECK(expected_count < MAX_EVENTS && nav_type(name) >= 0);
+            expected[expected_count++] = (trace_event_t){t, nav_type(name), repeat != 0};
+            continue;
+        }
+        if (line[0] == '#' || sscanf(line, "%u,%u,%u", &t, &y, &x) != 3) {
+            continue;
+        }
+        uint64_t target_us = (uint64_t)(BASE_MS + t) * 1000;
+        if (time_us_64() < target_us) {
+            host_clock_advance_us(target_us - time_us_64());
+        }
+        // Y, X e temperatura, na ordem crescente dos canais do round-robin
+        const uint16_t samples[] = {(uint16_t)y, (uint16_t)x, TEMP_SAMPLE};
+        host_adc_push_round(samples, 3);
+        rounds++;
+
+        input_event_t event;
+        while (input_pop(INPUT_MASK_NAV, INPUT_MASK(INPUT_SOURCE_JOYSTICK), &event)) {
+            if (seen_count < MAX_EVENTS) {
+                seen[seen_count++] = (trace_event_t){event.time_ms - BASE_MS, event.type, event.repeat};
+            }
+        }
+    }
+    fclose(file);
+    CHECK(rounds > 0);
+
+    bool match = seen_count == expected_count;
+    for (size_t i = 0; match && i < seen_count; i++) {
+        uint32_t delta = seen[i].time_ms > expected[i].time_ms ? seen[i].time_ms - expected[i].time_ms
+                                                               : expected[i].time_ms - seen[i].time_ms;
+        match = seen[i].type == expected[i].type && seen[i].repeat == expected[i].repeat &&
+                delta <= ROUND_TOLERANCE_MS;
+    }
+    if (!match) {
+        print_events("esperado", expected, expected_count);
+        print_events("recebido", seen, seen_count);
+        check_failures++;
+    }
+    CHECK_EXIT();
+}
+
+// Idade máxima na cauda, eventos que não combinam preservados e fila cheia
+static int run_expiry(void) {
+    input_event_t event;
+    host_clock_freeze((uint64_t)BASE_MS * 1000);
+
+    // Um press que ninguém pede expira quando chega à cauda depois de INPUT_EVENT_MAX_AGE_MS
+    CHECK(input_push(INPUT_BTN_PRESS, INPUT_SOURCE_BTN_A, false, BASE_MS));
+    host_clock_advance_ms(INPUT_EVENT_MAX_AGE_MS);
+    CHECK(!input_pop(INPUT_MASK_NAV, INPUT_MASK_ALL, &event));
+    CHECK(input_pop(INPUT_MASK(INPUT_BTN_PRESS), INPUT_MASK_ALL, &event)); // Ainda no limite: não expirou
+    CHECK(input_push(INPUT_BTN_PRESS, INPUT_SOURCE_BTN_A, false, BASE_MS + INPUT_EVENT_MAX_AGE_MS));
+    host_clock_advance_ms(INPUT_EVENT_MAX_AGE_MS + 1);
+    CHECK(input_push(INPUT_NAV_UP, INPUT_SOURCE_JOYSTICK, false, to_ms_since_boot(get_absolute_time())));
+    CHECK(input_pop(INPUT_MASK_NAV, INPUT_MASK_ALL, &event) && event.type == INPUT_NAV_UP);
+    CHECK(!input_pop(INPUT_MASK_ALL, INPUT_MASK_ALL, &event)); // O press velho saiu pela cauda
+
+    // Só a cauda expira: um evento novo na frente segura o velho atrás dele até ser retirado
+    uint32_t now_ms = to_ms_since_boot(get_absolute_time());
+    CHECK(input_push(INPUT_BTN_RELEASE, INPUT_SOURCE_BTN_B, false, now_ms));
+    CHECK(input_push(INPUT_NAV_DOWN, INPUT_SOURCE_JOYSTICK, false, now_ms));
+    host_clock_advance_ms(INPUT_EVENT_MAX_AGE_MS / 2);
+    CHECK(!input_pop(INPUT_MASK(INPUT_BTN_LONG), INPUT_MASK_ALL, &event));
+    CHECK(input_pop(INPUT_MASK_NAV, INPUT_MASK_ALL, &event) && event.type == INPUT_NAV_DOWN);
+    CHECK(input_pop(INPUT_MASK_ALL, INPUT_MASK(INPUT_SOURCE_BTN_B), &event) && event.type == INPUT_BTN_RELEASE);
+
+    // O menu ignora navegação acumulada por mais de INPUT_EVENT_MAX_AGE_MS
+    int selected = 2;
+    now_ms = to_ms_since_boot(get_absolute_time());
+    CHECK(input_push(INPUT_NAV_UP, INPUT_SOURCE_JOYSTICK, false, now_ms));
+    CHECK(input_push(INPUT_NAV_UP, INPUT_SOURCE_JOYSTICK, true, now_ms + 600));
+    host_clock_advance_ms(INPUT_EVENT_MAX_AGE_MS + 100);
+    joystick_handle_menu_navigation(5, &selected);
+    CHECK(selected == 1);
+    joystick_handle_menu_navigation(5, &selected);
+    CHECK(selected == 1);
+
+    // Fila cheia: o evento novo é descartado e os que já estavam continuam na ordem
+    now_ms = to_ms_since_boot(get_absolute_time());
+    for (uint32_t i = 0; i < INPUT_QUEUE_LEN; i++) {
+        CHECK(input_push(INPUT_NAV_RIGHT, INPUT_SOURCE_JOYSTICK, false, now_ms + i));
+    }
+    CHECK(!input_push(INPUT_NAV_LEFT, INPUT_SOURCE_JOYSTICK, false, now_ms));
+    for (uint32_t i = 0; i < INPUT_QUEUE_LEN; i++) {
+        CHECK(input_pop(INPUT_MASK_ALL, INPUT_MASK_ALL, &event) && event.time_ms == now_ms + i);
+    }
+    CHECK(!input_pop(INPUT_MASK_ALL, INPUT_MASK_ALL, &event));
+    CHECK_EXIT();
+}
+
+int main(int argc, char **argv) {
+    if (argc != 2) {
+        fprintf(stderr, "uso: %s <traço.csv|expiracao>\n", argv[0]);
+        return 2;
+    }
+    return strcmp(argv[1], "expiracao") == 0 ? run_expiry() : run_trace(argv[1]);
+}
@@ -0,0 +1,68 @@
+/*
+ * Anúncio de rotação de chaves (src/key_manager.c): a sessão só muda depois que o anúncio
+ * retido com QoS 1 foi aceito pelo mqtt_comm, o eco do próprio anúncio não rotaciona de
+ * novo e outra placa que recebe o anúncio passa para a mesma sessão.
+ */
+#include "check.h"
+#include "fakes/fakes.h"
+#include "shims/host.h"
+#include "include/key_manager.h"
+#include "config/config.h"
+#include "config/credentials.h"
+
+int main(void) {
+    fake_mqtt_message_t announcement;
+    host_clock_freeze(1000000);
+    CHECK(key_manager_init());
+    CHECK(key_manager_current()->session_id == 0);
+
+    // Fila de saída cheia: nada é anunciado e a sessão atual continua
+    fake_mqtt_set_publish_result(-1);
+    key_manager_announce_next();
+    CHECK(fake_mqtt_published() == 0);
+    CHECK(key_manager_current()->session_id == 0);
+
+    // Anúncio aceito: retido, QoS 1, e só então a sessão 1 é aplicada
+    fake_mqtt_set_publish_result(0);
+    key_manager_announce_next();
+    CHECK(fake_mqtt_take(&announcement));
+    CHECK_STR(announcement.topic, MQTT_TOPIC_KEYS);
+    CHECK(announcement.retain && announcement.qos == 1);
+    CHECK(key_manager_current()->session_id == 1);
+    CHECK(key_manager_previous() != NULL && key_manager_previous()->session_id == 0);
+
+    // O eco do próprio anúncio não muda nada
+    key_manager_control_handler(MQTT_TOPIC_KEYS, announcement.payload, announcement.len);
+    key_manager_poll(false);
+    CHECK(key_manager_current()->session_id == 1);
+
+    // Um anúncio adulterado é recusado
+    uint8_t forged[sizeof(announcement.payload)];
+    memcpy(forged, announcement.payload, announcement.len);
+    forged[3] = 7;
+    key_manager_control_handler(MQTT_TOPIC_KEYS, forged, announcement.len);
+    key_manager_poll(false);
+    CHECK(key_manager_current()->session_id == 1);
+
+    // Outra placa (mesmo segredo, ainda na sessão 0) aplica o anúncio no loop principal
+    CHECK(key_manager_init());
+    key_manager_control_handler(MQTT_TOPIC_KEYS, announcement.payload, announcement.len);
+    CHECK(key_manager_current()->session_id == 0);
+    key_manager_poll(false);
+    CHECK(key_manager_current()->session_id == 1);
+
+#if KEY_ROTATION_INTERVAL_MS > 0
+    // Rotação periódica: uma falha não espera o intervalo inteiro para tentar de novo
+    fake_mqtt_set_connected(true);
+    host_clock_advance_ms(KEY_ROTATION_INTERVAL_MS);
+    fake_mqtt_set_publish_result(-1);
+    key_manager_poll(true);
+    CHECK(key_manager_current()->session_id == 1);
+    fake_mqtt_set_publish_result(0);
+    host_clock_advance_ms(KEY_ROTATION_INTERVAL_MS / 2);
+    key_manager_poll(true);
+    CHECK(fake_mqtt_take(&announcement) && announcement.qos == 1);
+    CHECK(key_manager_current()->session_id == 2);
+#endif
+    CHECK_EXIT();
+}
@@ -0,0 +1,226 @@
+/*
+ * Ida e volta de cada plugin (include/app.h): o encode do publisher publica no
+ * mqtt_comm de teste (fakes/mqtt_capture.c), a mensagem vai para o decode do subscriber
+ * e o texto que ele mostra no display tem que ser exatamente o que o publisher montou.
+ * A entrega passa pelas inscrições do subscriber, como no broker: um stream que o modo
+ * não assinou não chega ao decode.
+ * Publisher e subscriber rodam no mesmo processo, com as mesmas chaves e o mesmo ID de
+ * placa, como no firmware de loopback.
+ *   test_modes_roundtrip <caso>   (plain, xor, hmac, aes, chacha, mixed, streams)
+ */
+#include "check.h"
+#include "fakes/fakes.h"
+#include "shims/host.h"
+#include "include/publisher_modes.h"
+#include "include/subscriber_modes.h"
+#include "include/key_manager.h"
+#include "include/mqtt_comm.h"
+#include "include/frame.h"
+#include "include/numfmt.h"
+#include "include/prefilter.h"
+#include "include/stream.h"
+#include "include/adc_scan.h"
+#include "include/log.h"
+#include "config/config.h"
+#include "config/credentials.h"
+#include "pico/stdlib.h"
+#include <stdlib.h>
+
+#define SINGLE_MODE_MESSAGES 12
+#define MIXED_MODE_MESSAGES 15  // Três voltas pelos cinco modos
+#define STREAMS_RUN_MS 20000    // Quatro lotes do stream de temperatura (5 amostras a 1 s)
+
+typedef struct {
+    const char *name;
+    const char *publisher_label;
+    const char *subscriber_label;
+} roundtrip_case_t;
+
+static const roundtrip_case_t cases[] = {
+    {"plain", "Sem seguranca", "Sem seguranca"},
+    {"xor", "Encriptacao XOR", "Encriptacao XOR"},
+    {"hmac", "Autenticacao HMAC", "Autenticacao HMAC"},
+    {"aes", "AES-GCM", "AES-GCM"},
+    {"chacha", "ChaCha20-Poly1305", "ChaCha20-Poly1305"},
+    {"mixed", "Todos intercalados", "Automatico (todos)"},
+    {"streams", "Multi-stream", "Automatico (todos)"},
+};
+
+static const app_mode_t *find_mode(const app_mode_t *modes, size_t count, const char *label) {
+    for (size_t i = 0; i < count; i++) {
+        if (strcmp(modes[i].label, label) == 0) {
+            return &modes[i];
+        }
+    }
+    fprintf(stderr, "plugin \"%s\" nao encontrado\n", label);
+    exit(2);
+}
+
+// O XOR mostra o texto decifrado na linha 4; os outros decodificadores, na linha 2
+static const char *decoded_line(const fake_mqtt_message_t *message) {
+    bool xor = message->len > 0 && message->payload[0] == FRAME_TYPE(FRAME_KIND_XOR);
+    return fake_display_line(xor ? 4 : 2, false);
+}
+
+// O decode é o handler geral do mqtt_comm, como em app_enter_mode
+static void deliver(const fake_mqtt_message_t *message) {
+    fake_display_reset();
+    fake_mqtt_deliver(message->topic, message->payload, message->len);
+    log_flush();
+}
+
+/* --- Modos de uma mensagem por passo: "26.5,<timestamp>" com o relógio do passo --- */
+static uint32_t run_readings(const app_mode_t *publisher, uint32_t messages) {
+    uint32_t verified = 0;
+    for (uint32_t step = 0; step < messages; step++) {
+        char expected[64];
+        numfmt_reading(expected, sizeof(expected), 265, 1, time_us_64());
+
+        int32_t wait_ms = publisher->encode();
+        CHECK(wait_ms != APP_MODE_EXIT);
+        CHECK(fake_mqtt_published() == 1);
+
+        fake_mqtt_message_t message;
+        while (fake_mqtt_take(&message)) {
+            CHECK_STR(message.topic, MQTT_TOPIC_SUBSCRIBE);
+            deliver(&message);
+            CHECK_STR(decoded_line(&message), expected);
+            verified += strcmp(decoded_line(&message), expected) == 0;
+        }
+        host_clock_advance_ms(wait_ms > 0 ? (uint32_t)wait_ms : 1);
+    }
+    return verified;
+}
+
+/* --- Multi-stream: cada lote tem as amostras da fonte do tópico e o timestamp do envio --- */
+static stream_source_t source_for_topic(const char *topic) {
+    if (strcmp(topic, MQTT_TOPIC_SUBSCRIBE) == 0) {
+        return stream_source_fixed;
+    }
+    if (strcmp(topic, MQTT_TOPIC_SENSORS "/chip") == 0) {
+        return stream_source_chip_temp;
+    }
+    if (strcmp(topic, MQTT_TOPIC_SENSORS "/joystick") == 0) {
+        return stream_source_joystick_y;
+    }
+    return NULL;
+}
+
+// Confere "a1;a2;...;aN,timestamp": as fontes só mudam entre lotes, então toda amostra é a atual
+static bool check_batch(const char *text, stream_source_t source, uint64_t now_us) {
+    char sample[STREAM_SAMPLE_LEN + 1];
+    source(sample, sizeof(sample));
+    const char *comma = strrchr(text, ',');
+    if (comma == NULL) {
+        fprintf(stderr, "lote sem timestamp: \"%s\"\n", text);
+        return false;
+    }
+    char timestamp[NUMFMT_U64_LEN + 1];
+    numfmt_u64(timestamp, now_us);
+    bool ok = strcmp(comma + 1, timestamp) == 0;
+    size_t sample_len = strlen(sample);
+    for (const char *p = text; p < comma; p += sample_len + 1) {
+        ok = ok && strncmp(p, sample, sample_len) == 0 && (p[sample_len] == ';' || p + sample_len == comma);
+    }
+    if (!ok) {
+        fprintf(stderr, "lote \"%s\": esperadas amostras \"%s\" e timestamp %s\n", text, sample, timestamp);
+    }
+    return ok;
+}
+
+static uint32_t run_streams(const app_mode_t *publisher) {
+    // Joystick Y, X e temperatura, na ordem da varredura
+    uint16_t adc_round[3] = {3100, 2048, 876};
+    adc_scan_init();
+    host_adc_push_round(adc_round, 3);
+
+    uint32_t per_topic[3] = {0};
+    uint32_t verified = 0;
+    uint64_t end_us = time_us_64() + STREAMS_RUN_MS * 1000ull;
+    while (time_us_64() < end_us) {
+        int32_t wait_ms = publisher->encode();
+        CHECK(wait_ms != APP_MODE_EXIT);
+
+        fake_mqtt_message_t message;
+        bool chip_sent = false;
+        bool joystick_sent = false;
+        while (fake_mqtt_take(&message)) {
+            stream_source_t source = source_for_topic(message.topic);
+            CHECK(source != NULL);
+            if (source == NULL) {
+                continue;
+            }
+            deliver(&message);
+            bool ok = check_batch(decoded_line(&message), source, time_us_64());
+            CHECK(ok);
+            verified += ok;
+            per_topic[source == stream_source_fixed ? 0 : source == stream_source_chip_temp ? 1 : 2]++;
+            chip_sent |= source == stream_source_chip_temp;
+            joystick_sent |= source == stream_source_joystick_y;
+        }
+        // O próximo lote do stream usa outra leitura: os deltas entre mensagens deixam de ser zero
+        if (chip_sent || joystick_sent) {
+            adc_round[0] = (uint16_t)(adc_round[0] + (joystick_sent ? 37 : 0));
+            adc_round[2] = (uint16_t)(adc_round[2] + (chip_sent ? 3 : 0));
+            host_adc_push_round(adc_round, 3);
+        }
+        host_clock_advance_ms(wait_ms > 0 ? (uint32_t)wait_ms : 1);
+    }
+    CHECK(per_topic[0] >= 4);
+    CHECK(per_topic[1] >= 3); // Quadro-chave e deltas do modo COMPRESS_DELTA
+    CHECK(per_topic[2] >= 20);
+    CHECK(verified == stream_published_total());
+    return verified;
+}
+
+int main(int argc, char **argv) {
+    const roundtrip_case_t *selected = NULL;
+    for (size_t i = 0; argc == 2 && i < sizeof(cases) / sizeof(cases[0]); i++) {
+        if (strcmp(argv[1], cases[i].name) == 0) {
+            selected = &cases[i];
+        }
+    }
+    if (selected == NULL) {
+        fprintf(stderr, "uso: %s <plain|xor|hmac|aes|chacha|mixed|streams>\n", argv[0]);
+        return 2;
+    }
+    const app_mode_t *publisher = find_mode(publisher_modes, publisher_mode_count, selected->publisher_label);
+    const app_mode_t *subscriber = find_mode(subscriber_modes, subscriber_mode_count, selected->subscriber_label);
+    CHECK(publisher->encode != NULL && subscriber->decode != NULL);
+
+    host_clock_freeze(1000000);
+    CHECK(key_manager_init());
+    publisher_boot();
+    subscriber_boot();
+    fake_mqtt_set_connected(true);
+    subscriber_connected();
+    fake_mqtt_clear(); // Ping da sincronização de relógio
+
+    if (publisher->init != NULL) {
+        publisher->init();
+    }
+    if (subscriber->init != NULL) {
+        subscriber->init();
+    }
+    mqtt_comm_set_message_handler(subscriber->decode);
+    // Os streams extras só são assinados no modo automático
+    CHECK(fake_mqtt_is_subscribed(MQTT_TOPIC_SENSORS "/#") == (strcmp(subscriber->label, "Automatico (todos)") == 0));
+    uint32_t verified;
+    if (strcmp(selected->name, "streams") == 0) {
+        verified = run_streams(publisher);
+    } else {
+        uint32_t messages = strcmp(selected->name, "mixed") == 0 ? MIXED_MODE_MESSAGES : SINGLE_MODE_MESSAGES;
+        verified = run_readings(publisher, messages);
+        CHECK(verified == messages);
+    }
+    if (publisher->teardown != NULL) {
+        publisher->teardown();
+    }
+    if (subscriber->teardown != NULL) {
+        subscriber->teardown();
+    }
+    CHECK(!fake_mqtt_is_subscribed(MQTT_TOPIC_SENSORS "/#"));
+    CHECK(prefilter_rejected_total() == 0);
+    printf("%s: %lu mensagens conferidas\n", selected->name, (unsigned long)verified);
+    CHECK_EXIT();
+}
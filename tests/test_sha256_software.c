@@ -0,0 +1,68 @@
+/*
+ * Caminho em software do sha256_backend (o único fora do RP2350): vetores do RFC 4231 e
+ * de 1 KB de include/sha256_vectors.h pelo hmac_sha256, o hash em pedaços de qualquer
+ * tamanho contra o hash de uma vez e o autoteste do boot.
+ */
+
+#include "include/sha256_backend.h"
+#include "include/sha256_vectors.h"
+#include "check.h"
+
+// SHA-256("abc"), FIPS 180-2, apêndice B.1
+static const uint8_t digest_abc[SHA256_DIGEST_LEN] = {
+    0xba, 0x78, 0x16, 0xbf, 0x8f, 0x01, 0xcf, 0xea, 0x41, 0x41, 0x40, 0xde, 0x5d, 0xae, 0x22, 0x23,
+    0xb0, 0x03, 0x61, 0xa3, 0x96, 0x17, 0x7a, 0x9c, 0xb4, 0x10, 0xff, 0x61, 0xf2, 0x00, 0x15, 0xad};
+
+static uint8_t message[SHA256_VECTOR_1K_LEN];
+
+static void hash_in_chunks(size_t chunk, uint8_t out[SHA256_DIGEST_LEN]) {
+    sha256_backend_ctx_t ctx;
+    CHECK(sha256_backend_start_with(&ctx, SHA256_BACKEND_SOFTWARE, sizeof(message)) == 0);
+    for (size_t off = 0; off < sizeof(message); off += chunk) {
+        size_t len = sizeof(message) - off < chunk ? sizeof(message) - off : chunk;
+        CHECK(sha256_backend_update(&ctx, message + off, len) == 0);
+    }
+    CHECK(sha256_backend_finish(&ctx, out) == 0);
+}
+
+int main(void) {
+    uint8_t out[SHA256_DIGEST_LEN];
+    sha256_backend_ctx_t ctx;
+
+    // Sem acelerador, o backend automático escolhe o software
+    CHECK(sha256_backend_start_with(&ctx, SHA256_BACKEND_HARDWARE, 64) == -1);
+    CHECK(sha256_backend_start(&ctx, 3) == 0);
+    CHECK(ctx.backend == SHA256_BACKEND_SOFTWARE);
+    CHECK(sha256_backend_update(&ctx, (const uint8_t *)"abc", 3) == 0);
+    CHECK(sha256_backend_finish(&ctx, out) == 0);
+    CHECK(memcmp(out, digest_abc, SHA256_DIGEST_LEN) == 0);
+
+    for (size_t v = 0; v < SHA256_RFC4231_VECTOR_COUNT; v++) {
+        const hmac_vector_t *vec = &sha256_rfc4231_vectors[v];
+        CHECK(hmac_sha256(vec->key, vec->key_len, (const uint8_t *)vec->msg, strlen(vec->msg), out) == 0);
+        if (memcmp(out, vec->expected, SHA256_DIGEST_LEN) != 0) {
+            fprintf(stderr, "vetor %u do RFC 4231 difere\n", (unsigned)v);
+            check_failures++;
+        }
+    }
+
+    sha256_vector_fill_1k(message);
+    CHECK(hmac_sha256((const uint8_t *)sha256_vector_1k_key, strlen(sha256_vector_1k_key), message,
+                      sizeof(message), out) == 0);
+    CHECK(memcmp(out, sha256_vector_1k_expected, SHA256_DIGEST_LEN) == 0);
+
+    // Pedaços que atravessam a fronteira do bloco de 64 B em pontos diferentes
+    static const size_t chunks[] = {1, 7, 63, 64, 65, 333, SHA256_VECTOR_1K_LEN};
+    uint8_t whole[SHA256_DIGEST_LEN];
+    hash_in_chunks(SHA256_VECTOR_1K_LEN, whole);
+    for (size_t c = 0; c < sizeof(chunks) / sizeof(chunks[0]); c++) {
+        hash_in_chunks(chunks[c], out);
+        if (memcmp(out, whole, SHA256_DIGEST_LEN) != 0) {
+            fprintf(stderr, "hash em pedacos de %u B difere\n", (unsigned)chunks[c]);
+            check_failures++;
+        }
+    }
+
+    CHECK(sha256_backend_selftest());
+    CHECK_EXIT();
+}
@@ -0,0 +1,183 @@
+#!/usr/bin/env python3
+"""Teste de estresse do pré-filtro do subscriber: inunda o tópico com mensagens falsas.
+
+Uso:
+    python3 tools/flood_stress.py <broker> [--rate 50000] [--duration 10] [--serial /dev/ttyACM0]
+
+Gera uma mistura de mensagens que o subscriber deve recusar sem gastar CPU com
+criptografia (src/prefilter.c):
+    curta     - menor que cabeçalho + tag
+    grande    - maior que o buffer de payload do mqtt_comm (descartada antes do handler)
+    tipo      - primeiro byte com versão/AEAD inválidos
+    lixo      - cabeçalho AEAD válido para o tópico, remetente aleatório e tag aleatória
+    replay    - cópia de um frame legítimo capturado (com --capture)
+Os pacotes PUBLISH são codificados uma vez e enviados em lotes a cada 10 ms para
+sustentar a taxa pedida. Durante a inundação, uma sonda publica em <tópico>/sonda e
+mede o tempo de ida e volta pelo broker (fila do broker sob carga).
+Com --serial (requer pyserial), envia 'p' ao console do subscriber antes e depois e
+imprime as recusas por motivo, a CPU nos handlers e a latência local das mensagens
+legítimas aceitas durante a inundação. Sem --serial, digite 'p' manualmente.
+"""
+import argparse
+import os
+import random
+import socket
+import struct
+import sys
+import threading
+import time
+
+sys.path.insert(0, os.path.dirname(os.path.abspath(__file__)))
+from mqtt_lite import MqttLite, encode_string, packet  # noqa: E402
+
+FRAME_VERSION = 1
+FRAME_HEADER_LEN = 17  # [tipo 1][remetente 4][boot 4][contador 4][hash do tópico 4]
+FRAME_TAG_LEN = 16
+PAYLOAD_BUFFER = 256   # payload_buffer do src/mqtt_comm.c
+BATCH_INTERVAL = 0.01
+
+
+def topic_hash(topic):
+    """FNV-1a de 32 bits, igual a frame_topic_hash()."""
+    h = 2166136261
+    for byte in topic.encode():
+        h ^= byte
+        h = (h * 16777619) & 0xFFFFFFFF
+    return h
+
+
+def bogus_payloads(topic, captured, count):
+    kinds = ["curta", "grande", "tipo", "lixo"] + (["replay"] if captured else [])
+    out = []
+    for i in range(count):
+        kind = kinds[i % len(kinds)]
+        if kind == "curta":
+            payload = os.urandom(random.randint(1, FRAME_HEADER_LEN + FRAME_TAG_LEN - 1))
+        elif kind == "grande":
+            payload = os.urandom(PAYLOAD_BUFFER + random.randint(0, 64))
+        elif kind == "tipo":
+            payload = bytes([0xF0 | random.randint(0, 15)]) + os.urandom(40)
+        elif kind == "lixo":
+            aead = random.choice((1, 2))
+            payload = bytes([(FRAME_VERSION << 4) | aead]) + os.urandom(12) + \
+                struct.pack("!I", topic_hash(topic)) + os.urandom(FRAME_TAG_LEN + 12)
+        else:
+            payload = captured
+        out.append(packet(3, 0, encode_string(topic) + payload))
+    return out
+
+
+def capture_frame(client, topic):
+    client.subscribe(topic)
+    print("Aguardando um frame legitimo em %s para o replay..." % topic)
+    while True:
+        _, frame = client.read_publish()
+        if len(frame) > FRAME_HEADER_LEN + FRAME_TAG_LEN and frame[0] >> 4 == FRAME_VERSION:
+            return frame
+
+
+def probe_loop(args, stop, results):
+    """Publica sondas com o instante de envio e mede a volta pelo broker."""
+    client = MqttLite(args.broker, args.port, "flood-sonda", args.user, args.password)
+    probe_topic = args.topic + "/sonda"
+    client.subscribe(probe_topic)
+    client.sock.settimeout(2.0)
+    while not stop.is_set():
+        sent = time.monotonic()
+        client.publish(probe_topic, struct.pack("!d", sent))
+        try:
+            while True:
+                _, payload = client.read_publish()
+                if len(payload) == 8 and struct.unpack("!d", payload)[0] == sent:
+                    results.append((time.monotonic() - sent) * 1000.0)
+                    break
+        except socket.timeout:
+            results.append(None)
+        stop.wait(0.1)
+    client.close()
+
+
+def serial_stats(port):
+    """Envia 'p' ao console do subscriber e retorna as linhas impressas."""
+    import serial  # pyserial, só necessário com --serial
+    with serial.Serial(port, 115200, timeout=0.5) as console:
+        console.reset_input_buffer()
+        console.write(b"p")
+        lines = []
+        while True:
+            line = console.readline()
+            if not line:
+                return lines
+            lines.append(line.decode(errors="replace").rstrip())
+
+
+def percentile(values, p):
+    ordered = sorted(values)
+    return ordered[min(len(ordered) - 1, int(len(ordered) * p / 100))]
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("broker")
+    parser.add_argument("--port", type=int, default=1883)
+    parser.add_argument("--user", default="aluno")
+    parser.add_argument("--password", default="senha123")
+    parser.add_argument("--topic", default="escola/sala1/temperatura")
+    parser.add_argument("--rate", type=float, default=50000.0, help="mensagens falsas por segundo")
+    parser.add_argument("--duration", type=float, default=10.0, help="segundos de inundação")
+    parser.add_argument("--capture", action="store_true", help="inclui replays de um frame AEAD capturado")
+    parser.add_argument("--serial", help="porta serial do subscriber para ler o comando 'p'")
+    args = parser.parse_args()
+
+    flooder = MqttLite(args.broker, args.port, "flood-stress", args.user, args.password)
+    captured = capture_frame(flooder, args.topic) if args.capture else None
+    packets = bogus_payloads(args.topic, captured, 4096)
+
+    if args.serial:
+        serial_stats(args.serial)  # Zera a janela de CPU e latência do subscriber
+
+    stop = threading.Event()
+    probes = []
+    prober = threading.Thread(target=probe_loop, args=(args, stop, probes), daemon=True)
+    prober.start()
+
+    per_batch = max(1, int(args.rate * BATCH_INTERVAL))
+    print("Inundando %s: %.0f msg/s por %.0f s (%d por lote)" % (args.topic, args.rate, args.duration, per_batch))
+    sent = 0
+    index = 0
+    start = time.monotonic()
+    next_batch = start
+    while time.monotonic() - start < args.duration:
+        batch = bytearray()
+        for _ in range(per_batch):
+            batch += packets[index]
+            index = (index + 1) % len(packets)
+        flooder.sock.sendall(batch)
+        sent += per_batch
+        next_batch += BATCH_INTERVAL
+        delay = next_batch - time.monotonic()
+        if delay > 0:
+            time.sleep(delay)
+    elapsed = time.monotonic() - start
+    stop.set()
+    prober.join()
+    flooder.close()
+
+    print("Enviadas %d mensagens falsas em %.1f s (%.0f/s efetivos)" % (sent, elapsed, sent / elapsed))
+    answered = [p for p in probes if p is not None]
+    if answered:
+        print("Sondas pelo broker: %d/%d respondidas, p50 %.1f ms, p99 %.1f ms, max %.1f ms" % (
+            len(answered), len(probes), percentile(answered, 50), percentile(answered, 99), max(answered)))
+    else:
+        print("Nenhuma sonda respondida (%d enviadas)" % len(probes))
+
+    if args.serial:
+        print("Subscriber (comando 'p') durante a inundacao:")
+        for line in serial_stats(args.serial):
+            print("  " + line)
+    else:
+        print("Digite 'p' no terminal serial do subscriber para ver recusas, CPU e latencia das aceitas.")
+
+
+if __name__ == "__main__":
+    main()
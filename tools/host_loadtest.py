@@ -0,0 +1,231 @@
+#!/usr/bin/env python3
+"""Carga de ponta a ponta no subscriber do firmware, sem placa.
+
+Uso:
+    python3 tools/host_loadtest.py <host_subscriber> [--rate 8] [--duration 4]
+                                   [--drop 0.05] [--dup 0.1] [--reorder 0.1] [--jitter 50] [--seed 7]
+    python3 tools/host_loadtest.py --loopback <host_loopback> [--delay 2] [--jitter 3]
+
+Sobe o tools/mini_broker.py numa porta livre, com as falhas pedidas no tópico dos modos,
+liga o host_subscriber do build de host (src/subscriber_modes.c e src/mqtt_comm.c sobre
+o cliente de sockets de tests/shims/host_mqtt.c) e publica com o tools/load_gen.py no
+modo intercalado. No fim, cruza as contagens do broker com as do pré-filtro:
+    - toda mensagem que o broker entregou chegou a um handler do mqtt_comm;
+    - toda mensagem que chegou foi aceita ou recusada por um motivo do pré-filtro;
+    - nada é recusado por tamanho, cabeçalho, taxa, tag ou formato;
+    - sem falhas, todas as enviadas são aceitas;
+    - com falhas, cada duplicata vira um replay e só se perdem as descartadas pelo broker
+      e, no máximo, uma por mensagem reordenada (a retida chega depois da seguinte).
+A taxa padrão fica abaixo de PREFILTER_RATE_PER_S, para a cota não entrar na conta.
+
+Com --loopback, o executável é o host_loopback (src/loopback.c sobre o mesmo cliente):
+o broker atrasa as mensagens do tópico de loopback (--delay/--jitter) e cada modo faz a
+volta completa frame_encode -> broker -> frame_open/mac_verify/numfmt. Confere que o
+host_loopback saiu sem falhas e que o broker atrasou todas as rodadas pelo broker.
+Sai com 1 se alguma conferência falhar (no CTest: host_loadtest_* e host_loopback).
+"""
+import argparse
+import os
+import re
+import signal
+import socket
+import subprocess
+import sys
+import threading
+import time
+
+TOOLS = os.path.dirname(os.path.abspath(__file__))
+BROKER_STATS = re.compile(r"recebidas (\d+), entregues (\d+), descartadas (\d+), duplicadas (\d+), "
+                          r"reordenadas (\d+), atrasadas (\d+)")
+PREFILTER_LINE = re.compile(r"^pre-filtro\s+(\S+)\s+(\d+)$")
+RX_LINE = re.compile(r"^mqtt: (\d+) mensagens entregues")
+SENT_LINE = re.compile(r"Enviadas (\d+) mensagens")
+REJECTIONS = ("tamanho", "cabecalho", "replay", "taxa", "tag", "formato")
+SETTLE_S = 3  # Mensagens retidas (--hold) e atrasadas depois do fim da carga
+STARTUP_TIMEOUT_S = 10
+LOOPBACK_TIMEOUT_S = 60
+LOOPBACK_ROUNDS = 5 * 100  # Modos x LOOPBACK_MESSAGES, só as rodadas pelo broker
+
+
+def free_port():
+    with socket.socket() as s:
+        s.bind(("127.0.0.1", 0))
+        return s.getsockname()[1]
+
+
+def wait_listening(port, timeout):
+    deadline = time.monotonic() + timeout
+    while time.monotonic() < deadline:
+        try:
+            socket.create_connection(("127.0.0.1", port), 0.2).close()
+            return True
+        except OSError:
+            time.sleep(0.05)
+    return False
+
+
+def restore_sigint():
+    # O CTest pode rodar em segundo plano, com SIGINT ignorado: o broker precisa dele
+    signal.signal(signal.SIGINT, signal.SIG_DFL)
+
+
+class LineReader:
+    """Guarda as linhas da saída de um processo e avisa quando aparece `marker`."""
+
+    def __init__(self, stream, marker=None):
+        self.lines = []
+        self.marker = marker
+        self.seen = threading.Event()
+        self.thread = threading.Thread(target=self.run, args=(stream,), daemon=True)
+        self.thread.start()
+
+    def run(self, stream):
+        for line in stream:
+            line = line.rstrip("\n")
+            self.lines.append(line)
+            if self.marker is not None and line == self.marker:
+                self.seen.set()
+
+    def text(self):
+        self.thread.join(5)
+        return "\n".join(self.lines)
+
+
+def check(results, condition, description):
+    results.append((condition, description))
+
+
+def start_broker(args, faults):
+    """Sobe o mini_broker numa porta livre com as falhas de `args` em `faults`."""
+    port = free_port()
+    broker = subprocess.Popen(
+        [sys.executable, os.path.join(TOOLS, "mini_broker.py"), "--host", "127.0.0.1", "--port", str(port),
+         "--faults", faults, "--drop", str(args.drop), "--dup", str(args.dup), "--reorder", str(args.reorder),
+         "--delay", str(args.delay), "--jitter", str(args.jitter), "--seed", str(args.seed), "--stats", "0"],
+        stdout=subprocess.PIPE, stderr=subprocess.STDOUT, text=True, preexec_fn=restore_sigint)
+    return broker, LineReader(broker.stdout), port
+
+
+def stop_broker(broker):
+    broker.send_signal(signal.SIGINT)  # Imprime as contagens finais e sai
+    try:
+        broker.wait(timeout=5)
+    except subprocess.TimeoutExpired:
+        broker.kill()
+
+
+def run_loopback(args):
+    broker, broker_out, port = start_broker(args, "escola/sala1/loopback")
+    try:
+        if not wait_listening(port, STARTUP_TIMEOUT_S):
+            sys.exit("mini_broker nao subiu na porta %d" % port)
+        loopback = subprocess.run([args.program, str(port)], stdout=subprocess.PIPE, stderr=subprocess.STDOUT,
+                                  text=True, timeout=LOOPBACK_TIMEOUT_S)
+    finally:
+        stop_broker(broker)
+    print(loopback.stdout, end="")
+    stats_match = list(BROKER_STATS.finditer(broker_out.text()))
+    if not stats_match:
+        sys.exit("saida inesperada do mini_broker")
+    print("mini_broker: " + stats_match[-1].group(0))
+    _, delivered, _, _, _, delayed = (int(v) for v in stats_match[-1].groups())
+
+    results = []
+    check(results, loopback.returncode == 0, "host_loopback sem falhas de decodificacao nem perdas")
+    check(results, delivered >= LOOPBACK_ROUNDS, "o broker devolveu todas as rodadas")
+    if args.delay > 0 or args.jitter > 0:
+        check(results, delayed >= LOOPBACK_ROUNDS, "todas as rodadas pelo broker atrasadas")
+    return results
+
+
+def run_subscriber(args):
+    broker, broker_out, port = start_broker(args, "escola/sala1/temperatura")
+    subscriber = None
+    try:
+        if not wait_listening(port, STARTUP_TIMEOUT_S):
+            sys.exit("mini_broker nao subiu na porta %d" % port)
+        seconds = int(args.duration + SETTLE_S + 1)
+        subscriber = subprocess.Popen([args.program, str(port), str(seconds)],
+                                      stdout=subprocess.PIPE, stderr=subprocess.STDOUT, text=True)
+        subscriber_out = LineReader(subscriber.stdout, "pronto")
+        if not subscriber_out.seen.wait(STARTUP_TIMEOUT_S):
+            subscriber.kill()
+            sys.exit("host_subscriber nao ficou pronto:\n" + subscriber_out.text())
+
+        load = subprocess.run(
+            [sys.executable, os.path.join(TOOLS, "load_gen.py"), "127.0.0.1", "--port", str(port),
+             "--mode", "mixed", "--rate", str(args.rate), "--duration", str(args.duration)],
+            stdout=subprocess.PIPE, stderr=subprocess.STDOUT, text=True, timeout=args.duration + 30)
+        print(load.stdout, end="")
+        subscriber.wait(timeout=seconds + 30)
+    finally:
+        if subscriber is not None and subscriber.poll() is None:
+            subscriber.kill()
+        stop_broker(broker)
+
+    sub_text = subscriber_out.text()
+    broker_text = broker_out.text()
+    sent_match = SENT_LINE.search(load.stdout)
+    stats_match = list(BROKER_STATS.finditer(broker_text))
+    prefilter = {}
+    rx_messages = None
+    for line in sub_text.splitlines():
+        m = PREFILTER_LINE.match(line)
+        if m:
+            prefilter[m.group(1)] = int(m.group(2))
+        m = RX_LINE.match(line)
+        if m:
+            rx_messages = int(m.group(1))
+    if load.returncode != 0 or not sent_match or not stats_match or rx_messages is None or not prefilter:
+        print(broker_text)
+        print(sub_text)
+        sys.exit("saida inesperada do load_gen, do mini_broker ou do host_subscriber")
+
+    sent = int(sent_match.group(1))
+    _, delivered, dropped, duplicated, reordered, _ = (int(v) for v in stats_match[-1].groups())
+    accepted = prefilter["aceitas"]
+    rejected = sum(prefilter[name] for name in REJECTIONS)
+    print("mini_broker: " + stats_match[-1].group(0))
+    print("load_gen: %d enviadas; subscriber: %d entregues ao handler, %d aceitas, %s" % (
+        sent, rx_messages, accepted, ", ".join("%s %d" % (n, prefilter[n]) for n in REJECTIONS)))
+
+    results = []
+    check(results, rx_messages == delivered, "entregues pelo broker == entregues aos handlers")
+    check(results, accepted + rejected == rx_messages, "aceitas + recusadas == entregues aos handlers")
+    for name in ("tamanho", "cabecalho", "taxa", "tag", "formato"):
+        check(results, prefilter[name] == 0, "nenhuma recusa por %s" % name)
+    check(results, accepted <= sent - dropped, "aceitas <= enviadas - descartadas")
+    check(results, accepted >= sent - dropped - reordered, "aceitas >= enviadas - descartadas - reordenadas")
+    check(results, prefilter["replay"] >= duplicated, "cada duplicata recusada como replay")
+    if args.drop == 0 and args.dup == 0 and args.reorder == 0:
+        check(results, accepted == sent, "sem falhas, todas as enviadas aceitas")
+    if not all(ok for ok, _ in results):
+        print(sub_text)
+    return results
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("program", help="executável host_subscriber (ou host_loopback, com --loopback)")
+    parser.add_argument("--loopback", action="store_true", help="roda o host_loopback em vez da carga")
+    parser.add_argument("--rate", type=float, default=8.0, help="mensagens por segundo do load_gen")
+    parser.add_argument("--duration", type=float, default=4.0, help="segundos de carga")
+    parser.add_argument("--drop", type=float, default=0.0)
+    parser.add_argument("--dup", type=float, default=0.0)
+    parser.add_argument("--reorder", type=float, default=0.0)
+    parser.add_argument("--delay", type=float, default=0.0, help="ms de atraso fixo do broker")
+    parser.add_argument("--jitter", type=float, default=0.0, help="ms; abaixo do intervalo entre mensagens")
+    parser.add_argument("--seed", type=int, default=1)
+    args = parser.parse_args()
+
+    results = run_loopback(args) if args.loopback else run_subscriber(args)
+    failed = [description for ok, description in results if not ok]
+    for description in failed:
+        print("FALHOU: " + description)
+    if failed:
+        sys.exit(1)
+    print("ok (%d conferencias)" % len(results))
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,294 @@
+#!/usr/bin/env python3
+"""Gerador de carga: publica frames válidos de qualquer modo a uma taxa controlada.
+
+Uso:
+    python3 tools/load_gen.py <broker> [--mode aes] [--rate 100] [--duration 10] [--ts-base 0] [--check]
+    python3 tools/load_gen.py --dump frames.txt [--mode mixed] [--rate 10] [--duration 5]
+
+Monta as mensagens como o publisher (src/frame.c), com as chaves derivadas de
+KEY_MASTER_SECRET e KEY_HKDF_SALT lidos de config/credentials.h:
+    plain    - [tipo] "26.5,<timestamp>"
+    xor      - [tipo] [texto ^ chave XOR da sessão]
+    hmac     - [tipo] [HMAC-SHA256 (32)] [texto]    (entrada padrão da tabela do src/mac.c)
+    aes      - frame AEAD AES-GCM        (requer o pacote cryptography)
+    chacha   - frame AEAD ChaCha20-Poly1305 (requer o pacote cryptography)
+    mixed    - um modo diferente a cada mensagem, como o modo intercalado do publisher
+O timestamp imita o da placa: µs desde o início da execução, somados a --ts-base.
+Nos modos plain, xor e hmac, o subscriber guarda um único último timestamp para
+todos os publishers. Por isso a carga disputa a janela de replay com o publisher real:
+enquanto os dois rodam, as mensagens de quem está atrás são recusadas como replay.
+Com --ts-base 0, a carga só passa se nenhum publisher com mais tempo de boot tiver
+publicado desde o boot do subscriber; para entrar na frente de um publisher ligado, use
+o tempo de boot dele (em µs) ou mais. Quando a carga para, o publisher volta a ser aceito
+assim que o relógio dele passa o último timestamp da carga. --ts-base epoch usa o
+relógio do computador desde a época: a carga sempre passa, mas o publisher real fica
+recusado como replay até o subscriber reiniciar. A latência de ponta a ponta da placa
+('y') só faz sentido com o publisher real. Os frames AEAD não usam esse timestamp para
+replay: usam o remetente --sender e um boot novo a cada execução.
+
+Com --dump ARQUIVO, nada é publicado: os frames de --rate x --duration mensagens vão
+para o arquivo, uma por linha ("modo timestamp hex"), na hora e sem broker. O
+tests/test_frame_crosscheck.c os abre com frame_open, mac_verify e numfmt do firmware
+e compara os modos determinísticos com os de frame_encode, byte a byte.
+
+Com --check, uma segunda conexão assina o tópico, abre os próprios frames e mede, pelo
+broker: perdas, duplicatas, fora de ordem e latência (p50/p99/máx). Assim o
+tools/mini_broker.py e suas falhas podem ser verificados sem placa.
+"""
+import argparse
+import hashlib
+import hmac
+import os
+import re
+import socket
+import struct
+import sys
+import threading
+import time
+
+sys.path.insert(0, os.path.dirname(os.path.abspath(__file__)))
+from mqtt_lite import MqttLite  # noqa: E402
+
+FRAME_VERSION = 1
+KIND = {"aes": 1, "chacha": 2, "plain": 3, "xor": 4, "hmac": 5}
+MIXED_ORDER = ("plain", "xor", "hmac", "aes", "chacha")  # mixed_kinds do src/publisher_modes.c
+HMAC_TAG_LEN = 32
+FRAME_HEADER_LEN = 17  # [tipo 1][remetente 4][boot 4][contador 4][hash do tópico 4]
+FRAME_TAG_LEN = 16
+BATCH_INTERVAL = 0.01
+CREDENTIALS = os.path.join(os.path.dirname(os.path.abspath(__file__)), "..", "config", "credentials.h")
+
+
+def read_defines(path):
+    """#define NOME "texto" do cabeçalho, como dicionário."""
+    with open(path, encoding="utf-8") as f:
+        return dict(re.findall(r'^#define\s+(\w+)\s+"([^"]*)"', f.read(), re.MULTILINE))
+
+
+def topic_hash(topic):
+    """FNV-1a de 32 bits, igual a frame_topic_hash()."""
+    h = 2166136261
+    for byte in topic.encode():
+        h ^= byte
+        h = (h * 16777619) & 0xFFFFFFFF
+    return h
+
+
+class Session:
+    """Chaves de uma sessão, derivadas como em derive_slot() do src/key_manager.c."""
+
+    def __init__(self, secret, salt, session_id):
+        prk = hmac.new(salt.encode(), secret.encode(), hashlib.sha256).digest()
+
+        def derive(label):
+            info = label.encode() + struct.pack("!I", session_id) + b"\x01"
+            return hmac.new(prk, info, hashlib.sha256).digest()
+
+        self.xor_key = derive("xor")[0] | 0x01
+        self.hmac_key = derive("hmac")
+        self.aead = {}
+        try:
+            from cryptography.hazmat.primitives.ciphers.aead import AESGCM, ChaCha20Poly1305
+        except ImportError:
+            return  # Só os modos sem AEAD (ver main)
+        self.aead["aes"] = AESGCM(derive("aes"))
+        self.aead["chacha"] = ChaCha20Poly1305(derive("chacha"))
+
+
+class Clock:
+    """Timestamps da carga: µs desde o início somados à base, ou o relógio do computador."""
+
+    def __init__(self, base):
+        self.start_us = time.time_ns() // 1000
+        self.base = self.start_us if base == "epoch" else int(base)
+
+    def now(self):
+        return time.time_ns() // 1000 - self.start_us + self.base
+
+
+class Codec:
+    def __init__(self, session, topic, sender, boot):
+        self.session = session
+        self.topic = topic
+        self.topic_hash = struct.pack("!I", topic_hash(topic))
+        self.sender = sender
+        self.boot = boot
+        self.counter = 0
+
+    def encode(self, mode, text):
+        kind = bytes([(FRAME_VERSION << 4) | KIND[mode]])
+        if mode == "plain":
+            return kind + text
+        if mode == "xor":
+            return kind + bytes(b ^ self.session.xor_key for b in text)
+        if mode == "hmac":
+            return kind + hmac.new(self.session.hmac_key, text, hashlib.sha256).digest()[:HMAC_TAG_LEN] + text
+        self.counter += 1
+        header = kind + struct.pack("!III", self.sender, self.boot, self.counter) + self.topic_hash
+        sealed = self.session.aead[mode].encrypt(header[1:13], text, header)  # ciphertext || tag
+        return header + sealed[-FRAME_TAG_LEN:] + sealed[:-FRAME_TAG_LEN]
+
+    def decode(self, frame):
+        """Texto de um frame gerado por encode(), ou None."""
+        modes = {v: k for k, v in KIND.items()}
+        if not frame or frame[0] >> 4 != FRAME_VERSION or (frame[0] & 0x0F) not in modes:
+            return None
+        mode = modes[frame[0] & 0x0F]
+        body = frame[1:]
+        if mode == "plain":
+            return body
+        if mode == "xor":
+            return bytes(b ^ self.session.xor_key for b in body)
+        if mode == "hmac":
+            return body[HMAC_TAG_LEN:]
+        if len(frame) < FRAME_HEADER_LEN + FRAME_TAG_LEN:
+            return None
+        header = frame[:FRAME_HEADER_LEN]
+        tag = frame[FRAME_HEADER_LEN:FRAME_HEADER_LEN + FRAME_TAG_LEN]
+        if mode not in self.session.aead:
+            return None
+        try:
+            return self.session.aead[mode].decrypt(header[1:13], frame[FRAME_HEADER_LEN + FRAME_TAG_LEN:] + tag, header)
+        except Exception:  # InvalidTag: frame de outro remetente ou de outra sessão
+            return None
+
+
+def percentile(values, p):
+    ordered = sorted(values)
+    return ordered[min(len(ordered) - 1, int(len(ordered) * p / 100))]
+
+
+def check_loop(args, codec, clock, ready, stop, results):
+    """Assina o tópico e registra o timestamp e a latência de cada frame próprio recebido."""
+    client = MqttLite(args.broker, args.port, "load-gen-check", args.user, args.password)
+    client.subscribe(args.topic)
+    client.sock.settimeout(0.2)
+    ready.set()
+    while not stop.is_set():
+        try:
+            _, frame = client.read_publish()
+        except socket.timeout:
+            continue
+        now_us = clock.now()
+        text = codec.decode(frame)
+        if text is None or b"," not in text:
+            continue
+        try:
+            timestamp = int(text.rsplit(b",", 1)[1])
+        except ValueError:
+            continue
+        results.append((timestamp, now_us - timestamp))
+    client.close()
+
+
+def report_check(sent, received):
+    timestamps = [ts for ts, _ in received]
+    unique = set(timestamps)
+    sent_set = set(sent)
+    out_of_order = sum(1 for a, b in zip(timestamps, timestamps[1:]) if b < a)
+    print("Pelo broker: %d recebidas, %d perdidas, %d duplicadas, %d fora de ordem" % (
+        len(received), len(sent_set - unique), len(timestamps) - len(unique), out_of_order))
+    latencies = [lat / 1000.0 for _, lat in received]
+    if latencies:
+        print("Latencia: p50 %.2f ms, p99 %.2f ms, max %.2f ms" % (
+            percentile(latencies, 50), percentile(latencies, 99), max(latencies)))
+
+
+def next_timestamp(clock, sent):
+    timestamp = clock.now()
+    if sent and timestamp <= sent[-1]:
+        timestamp = sent[-1] + 1  # O subscriber exige timestamps crescentes
+    return timestamp
+
+
+def dump_frames(args, codec, clock, modes):
+    """Grava os frames em vez de publicá-los (ver --dump)."""
+    sent = []
+    with open(args.dump, "w", encoding="ascii") as f:
+        f.write("# modo timestamp frame (hex); topico %s, sessao %d\n" % (args.topic, args.session))
+        for i in range(int(args.rate * args.duration)):
+            mode = modes[i % len(modes)]
+            timestamp = next_timestamp(clock, sent)
+            frame = codec.encode(mode, ("%s,%d" % (args.value, timestamp)).encode())
+            f.write("%s %d %s\n" % (mode, timestamp, frame.hex()))
+            sent.append(timestamp)
+    print("Gravados %d frames em %s" % (len(sent), args.dump))
+
+
+def main():
+    credentials = read_defines(CREDENTIALS)
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("broker", nargs="?")
+    parser.add_argument("--port", type=int, default=1883)
+    parser.add_argument("--user", default=credentials.get("MQTT_USER"))
+    parser.add_argument("--password", default=credentials.get("MQTT_PASS"))
+    parser.add_argument("--topic", default=credentials.get("MQTT_TOPIC_SUBSCRIBE"))
+    parser.add_argument("--mode", choices=sorted(KIND) + ["mixed"], default="mixed")
+    parser.add_argument("--rate", type=float, default=100.0, help="mensagens por segundo")
+    parser.add_argument("--duration", type=float, default=10.0, help="segundos de carga")
+    parser.add_argument("--session", type=int, default=0, help="sessão de chaves (ver 'k' no console)")
+    parser.add_argument("--sender", type=lambda s: int(s, 0), default=0x4C4F4144, help="remetente dos frames AEAD")
+    parser.add_argument("--value", default="26.5", help="leitura antes do timestamp")
+    parser.add_argument("--ts-base", default="0",
+                        help="µs somados aos timestamps (ex.: tempo de boot do publisher), ou epoch")
+    parser.add_argument("--check", action="store_true", help="assina o tópico e confere a entrega pelo broker")
+    parser.add_argument("--dump", metavar="ARQUIVO", help="grava os frames no arquivo em vez de publicar")
+    args = parser.parse_args()
+    if args.broker is None and args.dump is None:
+        parser.error("informe o broker ou --dump")
+    if args.ts_base != "epoch" and not args.ts_base.isdigit():
+        parser.error("--ts-base deve ser um inteiro de µs ou epoch")
+
+    session = Session(credentials["KEY_MASTER_SECRET"], credentials["KEY_HKDF_SALT"], args.session)
+    codec = Codec(session, args.topic, args.sender, int(time.time()))
+    modes = MIXED_ORDER if args.mode == "mixed" else (args.mode,)
+    if not session.aead:
+        if args.mode in ("aes", "chacha"):
+            sys.exit("O modo %s requer o pacote cryptography (pip install cryptography)" % args.mode)
+        if args.mode == "mixed":
+            modes = tuple(m for m in modes if m not in ("aes", "chacha"))
+            print("Sem o pacote cryptography: intercalando so os modos sem AEAD")
+
+    clock = Clock(args.ts_base)
+    if args.dump:
+        dump_frames(args, codec, clock, modes)
+        return
+    stop = threading.Event()
+    received = []
+    checker = None
+    if args.check:
+        ready = threading.Event()
+        checker = threading.Thread(target=check_loop, args=(args, codec, clock, ready, stop, received), daemon=True)
+        checker.start()
+        ready.wait(5.0)
+
+    client = MqttLite(args.broker, args.port, "load-gen", args.user, args.password)
+    per_batch = max(1, int(args.rate * BATCH_INTERVAL))
+    interval = per_batch / args.rate
+    print("Publicando %s em %s: %.0f msg/s por %.0f s" % ("/".join(modes), args.topic, args.rate, args.duration))
+    sent = []
+    start = time.monotonic()
+    next_batch = start
+    while time.monotonic() - start < args.duration:
+        for _ in range(per_batch):
+            timestamp = next_timestamp(clock, sent)
+            text = ("%s,%d" % (args.value, timestamp)).encode()
+            client.publish(args.topic, codec.encode(modes[len(sent) % len(modes)], text))
+            sent.append(timestamp)
+        next_batch += interval
+        delay = next_batch - time.monotonic()
+        if delay > 0:
+            time.sleep(delay)
+    elapsed = time.monotonic() - start
+    client.close()
+    print("Enviadas %d mensagens em %.1f s (%.0f/s efetivos)" % (len(sent), elapsed, len(sent) / elapsed))
+
+    if checker is not None:
+        time.sleep(1.0)  # Mensagens atrasadas ou retidas pelo broker
+        stop.set()
+        checker.join()
+        report_check(sent, received)
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,368 @@
+#!/usr/bin/env python3
+"""Broker MQTT 3.1.1 mínimo, sem dependências, com injeção de falhas na entrega.
+
+Uso:
+    python3 tools/mini_broker.py [--port 1883] [--drop 0.05] [--dup 0.02] [--reorder 0.05]
+                                 [--delay 20] [--jitter 10] [--faults 'escola/sala1/temperatura']
+
+Substitui o Mosquitto de MQTT_BROKER_IP nos testes locais: aponte MQTT_BROKER_IP
+(config/credentials.h) para o IP do computador, com MQTT_BROKER_PORT 1883 (sem TLS), ou
+rode tools/load_gen.py contra 127.0.0.1. Suporta CONNECT com usuário/senha (conferidos
+só com --user), will, SUBSCRIBE/UNSUBSCRIBE com + e #, mensagens retidas, PINGREQ e
+PUBLISH com QoS 0, 1 (PUBACK) e 2 (PUBREC/PUBCOMP). Toda entrega sai com QoS 0.
+
+As falhas valem por assinante, só para os tópicos que casam com --faults:
+    drop     - a mensagem não é entregue
+    dup      - a mensagem é entregue duas vezes
+    reorder  - a mensagem é retida e sai depois da próxima (ou após --hold ms)
+    delay    - atraso fixo de entrega, mais um atraso aleatório de até --jitter ms
+As mensagens retidas e os wills não passam pelas falhas. A cada --stats segundos e no
+Ctrl-C, imprime recebidas, entregues e as falhas aplicadas.
+"""
+import argparse
+import heapq
+import itertools
+import os
+import random
+import socket
+import socketserver
+import struct
+import sys
+import threading
+import time
+
+sys.path.insert(0, os.path.dirname(os.path.abspath(__file__)))
+from mqtt_lite import encode_string, packet  # noqa: E402
+
+CONNECT, CONNACK, PUBLISH, PUBACK, PUBREC, PUBREL, PUBCOMP = 1, 2, 3, 4, 5, 6, 7
+SUBSCRIBE, SUBACK, UNSUBSCRIBE, UNSUBACK, PINGREQ, PINGRESP, DISCONNECT = 8, 9, 10, 11, 12, 13, 14
+
+
+def topic_matches(pattern, topic):
+    """Filtro MQTT com + (um nível) e # (o resto, inclusive o nível pai)."""
+    if topic.startswith("$") and pattern[:1] in ("+", "#"):
+        return False
+    levels = topic.split("/")
+    parts = pattern.split("/")
+    for i, part in enumerate(parts):
+        if part == "#":
+            return True
+        if i >= len(levels) or (part != "+" and part != levels[i]):
+            return False
+    return len(parts) == len(levels)
+
+
+def read_string(body, offset):
+    length = struct.unpack("!H", body[offset:offset + 2])[0]
+    return body[offset + 2:offset + 2 + length], offset + 2 + length
+
+
+class Stats:
+    FIELDS = ("recebidas", "entregues", "descartadas", "duplicadas", "reordenadas", "atrasadas")
+
+    def __init__(self):
+        self.lock = threading.Lock()
+        self.counts = dict.fromkeys(self.FIELDS, 0)
+
+    def add(self, field, n=1):
+        with self.lock:
+            self.counts[field] += n
+
+    def line(self):
+        with self.lock:
+            return ", ".join("%s %d" % (name, self.counts[name]) for name in self.FIELDS)
+
+
+class Broker:
+    def __init__(self, args):
+        self.args = args
+        self.rng = random.Random(args.seed)
+        self.lock = threading.Lock()
+        self.clients = {}   # client_id -> ClientHandler
+        self.retained = {}  # tópico -> payload
+        self.stats = Stats()
+        self.timers = []    # heap de (instante, desempate, cliente, pacote)
+        self.timer_ids = itertools.count()
+        self.timer_cond = threading.Condition()
+        threading.Thread(target=self.timer_loop, daemon=True).start()
+
+    def schedule(self, due, client, data):
+        with self.timer_cond:
+            heapq.heappush(self.timers, (due, next(self.timer_ids), client, data))
+            self.timer_cond.notify()
+
+    def timer_loop(self):
+        while True:
+            with self.timer_cond:
+                while not self.timers or self.timers[0][0] > time.monotonic():
+                    timeout = self.timers[0][0] - time.monotonic() if self.timers else None
+                    self.timer_cond.wait(timeout)
+                _, _, client, data = heapq.heappop(self.timers)
+            if data is None:
+                client.release_held()
+            else:
+                client.send(data)
+
+    def register(self, client):
+        with self.lock:
+            old = self.clients.get(client.client_id)
+            self.clients[client.client_id] = client
+        if old is not None:
+            old.close()  # Mesmo client_id: a conexão nova assume a sessão
+
+    def unregister(self, client):
+        with self.lock:
+            if self.clients.get(client.client_id) is client:
+                del self.clients[client.client_id]
+
+    def publish(self, topic, payload, retain=False, faults=True):
+        self.stats.add("recebidas")
+        if retain:
+            with self.lock:
+                if payload:
+                    self.retained[topic] = payload
+                else:
+                    self.retained.pop(topic, None)
+        data = packet(PUBLISH, 0, encode_string(topic) + payload)
+        faulty = faults and topic_matches(self.args.faults, topic)
+        with self.lock:
+            targets = [c for c in self.clients.values() if c.subscribed(topic)]
+        for client in targets:
+            if faulty:
+                self.deliver_with_faults(client, data)
+            else:
+                client.send(data)
+
+    def deliver_with_faults(self, client, data):
+        args = self.args
+        with self.lock:  # Um só gerador aleatório, para --seed reproduzir a sequência
+            drop = self.rng.random() < args.drop
+            copies = 2 if self.rng.random() < args.dup else 1
+            hold = self.rng.random() < args.reorder
+            delay = (args.delay + self.rng.uniform(0, args.jitter)) / 1000.0
+        if drop:
+            self.stats.add("descartadas")
+            return
+        if copies > 1:
+            self.stats.add("duplicadas")
+        for _ in range(copies):
+            if hold and client.hold(data):
+                self.stats.add("reordenadas")
+                self.schedule(time.monotonic() + args.hold / 1000.0, client, None)
+                hold = False
+            elif delay > 0:
+                self.stats.add("atrasadas")
+                self.schedule(time.monotonic() + delay, client, data)
+            else:
+                client.send(data)
+
+    def retained_for(self, pattern):
+        with self.lock:
+            return [(t, p) for t, p in self.retained.items() if topic_matches(pattern, t)]
+
+
+class ClientHandler(socketserver.BaseRequestHandler):
+    def setup(self):
+        self.broker = self.server.broker
+        self.client_id = None
+        self.filters = set()
+        self.send_lock = threading.Lock()
+        self.held = None
+        self.will = None
+        self.closed = False
+
+    def send(self, data):
+        with self.send_lock:
+            if self.closed:
+                return
+            held, self.held = self.held, None
+            try:
+                self.request.sendall(data + (held or b""))
+            except OSError:
+                self.closed = True
+                return
+        delivered = (data[0] >> 4 == PUBLISH) + (held is not None)
+        if delivered:
+            self.broker.stats.add("entregues", delivered)
+
+    def hold(self, data):
+        """Retém uma mensagem para sair depois da próxima; False se já há uma retida."""
+        with self.send_lock:
+            if self.held is not None:
+                return False
+            self.held = data
+            return True
+
+    def release_held(self):
+        with self.send_lock:
+            held, self.held = self.held, None
+        if held is not None:
+            self.send(held)
+
+    def subscribed(self, topic):
+        return any(topic_matches(f, topic) for f in tuple(self.filters))
+
+    def close(self):
+        self.closed = True
+        try:
+            self.request.shutdown(socket.SHUT_RDWR)
+        except OSError:
+            pass
+
+    def read_exact(self, n):
+        data = bytearray()
+        while len(data) < n:
+            chunk = self.request.recv(n - len(data))
+            if not chunk:
+                raise ConnectionError
+            data += chunk
+        return bytes(data)
+
+    def read_packet(self):
+        first = self.read_exact(1)[0]
+        length, shift = 0, 0
+        while True:
+            byte = self.read_exact(1)[0]
+            length |= (byte & 0x7F) << shift
+            shift += 7
+            if not byte & 0x80:
+                break
+        return first >> 4, first & 0x0F, self.read_exact(length)
+
+    def on_connect(self, body):
+        protocol, offset = read_string(body, 0)
+        level, flags = body[offset], body[offset + 1]
+        offset += 4  # Nível, flags e keepalive
+        client_id, offset = read_string(body, offset)
+        if flags & 0x04:
+            will_topic, offset = read_string(body, offset)
+            will_payload, offset = read_string(body, offset)
+            self.will = (will_topic.decode(), will_payload, bool(flags & 0x20))
+        user = password = None
+        if flags & 0x80:
+            user, offset = read_string(body, offset)
+        if flags & 0x40:
+            password, offset = read_string(body, offset)
+
+        args = self.broker.args
+        if protocol != b"MQTT" or level != 4:
+            code = 1  # Versão do protocolo não suportada
+        elif args.user is not None and (user != args.user.encode() or password != (args.password or "").encode()):
+            code = 4  # Usuário ou senha inválidos
+        else:
+            code = 0
+        self.client_id = client_id.decode() or "anonimo-%s:%d" % self.client_address
+        self.send(packet(CONNACK, 0, bytes([0, code])))
+        if code != 0:
+            raise ConnectionError
+        self.broker.register(self)
+        print("conectado: %s (%s:%d)" % ((self.client_id,) + self.client_address))
+
+    def on_publish(self, flags, body):
+        topic, offset = read_string(body, 0)
+        qos = (flags >> 1) & 0x03
+        packet_id = b""
+        if qos > 0:
+            packet_id, offset = body[offset:offset + 2], offset + 2
+        self.broker.publish(topic.decode(), body[offset:], retain=bool(flags & 0x01))
+        if qos == 1:
+            self.send(packet(PUBACK, 0, packet_id))
+        elif qos == 2:
+            self.send(packet(PUBREC, 0, packet_id))
+
+    def on_subscribe(self, body):
+        packet_id, offset = body[:2], 2
+        granted = bytearray()
+        new_filters = []
+        while offset < len(body):
+            pattern, offset = read_string(body, offset)
+            offset += 1  # QoS pedida: toda entrega sai com QoS 0
+            new_filters.append(pattern.decode())
+            granted.append(0)
+        self.filters.update(new_filters)
+        self.send(packet(SUBACK, 0, packet_id + bytes(granted)))
+        for pattern in new_filters:
+            for topic, payload in self.broker.retained_for(pattern):
+                self.send(packet(PUBLISH, 0x01, encode_string(topic) + payload))
+
+    def on_unsubscribe(self, body):
+        offset = 2
+        while offset < len(body):
+            pattern, offset = read_string(body, offset)
+            self.filters.discard(pattern.decode())
+        self.send(packet(UNSUBACK, 0, body[:2]))
+
+    def handle(self):
+        clean_exit = False
+        try:
+            ptype, _, body = self.read_packet()
+            if ptype != CONNECT:
+                return
+            self.on_connect(body)
+            while not self.closed:
+                ptype, flags, body = self.read_packet()
+                if ptype == PUBLISH:
+                    self.on_publish(flags, body)
+                elif ptype == PUBREL:
+                    self.send(packet(PUBCOMP, 0, body[:2]))
+                elif ptype == SUBSCRIBE:
+                    self.on_subscribe(body)
+                elif ptype == UNSUBSCRIBE:
+                    self.on_unsubscribe(body)
+                elif ptype == PINGREQ:
+                    self.send(packet(PINGRESP, 0, b""))
+                elif ptype == DISCONNECT:
+                    clean_exit = True
+                    return
+        except (ConnectionError, OSError, IndexError, struct.error):
+            pass
+        finally:
+            self.closed = True
+            if self.client_id is not None:
+                self.broker.unregister(self)
+                print("desconectado: %s" % self.client_id)
+                if self.will is not None and not clean_exit:
+                    topic, payload, retain = self.will
+                    self.broker.publish(topic, payload, retain=retain, faults=False)
+
+
+class Server(socketserver.ThreadingTCPServer):
+    daemon_threads = True
+    allow_reuse_address = True
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("--host", default="0.0.0.0")
+    parser.add_argument("--port", type=int, default=1883)
+    parser.add_argument("--user", help="exige este usuário (sem a opção, aceita qualquer um)")
+    parser.add_argument("--password")
+    parser.add_argument("--faults", default="#", help="filtro de tópicos sujeitos às falhas")
+    parser.add_argument("--drop", type=float, default=0.0, help="probabilidade de descartar")
+    parser.add_argument("--dup", type=float, default=0.0, help="probabilidade de duplicar")
+    parser.add_argument("--reorder", type=float, default=0.0, help="probabilidade de trocar com a próxima")
+    parser.add_argument("--hold", type=float, default=500.0, help="ms máximos de uma mensagem retida para reordenar")
+    parser.add_argument("--delay", type=float, default=0.0, help="atraso fixo de entrega (ms)")
+    parser.add_argument("--jitter", type=float, default=0.0, help="atraso aleatório adicional máximo (ms)")
+    parser.add_argument("--seed", type=int, help="semente das falhas, para repetir um teste")
+    parser.add_argument("--stats", type=float, default=10.0, help="segundos entre impressões das contagens (0 desliga)")
+    args = parser.parse_args()
+
+    server = Server((args.host, args.port), ClientHandler)
+    server.broker = Broker(args)
+    print("Broker em %s:%d; falhas em '%s': drop %.2f, dup %.2f, reorder %.2f, atraso %.0f+%.0f ms" % (
+        args.host, args.port, args.faults, args.drop, args.dup, args.reorder, args.delay, args.jitter))
+    threading.Thread(target=server.serve_forever, daemon=True).start()
+    try:
+        while True:
+            time.sleep(args.stats if args.stats > 0 else 3600)
+            if args.stats > 0:
+                print(server.broker.stats.line())
+    except KeyboardInterrupt:
+        pass
+    server.shutdown()
+    print(server.broker.stats.line())
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,94 @@
+"""Cliente MQTT 3.1.1 mínimo (QoS 0), sem dependências, para as ferramentas de teste.
+
+Suporta CONNECT (usuário/senha opcionais), SUBSCRIBE, PUBLISH (com retain) e
+leitura dos PUBLISH recebidos. Não trata QoS 1/2 nem reconexão.
+"""
+import socket
+import struct
+
+
+def encode_remaining_length(n):
+    out = bytearray()
+    while True:
+        byte = n % 128
+        n //= 128
+        if n:
+            byte |= 0x80
+        out.append(byte)
+        if not n:
+            return bytes(out)
+
+
+def encode_string(s):
+    data = s.encode() if isinstance(s, str) else s
+    return struct.pack("!H", len(data)) + data
+
+
+def packet(ptype, flags, body):
+    return bytes([(ptype << 4) | flags]) + encode_remaining_length(len(body)) + body
+
+
+class MqttLite:
+    def __init__(self, host, port=1883, client_id="tool", user=None, password=None, keepalive=60):
+        self.sock = socket.create_connection((host, port))
+        self.next_packet_id = 1
+        flags = 0x02  # Clean session
+        payload = encode_string(client_id)
+        if user is not None:
+            flags |= 0x80
+            payload += encode_string(user)
+        if password is not None:
+            flags |= 0x40
+            payload += encode_string(password)
+        body = encode_string("MQTT") + bytes([4, flags]) + struct.pack("!H", keepalive) + payload
+        self.sock.sendall(packet(1, 0, body))
+        ptype, _, body = self.read_packet()
+        if ptype != 2 or body[1] != 0:
+            raise ConnectionError("CONNACK recusado: %r" % body)
+
+    def _read_exact(self, n):
+        data = bytearray()
+        while len(data) < n:
+            chunk = self.sock.recv(n - len(data))
+            if not chunk:
+                raise ConnectionError("conexão fechada pelo broker")
+            data += chunk
+        return bytes(data)
+
+    def read_packet(self):
+        """Retorna (tipo, flags, corpo) do próximo pacote."""
+        first = self._read_exact(1)[0]
+        length, shift = 0, 0
+        while True:
+            byte = self._read_exact(1)[0]
+            length |= (byte & 0x7F) << shift
+            shift += 7
+            if not byte & 0x80:
+                break
+        return first >> 4, first & 0x0F, self._read_exact(length)
+
+    def subscribe(self, topic):
+        packet_id = self.next_packet_id
+        self.next_packet_id += 1
+        body = struct.pack("!H", packet_id) + encode_string(topic) + b"\x00"
+        self.sock.sendall(packet(8, 0x02, body))
+
+    def publish(self, topic, payload, retain=False):
+        self.sock.sendall(packet(3, 0x01 if retain else 0x00, encode_string(topic) + payload))
+
+    def read_publish(self):
+        """Bloqueia até receber um PUBLISH e retorna (tópico, payload)."""
+        while True:
+            ptype, flags, body = self.read_packet()
+            if ptype != 3:
+                continue  # SUBACK, PINGRESP...
+            topic_len = struct.unpack("!H", body[:2])[0]
+            topic = body[2:2 + topic_len].decode()
+            offset = 2 + topic_len + (2 if flags & 0x06 else 0)  # Packet id só com QoS > 0
+            return topic, body[offset:]
+
+    def close(self):
+        try:
+            self.sock.sendall(packet(14, 0, b""))
+        finally:
+            self.sock.close()
@@ -0,0 +1,103 @@
+# Relatório de RAM de um firmware, chamado ao final da linkagem com -DRAM_REPORT=ON:
+#   cmake -DELF=<firmware.elf> -DNM=<arm-none-eabi-nm> -DSU_DIR=<CMakeFiles/<alvo>.dir>[,<outro>.dir] -P tools/ram_report.cmake
+# Imprime a RAM estática (.data + .bss), a parte reservada pelo pool de mensagens
+# (src/pool.c), os maiores símbolos e os maiores quadros de pilha medidos pelo
+# -fstack-usage. Quadros "dynamic" (VLA ou alloca) não têm limite conhecido em
+# compilação e são listados à parte. SU_DIR aceita vários diretórios separados por
+# vírgula (o do firmware e o da biblioteca app_core).
+
+if (NOT ELF OR NOT NM OR NOT SU_DIR)
+    message(FATAL_ERROR "ram_report.cmake: defina ELF, NM e SU_DIR")
+endif()
+
+set(TOP_COUNT 10)
+
+# Tamanhos com zeros à esquerda para ordenar como texto
+function(pad_size value out)
+    string(LENGTH "${value}" length)
+    while (length LESS 8)
+        string(PREPEND value "0")
+        math(EXPR length "${length} + 1")
+    endwhile()
+    set(${out} "${value}" PARENT_SCOPE)
+endfunction()
+
+function(print_top title entries)
+    list(SORT entries)
+    list(REVERSE entries)
+    list(LENGTH entries count)
+    if (count GREATER TOP_COUNT)
+        list(SUBLIST entries 0 ${TOP_COUNT} entries)
+    endif()
+    message("  ${title}:")
+    foreach(entry IN LISTS entries)
+        string(REPLACE "|" ";" fields "${entry}")
+        list(GET fields 0 size)
+        list(GET fields 1 name)
+        math(EXPR size "${size}")
+        message("    ${size} B  ${name}")
+    endforeach()
+endfunction()
+
+# --- RAM estática ---
+execute_process(COMMAND ${NM} --print-size --size-sort --radix=d ${ELF}
+                OUTPUT_VARIABLE nm_output RESULT_VARIABLE nm_result)
+if (NOT nm_result EQUAL 0)
+    message(FATAL_ERROR "ram_report.cmake: ${NM} falhou para ${ELF}")
+endif()
+string(REPLACE "\n" ";" nm_lines "${nm_output}")
+
+set(static_total 0)
+set(pool_total 0)
+set(symbols "")
+foreach(line IN LISTS nm_lines)
+    # endereço, tamanho, tipo (b/d = .bss/.data) e nome
+    if (line MATCHES "^[0-9]+ 0*([0-9]+) [bBdD] (.+)$")
+        set(size ${CMAKE_MATCH_1})
+        set(name ${CMAKE_MATCH_2})
+        math(EXPR static_total "${static_total} + ${size}")
+        if (name MATCHES "^pool_blocks_")
+            math(EXPR pool_total "${pool_total} + ${size}")
+        endif()
+        pad_size(${size} padded)
+        list(APPEND symbols "${padded}|${name}")
+    endif()
+endforeach()
+
+# --- Pilha ---
+string(REPLACE "," ";" su_dirs "${SU_DIR}")
+set(su_files "")
+foreach(dir IN LISTS su_dirs)
+    file(GLOB_RECURSE dir_su_files "${dir}/*.su")
+    list(APPEND su_files ${dir_su_files})
+endforeach()
+set(frames "")
+set(dynamic_frames "")
+foreach(su_file IN LISTS su_files)
+    file(STRINGS ${su_file} su_lines)
+    foreach(line IN LISTS su_lines)
+        # arquivo:linha:coluna:função <tab> bytes <tab> static | dynamic | dynamic,bounded
+        if (line MATCHES "^.*:([^:\t]+)\t([0-9]+)\t(.+)$")
+            pad_size(${CMAKE_MATCH_2} padded)
+            list(APPEND frames "${padded}|${CMAKE_MATCH_1}")
+            if (CMAKE_MATCH_3 STREQUAL "dynamic")
+                list(APPEND dynamic_frames "${padded}|${CMAKE_MATCH_1}")
+            endif()
+        endif()
+    endforeach()
+endforeach()
+
+get_filename_component(elf_name ${ELF} NAME)
+message("RAM de ${elf_name}:")
+message("  Estatica (.data + .bss): ${static_total} B, dos quais ${pool_total} B do pool de mensagens")
+print_top("Maiores simbolos" "${symbols}")
+if (frames)
+    print_top("Maiores quadros de pilha" "${frames}")
+    if (dynamic_frames)
+        print_top("Quadros sem limite (VLA/alloca)" "${dynamic_frames}")
+    else()
+        message("  Quadros sem limite (VLA/alloca): nenhum")
+    endif()
+else()
+    message("  Sem arquivos .su em ${SU_DIR}")
+endif()
@@ -0,0 +1,70 @@
+#!/usr/bin/env python3
+"""Inunda o subscriber com frames AEAD repetidos para medir a recusa pelo cabeçalho.
+
+Uso:
+    python3 tools/replay_flood.py <broker> [--count 1000] [--rate 200] [--mode replay|forjado]
+
+Captura o próximo frame publicado em escola/sala1/temperatura (publisher no modo
+AES-GCM ou ChaCha20-Poly1305) e o republica --count vezes:
+    replay   - frame idêntico: recusado pelo cabeçalho (sequência repetida), sem decifrar
+    forjado  - contador avançado e tag aleatória: passa pelo cabeçalho e falha na tag,
+               ou seja, o custo de uma decifragem completa
+Depois, digite 'p' no terminal serial do subscriber para ver os frames recusados pelo
+pré-filtro (cabeçalho/replay) e 'f' para contagens e µs médios dos que chegaram a frame_open.
+"""
+import argparse
+import os
+import struct
+import sys
+import time
+
+sys.path.insert(0, os.path.dirname(os.path.abspath(__file__)))
+from mqtt_lite import MqttLite  # noqa: E402
+
+FRAME_HEADER_LEN = 17  # [tipo 1][remetente 4][boot 4][contador 4][hash do tópico 4]
+FRAME_TAG_LEN = 16
+
+
+def forge(frame, index):
+    """Avança o contador do cabeçalho e troca a tag: o frame só é recusado pela tag."""
+    counter = struct.unpack("!I", frame[9:13])[0] + 1000 + index
+    tag = os.urandom(FRAME_TAG_LEN)
+    return frame[:9] + struct.pack("!I", counter & 0xFFFFFFFF) + frame[13:FRAME_HEADER_LEN] + tag + \
+        frame[FRAME_HEADER_LEN + FRAME_TAG_LEN:]
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("broker")
+    parser.add_argument("--port", type=int, default=1883)
+    parser.add_argument("--user", default="aluno")
+    parser.add_argument("--password", default="senha123")
+    parser.add_argument("--topic", default="escola/sala1/temperatura")
+    parser.add_argument("--count", type=int, default=1000)
+    parser.add_argument("--rate", type=float, default=200.0, help="frames por segundo")
+    parser.add_argument("--mode", choices=("replay", "forjado"), default="replay")
+    args = parser.parse_args()
+
+    client = MqttLite(args.broker, args.port, "replay-flood", args.user, args.password)
+    client.subscribe(args.topic)
+    print("Aguardando um frame em %s..." % args.topic)
+    while True:
+        _, frame = client.read_publish()
+        if len(frame) > FRAME_HEADER_LEN + FRAME_TAG_LEN and frame[0] >> 4 == 1:
+            break
+    print("Capturado frame de %d bytes (tipo 0x%02x); enviando %d (%s)" % (len(frame), frame[0], args.count, args.mode))
+
+    interval = 1.0 / args.rate
+    start = time.monotonic()
+    for i in range(args.count):
+        client.publish(args.topic, frame if args.mode == "replay" else forge(frame, i))
+        delay = start + (i + 1) * interval - time.monotonic()
+        if delay > 0:
+            time.sleep(delay)
+    elapsed = time.monotonic() - start
+    print("Enviados %d frames em %.1f s (%.0f/s)" % (args.count, elapsed, args.count / elapsed))
+    client.close()
+
+
+if __name__ == "__main__":
+    main()
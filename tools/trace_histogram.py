@@ -0,0 +1,73 @@
+#!/usr/bin/env python3
+"""Converte o dump do rastreamento (comando 't' do console) em histogramas por estágio.
+
+Uso:
+    python3 tools/trace_histogram.py captura_serial.txt
+    minicom -C captura.txt ...  (ou qualquer log do terminal serial)
+
+Lê as linhas "TRACE,<estagio>,<B|E>,<us>" (as demais são ignoradas), pareia
+início e fim de cada estágio e imprime percentis e um histograma com faixas
+em potências de 2 microssegundos.
+"""
+import sys
+from collections import defaultdict
+
+U32 = 1 << 32
+
+
+def parse_durations(lines):
+    """Retorna {estagio: [duracao_us, ...]} a partir das linhas do dump."""
+    open_begins = defaultdict(list)  # Pilha por estágio (um estágio pode aninhar em outro)
+    durations = defaultdict(list)
+    for line in lines:
+        line = line.strip()
+        if line.startswith("TRACE-BEGIN"):
+            open_begins.clear()  # Cada dump recomeça o pareamento
+            continue
+        if not line.startswith("TRACE,"):
+            continue
+        try:
+            _, stage, kind, ts = line.split(",")
+            ts = int(ts)
+        except ValueError:
+            continue
+        if kind == "B":
+            open_begins[stage].append(ts)
+        elif kind == "E" and open_begins[stage]:
+            start = open_begins[stage].pop()
+            durations[stage].append((ts - start) % U32)  # time_us_32 dá a volta a cada ~71 min
+    return durations
+
+
+def percentile(sorted_values, p):
+    index = min(len(sorted_values) - 1, int(round(p / 100.0 * (len(sorted_values) - 1))))
+    return sorted_values[index]
+
+
+def print_histogram(stage, values, width=40):
+    values = sorted(values)
+    print(f"== {stage}: n={len(values)} min={values[0]} p50={percentile(values, 50)} "
+          f"p90={percentile(values, 90)} p99={percentile(values, 99)} max={values[-1]} us")
+    buckets = defaultdict(int)
+    for v in values:
+        buckets[max(v, 1).bit_length() - 1] += 1
+    peak = max(buckets.values())
+    for exp in range(min(buckets), max(buckets) + 1):
+        count = buckets.get(exp, 0)
+        bar = "#" * max(1 if count else 0, count * width // peak)
+        print(f"  [{1 << exp:>8}, {1 << (exp + 1):>8}) us {count:>6} {bar}")
+
+
+def main():
+    stream = open(sys.argv[1], encoding="utf-8", errors="replace") if len(sys.argv) > 1 else sys.stdin
+    durations = parse_durations(stream)
+    if not durations:
+        print("Nenhum evento TRACE encontrado.", file=sys.stderr)
+        return 1
+    for stage in sorted(durations):
+        print_histogram(stage, durations[stage])
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())